@@ -124,6 +124,20 @@ t.SetBranchAddress('classb', cb)
 ms = ROOT.MyStruct()
 ds.SetBranchAddress('structb', ms)
 \endcode
+
+Finally, branches of fundamental types can be read as numpy arrays with
+TTree::AsNumpy, which is based on ROOT::Experimental::TTreeColumnExporter.
+The data is read with the bulk I/O interface directly into the memory
+adopted by the numpy arrays, in parallel if the implicit multi-threading of
+ROOT is enabled. Variable-size array branches are returned as a pair of
+arrays, the offsets and the flat values, in the layout of an Arrow LargeList.
+\code{.py}
+columns = t.AsNumpy(['floatb', 'arrayb', 'varb'])
+columns['floatb']          # 1D array
+columns['arrayb']          # 2D array of shape (entries, N)
+offsets, values = columns['varb']
+values[offsets[i]:offsets[i+1]] # content of entry i
+\endcode
 \htmlonly
 </div>
 \endhtmlonly
@@ -132,6 +146,8 @@ ds.SetBranchAddress('structb', ms)
 
 from libROOTPythonizations import AddBranchAttrSyntax, SetBranchAddressPyz, BranchPyz
 
+import ctypes
+
 import cppyy
 from ROOT import pythonization
 
@@ -293,6 +309,101 @@ def _TTreeAsMatrix(self, columns=None, exclude=None, dtype="double", return_labe
     else:
         return reshaped_matrix_np
 
+# TTree.AsNumpy functionality
+# Long_t is a C long: 4 bytes on Windows, 8 bytes on 64-bit Unix
+_long_size = ctypes.sizeof(ctypes.c_long)
+_numpy_typestr_map = {
+    "Char_t": "i1", "UChar_t": "u1",
+    "Short_t": "i2", "UShort_t": "u2",
+    "Int_t": "i4", "UInt_t": "u4",
+    "Long_t": "i{}".format(_long_size), "ULong_t": "u{}".format(_long_size),
+    "Long64_t": "i8", "ULong64_t": "u8",
+    "Float_t": "f4", "Double_t": "f8",
+}
+
+
+class _ArrayInterface(object):
+    """Expose a memory buffer owned by C++ through the numpy array interface."""
+    def __init__(self, pointer, shape, typestr):
+        # Numpy breaks for data pointer of 0 even though the array is empty.
+        self.__array_interface__ = {
+            "shape": shape,
+            "typestr": typestr,
+            "version": 3,
+            "data": (pointer if pointer else 1, False)
+        }
+
+
+def _TTreeAsNumpy(self, columns=None, exclude=None):
+    """Read-out branches of the TTree as numpy arrays without intermediate copies.
+
+    The branches are read in bulk straight into the buffers adopted by the numpy
+    arrays, in multiple threads if the implicit multi-threading of ROOT is enabled.
+    Only branches with a single leaf of fundamental type are supported, and the
+    tree has to be stored in a file.
+
+    Parameters:
+        columns: If None return all branches as columns, otherwise specify names in iterable.
+        exclude: Exclude branches from selection.
+
+    Returns:
+        dict: Dict with column names as keys and numpy arrays as values. Fixed-size
+        array branches are returned as 2D arrays, variable-size array branches as a
+        tuple (offsets, values).
+    """
+    if isinstance(columns, str):
+        raise TypeError("The columns argument requires a list of strings")
+    if isinstance(exclude, str):
+        raise TypeError("The exclude argument requires a list of strings")
+
+    try:
+        import numpy
+        from ROOT.pythonization._rdf_utils import ndarray
+    except:
+        raise ImportError("Failed to import numpy during call of TTree.AsNumpy.")
+    from libROOTPythonizations import GetEndianess, GetDataPointer
+
+    if self.IsA().InheritsFrom("TChain"):
+        raise TypeError("TTree.AsNumpy does not support TChain.")
+    directory = self.GetDirectory()
+    if not directory or not directory.GetFile():
+        raise Exception("Tree {} is not stored in a file.".format(self.GetName()))
+
+    if columns is None:
+        columns = [branch.GetName() for branch in self.GetListOfBranches()]
+    if exclude is None:
+        exclude = []
+    columns = [col for col in columns if not col in exclude]
+
+    columns_vector = cppyy.gbl.std.vector["string"](len(columns))
+    for i, col in enumerate(columns):
+        columns_vector[i] = col
+
+    # Path of the tree inside its file, e.g. "dir/tree"
+    path = str(directory.GetPath()).split(":", 1)[-1].strip("/")
+    tree_path = path + "/" + self.GetName() if path else self.GetName()
+    exporter = cppyy.gbl.ROOT.Experimental.TTreeColumnExporter(tree_path, directory.GetFile().GetName())
+    exporter.Export(columns_vector)
+
+    endianess = GetEndianess()
+    column_cppname = "ROOT::Experimental::TTreeColumnExporter::TColumn"
+    py_arrays = {}
+    for column in exporter.GetColumns():
+        typestr = endianess + _numpy_typestr_map[str(column.GetTypeName())]
+        pointer = GetDataPointer(column, column_cppname, "GetData")
+        if column.IsJagged():
+            values = ndarray(_ArrayInterface(pointer, (column.GetNValues(), ), typestr), exporter)
+            offsets_pointer = GetDataPointer(column, column_cppname, "GetOffsets")
+            offsets = ndarray(_ArrayInterface(offsets_pointer, (column.GetNEntries() + 1, ), endianess + "i8"), exporter)
+            py_arrays[str(column.GetName())] = (offsets, values)
+        else:
+            shape = (column.GetNEntries(), )
+            if column.GetInnerSize() > 1:
+                shape = (column.GetNEntries(), column.GetInnerSize())
+            py_arrays[str(column.GetName())] = ndarray(_ArrayInterface(pointer, shape, typestr), exporter)
+
+    return py_arrays
+
 @pythonization()
 def pythonize_ttree(klass, name):
     # Parameters:
@@ -329,4 +440,7 @@ def pythonize_ttree(klass, name):
         # AsMatrix
         klass.AsMatrix = _TTreeAsMatrix
 
+        # AsNumpy
+        klass.AsNumpy = _TTreeAsNumpy
+
     return True
@@ -0,0 +1,85 @@
+import os
+import unittest
+import ROOT
+import numpy as np
+
+
+class TTreeAsNumpy(unittest.TestCase):
+    """
+    Test for the TTree.AsNumpy pythonization, reading branches in bulk with
+    ROOT::Experimental::TTreeColumnExporter
+    """
+
+    filename = "ttree_asnumpy.root"
+    nentries = 1000
+
+    @classmethod
+    def setUpClass(cls):
+        f = ROOT.TFile(cls.filename, "RECREATE")
+        t = ROOT.TTree("t", "t")
+        t.SetAutoFlush(100)
+        i = np.empty(1, dtype=np.int32)
+        x = np.empty(1, dtype=np.float32)
+        v = np.empty(3, dtype=np.float64)
+        n = np.empty(1, dtype=np.int32)
+        s = np.empty(10, dtype=np.int16)
+        t.Branch("i", i, "i/I")
+        t.Branch("x", x, "x/F")
+        t.Branch("v", v, "v[3]/D")
+        t.Branch("n", n, "n/I")
+        t.Branch("s", s, "s[n]/S")
+        for e in range(cls.nentries):
+            i[0] = e
+            x[0] = 0.5 * e
+            v[:] = [e + 0.1 * k for k in range(3)]
+            n[0] = e % 10
+            s[:n[0]] = [k - e % 7 for k in range(n[0])]
+            t.Fill()
+        f.Write()
+        f.Close()
+
+    @classmethod
+    def tearDownClass(cls):
+        os.remove(cls.filename)
+
+    def test_roundtrip(self):
+        f = ROOT.TFile(self.filename)
+        t = f.Get("t")
+        columns = t.AsNumpy(["i", "x", "v", "s"])
+        self.assertEqual(sorted(columns.keys()), ["i", "s", "v", "x"])
+
+        ref = np.arange(self.nentries)
+        self.assertEqual(columns["i"].dtype, np.int32)
+        self.assertTrue((columns["i"] == ref).all())
+        self.assertEqual(columns["x"].dtype, np.float32)
+        self.assertTrue((columns["x"] == 0.5 * ref).all())
+
+        v = columns["v"]
+        self.assertEqual(v.shape, (self.nentries, 3))
+        for k in range(3):
+            self.assertTrue(np.allclose(v[:, k], ref + 0.1 * k))
+
+        offsets, values = columns["s"]
+        self.assertEqual(offsets.shape, (self.nentries + 1, ))
+        self.assertEqual(values.dtype, np.int16)
+        for e in range(self.nentries):
+            entry = values[offsets[e]:offsets[e + 1]]
+            self.assertEqual(len(entry), e % 10)
+            self.assertTrue((entry == np.arange(e % 10) - e % 7).all())
+
+    def test_exclude(self):
+        f = ROOT.TFile(self.filename)
+        t = f.Get("t")
+        columns = t.AsNumpy(exclude=["v", "s"])
+        self.assertEqual(sorted(columns.keys()), ["i", "n", "x"])
+        self.assertTrue((columns["n"] == np.arange(self.nentries) % 10).all())
+
+    def test_tree_in_memory(self):
+        ROOT.gROOT.cd()
+        t = ROOT.TTree("mem", "mem")
+        with self.assertRaises(Exception):
+            t.AsNumpy()
+
+
+if __name__ == '__main__':
+    unittest.main()
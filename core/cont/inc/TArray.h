@@ -34,6 +34,8 @@ protected:
    Bool_t        BoundsOk(const char *where, Int_t at) const;
    Bool_t        OutOfBoundsError(const char *where, Int_t i) const;
 
+   static Int_t  fgCompactMinSize; //Minimum size of the arrays streamed in compact form (0: never)
+
 public:
    Int_t     fN;            //Number of array elements
 
@@ -53,6 +55,15 @@ public:
    static TArray *ReadArray(TBuffer &b, const TClass *clReq);
    static void    WriteArray(TBuffer &b, const TArray *a);
 
+   static Int_t   GetCompactStreaming();
+   static void    SetCompactStreaming(Int_t minsize = 1024);
+   template <typename T>
+   static Bool_t  IsCompactStreamable(TBuffer &b, const T *arr, Int_t n);
+   template <typename T>
+   static void    ReadCompactArray(TBuffer &b, T *arr, Int_t n);
+   template <typename T>
+   static void    WriteCompactArray(TBuffer &b, const T *arr, Int_t n);
+
    friend TBuffer &operator<<(TBuffer &b, const TArray *obj);
 
    ClassDef(TArray,1)  //Abstract array base class
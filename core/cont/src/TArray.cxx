@@ -14,6 +14,15 @@
 Abstract array base class. Used by TArrayC, TArrayS, TArrayI,
 TArrayL, TArrayF and TArrayD.
 Data member is public for historical reasons.
+
+Arrays that are mostly made of zeros, like the bin contents of large
+histograms with few filled bins, can be streamed in compact form: only
+the runs of non-zero elements are written, together with the number of
+zeros separating them. This is enabled with SetCompactStreaming() for
+all arrays of at least the given size, and only used when the compact
+form is smaller than the plain one. The zeros are restored when reading,
+independently of the setting. Files written in compact form cannot be
+read by ROOT versions that do not support it.
 */
 
 #include "TArray.h"
@@ -21,9 +30,61 @@ Data member is public for historical reasons.
 #include "TClass.h"
 #include "TBuffer.h"
 
+#include <cmath>
+#include <vector>
+
 
 ClassImp(TArray);
 
+Int_t TArray::fgCompactMinSize = 0;
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Whether v is a zero that is not stored in compact form; -0. is kept to be
+/// restored exactly.
+
+template <typename T>
+inline bool IsSuppressedZero(T v)
+{
+   return v == T(0) && !std::signbit(v);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Call onRun(zeros, length) for each run of elements of arr stored in compact
+/// form, `zeros` being the number of zeros since the end of the previous run.
+/// Runs are only split at gaps of zeros larger than a run header.
+
+template <typename T, typename F>
+void ScanCompactRuns(const T *arr, Int_t n, F onRun)
+{
+   const Int_t minGap = 2 * sizeof(Int_t) / sizeof(T) + 1;
+   Int_t end = 0;
+   Int_t i = 0;
+   while (i < n) {
+      while (i < n && IsSuppressedZero(arr[i]))
+         ++i;
+      if (i == n)
+         break;
+      const Int_t begin = i;
+      Int_t last = ++i;
+      while (i < n) {
+         if (!IsSuppressedZero(arr[i])) {
+            last = ++i;
+            continue;
+         }
+         while (i < n && IsSuppressedZero(arr[i]))
+            ++i;
+         if (i - last >= minGap)
+            break;
+      }
+      onRun(begin - end, last - begin);
+      end = last;
+   }
+}
+
+} // anonymous namespace
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Generate an out-of-bounds error. Always returns false.
 
@@ -106,6 +167,138 @@ void TArray::WriteArray(TBuffer &b, const TArray *a)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the minimum size of the arrays streamed in compact form,
+/// 0 if compact streaming is disabled.
+
+Int_t TArray::GetCompactStreaming()
+{
+   return fgCompactMinSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Stream the arrays of at least minsize elements in compact form, i.e.
+/// without their runs of zeros, when this makes them smaller.
+/// This applies to the TArray classes and to the bin contents of THn.
+/// With minsize = 0 (default at startup), arrays are always written in full.
+
+void TArray::SetCompactStreaming(Int_t minsize)
+{
+   fgCompactMinSize = minsize > 0 ? minsize : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return whether the n elements of arr should be written to b in compact
+/// form, see SetCompactStreaming(). This is never the case for text
+/// based buffers like TBufferJSON.
+
+template <typename T>
+Bool_t TArray::IsCompactStreamable(TBuffer &b, const T *arr, Int_t n)
+{
+   if (fgCompactMinSize <= 0 || n < fgCompactMinSize || !arr)
+      return kFALSE;
+   if (b.InheritsFrom("TBufferText"))
+      return kFALSE;
+
+   Long64_t nruns = 0;
+   Long64_t nvalues = 0;
+   ScanCompactRuns(arr, n, [&](Int_t, Int_t length) {
+      ++nruns;
+      nvalues += length;
+   });
+   return (1 + 2 * nruns) * Long64_t(sizeof(Int_t)) + nvalues * Long64_t(sizeof(T)) < n * Long64_t(sizeof(T));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read the n elements of arr from b, written by WriteCompactArray().
+/// The non-zero runs are read at the end of arr and moved to their position,
+/// filling the gaps with zeros.
+
+template <typename T>
+void TArray::ReadCompactArray(TBuffer &b, T *arr, Int_t n)
+{
+   Int_t nruns = 0;
+   b >> nruns;
+   if (nruns < 0 || nruns > n) {
+      ::Error("TArray::ReadCompactArray", "invalid number of runs %d for %d elements", nruns, n);
+      memset(arr, 0, n * sizeof(T));
+      return;
+   }
+   std::vector<Int_t> runs(2 * nruns);
+   b.ReadFastArray(runs.data(), 2 * nruns);
+
+   Long64_t total = 0;
+   Long64_t nvalues = 0;
+   for (Int_t r = 0; r < nruns; ++r) {
+      if (runs[2 * r] < 0 || runs[2 * r + 1] <= 0)
+         total = Long64_t(n) + 1;
+      total += Long64_t(runs[2 * r]) + runs[2 * r + 1];
+      nvalues += runs[2 * r + 1];
+   }
+   if (total > n) {
+      ::Error("TArray::ReadCompactArray", "runs do not fit in %d elements", n);
+      memset(arr, 0, n * sizeof(T));
+      return;
+   }
+
+   // The gap before each run ends before the stored values of this run,
+   // so that runs can be moved in order.
+   T *values = arr + (n - nvalues);
+   b.ReadFastArray(values, Int_t(nvalues));
+   Int_t pos = 0;
+   for (Int_t r = 0; r < nruns; ++r) {
+      memset(arr + pos, 0, runs[2 * r] * sizeof(T));
+      pos += runs[2 * r];
+      memmove(arr + pos, values, runs[2 * r + 1] * sizeof(T));
+      values += runs[2 * r + 1];
+      pos += runs[2 * r + 1];
+   }
+   memset(arr + pos, 0, (n - pos) * sizeof(T));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write the n elements of arr to b in compact form: the number of runs of
+/// non-zero elements, the number of zeros before and the length of each run,
+/// then the elements of all runs. To be read with ReadCompactArray().
+
+template <typename T>
+void TArray::WriteCompactArray(TBuffer &b, const T *arr, Int_t n)
+{
+   std::vector<Int_t> runs;
+   ScanCompactRuns(arr, n, [&](Int_t zeros, Int_t length) {
+      runs.push_back(zeros);
+      runs.push_back(length);
+   });
+   const Int_t nruns = runs.size() / 2;
+   b << nruns;
+   b.WriteFastArray(runs.data(), 2 * nruns);
+   Int_t pos = 0;
+   for (Int_t r = 0; r < nruns; ++r) {
+      pos += runs[2 * r];
+      b.WriteFastArray(arr + pos, runs[2 * r + 1]);
+      pos += runs[2 * r + 1];
+   }
+}
+
+#define INSTANTIATE_COMPACT_STREAMING(T)                                       \
+   template Bool_t TArray::IsCompactStreamable(TBuffer &, const T *, Int_t);  \
+   template void TArray::ReadCompactArray(TBuffer &, T *, Int_t);             \
+   template void TArray::WriteCompactArray(TBuffer &, const T *, Int_t);
+
+INSTANTIATE_COMPACT_STREAMING(Char_t)
+INSTANTIATE_COMPACT_STREAMING(Short_t)
+INSTANTIATE_COMPACT_STREAMING(Int_t)
+INSTANTIATE_COMPACT_STREAMING(Long_t)
+INSTANTIATE_COMPACT_STREAMING(Long64_t)
+INSTANTIATE_COMPACT_STREAMING(UShort_t)
+INSTANTIATE_COMPACT_STREAMING(UInt_t)
+INSTANTIATE_COMPACT_STREAMING(ULong_t)
+INSTANTIATE_COMPACT_STREAMING(ULong64_t)
+INSTANTIATE_COMPACT_STREAMING(Float_t)
+INSTANTIATE_COMPACT_STREAMING(Double_t)
+
+#undef INSTANTIATE_COMPACT_STREAMING
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Write TArray or derived object to buffer.
 
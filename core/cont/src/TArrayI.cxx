@@ -147,8 +147,17 @@ void TArrayI::Streamer(TBuffer &b)
    if (b.IsReading()) {
       Int_t n;
       b >> n;
-      Set(n);
-      b.ReadFastArray(fArray,n);
+      if (n < 0) {
+         // compact form, see TArray::SetCompactStreaming
+         Set(-n);
+         ReadCompactArray(b, fArray, -n);
+      } else {
+         Set(n);
+         b.ReadFastArray(fArray,n);
+      }
+   } else if (IsCompactStreamable(b, fArray, fN)) {
+      b << -fN;
+      WriteCompactArray(b, fArray, fN);
    } else {
       b << fN;
       b.WriteFastArray(fArray, fN);
@@ -83,19 +83,19 @@
 #pragma link C++ class THnBase+;
 #pragma link C++ class THnIter+;
 #pragma link C++ class TNDArray+;
-#pragma link C++ class TNDArrayT<Float_t>+;
-//#pragma link C++ class TNDArrayT<Float16_t>+;
-#pragma link C++ class TNDArrayT<Double_t>+;
-//#pragma link C++ class TNDArrayT<Double32_t>+;
-#pragma link C++ class TNDArrayT<Long64_t>+;
-#pragma link C++ class TNDArrayT<Long_t>+;
-#pragma link C++ class TNDArrayT<Int_t>+;
-#pragma link C++ class TNDArrayT<Short_t>+;
-#pragma link C++ class TNDArrayT<Char_t>+;
-#pragma link C++ class TNDArrayT<ULong64_t>+;
-#pragma link C++ class TNDArrayT<ULong_t>+;
-#pragma link C++ class TNDArrayT<UInt_t>+;
-#pragma link C++ class TNDArrayT<UShort_t>+;
+#pragma link C++ class TNDArrayT<Float_t>-;
+//#pragma link C++ class TNDArrayT<Float16_t>-;
+#pragma link C++ class TNDArrayT<Double_t>-;
+//#pragma link C++ class TNDArrayT<Double32_t>-;
+#pragma link C++ class TNDArrayT<Long64_t>-;
+#pragma link C++ class TNDArrayT<Long_t>-;
+#pragma link C++ class TNDArrayT<Int_t>-;
+#pragma link C++ class TNDArrayT<Short_t>-;
+#pragma link C++ class TNDArrayT<Char_t>-;
+#pragma link C++ class TNDArrayT<ULong64_t>-;
+#pragma link C++ class TNDArrayT<ULong_t>-;
+#pragma link C++ class TNDArrayT<UInt_t>-;
+#pragma link C++ class TNDArrayT<UShort_t>-;
 #pragma link C++ class TNDArrayRef<Float_t>+;
 //#pragma link C++ class TNDArrayRef<Float16_t>+;
 #pragma link C++ class TNDArrayRef<Double_t>+;
@@ -121,6 +121,9 @@ namespace ROOT {
             return std::string(fFunc->GetParName(i));
          }
 
+         /// evaluate the function at n points, using TF1::EvalParN when possible
+         void EvalParN(unsigned int n, const T *const *x, T *f, const double *p) const;
+
          // evaluate the derivative of the function with respect to the parameters
          void ParameterGradient(const T *x, const double *par, T *grad) const;
 
@@ -209,6 +212,24 @@ namespace ROOT {
          }
       };
 
+      /**
+       * Auxiliar class to call TF1::EvalParN, which exists only for double, from WrappedMultiTF1Templ::EvalParN.
+       * The general implementation returns false and the points are evaluated one by one.
+       */
+      template <class T>
+      struct TF1EvalParN {
+         static bool EvalParN(TF1 *, unsigned int, const T *const *, T *, const double *) { return false; }
+      };
+
+      template <>
+      struct TF1EvalParN<double> {
+         static bool EvalParN(TF1 *func, unsigned int n, const double *const *x, double *f, const double *p)
+         {
+            func->EvalParN(n, x, f, p);
+            return true;
+         }
+      };
+
       // implementations for WrappedMultiTF1Templ<T>
       template<class T>
       WrappedMultiTF1Templ<T>::WrappedMultiTF1Templ(TF1 &f, unsigned int dim)  :
@@ -269,6 +290,14 @@ namespace ROOT {
          return *this;
       }
 
+      template <class T>
+      void WrappedMultiTF1Templ<T>::EvalParN(unsigned int n, const T *const *x, T *f, const double *p) const
+      {
+         // the TF1 can have more coordinates than the wrapper: evaluate then point by point, as DoEvalPar
+         if (fDim != (unsigned int)fFunc->GetNdim() || !TF1EvalParN<T>::EvalParN(fFunc, n, x, f, p))
+            IParametricFunctionMultiDimTempl<T>::EvalParN(n, x, f, p);
+      }
+
       template <class T>
       void WrappedMultiTF1Templ<T>::ParameterGradient(const T *x, const double *par, T *grad) const
       {
@@ -110,6 +110,7 @@ public:
       TH1*          GetCopyTotalHisto() const;
       Int_t         GetDimension() const;
       TDirectory*   GetDirectory() const {return fDirectory;}
+      void          GetEfficiencies(Int_t n, const Int_t* bins, Double_t* eff, Double_t* errLow, Double_t* errUp) const;
       Double_t      GetEfficiency(Int_t bin) const;
       Double_t      GetEfficiencyErrorLow(Int_t bin) const;
       Double_t      GetEfficiencyErrorUp(Int_t bin) const;
@@ -177,6 +178,9 @@ public:
       static Double_t FeldmanCousins(Double_t total,Double_t passed,Double_t level,Bool_t bUpper);
       static Bool_t FeldmanCousinsInterval(Double_t total,Double_t passed,Double_t level,Double_t & lower, Double_t & upper);
       static Double_t MidPInterval(Double_t total,Double_t passed,Double_t level,Bool_t bUpper);
+      static void ConfidenceIntervals(Int_t n,const Double_t* total,const Double_t* passed,Double_t level,
+                                      EStatOption option,Double_t* lower,Double_t* upper,
+                                      Double_t alpha = 1,Double_t beta = 1,Bool_t bShortest = false);
       // Bayesian functions
       static Double_t Bayesian(Double_t total,Double_t passed,Double_t level,Double_t alpha,Double_t beta,Bool_t bUpper, Bool_t bShortest = false);
       // helper functions for Bayesian statistics
@@ -38,6 +38,7 @@ public:
    virtual TF1     *DrawCopy(Option_t *option="") const;
    virtual Double_t Eval(Double_t x, Double_t y=0, Double_t z=0, Double_t t=0) const;
    virtual Double_t EvalPar(const Double_t *x, const Double_t *params=0);
+   virtual void     EvalParN(Int_t n, const Double_t *const *x, Double_t *result, const Double_t *params=nullptr);
 
 #ifdef R__HAS_VECCORE
    using TF1::Eval;    // to not hide the vectorized version
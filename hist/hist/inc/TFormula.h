@@ -105,6 +105,8 @@ private:
    std::string       fGradGenerationInput; //! input query to clad to generate a gradient
    CallFuncSignature fFuncPtr = nullptr; //!  function pointer, owned by the JIT.
    CallFuncSignature fGradFuncPtr = nullptr; //!  function pointer, owned by the JIT.
+   std::unique_ptr<TMethodCall> fBatchMethod; //! pointer to the methodcall evaluating many points
+   std::atomic<CallFuncSignature> fBatchFuncPtr{nullptr}; //!  function pointer, owned by the JIT.
    void *   fLambdaPtr = nullptr;            //!  pointer to the lambda function
    static bool       fIsCladRuntimeIncluded;
 
@@ -130,6 +132,11 @@ private:
    bool HasGradientGenerationFailed() const {
       return !fGradMethod && !fGradGenerationInput.empty();
    }
+   std::string GetBatchFuncName() const {
+      assert(fClingName.Length() && "TFormula is not initialized yet!");
+      return std::string(fClingName.Data()) + "_batch";
+   }
+   CallFuncSignature PrepareBatchEvalMethod() const;
 
 protected:
 
@@ -195,6 +202,7 @@ public:
    Double_t       Eval(Double_t x, Double_t y , Double_t z) const;
    Double_t       Eval(Double_t x, Double_t y , Double_t z , Double_t t ) const;
    Double_t       EvalPar(const Double_t *x, const Double_t *params=0) const;
+   void           EvalParN(Int_t n, const Double_t *const *x, Double_t *result, const Double_t *params = nullptr) const;
 
    /// Generate gradient computation routine with respect to the parameters.
    /// \returns true if a gradient was generated and GradientPar can be called.
@@ -83,6 +83,7 @@ public:
    };
 
    friend class TH1Merger;
+   friend class TH1ConcurrentFiller;
 
 protected:
     Int_t         fNcells;          ///< number of bins(1D), cells (2D) +U/Overflows
@@ -115,6 +116,7 @@ protected:
     static Bool_t fgAddDirectory;   ///<!flag to add histograms to the directory
     static Bool_t fgStatOverflows;  ///<!flag to use under/overflows in statistics
     static Bool_t fgDefaultSumw2;   ///<!flag to call TH1::Sumw2 automatically at histogram creation time
+    static Int_t  fgParallelThreshold; ///<!minimal number of bins for multi-threaded operations on the bins
 
 public:
    static Int_t FitOptionsMake(Option_t *option, Foption_t &Foption);
@@ -149,6 +151,9 @@ protected:
                                Option_t * opt, Bool_t doerr = kFALSE) const;
 
    virtual void     DoFillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stride=1);
+   void             DoFillBins(Int_t n, const Int_t *bins, const Double_t *w, Int_t stride);
+   void             CheckFillNWeights(Int_t ntimes, const Double_t *w, Int_t stride);
+   enum { kFillBatchSize = 1024 };   // number of entries whose bins are found at once by FillN
    Bool_t    GetStatOverflowsBehaviour() const { return EStatOverflows::kNeutral == fStatOverflows ? fgStatOverflows : EStatOverflows::kConsider == fStatOverflows; }
 
    static bool CheckAxisLimits(const TAxis* a1, const TAxis* a2);
@@ -300,6 +305,7 @@ public:
    virtual Double_t GetNormFactor() const {return fNormFactor;}
    virtual char    *GetObjectInfo(Int_t px, Int_t py) const;
    Option_t        *GetOption() const {return fOption.Data();}
+   static  Int_t    GetParallelThreshold();
 
    TVirtualHistPainter *GetPainter(Option_t *option="");
 
@@ -404,6 +410,7 @@ public:
    virtual void     SetNormFactor(Double_t factor=1) {fNormFactor = factor;}
    virtual void     SetStats(Bool_t stats=kTRUE); // *MENU*
    virtual void     SetOption(Option_t *option=" ") {fOption = option;}
+   static  void     SetParallelThreshold(Int_t nbins=100000);
    virtual void     SetTickLength(Float_t length=0.02, Option_t *axis="X");
    virtual void     SetTitleFont(Style_t font=62, Option_t *axis="X");
    virtual void     SetTitleOffset(Float_t offset=1, Option_t *axis="X");
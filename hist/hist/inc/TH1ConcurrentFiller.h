@@ -0,0 +1,86 @@
+// @(#)root/hist:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2021, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TH1ConcurrentFiller
+#define ROOT_TH1ConcurrentFiller
+
+#include "TH1.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class TH1ConcurrentFiller {
+public:
+   /// How the entries filled by concurrent threads are accumulated
+   enum class EMode {
+      kAuto,    ///< kSharded, unless the shards would need more than GetMaxShardBytes()
+      kSharded, ///< Each thread fills its own copy of the bin contents
+      kAtomic   ///< All threads fill the same bin contents with atomic additions
+   };
+
+private:
+   /// Per-thread copy of the contents and statistics. The padding keeps the
+   /// members of consecutive shards on different cache lines without relying on
+   /// over-aligned allocations, which std::vector only supports from C++17.
+   struct Shard {
+      std::vector<Double_t> fSumw;  ///< Sum of weights per bin (empty in atomic mode)
+      std::vector<Double_t> fSumw2; ///< Sum of squares of weights per bin, allocated at the first weight != 1
+      Double_t fStats[TH1::kNstat]; ///< Statistics, see TH1::GetStats
+      Double_t fEntries;            ///< Number of entries
+      char fPadding[64];            ///< Separates the shard from the next one
+   };
+
+   TH1 *fHist;                                     ///< Histogram being filled
+   EMode fMode;                                    ///< kSharded or kAtomic
+   ULong64_t fId;                                  ///< Identifies this filler in the thread-local slot cache
+   Int_t fNcells;                                  ///< Number of bins of fHist, including under/overflows
+   Bool_t fStatOverflows;                          ///< Whether under/overflows enter the statistics
+   Bool_t fTrackSumw2;                             ///< Whether the sums of squares of weights are needed from the start
+   Bool_t fLocked;                                 ///< fHist cannot be filled concurrently, calls are serialized
+   std::vector<Shard> fShards;                     ///< One per slot
+   std::unique_ptr<std::atomic<ULong64_t>[]> fOwners; ///< Token of the thread owning each slot (0 if free)
+   std::unique_ptr<std::atomic<Double_t>[]> fAtomicSumw;  ///< Shared contents, used in atomic mode and by threads without a slot
+   std::unique_ptr<std::atomic<Double_t>[]> fAtomicSumw2; ///< Shared sums of squares of weights
+   std::atomic<Double_t> fAtomicStats[TH1::kNstat];       ///< Statistics of the entries filled in the shared contents
+   std::atomic<Double_t> fAtomicEntries;           ///< Number of entries filled in the shared contents
+   std::atomic<Bool_t> fAtomicWeighted;            ///< Whether a weight != 1 was filled in the shared contents
+   std::once_flag fAtomicInit;                     ///< Allocation of the shared contents
+   std::mutex fLockedMutex;                        ///< Serializes the calls if fLocked
+
+   static Long64_t fgMaxShardBytes;                ///< Maximum size of the shards in mode kAuto
+
+   Int_t GetSlot();
+   void InitAtomic();
+   Int_t DoFill(Int_t nvars, const Double_t *v, Double_t w);
+   Int_t LockedFill(Int_t nargs, Double_t x, Double_t y, Double_t z, Double_t w);
+
+   TH1ConcurrentFiller(const TH1ConcurrentFiller &) = delete;
+   TH1ConcurrentFiller &operator=(const TH1ConcurrentFiller &) = delete;
+
+public:
+   TH1ConcurrentFiller(TH1 &hist, UInt_t nslots = 0, EMode mode = EMode::kAuto);
+   ~TH1ConcurrentFiller();
+
+   Int_t Fill(Double_t x);
+   Int_t Fill(Double_t x, Double_t y);
+   Int_t Fill(Double_t x, Double_t y, Double_t z);
+   Int_t Fill(Double_t x, Double_t y, Double_t z, Double_t w);
+   void Flush();
+   TH1 *GetHistogram() { Flush(); return fHist; }
+   EMode GetMode() const { return fMode; }
+   UInt_t GetNSlots() const { return fShards.size(); }
+
+   static Long64_t GetMaxShardBytes();
+   static void SetMaxShardBytes(Long64_t bytes);
+};
+
+#endif
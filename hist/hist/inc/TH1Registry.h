@@ -0,0 +1,112 @@
+// @(#)root/hist:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2021, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TH1Registry
+#define ROOT_TH1Registry
+
+#include "TH1.h"
+#include "TDirectory.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+class TList;
+
+class TH1Registry {
+private:
+   /// A registered histogram, immutable once published.
+   struct Entry {
+      std::string fName; ///< Name under which the histogram is registered
+      UInt_t fHash;      ///< Hash of fName
+      TH1 *fHist;        ///< Registered histogram
+   };
+
+   /// Open addressing hash table of entries, never modified except for the insertion of entries.
+   struct Table {
+      UInt_t fMask;                                  ///< Number of slots minus one
+      std::unique_ptr<std::atomic<Entry *>[]> fSlots; ///< Entries, nullptr for empty slots
+      Table(UInt_t nslots);
+   };
+
+   /// Part of the registry with its own lock for insertions. The padding keeps
+   /// consecutive shards on different cache lines also when the registry is
+   /// allocated with new, which ignores over-alignment before C++17.
+   struct Shard {
+      std::atomic<Table *> fTable{nullptr};         ///< Current table, read without locking
+      mutable std::mutex fMutex;                    ///< Serializes the insertions
+      std::vector<std::unique_ptr<Entry>> fEntries; ///< Entries in insertion order
+      std::vector<std::unique_ptr<Table>> fTables;  ///< Current and replaced tables, kept for concurrent readers
+      char fPadding[64];                            ///< Separates the shard from the next one
+   };
+
+   static constexpr UInt_t kNShards = 64;
+
+   Shard fShards[kNShards];      ///< Entries by hash of their name
+   std::atomic<Long64_t> fSize;  ///< Number of registered histograms
+   Bool_t fOwner;                ///< Whether the histograms are deleted with the registry
+
+   static UInt_t Hash(const char *name);
+   Shard &GetShard(UInt_t hash) { return fShards[hash % kNShards]; }
+   const Shard &GetShard(UInt_t hash) const { return fShards[hash % kNShards]; }
+   TH1 *Insert(TH1 *hist, Bool_t &inserted);
+   std::vector<TH1 *> GetHistograms() const;
+
+   TH1Registry(const TH1Registry &) = delete;
+   TH1Registry &operator=(const TH1Registry &) = delete;
+
+public:
+   TH1Registry(Bool_t owner = kTRUE);
+   ~TH1Registry();
+
+   Bool_t Add(TH1 *hist);
+   void ForEach(const std::function<void(TH1 &)> &func) const;
+   TH1 *Get(const char *name) const;
+   template <class HIST>
+   HIST *Get(const char *name) const { return dynamic_cast<HIST *>(Get(name)); }
+   template <class HIST, class... ARGS>
+   HIST *GetOrCreate(const char *name, ARGS &&... args);
+   Long64_t GetSize() const { return fSize; }
+   Bool_t IsOwner() const { return fOwner; }
+   TList *Snapshot() const;
+   Int_t Write(TDirectory *dir, Option_t *option = "WriteDelete") const;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the histogram registered as name, creating it with
+/// `new HIST(name, args...)` if there is none. The new histogram is not
+/// added to gDirectory. Returns nullptr if the registered histogram is not
+/// a HIST. If several threads create the same histogram at the same time,
+/// all of them get the one that was registered first; this requires
+/// ROOT::EnableThreadSafety() to have been called.
+
+template <class HIST, class... ARGS>
+HIST *TH1Registry::GetOrCreate(const char *name, ARGS &&... args)
+{
+   if (TH1 *hist = Get(name))
+      return dynamic_cast<HIST *>(hist);
+
+   HIST *created;
+   {
+      TDirectory::TContext ctx(nullptr);
+      created = new HIST(name, std::forward<ARGS>(args)...);
+   }
+   Bool_t inserted = kFALSE;
+   TH1 *hist = Insert(created, inserted);
+   if (!inserted)
+      delete created;
+   return dynamic_cast<HIST *>(hist);
+}
+
+#endif
@@ -38,8 +38,7 @@ class THnSparse: public THnBase {
    Int_t      fChunkSize;    // number of entries for each chunk
    Long64_t   fFilledBins;   // number of filled bins
    TObjArray  fBinContent;   // array of THnSparseArrayChunk
-   TExMap     fBins;         //! filled bins
-   TExMap     fBinsContinued;//! filled bins for non-unique hashes, containing pairs of (bin index 0, bin index 1)
+   THnSparseBinIndex fBins;  //! filled bins, by hash of their compact coordinates
    THnSparseCompactBinCoord *fCompactCoord; //! compact coordinate
 
    THnSparse(const THnSparse&); // Not implemented
@@ -89,6 +88,9 @@ class THnSparse: public THnBase {
 
    ROOT::Internal::THnBaseBinIter* CreateIter(Bool_t respectAxisRange) const;
 
+   void FillN(Long64_t n, const Double_t *x, const Double_t *w = nullptr);
+   Long64_t Merge(TCollection* list);
+
    Long64_t GetNbins() const { return fFilledBins; }
    void SetFilledBins(Long64_t nbins) { fFilledBins = nbins; }
 
@@ -23,6 +23,8 @@
 
 #include "TObject.h"
 
+#include <vector>
+
 class TBrowser;
 class TH1;
 class THnSparse;
@@ -65,5 +67,60 @@ class THnSparseArrayChunk: public TObject {
 
    ClassDef(THnSparseArrayChunk, 1); // chunks of linearized bins
 };
+
+class THnSparseBinIndex {
+ public:
+   /// A slot of the table: the hash of a bin's compact coordinates and
+   /// the linear bin index + 1; fIndex1 == 0 marks a free slot.
+   struct Entry {
+      ULong64_t fHash;
+      Long64_t  fIndex1;
+   };
+
+   THnSparseBinIndex(): fShift(64), fSize(0) {}
+
+   Long64_t GetSize() const { return fSize; }
+   size_t   GetMemSize() const { return fEntries.capacity() * sizeof(Entry); }
+
+   /// Return the first slot to probe for hash; the table must not be empty.
+   /// The hash is multiplied by 2^64 / golden ratio to spread the compact
+   /// coordinates of neighbouring bins over the whole table.
+   size_t GetFirstSlot(ULong64_t hash) const {
+      return (hash * 0x9E3779B97F4A7C15ULL) >> fShift; }
+   size_t GetNextSlot(size_t slot) const { return (slot + 1) & (fEntries.size() - 1); }
+   const Entry& GetEntry(size_t slot) const { return fEntries[slot]; }
+
+   /// Store bin index idx for hash in the free slot found by probing.
+   void SetAt(size_t slot, ULong64_t hash, Long64_t idx) {
+      fEntries[slot].fHash = hash;
+      fEntries[slot].fIndex1 = idx + 1;
+      ++fSize;
+   }
+   void Insert(ULong64_t hash, Long64_t idx);
+
+   /// Make room for nbins entries without exceeding the maximal load.
+   void Reserve(Long64_t nbins) {
+      if (3 * nbins > 2 * (Long64_t) fEntries.size())
+         Rehash(nbins);
+   }
+
+   /// Hint the CPU to load the first slot for hash into the cache.
+   void Prefetch(ULong64_t hash) const {
+#if defined(__GNUC__) || defined(__clang__)
+      if (fSize)
+         __builtin_prefetch(&fEntries[GetFirstSlot(hash)]);
+#else
+      (void) hash;
+#endif
+   }
+   void Clear();
+
+ private:
+   void Rehash(Long64_t nbins);
+
+   std::vector<Entry> fEntries; // the slots; their number is a power of 2
+   Int_t    fShift;             // 64 - log2(number of slots)
+   Long64_t fSize;              // number of used slots
+};
 #endif // ROOT_THnSparse_Internal
 
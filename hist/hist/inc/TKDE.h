@@ -65,6 +65,12 @@ public:
       kForcedBinning
    };
 
+   enum EEvaluation { // Evaluation algorithm option
+      kDirect, // Sum the kernel over all the data (or bins)
+      kPruned, // Sum only over the data whose kernel support contains the point, found in the sorted data
+      kFFT     // Interpolate the convolution of the linearly binned data with the kernel on a grid (fixed iteration)
+   };
+
    
    TKDE();                    // defaul constructor used only by I/O 
 
@@ -99,6 +105,8 @@ public:
    void SetUseBinsNEvents(UInt_t nEvents);
    void SetTuneFactor(Double_t rho);
    void SetRange(Double_t xMin, Double_t xMax); // By default computed from the data
+   void SetEvaluation(EEvaluation eval);
+   void SetFFTTolerance(Double_t tolerance);
 
    virtual void Draw(const Option_t* option = "");
 
@@ -106,6 +114,7 @@ public:
    Double_t operator()(const Double_t* x, const Double_t* p=0) const;  // Needed for creating TF1
 
    Double_t GetValue(Double_t x) const { return (*this)(x); }
+   void GetValues(UInt_t n, const Double_t* x, Double_t* values) const;
    Double_t GetError(Double_t x) const;
 
    Double_t GetBias(Double_t x) const;
@@ -158,6 +167,7 @@ private:
    EIteration fIteration;
    EMirror fMirror;
    EBinning fBinning;
+   EEvaluation fEvaluation;
 
 
    Bool_t fUseMirroring, fMirrorLeft, fMirrorRight, fAsymLeft, fAsymRight;
@@ -177,6 +187,7 @@ private:
    Double_t fXMax;  // Data maximum value
    Double_t fRho;   // Adjustment factor for sigma
    Double_t fAdaptiveBandwidthFactor; // Geometric mean of the kernel density estimation from the data for adaptive iteration
+   Double_t fFFTTolerance; // Approximate relative accuracy of the kFFT evaluation
 
    Double_t fWeightSize; // Caches the weight size
 
@@ -212,6 +223,7 @@ private:
    Double_t UpperConfidenceInterval(const Double_t* x, const Double_t* p) const; // Valid if the bandwidth is small compared to nEvents**1/5
    Double_t LowerConfidenceInterval(const Double_t* x, const Double_t* p) const; // Valid if the bandwidth is small compared to nEvents**1/5
    Double_t ApproximateBias(const Double_t* x, const Double_t* ) const { return GetBias(*x); }
+   Double_t GetKernelSupport() const;
    Double_t ComputeKernelL2Norm() const;
    Double_t ComputeKernelSigma2() const;
    Double_t ComputeKernelMu() const;
@@ -253,7 +265,7 @@ private:
    TF1* GetPDFUpperConfidenceInterval(Double_t confidenceLevel = 0.95, UInt_t npx = 100, Double_t xMin = 1.0, Double_t xMax = 0.0);
    TF1* GetPDFLowerConfidenceInterval(Double_t confidenceLevel = 0.95, UInt_t npx = 100, Double_t xMin = 1.0, Double_t xMax = 0.0);
 
-   ClassDef(TKDE, 2) // One dimensional semi-parametric Kernel Density Estimation
+   ClassDef(TKDE, 3) // One dimensional semi-parametric Kernel Density Estimation
 
 };
 
@@ -13,6 +13,8 @@
 #define ROOT_TNDArray
 
 #include "TObject.h"
+#include "TArray.h"
+#include "TBuffer.h"
 #include "TError.h"
 
 //////////////////////////////////////////////////////////////////////////
@@ -34,6 +36,9 @@
 // three-dimensional example, up to an element with conversion operator //
 // to double: double value = arr[0][1][2];                              //
 //                                                                      //
+// The data of TNDArrayT is written without its runs of zeros if        //
+// enabled by TArray::SetCompactStreaming().                            //
+//                                                                      //
 //////////////////////////////////////////////////////////////////////////
 
 // Array layout:
@@ -187,9 +192,50 @@ public:
 protected:
    int fNumData; // number of bins, product of fSizes
    T*  fData; //[fNumData] data
-   ClassDef(TNDArrayT, 1); // N-dimensional array
+   ClassDef(TNDArrayT, 2); // N-dimensional array
 };
 
+template <typename T>
+void TNDArrayT<T>::Streamer(TBuffer &R__b)
+{
+   // Stream an object of class TNDArrayT. Version 2 has the same layout as
+   // version 1, except that the data can be in the compact form of
+   // TArray::WriteCompactArray(), flagged by 2 instead of 1 before it.
+
+   if (R__b.IsReading()) {
+      UInt_t R__s, R__c;
+      Version_t R__v = R__b.ReadVersion(&R__s, &R__c);
+      if (R__v < 2 || R__b.InheritsFrom("TBufferText")) {
+         R__b.ReadClassBuffer(TNDArrayT<T>::Class(), this, R__v, R__s, R__c);
+         return;
+      }
+      TNDArray::Streamer(R__b);
+      R__b >> fNumData;
+      delete [] fData;
+      fData = 0;
+      Char_t isArray;
+      R__b >> isArray;
+      if (isArray) {
+         fData = new T[fNumData];
+         if (isArray == 2)
+            TArray::ReadCompactArray(R__b, fData, fNumData);
+         else
+            R__b.ReadFastArray(fData, fNumData);
+      }
+      R__b.CheckByteCount(R__s, R__c, TNDArrayT<T>::IsA());
+   } else if (!TArray::IsCompactStreamable(R__b, fData, fNumData)) {
+      R__b.WriteClassBuffer(TNDArrayT<T>::Class(), this);
+   } else {
+      R__b.TagStreamerInfo(TNDArrayT<T>::Class()->GetStreamerInfo());
+      UInt_t R__c = R__b.WriteVersion(TNDArrayT<T>::IsA(), kTRUE);
+      TNDArray::Streamer(R__b);
+      R__b << fNumData;
+      R__b << Char_t(2);
+      TArray::WriteCompactArray(R__b, fData, fNumData);
+      R__b.SetByteCount(R__c, kTRUE);
+   }
+}
+
 // FIXME: Remove once we implement https://sft.its.cern.ch/jira/browse/ROOT-6284
 // When building with -fmodules, it instantiates all pending instantiations,
 // instead of delaying them until the end of the translation unit.
@@ -198,7 +244,6 @@ protected:
 //
 // In case we are building with -fmodules, we need to forward declare the
 // specialization in order to compile the dictionary G__Hist.cxx.
-template<> void TNDArrayT<double>::Streamer(TBuffer &R__b);
 template<> TClass *TNDArrayT<double>::Class();
 
 
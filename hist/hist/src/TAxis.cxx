@@ -434,6 +434,53 @@ Int_t TAxis::FindFixBin(Double_t x) const
    return bin;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Find the bin numbers of the n abscissas x[0], x[stride], ..., x[(n-1)*stride]
+/// and store them in bins[0], ..., bins[n-1].
+///
+/// The result is identical to calling TAxis::FindFixBin for each abscissa, but
+/// the loops have no branches, so that the compiler can vectorize them.
+/// Fixed bins use the same arithmetic as FindFixBin; variable bins are found
+/// with a branchless binary search advancing all the abscissas by one level
+/// at a time. As with TMath::BinarySearch, an abscissa equal to several
+/// (duplicate) edges is in the bin starting at the first of them.
+
+void TAxis::FindFixBins(Int_t n, const Double_t *x, Int_t *bins, Int_t stride) const
+{
+   const Double_t xmin = fXmin;
+   const Double_t xmax = fXmax;
+   const Int_t nbins = fNbins;
+   if (!fXbins.fN) {
+      const Double_t width = xmax - xmin;
+      for (Int_t i = 0; i < n; ++i) {
+         const Double_t v = x[i * stride];
+         // Select before converting, the conversion of NaN or huge values is undefined.
+         const Double_t t = v < xmin ? -1. : (v < xmax ? nbins * (v - xmin) / width : nbins);
+         bins[i] = 1 + Int_t(t);
+      }
+      return;
+   }
+
+   // bins[i] is the index of the highest edge below x[i] (if x[i] > xmin).
+   const Double_t *edges = fXbins.fArray;
+   const Int_t nedges = fXbins.fN;
+   for (Int_t i = 0; i < n; ++i)
+      bins[i] = 0;
+   for (Int_t len = nedges; len > 1; len -= len / 2) {
+      const Int_t half = len / 2;
+      for (Int_t i = 0; i < n; ++i)
+         bins[i] += edges[bins[i] + half] < x[i * stride] ? half : 0;
+   }
+   for (Int_t i = 0; i < n; ++i) {
+      const Double_t v = x[i * stride];
+      // Number of edges below v, i.e. the first edge at or above v, as TMath::BinarySearch.
+      Int_t k = bins[i] + (edges[bins[i]] < v ? 1 : 0);
+      k = k < nedges ? k : nedges - 1;
+      const Int_t edge = k - (edges[k] == v ? 0 : 1);
+      bins[i] = v < xmin ? 0 : (v < xmax ? 1 + edge : nbins + 1);
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return label for bin
 
@@ -7,6 +7,7 @@
 #include <cmath>
 #include <stdlib.h>
 #include <cassert>
+#include <unordered_map>
 
 //ROOT headers
 #include "Math/DistFuncMathCore.h"
@@ -1617,7 +1618,6 @@ void TEfficiency::FillGraph(TGraphAsymmErrors * graph, Option_t * opt) const
    // LM: cannot use TGraph::SetPoint because it deletes the underlying
    // histogram  each time (see TGraph::SetPoint)
    // so use it only when extra points are added to the graph
-   Int_t j = 0;
    double * px = graph->GetX();
    double * py = graph->GetY();
    double * exl = graph->GetEXlow();
@@ -1625,14 +1625,24 @@ void TEfficiency::FillGraph(TGraphAsymmErrors * graph, Option_t * opt) const
    double * eyl = graph->GetEYlow();
    double * eyh = graph->GetEYhigh();
    Int_t npoints = fTotalHistogram->GetNbinsX();
+   std::vector<Int_t> bins;
+   bins.reserve(npoints);
    for (Int_t i = 0; i < npoints; ++i) {
       if (!plot0Bins && fTotalHistogram->GetBinContent(i+1) == 0 )    continue;
-      x = fTotalHistogram->GetBinCenter(i+1);
-      y = GetEfficiency(i+1);
-      xlow = fTotalHistogram->GetBinCenter(i+1) - fTotalHistogram->GetBinLowEdge(i+1);
-      xup = fTotalHistogram->GetBinWidth(i+1) - xlow;
-      ylow = GetEfficiencyErrorLow(i+1);
-      yup = GetEfficiencyErrorUp(i+1);
+      bins.push_back(i+1);
+   }
+   // the efficiencies and errors of all the points at once
+   Int_t n = bins.size();
+   std::vector<Double_t> effs(n), errsLow(n), errsUp(n);
+   GetEfficiencies(n, bins.data(), effs.data(), errsLow.data(), errsUp.data());
+   for (Int_t j = 0; j < n; ++j) {
+      Int_t bin = bins[j];
+      x = fTotalHistogram->GetBinCenter(bin);
+      y = effs[j];
+      xlow = fTotalHistogram->GetBinCenter(bin) - fTotalHistogram->GetBinLowEdge(bin);
+      xup = fTotalHistogram->GetBinWidth(bin) - xlow;
+      ylow = errsLow[j];
+      yup = errsUp[j];
       // in the case the graph already existed and extra points have been added
       if (j >= graph->GetN() ) {
          graph->SetPoint(j,x,y);
@@ -1646,11 +1656,10 @@ void TEfficiency::FillGraph(TGraphAsymmErrors * graph, Option_t * opt) const
          eyl[j] = ylow;
          eyh[j] = yup;
       }
-      j++;
    }
 
    // tell the graph the effective number of points
-   graph->Set(j);
+   graph->Set(n);
    //refresh title before painting if changed
    TString oldTitle = graph->GetTitle();
    TString newTitle = GetTitle();
@@ -1819,6 +1828,105 @@ Double_t TEfficiency::ClopperPearson(Double_t total,Double_t passed,Double_t lev
    else
       return ((passed == 0) ? 0.0 : ROOT::Math::beta_quantile(alpha,passed,total-passed+1.0));
 }
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Calculates the boundaries of the confidence intervals of n pairs of total
+/// and passed events, with the frequentist method boundary or, if boundary is
+/// null, the Bayesian posterior for the prior Beta(alpha,beta) with a central
+/// or the shortest interval.
+///
+/// The boundaries of a pair of integer numbers of events are calculated only
+/// once, and copied for all the other occurrences of that pair.
+
+void ComputeIntervals(Int_t n, const Double_t *total, const Double_t *passed, Double_t level,
+                      Double_t (*boundary)(Double_t, Double_t, Double_t, Bool_t), Double_t alpha, Double_t beta,
+                      Bool_t bShortest, Double_t *lower, Double_t *upper)
+{
+   // index of the first occurrence of each pair (total, passed) of integers
+   std::unordered_map<ULong64_t, Int_t> first;
+   for (Int_t i = 0; i < n; ++i) {
+      const Double_t t = total[i];
+      const Double_t p = passed[i];
+      if (t >= 0 && p >= 0 && t < 4294967296. && p < 4294967296. && t == std::floor(t) && p == std::floor(p)) {
+         auto found = first.emplace((ULong64_t(t) << 32) | ULong64_t(p), i);
+         if (!found.second) {
+            lower[i] = lower[found.first->second];
+            upper[i] = upper[found.first->second];
+            continue;
+         }
+      }
+
+      if (!boundary) {
+         const Double_t a = p + alpha;
+         const Double_t b = (t - p) + beta;
+         if (bShortest) {
+            lower[i] = 0;
+            upper[i] = 1;
+            TEfficiency::BetaShortestInterval(level, a, b, lower[i], upper[i]);
+         } else {
+            lower[i] = TEfficiency::BetaCentralInterval(level, a, b, false);
+            upper[i] = TEfficiency::BetaCentralInterval(level, a, b, true);
+         }
+      } else if (boundary == &TEfficiency::FeldmanCousins) {
+         // both boundaries come from the same calculation
+         lower[i] = 0;
+         upper[i] = 1;
+         if (!TEfficiency::FeldmanCousinsInterval(t, p, level, lower[i], upper[i]))
+            ::Error("FeldmanCousins", "Error running FC method - return 0 or 1");
+      } else {
+         lower[i] = boundary(t, p, level, false);
+         upper[i] = boundary(t, p, level, true);
+      }
+   }
+}
+
+} // unnamed namespace
+
+////////////////////////////////////////////////////////////////////////////////
+/// Calculates the boundaries of the confidence intervals of many bins at once
+///
+/// \param[in] n number of bins
+/// \param[in] total numbers of total events, n values
+/// \param[in] passed numbers of passed events, n values
+/// \param[in] level confidence level
+/// \param[in] option statistic option, see TEfficiency::SetStatisticOption
+/// \param[out] lower lower boundaries of the intervals, n values
+/// \param[out] upper upper boundaries of the intervals, n values
+/// \param[in] alpha,beta parameters of the beta prior for kBBayesian
+/// \param[in] bShortest for the Bayesian options, true for the shortest
+///                      interval, false for the central interval
+///
+/// The boundaries are the same as the ones returned bin by bin by the static
+/// functions of the chosen method (ClopperPearson(), Wilson(), Bayesian(), ...),
+/// but they are calculated only once for each pair of integer numbers of
+/// total and passed events, which is much faster for many bins with few
+/// events. Both boundaries of the Feldman-Cousins and shortest Bayesian
+/// intervals come from a single calculation.
+
+void TEfficiency::ConfidenceIntervals(Int_t n, const Double_t* total, const Double_t* passed, Double_t level,
+                                      EStatOption option, Double_t* lower, Double_t* upper,
+                                      Double_t alpha, Double_t beta, Bool_t bShortest)
+{
+   Double_t (*boundary)(Double_t, Double_t, Double_t, Bool_t) = 0;
+   switch(option)
+   {
+      case kFCP:      boundary = &ClopperPearson; break;
+      case kFNormal:  boundary = &Normal;         break;
+      case kFWilson:  boundary = &Wilson;         break;
+      case kFAC:      boundary = &AgrestiCoull;   break;
+      case kFFC:      boundary = &FeldmanCousins; break;
+      case kMidP:     boundary = &MidPInterval;   break;
+      case kBJeffrey: alpha = 0.5; beta = 0.5;    break;
+      case kBUniform: alpha = 1;   beta = 1;      break;
+      case kBBayesian:                            break;
+      default:
+         ::Error("TEfficiency::ConfidenceIntervals", "unknown statistic option %d - using Clopper-Pearson", option);
+         boundary = &ClopperPearson;
+   }
+   ComputeIntervals(n, total, passed, level, boundary, alpha, beta, bShortest, lower, upper);
+}
 ////////////////////////////////////////////////////////////////////////////////
 /**
     Calculates the combined efficiency and its uncertainties
@@ -2453,6 +2561,47 @@ Int_t TEfficiency::GetDimension() const
    return fTotalHistogram->GetDimension();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Returns the efficiencies and their lower and upper errors in the n global
+/// bins given in bins
+///
+/// The results are the same as the ones of GetEfficiency(bin),
+/// GetEfficiencyErrorLow(bin) and GetEfficiencyErrorUp(bin), but without
+/// weights the confidence intervals are calculated at once with
+/// ConfidenceIntervals(): only once for all the bins with the same numbers of
+/// total and passed events.
+
+void TEfficiency::GetEfficiencies(Int_t n, const Int_t* bins, Double_t* eff, Double_t* errLow, Double_t* errUp) const
+{
+   for (Int_t i = 0; i < n; ++i)
+      eff[i] = GetEfficiency(bins[i]);
+
+   // weights and priors per bin are treated bin by bin
+   if (TestBit(kUseWeights) || (TestBit(kIsBayesian) && TestBit(kUseBinPrior))) {
+      for (Int_t i = 0; i < n; ++i) {
+         errLow[i] = GetEfficiencyErrorLow(bins[i]);
+         errUp[i] = GetEfficiencyErrorUp(bins[i]);
+      }
+      return;
+   }
+
+   std::vector<Double_t> total(n);
+   std::vector<Double_t> passed(n);
+   for (Int_t i = 0; i < n; ++i) {
+      total[i] = fTotalHistogram->GetBinContent(bins[i]);
+      passed[i] = fPassedHistogram->GetBinContent(bins[i]);
+   }
+   if (TestBit(kIsBayesian))
+      ComputeIntervals(n, total.data(), passed.data(), fConfLevel, 0, GetBetaAlpha(), GetBetaBeta(),
+                       TestBit(kShortestInterval), errLow, errUp);
+   else
+      ComputeIntervals(n, total.data(), passed.data(), fConfLevel, fBoundary, 0, 0, false, errLow, errUp);
+   for (Int_t i = 0; i < n; ++i) {
+      errLow[i] = eff[i] - errLow[i];
+      errUp[i] = errUp[i] - eff[i];
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Returns the efficiency in the given global bin
 ///
@@ -31,6 +31,9 @@
 #include "TF1NormSum.h"
 #include "TF1Convolution.h"
 #include "TVirtualMutex.h"
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#endif
 #include "Math/WrappedFunction.h"
 #include "Math/WrappedTF1.h"
 #include "Math/BrentRootFinder.h"
@@ -1539,6 +1542,97 @@ Double_t TF1::EvalPar(const Double_t *x, const Double_t *params)
    return result;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate the function at n points with the given parameters and store the
+/// values in result.
+///
+/// x[j] points to the n values of coordinate j, i.e. point i is
+/// (x[0][i], ..., x[GetNdim()-1][i]). If params is omitted or equal 0, the
+/// internal values of the parameters are used, as in EvalPar.
+///
+/// Functions defined by a formula are evaluated by TFormula::EvalParN, which
+/// compiles the loop over the points with the formula; with implicit
+/// multi-threading enabled (ROOT::EnableImplicitMT) large sets of points are
+/// split among the threads. Vectorized functions are evaluated on several
+/// points at once, the other functions point by point with EvalPar.
+
+void TF1::EvalParN(Int_t n, const Double_t *const *x, Double_t *result, const Double_t *params)
+{
+   if (n <= 0) return;
+   const Int_t ndim = std::max(GetNdim(), 1);
+
+   if (fType == EFType::kFormula) {
+      assert(fFormula);
+      // the first block is evaluated serially, this compiles the function if needed
+      const Int_t kBlockSize = 16384;
+      Int_t nfirst = std::min(n, kBlockSize);
+      fFormula->EvalParN(nfirst, x, result, params);
+      if (nfirst < n) {
+         auto evalRange = [&](Int_t begin, Int_t end) {
+            std::vector<const Double_t *> xr(ndim);
+            for (Int_t j = 0; j < GetNdim(); ++j)
+               xr[j] = x[j] + begin;
+            fFormula->EvalParN(end - begin, xr.data(), result + begin, params);
+         };
+#ifdef R__USE_IMT
+         Int_t nblocks = (n - nfirst + kBlockSize - 1) / kBlockSize;
+         if (ROOT::IsImplicitMTEnabled() && nblocks > 1) {
+            ROOT::TThreadExecutor pool;
+            pool.Foreach([&](Int_t iblock) {
+               Int_t begin = nfirst + iblock * kBlockSize;
+               evalRange(begin, std::min(n, begin + kBlockSize));
+            }, ROOT::TSeqI(nblocks));
+         } else
+#endif
+            evalRange(nfirst, n);
+      }
+      if (fNormalized && fNormIntegral != 0) {
+         for (Int_t i = 0; i < n; ++i)
+            result[i] /= fNormIntegral;
+      }
+      return;
+   }
+
+#ifdef R__HAS_VECCORE
+   if (fType == EFType::kTemplVec && fFunctor) {
+      const Double_t *pars = params ? params : (Double_t *)fParams->GetParameters();
+      auto func = (TF1FunctorPointerImpl<ROOT::Double_v> *)fFunctor;
+      const Int_t vecSize = vecCore::VectorSize<ROOT::Double_v>();
+      std::vector<ROOT::Double_v> xv(ndim);
+      std::vector<Double_t> xi(ndim);
+      for (Int_t i = 0; i < n; i += vecSize) {
+         if (i + vecSize <= n) {
+            for (Int_t j = 0; j < GetNdim(); ++j)
+               vecCore::Load<ROOT::Double_v>(xv[j], x[j] + i);
+            vecCore::Store<ROOT::Double_v>(func->fImpl(xv.data(), pars), result + i);
+            continue;
+         }
+         // remaining points
+         for (Int_t k = i; k < n; ++k) {
+            for (Int_t j = 0; j < GetNdim(); ++j)
+               xi[j] = x[j][k];
+            result[k] = EvalParVec(xi.data(), pars);
+         }
+      }
+      if (fNormalized && fNormIntegral != 0) {
+         for (Int_t i = 0; i < n; ++i)
+            result[i] /= fNormIntegral;
+      }
+      return;
+   }
+#endif
+
+   std::vector<Double_t> xi(ndim);
+   // interpreted functions read the arguments from the addresses given to InitArgs
+   if (fType == EFType::kInterpreted)
+      InitArgs(xi.data(), params);
+   for (Int_t i = 0; i < n; ++i) {
+      for (Int_t j = 0; j < GetNdim(); ++j)
+         xi[j] = x[j][i];
+      result[i] = EvalPar(xi.data(), params);
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Execute action corresponding to one event.
 ///
@@ -2771,8 +2865,25 @@ Double_t TF1::IntegralFast(Int_t num, Double_t * /* x */, Double_t * /* w */, Do
    if (params)
       wf1.SetParameters(params);
    ROOT::Math::GaussLegendreIntegrator gli(num, epsilon);
-   gli.SetFunction(wf1);
-   return gli.Integral(a, b);
+   if (GetNdim() > 1 || num <= 0) {
+      gli.SetFunction(wf1);
+      return gli.Integral(a, b);
+   }
+
+   // evaluate the function at all the sampling points at once, then sum as
+   // GaussLegendreIntegrator does
+   std::vector<Double_t> xs(num), ws(num), fval(num);
+   gli.GetWeightVectors(xs.data(), ws.data());
+   const Double_t a0 = (b + a) / 2;
+   const Double_t b0 = (b - a) / 2;
+   for (Int_t i = 0; i < num; i++)
+      xs[i] = a0 + b0 * xs[i];
+   const Double_t *xx = xs.data();
+   EvalParN(num, &xx, fval.data());
+   Double_t result = 0.0;
+   for (Int_t i = 0; i < num; i++)
+      result += ws[i] * fval[i];
+   return result * b0;
 
 }
 
@@ -3109,10 +3220,21 @@ TH1   *TF1::DoCreateHistogram(Double_t xmin, Double_t  xmax, Bool_t recreate)
    histogram->GetYaxis()->SetTitle(ytitle.Data());
    Double_t *parameters = GetParameters();
 
-   InitArgs(xv, parameters);
-   for (i = 1; i <= fNpx; i++) {
-      xv[0] = histogram->GetBinCenter(i);
-      histogram->SetBinContent(i, EvalPar(xv, parameters));
+   if (GetNdim() <= 1) {
+      // evaluate the function at all the bin centers at once
+      std::vector<Double_t> xcenters(fNpx), values(fNpx);
+      for (i = 0; i < fNpx; i++)
+         xcenters[i] = histogram->GetBinCenter(i + 1);
+      const Double_t *xx = xcenters.data();
+      EvalParN(fNpx, &xx, values.data(), parameters);
+      for (i = 1; i <= fNpx; i++)
+         histogram->SetBinContent(i, values[i - 1]);
+   } else {
+      InitArgs(xv, parameters);
+      for (i = 1; i <= fNpx; i++) {
+         xv[0] = histogram->GetBinCenter(i);
+         histogram->SetBinContent(i, EvalPar(xv, parameters));
+      }
    }
 
    // Copy Function attributes to histogram attributes.
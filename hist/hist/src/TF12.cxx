@@ -13,6 +13,9 @@
 #include "TH1.h"
 #include "TVirtualPad.h"
 
+#include <algorithm>
+#include <vector>
+
 ClassImp(TF12);
 
 /** \class TF12
@@ -167,6 +170,24 @@ Double_t TF12::EvalPar(const Double_t *x, const Double_t *params)
    return fF2->EvalPar(xx,params);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate the function at n points x[0][i] for the given parameters,
+/// see TF1::EvalParN.
+
+void TF12::EvalParN(Int_t n, const Double_t *const *x, Double_t *result, const Double_t *params)
+{
+   if (n <= 0) return;
+   if (!fF2) {
+      std::fill(result, result + n, 0.);
+      return;
+   }
+   std::vector<Double_t> xy(n, fXY);
+   const Double_t *xx[2];
+   xx[fCase == 0 ? 0 : 1] = x[0];
+   xx[fCase == 0 ? 1 : 0] = xy.data();
+   fF2->EvalParN(n, xx, result, params);
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Save primitive as a C++ statement(s) on output stream out
@@ -719,6 +719,12 @@ void TFormula::Copy(TObject &obj) const
    fnew.fGradGenerationInput = fGradGenerationInput;
    fnew.fGradFuncPtr = fGradFuncPtr;
 
+   if (fBatchMethod) {
+      // use copy-constructor of TMethodCall
+      fnew.fBatchMethod.reset(new TMethodCall(*fBatchMethod));
+   }
+   fnew.fBatchFuncPtr = fBatchFuncPtr.load();
+
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -736,6 +742,8 @@ void TFormula::Clear(Option_t * )
 
    if(fMethod) fMethod->Delete();
    fMethod = nullptr;
+   fBatchMethod.reset();
+   fBatchFuncPtr = nullptr;
 
    fClingVariables.clear();
    fClingParameters.clear();
@@ -2288,6 +2296,9 @@ void TFormula::ProcessFormula(TString &formula)
 
          // set the name for Cling using the hash_function
          fClingName = gNamePrefix;
+         // the batch evaluation is generated again for the new expression
+         fBatchMethod.reset();
+         fBatchFuncPtr = nullptr;
 
          // check if formula exist already in the map
          R__LOCKGUARD(gROOTMutex);
@@ -3252,6 +3263,118 @@ void TFormula::GradientPar(const Double_t *x, Double_t *result)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the compiled function evaluating the formula on many points, see
+/// EvalParN(), and generate it at the first call.
+/// Return nullptr if the formula cannot be evaluated this way: if it is
+/// vectorized, built from a lambda expression, or if the compilation failed.
+
+TFormula::CallFuncSignature TFormula::PrepareBatchEvalMethod() const
+{
+   if (CallFuncSignature batchFunc = fBatchFuncPtr)
+      return batchFunc;
+   if (!fReadyToExecute || fVectorized || TestBit(TFormula::kLambda))
+      return nullptr;
+
+   R__LOCKGUARD(gROOTMutex);
+   // check again in case another thread has generated the function, or failed to
+   if (fBatchMethod)
+      return fBatchFuncPtr;
+   auto thisFormula = const_cast<TFormula*>(this);
+   if (!fClingInitialized && fLazyInitialization)
+      thisFormula->ReInitializeEvalMethod();
+   if (!fClingInitialized || !fClingName.Length())
+      return nullptr;
+
+   // Formulas with the same expression share the cling name, and the batch function.
+   std::string batchFuncName = GetBatchFuncName();
+   Bool_t declared = functionExists(batchFuncName);
+   if (!declared) {
+      TString args = (fNdim > 0 || fNpar > 0) ? "xi" : "";
+      if (fNpar > 0)
+         args += ", p";
+      TString code = TString::Format("#pragma cling optimize(2)\n"
+                                     "void %s(Int_t n, Double_t **x, Double_t *p, Double_t *result) {\n"
+                                     "   for (Int_t i = 0; i < n; ++i) {\n"
+                                     "      Double_t xi[%d];\n"
+                                     "      for (Int_t j = 0; j < %d; ++j)\n"
+                                     "         xi[j] = x[j][i];\n"
+                                     "      result[i] = %s(%s);\n"
+                                     "   }\n"
+                                     "}",
+                                     batchFuncName.c_str(), std::max(fNdim, 1), fNdim, fClingName.Data(), args.Data());
+      declared = gInterpreter->Declare(code);
+   }
+
+   // An invalid fBatchMethod records the failure, such that it is not attempted again.
+   thisFormula->fBatchMethod.reset(new TMethodCall());
+   if (declared)
+      fBatchMethod->InitWithPrototype(batchFuncName.c_str(), "Int_t,Double_t**,Double_t*,Double_t*");
+   if (!fBatchMethod->IsValid()) {
+      Warning("EvalParN", "Cannot compile the evaluation of %s on many points, evaluating them one by one",
+              GetExpFormula().Data());
+      return nullptr;
+   }
+   thisFormula->fBatchFuncPtr = prepareFuncPtr(fBatchMethod.get());
+   return fBatchFuncPtr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate the formula at n points and store the values in result.
+/// x[j] points to the n values of variable j, i.e. point i is
+/// (x[0][i], ..., x[GetNdim()-1][i]). If params is null the parameters of the
+/// formula are used.
+///
+/// The loop over the points is compiled together with the formula expression
+/// (at the first call), such that the compiler can inline and vectorize the
+/// evaluation instead of calling the formula once per point. Vectorized
+/// formulas are evaluated on ROOT::Double_v, i.e. on several points at once.
+/// Evaluating different points from several threads is safe.
+
+void TFormula::EvalParN(Int_t n, const Double_t *const *x, Double_t *result, const Double_t *params) const
+{
+   if (n <= 0)
+      return;
+   const Double_t *pars = params ? params : fClingParameters.data();
+   Int_t i = 0;
+
+#ifdef R__HAS_VECCORE
+   if (fVectorized) {
+      const Int_t vecSize = vecCore::VectorSize<ROOT::Double_v>();
+      std::vector<ROOT::Double_v> xvec(std::max(fNdim, 1));
+      for (; i + vecSize <= n; i += vecSize) {
+         for (Int_t j = 0; j < fNdim; ++j)
+            vecCore::Load<ROOT::Double_v>(xvec[j], x[j] + i);
+         vecCore::Store<ROOT::Double_v>(DoEvalVec(xvec.data(), pars), result + i);
+      }
+   }
+#endif
+
+   if (CallFuncSignature batchFunc = PrepareBatchEvalMethod()) {
+      // __attribute__((used)) extern "C" void __cf_0(void* obj, int nargs, void** args, void* ret)
+      // {
+      //    ((void (&)(int, double**, double*, double*))TFormula____id_batch)(*(int*)args[0],
+      //          *(double**)args[1], *(double**)args[2], *(double**)args[3]);
+      //    return;
+      // }
+      void *args[4];
+      args[0] = &n;
+      args[1] = const_cast<Double_t ***>(&x);
+      args[2] = const_cast<Double_t **>(&pars);
+      args[3] = &result;
+      (*batchFunc)(0, 4, args, /*ret*/nullptr);
+      return;
+   }
+
+   // remaining points
+   std::vector<Double_t> xi(fNdim);
+   for (; i < n; ++i) {
+      for (Int_t j = 0; j < fNdim; ++j)
+         xi[j] = x[j][i];
+      result[i] = EvalPar(xi.data(), pars);
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 #ifdef R__HAS_VECCORE
 // ROOT::Double_v TFormula::Eval(ROOT::Double_v x, ROOT::Double_v y, ROOT::Double_v z, ROOT::Double_v t) const
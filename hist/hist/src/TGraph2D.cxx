@@ -26,10 +26,12 @@
 #include "strtok.h"
 #include "snprintf.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <cassert>
 #include <iostream>
 #include <fstream>
+#include <vector>
 
 #include "HFitInterface.h"
 #include "Fit/DataRange.h"
@@ -1194,18 +1196,30 @@ TH2D *TGraph2D::GetHistogram(Option_t *option)
 
    Double_t x, y, z;
 
-   for (Int_t ix = 1; ix <= fNpx; ix++) {
-      x  = hxmin + (ix - 0.5) * dx;
-      for (Int_t iy = 1; iy <= fNpy; iy++) {
-         y  = hymin + (iy - 0.5) * dy;
-         // do interpolation
-         if (oldInterp)
+   if (oldInterp) {
+      for (Int_t ix = 1; ix <= fNpx; ix++) {
+         x  = hxmin + (ix - 0.5) * dx;
+         for (Int_t iy = 1; iy <= fNpy; iy++) {
+            y  = hymin + (iy - 0.5) * dy;
+            // do interpolation
             z  = ((TGraphDelaunay*)fDelaunay)->ComputeZ(x, y);
-         else
-            z  = ((TGraphDelaunay2D*)fDelaunay)->ComputeZ(x, y);
 
-         fHistogram->Fill(x, y, z);
+            fHistogram->Fill(x, y, z);
+         }
+      }
+   } else {
+      // interpolate all the bin centres at once
+      const Int_t n = fNpx * fNpy;
+      std::vector<Double_t> vx(n), vy(n), vz(n);
+      for (Int_t ix = 1, i = 0; ix <= fNpx; ix++) {
+         x  = hxmin + (ix - 0.5) * dx;
+         for (Int_t iy = 1; iy <= fNpy; iy++, i++) {
+            vx[i] = x;
+            vy[i] = hymin + (iy - 0.5) * dy;
+         }
       }
+      ((TGraphDelaunay2D*)fDelaunay)->ComputeZ(n, vx.data(), vy.data(), vz.data());
+      for (Int_t i = 0; i < n; i++) fHistogram->Fill(vx[i], vy[i], vz[i]);
    }
 
 
@@ -1333,6 +1347,35 @@ Double_t TGraph2D::Interpolate(Double_t x, Double_t y)
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Finds the z values at the n positions (x[i],y[i]) thanks to the Delaunay
+/// interpolation. With the default interpolation, the triangles containing the
+/// points are located with a spatial index, in parallel if implicit
+/// multi-threading is enabled (see ROOT::EnableImplicitMT).
+
+void TGraph2D::Interpolate(Int_t n, const Double_t *x, const Double_t *y, Double_t *z)
+{
+   if (n <= 0) return;
+   if (fNpoints <= 0) {
+      Error("Interpolate", "Empty TGraph2D");
+      std::fill(z, z + n, 0.);
+      return;
+   }
+
+   // finds the interpolator as for a single point
+   z[0] = Interpolate(x[0], y[0]);
+   if (!fDelaunay) {
+      std::fill(z, z + n, z[0]);
+      return;
+   }
+
+   if (fDelaunay->IsA() == TGraphDelaunay2D::Class()) {
+      ((TGraphDelaunay2D*)fDelaunay)->ComputeZ(n - 1, x + 1, y + 1, z + 1);
+   } else {
+      for (Int_t i = 1; i < n; i++) z[i] = ((TGraphDelaunay*)fDelaunay)->ComputeZ(x[i], y[i]);
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Paints this 2D graph with its current attributes
 
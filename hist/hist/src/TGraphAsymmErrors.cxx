@@ -27,6 +27,7 @@
 #include "strtok.h"
 
 #include <cstring>
+#include <vector>
 #include <iostream>
 #include <fstream>
 
@@ -643,6 +644,8 @@ void TGraphAsymmErrors::Divide(const TH1* pass, const TH1* total, Option_t *opt)
    //pointer to function returning the boundaries of the confidence interval
    //(is only used in the frequentist cases.)
    Double_t (*pBound)(Double_t,Double_t,Double_t,Bool_t) = &TEfficiency::ClopperPearson; // default method
+   //same method for the calculation of the intervals of all bins at once
+   TEfficiency::EStatOption statOption = TEfficiency::kFCP;
    //confidence level
    Double_t conf = 0.682689492137;
    //values for bayesian statistics
@@ -690,6 +693,7 @@ void TGraphAsymmErrors::Divide(const TH1* pass, const TH1* total, Option_t *opt)
          Warning("Divide", "given shape parameter for beta %.2lf is invalid", b);
       option.ReplaceAll("b(", "");
       bIsBayesian = true;
+      statOption = TEfficiency::kBBayesian;
 
       // look for specific bayesian options
 
@@ -707,31 +711,37 @@ void TGraphAsymmErrors::Divide(const TH1* pass, const TH1* total, Option_t *opt)
    else if (option.Contains("n")) {
       option.ReplaceAll("n", "");
       pBound = &TEfficiency::Normal;
+      statOption = TEfficiency::kFNormal;
    }
    // clopper pearson interval
    else if (option.Contains("cp")) {
       option.ReplaceAll("cp", "");
       pBound = &TEfficiency::ClopperPearson;
+      statOption = TEfficiency::kFCP;
    }
    // wilson interval
    else if (option.Contains("w")) {
       option.ReplaceAll("w", "");
       pBound = &TEfficiency::Wilson;
+      statOption = TEfficiency::kFWilson;
    }
    // agresti coull interval
    else if (option.Contains("ac")) {
       option.ReplaceAll("ac", "");
       pBound = &TEfficiency::AgrestiCoull;
+      statOption = TEfficiency::kFAC;
    }
    // Feldman-Cousins interval
    else if (option.Contains("fc")) {
       option.ReplaceAll("fc", "");
       pBound = &TEfficiency::FeldmanCousins;
+      statOption = TEfficiency::kFFC;
    }
    // mid-P Lancaster interval
    else if (option.Contains("midp")) {
       option.ReplaceAll("midp", "");
       pBound = &TEfficiency::MidPInterval;
+      statOption = TEfficiency::kMidP;
    }
 
    // interpret as Poisson ratio
@@ -787,6 +797,35 @@ void TGraphAsymmErrors::Divide(const TH1* pass, const TH1* total, Option_t *opt)
    //number of total and passed events
    Double_t t = 0 , p = 0;
    Double_t tw = 0, tw2 = 0, pw = 0, pw2 = 0, wratio = 1; // for the case of weights
+   // without weights, calculate the confidence intervals of all the bins
+   // at once: only once for each pair of numbers of passed and total events
+   std::vector<Double_t> lows, uppers;
+   if (!bEffective) {
+      std::vector<Int_t> bins;
+      std::vector<Double_t> totals, passeds;
+      for (Int_t b=1; b<=nbins; ++b) {
+         t = std::round(total->GetBinContent(b));
+         p = std::round(pass->GetBinContent(b));
+         if (bPoissonRatio)
+            t += p;
+         if (t == 0.0 && !plot0Bins)
+            continue;
+         bins.push_back(b);
+         totals.push_back(t);
+         passeds.push_back(p);
+      }
+      Int_t n = bins.size();
+      std::vector<Double_t> binLows(n), binUppers(n);
+      TEfficiency::ConfidenceIntervals(n, totals.data(), passeds.data(), conf, statOption,
+                                       binLows.data(), binUppers.data(), alpha, beta, useShortestInterval);
+      lows.resize(nbins + 1);
+      uppers.resize(nbins + 1);
+      for (Int_t i = 0; i < n; ++i) {
+         lows[bins[i]] = binLows[i];
+         uppers[bins[i]] = binUppers[i];
+      }
+   }
+
    //loop over all bins and fill the graph
    for (Int_t b=1; b<=nbins; ++b) {
 
@@ -884,7 +923,11 @@ void TGraphAsymmErrors::Divide(const TH1* pass, const TH1* total, Option_t *opt)
             else
                eff = TEfficiency::BetaMean(aa,bb);
 
-            if (useShortestInterval) {
+            if (!bEffective) {
+               low = lows[b];
+               upper = uppers[b];
+            }
+            else if (useShortestInterval) {
                TEfficiency::BetaShortestInterval(conf,aa,bb,low,upper);
             }
             else {
@@ -920,8 +963,14 @@ void TGraphAsymmErrors::Divide(const TH1* pass, const TH1* total, Option_t *opt)
             if(t != 0.0)
                eff = ((Double_t)p)/t;
 
-            low = pBound(t,p,conf,false);
-            upper = pBound(t,p,conf,true);
+            if (!bEffective) {
+               low = lows[b];
+               upper = uppers[b];
+            }
+            else {
+               low = pBound(t,p,conf,false);
+               upper = pBound(t,p,conf,true);
+            }
          }
       }
       // treat as Poisson ratio
@@ -16,6 +16,7 @@
 #include <sstream>
 #include <cmath>
 #include <iostream>
+#include <algorithm>
 
 #include "TROOT.h"
 #include "TBuffer.h"
@@ -51,6 +52,7 @@
 #include "Math/QuantFuncMathCore.h"
 
 #include "TH1Merger.h"
+#include "TH1ArrayHelper.h"
 
 /** \addtogroup Hist
 @{
@@ -537,6 +539,13 @@ When using the options 2 or 3 above, the labels are automatically
 ~~~ {.cpp}
         file->Write();
 ~~~
+ Large histograms with mostly empty bins, e.g. TH3 or THn, are written
+ faster and are smaller on file when their bin contents and errors are
+ streamed without the runs of empty bins:
+~~~ {.cpp}
+        TArray::SetCompactStreaming(1024); // for arrays of at least 1024 bins
+~~~
+ Such files can only be read by ROOT versions supporting this format.
 
 
 \anchor misc
@@ -560,6 +569,7 @@ Int_t  TH1::fgBufferSize   = 1000;
 Bool_t TH1::fgAddDirectory = kTRUE;
 Bool_t TH1::fgDefaultSumw2 = kFALSE;
 Bool_t TH1::fgStatOverflows= kFALSE;
+Int_t  TH1::fgParallelThreshold = 100000;
 
 extern void H1InitGaus();
 extern void H1InitExpo();
@@ -965,46 +975,68 @@ Bool_t TH1::Add(const TH1 *h1, Double_t c1)
    Double_t c1sq = c1 * c1;
    Double_t factsq = factor * factor;
 
-   for (Int_t bin = 0; bin < fNcells; ++bin) {
-      //special case where histograms have the kIsAverage bit set
-      if (this->TestBit(kIsAverage) && h1->TestBit(kIsAverage)) {
-         Double_t y1 = h1->RetrieveBinContent(bin);
-         Double_t y2 = this->RetrieveBinContent(bin);
-         Double_t e1sq = h1->GetBinErrorSqUnchecked(bin);
-         Double_t e2sq = this->GetBinErrorSqUnchecked(bin);
-         Double_t w1 = 1., w2 = 1.;
-
-         // consider all special cases  when bin errors are zero
-         // see http://root-forum.cern.ch/viewtopic.php?f=3&t=13299
-         if (e1sq) w1 = 1. / e1sq;
-         else if (h1->fSumw2.fN) {
-            w1 = 1.E200; // use an arbitrary huge value
-            if (y1 == 0) {
-               // use an estimated error from the global histogram scale
-               double sf = (s2[0] != 0) ? s2[1]/s2[0] : 1;
-               w1 = 1./(sf*sf);
+   Double_t *cont = TH1ArrayHelper::GetArray<Double_t, TArrayD>(this);
+   const Double_t *cont1 = TH1ArrayHelper::GetArray<Double_t, TArrayD>(h1);
+   if (cont && cont1 && !(this->TestBit(kIsAverage) && h1->TestBit(kIsAverage))) {
+      // normal case of addition, directly on the arrays of TH1D, TH2D and TH3D
+      Double_t *sumw2 = fSumw2.fN ? fSumw2.fArray : nullptr;
+      const Double_t *err1sq = h1->fSumw2.fN ? h1->fSumw2.fArray : cont1;
+      const Double_t c = c1 * factor;
+      const Double_t csq = c1sq * factsq;
+      TH1ArrayHelper::ForEachRange(fNcells, 1, [&](Long64_t begin, Long64_t end) {
+         if (sumw2) {
+            for (Long64_t bin = begin; bin < end; ++bin) {
+               const Double_t e1sq = err1sq[bin];
+               cont[bin] += c * cont1[bin];
+               sumw2[bin] += csq * e1sq;
             }
+         } else {
+            for (Long64_t bin = begin; bin < end; ++bin)
+               cont[bin] += c * cont1[bin];
          }
-         if (e2sq) w2 = 1. / e2sq;
-         else if (fSumw2.fN) {
-            w2 = 1.E200; // use an arbitrary huge value
-            if (y2 == 0) {
-               // use an estimated error from the global histogram scale
-               double sf = (s1[0] != 0) ? s1[1]/s1[0] : 1;
-               w2 = 1./(sf*sf);
+      });
+   } else {
+      for (Int_t bin = 0; bin < fNcells; ++bin) {
+         //special case where histograms have the kIsAverage bit set
+         if (this->TestBit(kIsAverage) && h1->TestBit(kIsAverage)) {
+            Double_t y1 = h1->RetrieveBinContent(bin);
+            Double_t y2 = this->RetrieveBinContent(bin);
+            Double_t e1sq = h1->GetBinErrorSqUnchecked(bin);
+            Double_t e2sq = this->GetBinErrorSqUnchecked(bin);
+            Double_t w1 = 1., w2 = 1.;
+
+            // consider all special cases  when bin errors are zero
+            // see http://root-forum.cern.ch/viewtopic.php?f=3&t=13299
+            if (e1sq) w1 = 1. / e1sq;
+            else if (h1->fSumw2.fN) {
+               w1 = 1.E200; // use an arbitrary huge value
+               if (y1 == 0) {
+                  // use an estimated error from the global histogram scale
+                  double sf = (s2[0] != 0) ? s2[1]/s2[0] : 1;
+                  w1 = 1./(sf*sf);
+               }
+            }
+            if (e2sq) w2 = 1. / e2sq;
+            else if (fSumw2.fN) {
+               w2 = 1.E200; // use an arbitrary huge value
+               if (y2 == 0) {
+                  // use an estimated error from the global histogram scale
+                  double sf = (s1[0] != 0) ? s1[1]/s1[0] : 1;
+                  w2 = 1./(sf*sf);
+               }
             }
-         }
 
-         double y =  (w1*y1 + w2*y2)/(w1 + w2);
-         UpdateBinContent(bin, y);
-         if (fSumw2.fN) {
-            double err2 =  1./(w1 + w2);
-            if (err2 < 1.E-200) err2 = 0;  // to remove arbitrary value when e1=0 AND e2=0
-            fSumw2.fArray[bin] = err2;
+            double y =  (w1*y1 + w2*y2)/(w1 + w2);
+            UpdateBinContent(bin, y);
+            if (fSumw2.fN) {
+               double err2 =  1./(w1 + w2);
+               if (err2 < 1.E-200) err2 = 0;  // to remove arbitrary value when e1=0 AND e2=0
+               fSumw2.fArray[bin] = err2;
+            }
+         } else { // normal case of addition between histograms
+            AddBinContent(bin, c1 * factor * h1->RetrieveBinContent(bin));
+            if (fSumw2.fN) fSumw2.fArray[bin] += c1sq * factsq * h1->GetBinErrorSqUnchecked(bin);
          }
-      } else { // normal case of addition between histograms
-         AddBinContent(bin, c1 * factor * h1->RetrieveBinContent(bin));
-         if (fSumw2.fN) fSumw2.fArray[bin] += c1sq * factsq * h1->GetBinErrorSqUnchecked(bin);
       }
    }
 
@@ -1206,10 +1238,33 @@ Bool_t TH1::Add(const TH1 *h1, const TH1 *h2, Double_t c1, Double_t c2)
    } else { // case of simple histogram addition
       Double_t c1sq = c1 * c1;
       Double_t c2sq = c2 * c2;
-      for (Int_t i = 0; i < fNcells; ++i) { // Loop on cells (bins including underflows/overflows)
-         UpdateBinContent(i, c1 * h1->RetrieveBinContent(i) + c2 * h2->RetrieveBinContent(i));
-         if (fSumw2.fN) {
-            fSumw2.fArray[i] = c1sq * h1->GetBinErrorSqUnchecked(i) + c2sq * h2->GetBinErrorSqUnchecked(i);
+      Double_t *cont = TH1ArrayHelper::GetArray<Double_t, TArrayD>(this);
+      const Double_t *cont1 = TH1ArrayHelper::GetArray<Double_t, TArrayD>(h1);
+      const Double_t *cont2 = TH1ArrayHelper::GetArray<Double_t, TArrayD>(h2);
+      if (cont && cont1 && cont2) {
+         // directly on the arrays of TH1D, TH2D and TH3D
+         Double_t *sumw2 = fSumw2.fN ? fSumw2.fArray : nullptr;
+         const Double_t *err1sq = h1->fSumw2.fN ? h1->fSumw2.fArray : cont1;
+         const Double_t *err2sq = h2->fSumw2.fN ? h2->fSumw2.fArray : cont2;
+         TH1ArrayHelper::ForEachRange(fNcells, 1, [&](Long64_t begin, Long64_t end) {
+            if (sumw2) {
+               for (Long64_t i = begin; i < end; ++i) {
+                  const Double_t e1sq = err1sq[i];
+                  const Double_t e2sq = err2sq[i];
+                  cont[i] = c1 * cont1[i] + c2 * cont2[i];
+                  sumw2[i] = c1sq * e1sq + c2sq * e2sq;
+               }
+            } else {
+               for (Long64_t i = begin; i < end; ++i)
+                  cont[i] = c1 * cont1[i] + c2 * cont2[i];
+            }
+         });
+      } else {
+         for (Int_t i = 0; i < fNcells; ++i) { // Loop on cells (bins including underflows/overflows)
+            UpdateBinContent(i, c1 * h1->RetrieveBinContent(i) + c2 * h2->RetrieveBinContent(i));
+            if (fSumw2.fN) {
+               fSumw2.fArray[i] = c1sq * h1->GetBinErrorSqUnchecked(i) + c2sq * h2->GetBinErrorSqUnchecked(i);
+            }
          }
       }
    }
@@ -2899,16 +2954,40 @@ Bool_t TH1::Divide(const TH1 *h1)
    if (fSumw2.fN == 0 && h1->GetSumw2N() != 0) Sumw2();
 
    //   - Loop on bins (including underflows/overflows)
-   for (Int_t i = 0; i < fNcells; ++i) {
-      Double_t c0 = RetrieveBinContent(i);
-      Double_t c1 = h1->RetrieveBinContent(i);
-      if (c1) UpdateBinContent(i, c0 / c1);
-      else UpdateBinContent(i, 0);
-
-      if(fSumw2.fN) {
-         if (c1 == 0) { fSumw2.fArray[i] = 0; continue; }
-         Double_t c1sq = c1 * c1;
-         fSumw2.fArray[i] = (GetBinErrorSqUnchecked(i) * c1sq + h1->GetBinErrorSqUnchecked(i) * c0 * c0) / (c1sq * c1sq);
+   Double_t *cont = TH1ArrayHelper::GetArray<Double_t, TArrayD>(this);
+   const Double_t *cont1 = TH1ArrayHelper::GetArray<Double_t, TArrayD>(h1);
+   if (cont && cont1) {
+      // directly on the arrays of TH1D, TH2D and TH3D
+      Double_t *sumw2 = fSumw2.fN ? fSumw2.fArray : nullptr;
+      const Double_t *err1sq = h1->fSumw2.fN ? h1->fSumw2.fArray : cont1;
+      TH1ArrayHelper::ForEachRange(fNcells, 1, [&](Long64_t begin, Long64_t end) {
+         if (sumw2) {
+            for (Long64_t i = begin; i < end; ++i) {
+               const Double_t c0 = cont[i];
+               const Double_t c1 = cont1[i];
+               const Double_t e0sq = sumw2[i];
+               const Double_t e1sq = err1sq[i];
+               const Double_t c1sq = c1 * c1;
+               cont[i] = c1 ? c0 / c1 : 0;
+               sumw2[i] = c1 ? (e0sq * c1sq + e1sq * c0 * c0) / (c1sq * c1sq) : 0;
+            }
+         } else {
+            for (Long64_t i = begin; i < end; ++i)
+               cont[i] = cont1[i] ? cont[i] / cont1[i] : 0;
+         }
+      });
+   } else {
+      for (Int_t i = 0; i < fNcells; ++i) {
+         Double_t c0 = RetrieveBinContent(i);
+         Double_t c1 = h1->RetrieveBinContent(i);
+         if (c1) UpdateBinContent(i, c0 / c1);
+         else UpdateBinContent(i, 0);
+
+         if(fSumw2.fN) {
+            if (c1 == 0) { fSumw2.fArray[i] = 0; continue; }
+            Double_t c1sq = c1 * c1;
+            fSumw2.fArray[i] = (GetBinErrorSqUnchecked(i) * c1sq + h1->GetBinErrorSqUnchecked(i) * c0 * c0) / (c1sq * c1sq);
+         }
       }
    }
    ResetStats();
@@ -2981,33 +3060,66 @@ Bool_t TH1::Divide(const TH1 *h1, const TH1 *h2, Double_t c1, Double_t c2, Optio
    SetMaximum();
 
    //   - Loop on bins (including underflows/overflows)
-   for (Int_t i = 0; i < fNcells; ++i) {
-      Double_t b1 = h1->RetrieveBinContent(i);
-      Double_t b2 = h2->RetrieveBinContent(i);
-      if (b2) UpdateBinContent(i, c1 * b1 / (c2 * b2));
-      else UpdateBinContent(i, 0);
+   Double_t *cont = TH1ArrayHelper::GetArray<Double_t, TArrayD>(this);
+   const Double_t *cont1 = TH1ArrayHelper::GetArray<Double_t, TArrayD>(h1);
+   const Double_t *cont2 = TH1ArrayHelper::GetArray<Double_t, TArrayD>(h2);
+   if (cont && cont1 && cont2) {
+      // directly on the arrays of TH1D, TH2D and TH3D
+      Double_t *sumw2 = fSumw2.fN ? fSumw2.fArray : nullptr;
+      const Double_t *err1sq = h1->fSumw2.fN ? h1->fSumw2.fArray : cont1;
+      const Double_t *err2sq = h2->fSumw2.fN ? h2->fSumw2.fArray : cont2;
+      const Double_t c1sq = c1 * c1;
+      const Double_t c2sq = c2 * c2;
+      TH1ArrayHelper::ForEachRange(fNcells, 1, [&](Long64_t begin, Long64_t end) {
+         if (sumw2) {
+            for (Long64_t i = begin; i < end; ++i) {
+               const Double_t b1 = cont1[i];
+               const Double_t b2 = cont2[i];
+               const Double_t e1sq = err1sq[i];
+               const Double_t e2sq = err2sq[i];
+               const Double_t b1sq = b1 * b1;
+               const Double_t b2sq = b2 * b2;
+               cont[i] = b2 ? c1 * b1 / (c2 * b2) : 0;
+               if (binomial) // see below for the binomial errors
+                  sumw2[i] = (b2 && b1 != b2) ? TMath::Abs(((1. - 2. * b1 / b2) * e1sq + b1sq * e2sq / b2sq) / b2sq)
+                                              : 0;
+               else
+                  sumw2[i] = b2 ? c1sq * c2sq * (e1sq * b2sq + e2sq * b1sq) / (c2sq * c2sq * b2sq * b2sq) : 0;
+            }
+         } else {
+            for (Long64_t i = begin; i < end; ++i)
+               cont[i] = cont2[i] ? c1 * cont1[i] / (c2 * cont2[i]) : 0;
+         }
+      });
+   } else {
+      for (Int_t i = 0; i < fNcells; ++i) {
+         Double_t b1 = h1->RetrieveBinContent(i);
+         Double_t b2 = h2->RetrieveBinContent(i);
+         if (b2) UpdateBinContent(i, c1 * b1 / (c2 * b2));
+         else UpdateBinContent(i, 0);
 
-      if (fSumw2.fN) {
-         if (b2 == 0) { fSumw2.fArray[i] = 0; continue; }
-         Double_t b1sq = b1 * b1; Double_t b2sq = b2 * b2;
-         Double_t c1sq = c1 * c1; Double_t c2sq = c2 * c2;
-         Double_t e1sq = h1->GetBinErrorSqUnchecked(i);
-         Double_t e2sq = h2->GetBinErrorSqUnchecked(i);
-         if (binomial) {
-            if (b1 != b2) {
-               // in the case of binomial statistics c1 and c2 must be 1 otherwise it does not make sense
-               // c1 and c2 are ignored
-               //fSumw2.fArray[bin] = TMath::Abs(w*(1-w)/(c2*b2));//this is the formula in Hbook/Hoper1
-               //fSumw2.fArray[bin] = TMath::Abs(w*(1-w)/b2);     // old formula from G. Flucke
-               // formula which works also for weighted histogram (see http://root-forum.cern.ch/viewtopic.php?t=3753 )
-               fSumw2.fArray[i] = TMath::Abs( ( (1. - 2.* b1 / b2) * e1sq  + b1sq * e2sq / b2sq ) / b2sq );
+         if (fSumw2.fN) {
+            if (b2 == 0) { fSumw2.fArray[i] = 0; continue; }
+            Double_t b1sq = b1 * b1; Double_t b2sq = b2 * b2;
+            Double_t c1sq = c1 * c1; Double_t c2sq = c2 * c2;
+            Double_t e1sq = h1->GetBinErrorSqUnchecked(i);
+            Double_t e2sq = h2->GetBinErrorSqUnchecked(i);
+            if (binomial) {
+               if (b1 != b2) {
+                  // in the case of binomial statistics c1 and c2 must be 1 otherwise it does not make sense
+                  // c1 and c2 are ignored
+                  //fSumw2.fArray[bin] = TMath::Abs(w*(1-w)/(c2*b2));//this is the formula in Hbook/Hoper1
+                  //fSumw2.fArray[bin] = TMath::Abs(w*(1-w)/b2);     // old formula from G. Flucke
+                  // formula which works also for weighted histogram (see http://root-forum.cern.ch/viewtopic.php?t=3753 )
+                  fSumw2.fArray[i] = TMath::Abs( ( (1. - 2.* b1 / b2) * e1sq  + b1sq * e2sq / b2sq ) / b2sq );
+               } else {
+                  //in case b1=b2 error is zero
+                  //use  TGraphAsymmErrors::BayesDivide for getting the asymmetric error not equal to zero
+                  fSumw2.fArray[i] = 0;
+               }
             } else {
-               //in case b1=b2 error is zero
-               //use  TGraphAsymmErrors::BayesDivide for getting the asymmetric error not equal to zero
-               fSumw2.fArray[i] = 0;
+               fSumw2.fArray[i] = c1sq * c2sq * (e1sq * b2sq + e2sq * b1sq) / (c2sq * c2sq * b2sq * b2sq);
             }
-         } else {
-            fSumw2.fArray[i] = c1sq * c2sq * (e1sq * b2sq + e2sq * b1sq) / (c2sq * c2sq * b2sq * b2sq);
          }
       }
    }
@@ -3454,6 +3566,10 @@ void TH1::FillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stride
 ////////////////////////////////////////////////////////////////////////////////
 /// Internal method to fill histogram content from a vector
 /// called directly by TH1::BufferEmpty
+///
+/// Unless the axis can be extended, the entries are processed in batches of
+/// kFillBatchSize: the bins of a whole batch are found at once with
+/// TAxis::FindFixBins, then the contents and the statistics are updated.
 
 void TH1::DoFillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stride)
 {
@@ -3462,6 +3578,33 @@ void TH1::DoFillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stri
    fEntries += ntimes;
    Double_t ww = 1;
    Int_t nbins   = fXaxis.GetNbins();
+
+   if (!fXaxis.CanExtend()) {
+      CheckFillNWeights(ntimes, w, stride);
+      const Bool_t statOverflows = GetStatOverflowsBehaviour();
+      Double_t sumw = fTsumw, sumw2 = fTsumw2, sumwx = fTsumwx, sumwx2 = fTsumwx2;
+      Int_t bins[kFillBatchSize];
+      for (Int_t first = 0; first < ntimes; first += kFillBatchSize) {
+         const Int_t n = std::min<Int_t>(kFillBatchSize, ntimes - first);
+         const Double_t *xb = x + (Long64_t)first * stride;
+         const Double_t *wb = w ? w + (Long64_t)first * stride : nullptr;
+         fXaxis.FindFixBins(n, xb, bins, stride);
+         DoFillBins(n, bins, wb, stride);
+         for (i = 0; i < n; ++i) {
+            // Entries outside the statistics range add zeros, not to depend on their values.
+            const Bool_t inRange = statOverflows || (bins[i] > 0 && bins[i] <= nbins);
+            const Double_t z = inRange ? (wb ? wb[i * stride] : 1.) : 0.;
+            const Double_t xx = inRange ? xb[i * stride] : 0.;
+            sumw   += z;
+            sumw2  += z*z;
+            sumwx  += z*xx;
+            sumwx2 += z*xx*xx;
+         }
+      }
+      fTsumw = sumw; fTsumw2 = sumw2; fTsumwx = sumwx; fTsumwx2 = sumwx2;
+      return;
+   }
+
    ntimes *= stride;
    for (i=0;i<ntimes;i+=stride) {
       bin =fXaxis.FindBin(x[i]);
@@ -3481,6 +3624,46 @@ void TH1::DoFillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stri
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Internal method adding the weights w[0], w[stride], ... (1 if w is NULL)
+/// to the contents of the n bins, and their squares to the sum of squares
+/// of weights if it is stored. Used by the batch filling of FillN.
+
+void TH1::DoFillBins(Int_t n, const Int_t *bins, const Double_t *w, Int_t stride)
+{
+   if (!w) {
+      for (Int_t i = 0; i < n; ++i)
+         AddBinContent(bins[i]);
+      if (fSumw2.fN) {
+         for (Int_t i = 0; i < n; ++i)
+            ++fSumw2.fArray[bins[i]];
+      }
+      return;
+   }
+   for (Int_t i = 0; i < n; ++i)
+      AddBinContent(bins[i], w[i * stride]);
+   if (fSumw2.fN) {
+      for (Int_t i = 0; i < n; ++i)
+         fSumw2.fArray[bins[i]] += w[i * stride] * w[i * stride];
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Internal method triggering the storage of the sum of squares of weights
+/// before a batch filling, if one of the weights is not 1 (see FillN).
+
+void TH1::CheckFillNWeights(Int_t ntimes, const Double_t *w, Int_t stride)
+{
+   if (fSumw2.fN || !w || TestBit(TH1::kIsNotW))
+      return;
+   for (Int_t i = 0; i < ntimes; ++i) {
+      if (w[(Long64_t)i * stride] != 1.0) {
+         Sumw2();
+         return;
+      }
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Fill histogram following distribution in function fname.
 ///
@@ -4359,6 +4542,16 @@ Bool_t TH1::GetDefaultSumw2()
    return fgDefaultSumw2;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the minimal number of bins above which the operations on the bins
+/// run on many threads when implicit multi-threading is enabled.
+/// see TH1::SetParallelThreshold.
+
+Int_t TH1::GetParallelThreshold()
+{
+   return fgParallelThreshold;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return the current number of entries.
 
@@ -6049,12 +6242,35 @@ Bool_t TH1::Multiply(const TH1 *h1)
    SetMaximum();
 
    //   - Loop on bins (including underflows/overflows)
-   for (Int_t i = 0; i < fNcells; ++i) {
-      Double_t c0 = RetrieveBinContent(i);
-      Double_t c1 = h1->RetrieveBinContent(i);
-      UpdateBinContent(i, c0 * c1);
-      if (fSumw2.fN) {
-         fSumw2.fArray[i] = GetBinErrorSqUnchecked(i) * c1 * c1 + h1->GetBinErrorSqUnchecked(i) * c0 * c0;
+   Double_t *cont = TH1ArrayHelper::GetArray<Double_t, TArrayD>(this);
+   const Double_t *cont1 = TH1ArrayHelper::GetArray<Double_t, TArrayD>(h1);
+   if (cont && cont1) {
+      // directly on the arrays of TH1D, TH2D and TH3D
+      Double_t *sumw2 = fSumw2.fN ? fSumw2.fArray : nullptr;
+      const Double_t *err1sq = h1->fSumw2.fN ? h1->fSumw2.fArray : cont1;
+      TH1ArrayHelper::ForEachRange(fNcells, 1, [&](Long64_t begin, Long64_t end) {
+         if (sumw2) {
+            for (Long64_t i = begin; i < end; ++i) {
+               const Double_t c0 = cont[i];
+               const Double_t c1 = cont1[i];
+               const Double_t e0sq = sumw2[i];
+               const Double_t e1sq = err1sq[i];
+               cont[i] = c0 * c1;
+               sumw2[i] = e0sq * c1 * c1 + e1sq * c0 * c0;
+            }
+         } else {
+            for (Long64_t i = begin; i < end; ++i)
+               cont[i] *= cont1[i];
+         }
+      });
+   } else {
+      for (Int_t i = 0; i < fNcells; ++i) {
+         Double_t c0 = RetrieveBinContent(i);
+         Double_t c1 = h1->RetrieveBinContent(i);
+         UpdateBinContent(i, c0 * c1);
+         if (fSumw2.fN) {
+            fSumw2.fArray[i] = GetBinErrorSqUnchecked(i) * c1 * c1 + h1->GetBinErrorSqUnchecked(i) * c0 * c0;
+         }
       }
    }
    ResetStats();
@@ -6113,12 +6329,37 @@ Bool_t TH1::Multiply(const TH1 *h1, const TH1 *h2, Double_t c1, Double_t c2, Opt
 
    //   - Loop on bins (including underflows/overflows)
    Double_t c1sq = c1 * c1; Double_t c2sq = c2 * c2;
-   for (Int_t i = 0; i < fNcells; ++i) {
-      Double_t b1 = h1->RetrieveBinContent(i);
-      Double_t b2 = h2->RetrieveBinContent(i);
-      UpdateBinContent(i, c1 * b1 * c2 * b2);
-      if (fSumw2.fN) {
-         fSumw2.fArray[i] = c1sq * c2sq * (h1->GetBinErrorSqUnchecked(i) * b2 * b2 + h2->GetBinErrorSqUnchecked(i) * b1 * b1);
+   Double_t *cont = TH1ArrayHelper::GetArray<Double_t, TArrayD>(this);
+   const Double_t *cont1 = TH1ArrayHelper::GetArray<Double_t, TArrayD>(h1);
+   const Double_t *cont2 = TH1ArrayHelper::GetArray<Double_t, TArrayD>(h2);
+   if (cont && cont1 && cont2) {
+      // directly on the arrays of TH1D, TH2D and TH3D
+      Double_t *sumw2 = fSumw2.fN ? fSumw2.fArray : nullptr;
+      const Double_t *err1sq = h1->fSumw2.fN ? h1->fSumw2.fArray : cont1;
+      const Double_t *err2sq = h2->fSumw2.fN ? h2->fSumw2.fArray : cont2;
+      TH1ArrayHelper::ForEachRange(fNcells, 1, [&](Long64_t begin, Long64_t end) {
+         if (sumw2) {
+            for (Long64_t i = begin; i < end; ++i) {
+               const Double_t b1 = cont1[i];
+               const Double_t b2 = cont2[i];
+               const Double_t e1sq = err1sq[i];
+               const Double_t e2sq = err2sq[i];
+               cont[i] = c1 * b1 * c2 * b2;
+               sumw2[i] = c1sq * c2sq * (e1sq * b2 * b2 + e2sq * b1 * b1);
+            }
+         } else {
+            for (Long64_t i = begin; i < end; ++i)
+               cont[i] = c1 * cont1[i] * c2 * cont2[i];
+         }
+      });
+   } else {
+      for (Int_t i = 0; i < fNcells; ++i) {
+         Double_t b1 = h1->RetrieveBinContent(i);
+         Double_t b2 = h2->RetrieveBinContent(i);
+         UpdateBinContent(i, c1 * b1 * c2 * b2);
+         if (fSumw2.fN) {
+            fSumw2.fArray[i] = c1sq * c2sq * (h1->GetBinErrorSqUnchecked(i) * b2 * b2 + h2->GetBinErrorSqUnchecked(i) * b1 * b1);
+         }
       }
    }
    ResetStats();
@@ -6644,6 +6885,18 @@ void TH1::SetDefaultSumw2(Bool_t sumw2)
    fgDefaultSumw2 = sumw2;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Static function to set the minimal number of bins above which Add(),
+/// Multiply(), Divide(), the projections and the rebinning of the TH2 and TH3
+/// and the projections of the THn run on many threads, when implicit
+/// multi-threading is enabled (see ROOT::EnableImplicitMT()). The results
+/// do not depend on the number of threads.
+
+void TH1::SetParallelThreshold(Int_t nbins)
+{
+   fgParallelThreshold = nbins > 0 ? nbins : 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Change (i.e. set) the title
 ///
@@ -0,0 +1,144 @@
+// @(#)root/hist:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2021, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+// Helper functions working directly on the bin arrays of the histograms,
+// on many threads for large histograms, instead of bin by bin through the
+// virtual bin accessors.
+
+#ifndef ROOT_TH1ArrayHelper
+#define ROOT_TH1ArrayHelper
+
+#include "TH1.h"
+#include "TH2.h"
+#include "TH3.h"
+#include "TClass.h"
+#include "TROOT.h"
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
+namespace TH1ArrayHelper {
+
+/// Minimal number of bins processed by a task.
+const Long64_t kMinBinsPerTask = 16384;
+
+/// Return the bin contents of histograms storing them in a TArrayT, i.e. the
+/// TH1, TH2 and TH3 of type T; nullptr for the other classes (profiles, TH1K, ...)
+template <typename T, typename TArrayT>
+T *GetArray(const TH1 *h)
+{
+   TClass *cl = h->IsA();
+   if (std::is_same<TArrayT, TArrayD>::value) {
+      if (cl != TH1D::Class() && cl != TH2D::Class() && cl != TH3D::Class())
+         return nullptr;
+   } else if (cl != TH1F::Class() && cl != TH2F::Class() && cl != TH3F::Class()) {
+      return nullptr;
+   }
+   return dynamic_cast<const TArrayT *>(h)->fArray;
+}
+
+/// Call func(begin, end) on consecutive ranges covering [0, n), each of the n
+/// elements standing for nbins bins of work: on many threads if implicit
+/// multi-threading is enabled and the total number of bins is at least
+/// TH1::GetParallelThreshold(), else once for [0, n). The ranges are disjoint,
+/// so func can write to the elements of its range without synchronization.
+template <typename FUNC>
+void ForEachRange(Long64_t n, Long64_t nbins, FUNC &&func)
+{
+#ifdef R__USE_IMT
+   const Long64_t nmin = std::max<Long64_t>(1, kMinBinsPerTask / std::max<Long64_t>(nbins, 1));
+   if (ROOT::IsImplicitMTEnabled() && n * nbins >= TH1::GetParallelThreshold() && n >= 2 * nmin) {
+      const Long64_t ntasks = std::min<Long64_t>(4 * ROOT::GetThreadPoolSize(), n / nmin);
+      ROOT::TThreadExecutor pool;
+      pool.Foreach([&](Int_t task) { func(n * task / ntasks, n * (task + 1) / ntasks); }, ROOT::TSeqI(ntasks));
+      return;
+   }
+#else
+   (void)nbins;
+#endif
+   func(Long64_t(0), n);
+}
+
+/// Offsets in the bin array of the bins first to last of an axis with nbins
+/// bins, for consecutive bins stride cells apart. The bins outside of the axis
+/// are clamped to the underflow and overflow bins, as in TH1::GetBin().
+inline std::vector<Int_t> GetBinOffsets(Int_t first, Int_t last, Int_t nbins, Int_t stride)
+{
+   std::vector<Int_t> offsets;
+   for (Int_t bin = first; bin <= last; ++bin)
+      offsets.push_back(std::min(std::max(bin, 0), nbins + 1) * stride);
+   return offsets;
+}
+
+template <typename T>
+void ProjectBinsImpl(const T *contents, const Double_t *sumw2, const std::vector<Int_t> &offsets1,
+                     const std::vector<Int_t> &offsets2, const std::vector<Int_t> &sumOffsets, Double_t *cont,
+                     Double_t *err2)
+{
+   const Long64_t n2 = offsets2.size();
+   auto projectRange = [&](Long64_t begin, Long64_t end) {
+      for (Long64_t i = begin; i < end; ++i) {
+         Double_t *rowCont = cont + i * n2;
+         Double_t *rowErr2 = err2 ? err2 + i * n2 : nullptr;
+         std::fill(rowCont, rowCont + n2, 0.);
+         if (rowErr2)
+            std::fill(rowErr2, rowErr2 + n2, 0.);
+         for (Int_t sumOffset : sumOffsets) {
+            const Int_t offset = offsets1[i] + sumOffset;
+            const T *in = contents + offset;
+            for (Long64_t j = 0; j < n2; ++j)
+               rowCont[j] += in[offsets2[j]];
+            if (!rowErr2)
+               continue;
+            if (sumw2) {
+               const Double_t *in2 = sumw2 + offset;
+               for (Long64_t j = 0; j < n2; ++j)
+                  rowErr2[j] += in2[offsets2[j]];
+            } else {
+               for (Long64_t j = 0; j < n2; ++j)
+                  rowErr2[j] += std::abs(Double_t(in[offsets2[j]]));
+            }
+         }
+      }
+   };
+   ForEachRange(offsets1.size(), n2 * sumOffsets.size(), projectRange);
+}
+
+/// Sum bins of h over some of its axes, for the projections: set
+/// `cont[i * n2 + j]`, n2 being the size of offsets2, to the sum over k of the
+/// contents of the bins `offsets1[i] + offsets2[j] + sumOffsets[k]`, added in
+/// the order of k, and `err2[i * n2 + j]` (if err2 is not nullptr) to the sum
+/// of their squared errors. Return kFALSE, without computing anything, if the
+/// bins of h cannot be accessed directly.
+inline Bool_t ProjectBins(const TH1 &h, const std::vector<Int_t> &offsets1, const std::vector<Int_t> &offsets2,
+                          const std::vector<Int_t> &sumOffsets, Double_t *cont, Double_t *err2)
+{
+   if (h.GetBuffer())
+      return kFALSE;
+   const Double_t *sumw2 = h.GetSumw2N() ? h.GetSumw2()->GetArray() : nullptr;
+   if (const Double_t *contents = GetArray<Double_t, TArrayD>(&h)) {
+      ProjectBinsImpl(contents, sumw2, offsets1, offsets2, sumOffsets, cont, err2);
+      return kTRUE;
+   }
+   if (const Float_t *contents = GetArray<Float_t, TArrayF>(&h)) {
+      ProjectBinsImpl(contents, sumw2, offsets1, offsets2, sumOffsets, cont, err2);
+      return kTRUE;
+   }
+   return kFALSE;
+}
+
+} // namespace TH1ArrayHelper
+
+#endif
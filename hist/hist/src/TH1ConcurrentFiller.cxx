@@ -0,0 +1,435 @@
+// @(#)root/hist:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2021, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "TH1ConcurrentFiller.h"
+#include "TH3.h"
+#include "TProfile.h"
+#include "TProfile2D.h"
+#include "TError.h"
+#include "TROOT.h"
+
+#include <algorithm>
+#include <thread>
+
+/** \class TH1ConcurrentFiller
+Fill a TH1, TH2 or TH3 from many threads without locks.
+
+Each thread filling through the filler gets a slot, i.e. its own copy
+("shard") of the bin contents, sums of squares of weights and statistics,
+padded not to share cache lines with the other shards. Filling only touches the thread's shard, so no
+synchronization is needed and threads do not invalidate each other's
+caches. The shards are added to the histogram by Flush(), which is also
+called by GetHistogram() and by the destructor:
+
+~~~ {.cpp}
+TH1D h("h", "h", 100, -5, 5);
+{
+   TH1ConcurrentFiller filler(h);
+   ROOT::TThreadExecutor pool;
+   pool.Foreach([&](int i) { filler.Fill(Generate(i)); }, ROOT::TSeqI(1000000));
+} // the filler adds all the entries to h
+h.Draw();
+~~~
+
+For large histograms a shard per thread can take too much memory: in mode
+EMode::kAuto (the default) the filler switches to EMode::kAtomic when the
+shards would need more than GetMaxShardBytes() (64 MB by default), where
+all the threads add to a single copy of the contents with atomic
+operations. The statistics stay per thread in both modes. Threads in
+excess of the number of slots also use the atomic contents.
+
+The Fill() calls follow the TH1 interface: Fill(x, w) fills a TH1 with
+weight w and a TH2 with (x, y); Fill(x, y, w) fills a TH2 with weight w
+and a TH3 with (x, y, z). Flush() must not run concurrently with Fill(),
+and the histogram must not be filled directly while the filler is in use.
+The axes of the histogram are not extended: the entries outside of the
+axes go to the underflow and overflow bins. Profiles, TH2Poly and TH1K,
+whose Fill() is not a plain addition, are filled under a lock.
+*/
+
+Long64_t TH1ConcurrentFiller::fgMaxShardBytes = 64 * 1024 * 1024;
+
+namespace {
+
+std::atomic<ULong64_t> gNextFillerId{1};
+std::atomic<ULong64_t> gNextThreadToken{1};
+
+/// Unique token of the calling thread, never reused.
+ULong64_t GetThreadToken()
+{
+   thread_local ULong64_t token = gNextThreadToken++;
+   return token;
+}
+
+/// Slots of the last fillers used by a thread.
+struct SlotCache {
+   static constexpr int kSize = 4;
+   ULong64_t fFiller[kSize] = {0, 0, 0, 0};
+   Int_t fSlot[kSize] = {-1, -1, -1, -1};
+   int fNext = 0;
+};
+
+thread_local SlotCache gSlotCache;
+
+inline void AtomicAdd(std::atomic<Double_t> &a, Double_t v)
+{
+   Double_t old = a.load(std::memory_order_relaxed);
+   while (!a.compare_exchange_weak(old, old + v, std::memory_order_relaxed))
+      ;
+}
+
+} // anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+/// Prepare the concurrent filling of hist.
+///
+/// \param[in] hist Histogram to fill, it must outlive the filler.
+/// \param[in] nslots Number of threads with their own shard. If 0, the size of
+///            the implicit multi-threading pool, or the number of cores if
+///            implicit multi-threading is disabled.
+/// \param[in] mode See EMode.
+///
+/// The buffer of hist, if any, is emptied and deleted, and its axes are
+/// made not extendable.
+
+TH1ConcurrentFiller::TH1ConcurrentFiller(TH1 &hist, UInt_t nslots, EMode mode)
+   : fHist(&hist), fMode(mode), fId(gNextFillerId++), fNcells(hist.GetNcells()), fStatOverflows(kFALSE),
+     fTrackSumw2(hist.GetSumw2N() > 0), fLocked(kFALSE)
+{
+   for (auto &s : fAtomicStats)
+      s = 0;
+   fAtomicEntries = 0;
+   fAtomicWeighted = kFALSE;
+
+   if (hist.InheritsFrom("TProfile") || hist.InheritsFrom("TProfile2D") || hist.InheritsFrom("TProfile3D") ||
+       hist.InheritsFrom("TH2Poly") || hist.InheritsFrom("TH1K")) {
+      fLocked = kTRUE;
+      fMode = EMode::kAtomic;
+      return;
+   }
+
+   if (hist.GetBuffer())
+      hist.BufferEmpty(1);
+   if (hist.GetXaxis()->CanExtend() || hist.GetYaxis()->CanExtend() || hist.GetZaxis()->CanExtend()) {
+      ::Warning("TH1ConcurrentFiller::TH1ConcurrentFiller",
+                "the axes of %s cannot be extended during a concurrent filling", hist.GetName());
+      hist.SetCanExtend(TH1::kNoAxis);
+   }
+   fStatOverflows = hist.GetStatOverflowsBehaviour();
+
+   if (nslots == 0)
+      nslots = ROOT::IsImplicitMTEnabled() ? ROOT::GetThreadPoolSize() : std::thread::hardware_concurrency();
+   if (nslots == 0)
+      nslots = 1;
+   if (fMode == EMode::kAuto)
+      fMode = (Long64_t)(sizeof(Double_t) * nslots * fNcells) <= fgMaxShardBytes ? EMode::kSharded : EMode::kAtomic;
+
+   fShards.resize(nslots);
+   fOwners.reset(new std::atomic<ULong64_t>[nslots]);
+   for (UInt_t i = 0; i < nslots; ++i) {
+      fOwners[i] = 0;
+      std::fill(fShards[i].fStats, fShards[i].fStats + TH1::kNstat, 0.);
+      fShards[i].fEntries = 0;
+   }
+   if (fMode == EMode::kAtomic)
+      std::call_once(fAtomicInit, &TH1ConcurrentFiller::InitAtomic, this);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add the entries filled so far to the histogram.
+
+TH1ConcurrentFiller::~TH1ConcurrentFiller()
+{
+   Flush();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Allocate the contents shared by all the threads.
+
+void TH1ConcurrentFiller::InitAtomic()
+{
+   fAtomicSumw.reset(new std::atomic<Double_t>[fNcells]);
+   fAtomicSumw2.reset(new std::atomic<Double_t>[fNcells]);
+   for (Int_t bin = 0; bin < fNcells; ++bin) {
+      fAtomicSumw[bin] = 0;
+      fAtomicSumw2[bin] = 0;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the slot owned by the calling thread, claiming a free one if needed,
+/// or -1 if all the slots are taken by other threads.
+
+Int_t TH1ConcurrentFiller::GetSlot()
+{
+   SlotCache &cache = gSlotCache;
+   for (int i = 0; i < SlotCache::kSize; ++i) {
+      if (cache.fFiller[i] == fId)
+         return cache.fSlot[i];
+   }
+
+   const ULong64_t token = GetThreadToken();
+   const Int_t nslots = fShards.size();
+   Int_t slot = -1;
+   for (Int_t i = 0; i < nslots && slot < 0; ++i) {
+      if (fOwners[i].load(std::memory_order_relaxed) == token)
+         slot = i;
+   }
+   for (Int_t i = 0; i < nslots && slot < 0; ++i) {
+      ULong64_t owner = 0;
+      if (fOwners[i].compare_exchange_strong(owner, token))
+         slot = i;
+   }
+   if (slot < 0)
+      std::call_once(fAtomicInit, &TH1ConcurrentFiller::InitAtomic, this);
+
+   cache.fFiller[cache.fNext] = fId;
+   cache.fSlot[cache.fNext] = slot;
+   cache.fNext = (cache.fNext + 1) % SlotCache::kSize;
+   return slot;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill the entry of coordinates v[0], ..., v[nvars-1] with weight w in the
+/// shard of the calling thread. Return the global bin, as TH1::Fill.
+
+Int_t TH1ConcurrentFiller::DoFill(Int_t nvars, const Double_t *v, Double_t w)
+{
+   const TAxis *axes[3] = {fHist->GetXaxis(), fHist->GetYaxis(), fHist->GetZaxis()};
+   Int_t bin = 0;
+   Int_t stride = 1;
+   Bool_t inRange = kTRUE;
+   for (Int_t i = 0; i < nvars; ++i) {
+      const Int_t nbins = axes[i]->GetNbins();
+      const Int_t b = axes[i]->FindFixBin(v[i]);
+      inRange &= b > 0 && b <= nbins;
+      bin += stride * b;
+      stride *= nbins + 2;
+   }
+
+   const Int_t slot = GetSlot();
+   Double_t *stats;
+   if (slot >= 0) {
+      Shard &shard = fShards[slot];
+      ++shard.fEntries;
+      stats = shard.fStats;
+      if (fMode == EMode::kSharded) {
+         if (shard.fSumw.empty()) {
+            shard.fSumw.resize(fNcells);
+            if (fTrackSumw2)
+               shard.fSumw2.resize(fNcells);
+         }
+         // Until the first weight != 1 the sums of squares of weights equal the sums of weights.
+         if (shard.fSumw2.empty() && w != 1. && !fHist->TestBit(TH1::kIsNotW))
+            shard.fSumw2 = shard.fSumw;
+         shard.fSumw[bin] += w;
+         if (!shard.fSumw2.empty())
+            shard.fSumw2[bin] += w * w;
+      } else {
+         AtomicAdd(fAtomicSumw[bin], w);
+         AtomicAdd(fAtomicSumw2[bin], w * w);
+         if (w != 1. && !fAtomicWeighted.load(std::memory_order_relaxed) && !fHist->TestBit(TH1::kIsNotW))
+            fAtomicWeighted = kTRUE;
+      }
+      if (!inRange && !fStatOverflows)
+         return -1;
+   } else {
+      AtomicAdd(fAtomicEntries, 1);
+      AtomicAdd(fAtomicSumw[bin], w);
+      AtomicAdd(fAtomicSumw2[bin], w * w);
+      if (w != 1. && !fAtomicWeighted.load(std::memory_order_relaxed) && !fHist->TestBit(TH1::kIsNotW))
+         fAtomicWeighted = kTRUE;
+      if (!inRange && !fStatOverflows)
+         return -1;
+      Double_t s[TH1::kNstat] = {0};
+      s[0] = w;
+      s[1] = w * w;
+      s[2] = w * v[0];
+      s[3] = w * v[0] * v[0];
+      if (nvars > 1) {
+         s[4] = w * v[1];
+         s[5] = w * v[1] * v[1];
+         s[6] = w * v[0] * v[1];
+      }
+      if (nvars > 2) {
+         s[7] = w * v[2];
+         s[8] = w * v[2] * v[2];
+         s[9] = w * v[0] * v[2];
+         s[10] = w * v[1] * v[2];
+      }
+      for (Int_t i = 0; i < 11; ++i)
+         AtomicAdd(fAtomicStats[i], s[i]);
+      return bin;
+   }
+
+   stats[0] += w;
+   stats[1] += w * w;
+   stats[2] += w * v[0];
+   stats[3] += w * v[0] * v[0];
+   if (nvars > 1) {
+      stats[4] += w * v[1];
+      stats[5] += w * v[1] * v[1];
+      stats[6] += w * v[0] * v[1];
+   }
+   if (nvars > 2) {
+      stats[7] += w * v[2];
+      stats[8] += w * v[2] * v[2];
+      stats[9] += w * v[0] * v[2];
+      stats[10] += w * v[1] * v[2];
+   }
+   return bin;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Forward a call to Fill with nargs arguments to the histogram, under a lock.
+
+Int_t TH1ConcurrentFiller::LockedFill(Int_t nargs, Double_t x, Double_t y, Double_t z, Double_t w)
+{
+   std::lock_guard<std::mutex> lock(fLockedMutex);
+   switch (nargs) {
+   case 1: return fHist->Fill(x);
+   case 2: return fHist->Fill(x, y);
+   case 3:
+      if (fHist->GetDimension() == 1)
+         return static_cast<TProfile *>(fHist)->Fill(x, y, z);
+      if (fHist->GetDimension() == 2)
+         return static_cast<TH2 *>(fHist)->Fill(x, y, z);
+      return static_cast<TH3 *>(fHist)->Fill(x, y, z);
+   default:
+      if (fHist->GetDimension() == 2)
+         return static_cast<TProfile2D *>(fHist)->Fill(x, y, z, w);
+      return static_cast<TH3 *>(fHist)->Fill(x, y, z, w);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill x in a TH1 with weight 1.
+
+Int_t TH1ConcurrentFiller::Fill(Double_t x)
+{
+   if (fLocked)
+      return LockedFill(1, x, 0, 0, 0);
+   return DoFill(1, &x, 1.);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill x with weight y in a TH1, or (x, y) with weight 1 in a TH2.
+
+Int_t TH1ConcurrentFiller::Fill(Double_t x, Double_t y)
+{
+   if (fLocked)
+      return LockedFill(2, x, y, 0, 0);
+   const Double_t v[2] = {x, y};
+   return fHist->GetDimension() == 1 ? DoFill(1, v, y) : DoFill(2, v, 1.);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill (x, y) with weight z in a TH2, or (x, y, z) with weight 1 in a TH3.
+
+Int_t TH1ConcurrentFiller::Fill(Double_t x, Double_t y, Double_t z)
+{
+   if (fLocked)
+      return LockedFill(3, x, y, z, 0);
+   const Double_t v[3] = {x, y, z};
+   return fHist->GetDimension() == 2 ? DoFill(2, v, z) : DoFill(3, v, 1.);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill (x, y, z) with weight w in a TH3.
+
+Int_t TH1ConcurrentFiller::Fill(Double_t x, Double_t y, Double_t z, Double_t w)
+{
+   if (fLocked)
+      return LockedFill(4, x, y, z, w);
+   const Double_t v[3] = {x, y, z};
+   return DoFill(3, v, w);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add the contents and statistics of all the shards to the histogram and
+/// reset them. Must not be called while other threads are filling.
+
+void TH1ConcurrentFiller::Flush()
+{
+   if (fLocked)
+      return;
+
+   Double_t entries = 0;
+   Bool_t needSumw2 = fAtomicWeighted;
+   for (auto &shard : fShards) {
+      entries += shard.fEntries;
+      needSumw2 |= !shard.fSumw2.empty();
+   }
+   entries += fAtomicEntries;
+   if (entries == 0)
+      return;
+
+   Double_t stats[TH1::kNstat];
+   fHist->GetStats(stats);
+   if (needSumw2 && !fHist->GetSumw2N())
+      fHist->Sumw2();
+   fTrackSumw2 = fHist->GetSumw2N() > 0;
+   Double_t *sumw2 = fTrackSumw2 ? fHist->GetSumw2()->GetArray() : nullptr;
+
+   for (auto &shard : fShards) {
+      if (!shard.fEntries)
+         continue;
+      for (Int_t bin = 0; bin < (Int_t)shard.fSumw.size(); ++bin) {
+         const Double_t sumw = shard.fSumw[bin];
+         if (sumw == 0 && (shard.fSumw2.empty() || shard.fSumw2[bin] == 0))
+            continue;
+         fHist->AddBinContent(bin, sumw);
+         if (sumw2)
+            sumw2[bin] += shard.fSumw2.empty() ? sumw : shard.fSumw2[bin];
+         shard.fSumw[bin] = 0;
+         if (!shard.fSumw2.empty())
+            shard.fSumw2[bin] = 0;
+      }
+      for (Int_t i = 0; i < TH1::kNstat; ++i) {
+         stats[i] += shard.fStats[i];
+         shard.fStats[i] = 0;
+      }
+      shard.fEntries = 0;
+   }
+
+   if (fAtomicSumw) {
+      for (Int_t bin = 0; bin < fNcells; ++bin) {
+         const Double_t sumw = fAtomicSumw[bin].exchange(0);
+         const Double_t sumw2bin = fAtomicSumw2[bin].exchange(0);
+         if (sumw != 0)
+            fHist->AddBinContent(bin, sumw);
+         if (sumw2)
+            sumw2[bin] += sumw2bin;
+      }
+      for (Int_t i = 0; i < TH1::kNstat; ++i)
+         stats[i] += fAtomicStats[i].exchange(0);
+      fAtomicEntries = 0;
+   }
+
+   fHist->PutStats(stats);
+   fHist->SetEntries(fHist->GetEntries() + entries);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the maximum size of the shards of all the threads, above which
+/// the mode EMode::kAuto uses atomic operations.
+
+Long64_t TH1ConcurrentFiller::GetMaxShardBytes()
+{
+   return fgMaxShardBytes;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Set the maximum size of the shards, see GetMaxShardBytes().
+
+void TH1ConcurrentFiller::SetMaxShardBytes(Long64_t bytes)
+{
+   fgMaxShardBytes = bytes;
+}
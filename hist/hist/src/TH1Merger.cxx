@@ -1,6 +1,7 @@
 // Helper clas implementing some of the TH1 functionality
 
 #include "TH1Merger.h"
+#include "TH1ArrayHelper.h"
 #include "TH1.h"
 #include "TH2.h"
 #include "TH3.h"
@@ -8,6 +9,12 @@
 #include "TError.h"
 #include "THashList.h"
 #include "TClass.h"
+#include "TObjString.h"
+#include "TROOT.h"
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#endif
+#include <algorithm>
 #include <iostream>
 #include <limits>
 #include <utility>
@@ -36,8 +43,9 @@ Bool_t TH1Merger::operator() () {
    if (type == kAllSameAxes)
       return SameAxesMerge();
 
+   // identical labelled axes do not need the label lookup of each bin
    if (type == kAllLabel)
-      return LabelMerge();
+      return HaveSameAxesAndLabels() ? SameAxesMerge() : LabelMerge();
 
    if (type == kAllNoLimits)
       return BufferMerge();
@@ -793,6 +801,7 @@ Bool_t TH1Merger::SameAxesMerge() {
    fH0->GetStats(totstats);
    Double_t nentries = fH0->GetEntries();
 
+   std::vector<const TH1 *> hists;
    TIter next(&fInputList);
    while (TH1* hist=(TH1*)next()) {
       // process only if the histogram has limits; otherwise it was processed before
@@ -810,10 +819,15 @@ Bool_t TH1Merger::SameAxesMerge() {
          totstats[i] += stats[i];
       nentries += hist->GetEntries();
 
-         //Int_t nx = hist->GetXaxis()->GetNbins();
+      hists.push_back(hist);
+   }
+
+   if (!AddArrays(hists)) {
+      for (auto hist : hists) {
          // loop on bins of the histogram and do the merge
-      for (Int_t ibin = 0; ibin < hist->fNcells; ibin++) {
-         MergeBin(hist, ibin, ibin);
+         for (Int_t ibin = 0; ibin < hist->fNcells; ibin++) {
+            MergeBin(hist, ibin, ibin);
+         }
       }
    }
    //copy merged stats
@@ -823,6 +837,138 @@ Bool_t TH1Merger::SameAxesMerge() {
    return kTRUE;
 }
 
+namespace {
+
+using TH1ArrayHelper::GetArray;
+
+/// Add the bins [begin, end) of the arrays `in` to `out`; the loop is vectorized by the compiler.
+template <typename T>
+void AddBinRange(T *out, const std::vector<const T *> &in, Int_t begin, Int_t end)
+{
+   for (auto array : in) {
+      for (Int_t i = begin; i < end; ++i)
+         out[i] += array[i];
+   }
+}
+
+/// Same as AddBinRange, for the sum of weight squares: histograms without one contribute their contents.
+template <typename T>
+void AddSumw2Range(Double_t *out, const std::vector<const Double_t *> &sumw2, const std::vector<const T *> &contents,
+                   Int_t begin, Int_t end)
+{
+   for (std::size_t h = 0; h < sumw2.size(); ++h) {
+      if (sumw2[h]) {
+         const Double_t *array = sumw2[h];
+         for (Int_t i = begin; i < end; ++i)
+            out[i] += array[i];
+      } else {
+         const T *array = contents[h];
+         for (Int_t i = begin; i < end; ++i)
+            out[i] += array[i];
+      }
+   }
+}
+
+template <typename T, typename TArrayT>
+Bool_t AddArraysImpl(TH1 *h0, const std::vector<const TH1 *> &hists, TArrayD &h0Sumw2)
+{
+   T *out = GetArray<T, TArrayT>(h0);
+   if (!out)
+      return kFALSE;
+   std::vector<const T *> contents;
+   std::vector<const Double_t *> sumw2;
+   for (auto hist : hists) {
+      if (hist->IsA() != h0->IsA())
+         return kFALSE;
+      contents.push_back(GetArray<T, TArrayT>(hist));
+      sumw2.push_back(hist->GetSumw2N() ? hist->GetSumw2()->GetArray() : nullptr);
+   }
+
+   const Int_t ncells = h0->GetNcells();
+   auto addRange = [&](Int_t begin, Int_t end) {
+      AddBinRange(out, contents, begin, end);
+      if (h0Sumw2.fN)
+         AddSumw2Range(h0Sumw2.fArray, sumw2, contents, begin, end);
+   };
+
+#ifdef R__USE_IMT
+   // Large merges are split in ranges of bins: each bin is still summed in the order of the
+   // inputs, so the result does not depend on the number of threads.
+   const Long64_t kMinBinsPerTask = 16384;
+   const Long64_t kMinWork = 1 << 20;
+   if (ROOT::IsImplicitMTEnabled() && Long64_t(ncells) * hists.size() >= kMinWork && ncells >= 2 * kMinBinsPerTask) {
+      const Int_t ntasks = std::min<Long64_t>(4 * ROOT::GetThreadPoolSize(), ncells / kMinBinsPerTask);
+      ROOT::TThreadExecutor pool;
+      pool.Foreach([&](Int_t task) { addRange(Long64_t(ncells) * task / ntasks, Long64_t(ncells) * (task + 1) / ntasks); },
+                   ROOT::TSeqI(ntasks));
+      return kTRUE;
+   }
+#endif
+   addRange(0, ncells);
+   return kTRUE;
+}
+
+} // anonymous namespace
+
+/**
+   Sum the bin contents (and the sum of weight squares) of the histograms in
+   `hists` into fH0 array by array, instead of bin by bin through the virtual
+   bin accessors.
+   This is possible when fH0 and all the histograms have identical binning and
+   are of the same class, storing double or float contents. Return kFALSE, without
+   modifying fH0, if this is not the case.
+ */
+Bool_t TH1Merger::AddArrays(const std::vector<const TH1 *> &hists)
+{
+   if (fIsProfileMerge || hists.empty())
+      return kFALSE;
+   for (auto hist : hists) {
+      if (hist->fNcells != fH0->fNcells)
+         return kFALSE;
+   }
+   if (AddArraysImpl<Double_t, TArrayD>(fH0, hists, fH0->fSumw2))
+      return kTRUE;
+   return AddArraysImpl<Float_t, TArrayF>(fH0, hists, fH0->fSumw2);
+}
+
+/**
+   Return kTRUE if all the non-empty histograms have the same bins as fH0, and
+   the same labels on the same bins. In this case the label merge is equivalent
+   to a bin by bin merge.
+ */
+Bool_t TH1Merger::HaveSameAxesAndLabels()
+{
+   auto sameLabels = [](const TAxis &a1, const TAxis &a2) {
+      THashList *labels1 = a1.GetLabels();
+      THashList *labels2 = a2.GetLabels();
+      if (!labels1 || !labels2)
+         return labels1 == labels2;
+      if (labels1->GetSize() != labels2->GetSize() || HasDuplicateLabels(labels1))
+         return kFALSE;
+      TIter next1(labels1);
+      TIter next2(labels2);
+      while (auto label1 = static_cast<TObjString *>(next1())) {
+         auto label2 = static_cast<TObjString *>(next2());
+         if (label1->GetUniqueID() != label2->GetUniqueID() || label1->String() != label2->String())
+            return kFALSE;
+      }
+      return kTRUE;
+   };
+   auto sameAxis = [&](const TAxis &a1, const TAxis &a2) {
+      return TH1::SameLimitsAndNBins(a1, a2) && sameLabels(a1, a2);
+   };
+
+   TIter next(&fInputList);
+   while (TH1 *hist = (TH1 *)next()) {
+      if (hist->IsEmpty())
+         continue;
+      if (!sameAxis(fH0->fXaxis, hist->fXaxis) || !sameAxis(fH0->fYaxis, hist->fYaxis) ||
+          !sameAxis(fH0->fZaxis, hist->fZaxis))
+         return kFALSE;
+   }
+   return kTRUE;
+}
+
 
 /**
    Merged histogram when axis can be different.
@@ -0,0 +1,234 @@
+// @(#)root/hist:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2021, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "TH1Registry.h"
+#include "TList.h"
+#include "TString.h"
+#include "TError.h"
+
+#include "ROOT/RMakeUnique.hxx"
+
+#include <cstring>
+
+/** \class TH1Registry
+Registry of histograms by name for many threads, e.g. in online monitoring
+where thousands of histograms are created and looked up concurrently.
+
+Looking up a histogram with Get() takes no lock, and creating or adding
+one only locks one of 64 shards of the registry, selected by the hash of
+the name. Unlike with TDirectory, the histograms are not in a TList and
+do not need the global ROOT lock: the histograms created by GetOrCreate()
+or given to Add() are not attached to any directory. Creating histograms
+from several threads still requires ROOT::EnableThreadSafety() to be
+called first, as for any concurrent use of ROOT.
+
+~~~ {.cpp}
+ROOT::EnableThreadSafety();
+TH1Registry registry;
+// from any thread:
+auto h = registry.GetOrCreate<TH1D>("pt", "p_{T}", 100, 0., 50.);
+h->Fill(pt);                 // or through a TH1ConcurrentFiller
+// periodically, from a monitoring thread:
+registry.Write(file);        // writes copies of all the histograms
+~~~
+
+Histograms cannot be removed from the registry, which owns them by
+default. Snapshot() and Write() copy the histograms without stopping the
+threads filling them: a histogram filled during the copy may have the
+entries of an ongoing Fill() only partially included. The structure of
+the histograms (binning, Sumw2, buffer) must not change while they are
+copied.
+*/
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create a table with nslots empty slots, nslots being a power of 2.
+
+TH1Registry::Table::Table(UInt_t nslots) : fMask(nslots - 1), fSlots(new std::atomic<Entry *>[nslots])
+{
+   for (UInt_t i = 0; i < nslots; ++i)
+      fSlots[i].store(nullptr, std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create an empty registry. If owner is true, the registered histograms
+/// are deleted with the registry.
+
+TH1Registry::TH1Registry(Bool_t owner) : fSize(0), fOwner(owner)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Destructor, deletes the histograms if the registry owns them.
+
+TH1Registry::~TH1Registry()
+{
+   if (!fOwner)
+      return;
+   for (auto &shard : fShards) {
+      for (auto &entry : shard.fEntries)
+         delete entry->fHist;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Hash of a histogram name.
+
+UInt_t TH1Registry::Hash(const char *name)
+{
+   return TString::Hash(name, strlen(name));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Register hist under its name unless a histogram with that name is
+/// already registered, in which case that one is returned and inserted
+/// is set to false.
+
+TH1 *TH1Registry::Insert(TH1 *hist, Bool_t &inserted)
+{
+   const char *name = hist->GetName();
+   const UInt_t hash = Hash(name);
+   Shard &shard = GetShard(hash);
+
+   std::lock_guard<std::mutex> lock(shard.fMutex);
+   Table *table = shard.fTable.load(std::memory_order_relaxed);
+   const UInt_t start = hash / kNShards;
+   if (table) {
+      for (UInt_t i = start;; ++i) {
+         Entry *entry = table->fSlots[i & table->fMask].load(std::memory_order_relaxed);
+         if (!entry)
+            break;
+         if (entry->fHash == hash && entry->fName == name) {
+            inserted = kFALSE;
+            return entry->fHist;
+         }
+      }
+   }
+
+   // Keep the tables at most half full; readers may still use the replaced ones.
+   const UInt_t nentries = shard.fEntries.size() + 1;
+   if (!table || 2 * nentries > table->fMask + 1) {
+      const UInt_t nslots = table ? 2 * (table->fMask + 1) : 16;
+      auto newTable = std::make_unique<Table>(nslots);
+      for (auto &entry : shard.fEntries) {
+         UInt_t i = entry->fHash / kNShards;
+         while (newTable->fSlots[i & newTable->fMask].load(std::memory_order_relaxed))
+            ++i;
+         newTable->fSlots[i & newTable->fMask].store(entry.get(), std::memory_order_relaxed);
+      }
+      table = newTable.get();
+      shard.fTables.emplace_back(std::move(newTable));
+      shard.fTable.store(table, std::memory_order_release);
+   }
+
+   shard.fEntries.emplace_back(new Entry{name, hash, hist});
+   UInt_t i = start;
+   while (table->fSlots[i & table->fMask].load(std::memory_order_relaxed))
+      ++i;
+   table->fSlots[i & table->fMask].store(shard.fEntries.back().get(), std::memory_order_release);
+   ++fSize;
+   inserted = kTRUE;
+   return hist;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Register hist under its name and detach it from its directory.
+/// Returns false, leaving hist untouched, if a histogram with that name
+/// is already registered.
+
+Bool_t TH1Registry::Add(TH1 *hist)
+{
+   if (!hist)
+      return kFALSE;
+   Bool_t inserted = kFALSE;
+   Insert(hist, inserted);
+   if (inserted)
+      hist->SetDirectory(nullptr);
+   return inserted;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the histogram registered as name, nullptr if there is none.
+/// Takes no lock.
+
+TH1 *TH1Registry::Get(const char *name) const
+{
+   const UInt_t hash = Hash(name);
+   const Table *table = GetShard(hash).fTable.load(std::memory_order_acquire);
+   if (!table)
+      return nullptr;
+   for (UInt_t i = hash / kNShards;; ++i) {
+      const Entry *entry = table->fSlots[i & table->fMask].load(std::memory_order_acquire);
+      if (!entry)
+         return nullptr;
+      if (entry->fHash == hash && entry->fName == name)
+         return entry->fHist;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the registered histograms, shard by shard.
+
+std::vector<TH1 *> TH1Registry::GetHistograms() const
+{
+   std::vector<TH1 *> hists;
+   hists.reserve(fSize);
+   for (auto &shard : fShards) {
+      std::lock_guard<std::mutex> lock(shard.fMutex);
+      for (auto &entry : shard.fEntries)
+         hists.push_back(entry->fHist);
+   }
+   return hists;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Call func for each registered histogram. Histograms registered during
+/// the iteration may be missed. func can register histograms.
+
+void TH1Registry::ForEach(const std::function<void(TH1 &)> &func) const
+{
+   for (TH1 *hist : GetHistograms())
+      func(*hist);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return a list owning a copy of each registered histogram, not attached
+/// to any directory.
+
+TList *TH1Registry::Snapshot() const
+{
+   TList *list = new TList();
+   list->SetOwner();
+   TDirectory::TContext ctx(nullptr);
+   for (TH1 *hist : GetHistograms()) {
+      TH1 *copy = static_cast<TH1 *>(hist->Clone());
+      copy->SetDirectory(nullptr);
+      list->Add(copy);
+   }
+   return list;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write a copy of each registered histogram to dir, e.g. a TFile, with
+/// TDirectory::WriteTObject and the given option. The default "WriteDelete"
+/// replaces the previous cycle of the histograms written by an earlier call.
+/// Returns the total number of bytes written.
+
+Int_t TH1Registry::Write(TDirectory *dir, Option_t *option) const
+{
+   if (!dir) {
+      Error("TH1Registry::Write", "no directory to write to");
+      return 0;
+   }
+   std::unique_ptr<TList> snapshot(Snapshot());
+   Int_t nbytes = 0;
+   for (TObject *hist : *snapshot)
+      nbytes += dir->WriteTObject(hist, hist->GetName(), option);
+   return nbytes;
+}
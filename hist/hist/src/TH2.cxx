@@ -27,6 +27,9 @@
 #include "TObjArray.h"
 #include "TVirtualHistPainter.h"
 #include "snprintf.h"
+#include "TH1ArrayHelper.h"
+
+#include <algorithm>
 
 ClassImp(TH2);
 
@@ -563,6 +566,48 @@ void TH2::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double
          return;
    }
 
+   // Unless an axis can be extended, the bins of kFillBatchSize entries are found at once.
+   if (!fXaxis.CanExtend() && !fYaxis.CanExtend()) {
+      const Int_t nentries = (ntimes - ifirst) / stride;
+      x += ifirst;
+      y += ifirst;
+      if (w) w += ifirst;
+      fEntries += nentries;
+      CheckFillNWeights(nentries, w, stride);
+      const Bool_t statOverflows = GetStatOverflowsBehaviour();
+      const Int_t nx = fXaxis.GetNbins(), ny = fYaxis.GetNbins();
+      Double_t sumw = fTsumw, sumw2 = fTsumw2, sumwx = fTsumwx, sumwx2 = fTsumwx2;
+      Double_t sumwy = fTsumwy, sumwy2 = fTsumwy2, sumwxy = fTsumwxy;
+      Int_t binsx[kFillBatchSize], binsy[kFillBatchSize];
+      for (Int_t first = 0; first < nentries; first += kFillBatchSize) {
+         const Int_t n = std::min<Int_t>(kFillBatchSize, nentries - first);
+         const Double_t *xb = x + (Long64_t)first * stride;
+         const Double_t *yb = y + (Long64_t)first * stride;
+         const Double_t *wb = w ? w + (Long64_t)first * stride : nullptr;
+         fXaxis.FindFixBins(n, xb, binsx, stride);
+         fYaxis.FindFixBins(n, yb, binsy, stride);
+         for (i = 0; i < n; ++i) {
+            const Bool_t inRange = statOverflows || (binsx[i] > 0 && binsx[i] <= nx && binsy[i] > 0 && binsy[i] <= ny);
+            const Double_t z  = inRange ? (wb ? wb[i * stride] : 1.) : 0.;
+            const Double_t xx = inRange ? xb[i * stride] : 0.;
+            const Double_t yy = inRange ? yb[i * stride] : 0.;
+            sumw   += z;
+            sumw2  += z*z;
+            sumwx  += z*xx;
+            sumwx2 += z*xx*xx;
+            sumwy  += z*yy;
+            sumwy2 += z*yy*yy;
+            sumwxy += z*xx*yy;
+         }
+         for (i = 0; i < n; ++i)
+            binsx[i] += binsy[i] * (nx + 2);
+         DoFillBins(n, binsx, wb, stride);
+      }
+      fTsumw = sumw; fTsumw2 = sumw2; fTsumwx = sumwx; fTsumwx2 = sumwx2;
+      fTsumwy = sumwy; fTsumwy2 = sumwy2; fTsumwxy = sumwxy;
+      return;
+   }
+
    Double_t ww = 1;
    for (i=ifirst;i<ntimes;i+=stride) {
       fEntries++;
@@ -1723,21 +1768,25 @@ TH2 *TH2::Rebin2D(Int_t nxgroup, Int_t nygroup, const char *newname)
       }
 
       // (x, y): x - regular / overflow; y - regular / overflow
-      for (Int_t binx = 1, oldbinx = 1; binx < newnx; ++binx, oldbinx += nxgroup) {
-         for (Int_t biny = 1, oldbiny = 1; biny < newny; ++biny, oldbiny += nygroup) {
-            Double_t binContent = 0.0, binErrorSq = 0.0;
-            for (Int_t i = 0; i < nxgroup && (oldbinx + i) < nx; ++i) {
-               for (Int_t j = 0; j < nygroup && (oldbiny + j) < ny; ++j) {
-                  Int_t bin = oldbinx + i + (oldbiny + j) * nx;
-                  binContent += oldBins[bin];
-                  if (oldErrors) binErrorSq += oldErrors[bin];
+      // on many threads for large histograms, in ranges of new x bins
+      auto rebinRange = [&](Long64_t begin, Long64_t end) {
+         for (Int_t binx = 1 + begin, oldbinx = 1 + begin * nxgroup; binx < 1 + end; ++binx, oldbinx += nxgroup) {
+            for (Int_t biny = 1, oldbiny = 1; biny < newny; ++biny, oldbiny += nygroup) {
+               Double_t binContent = 0.0, binErrorSq = 0.0;
+               for (Int_t i = 0; i < nxgroup && (oldbinx + i) < nx; ++i) {
+                  for (Int_t j = 0; j < nygroup && (oldbiny + j) < ny; ++j) {
+                     Int_t bin = oldbinx + i + (oldbiny + j) * nx;
+                     binContent += oldBins[bin];
+                     if (oldErrors) binErrorSq += oldErrors[bin];
+                  }
                }
+               Int_t newbin = binx + biny * newnx;
+               hnew->UpdateBinContent(newbin, binContent);
+               if (oldErrors) hnew->fSumw2[newbin] = binErrorSq;
             }
-            Int_t newbin = binx + biny * newnx;
-            hnew->UpdateBinContent(newbin, binContent);
-            if (oldErrors) hnew->fSumw2[newbin] = binErrorSq;
          }
-      }
+      };
+      TH1ArrayHelper::ForEachRange(newnx - 1, Long64_t(nxgroup) * ny, rebinRange);
    }
 
    // Restore x axis attributes
@@ -2199,26 +2248,42 @@ TH1D *TH2::DoProjection(bool onX, const char *name, Int_t firstbin, Int_t lastbi
    // implement filling of projected histogram
    // outbin is bin number of outAxis (the projected axis). Loop is done on all bin of TH2 histograms
    // inbin is the axis being integrated. Loop is done only on the selected bins
-   for ( Int_t outbin = 0; outbin <= outAxis->GetNbins() + 1;  ++outbin) {
-      err2 = 0;
-      cont = 0;
-      if (outAxis->TestBit(TAxis::kAxisRange) && ( outbin < firstOutBin || outbin > lastOutBin )) continue;
-
-      for (Int_t inbin = firstbin ; inbin <= lastbin ; ++inbin) {
-         Int_t binx, biny;
-         if (onX) { binx = outbin; biny=inbin; }
-         else     { binx = inbin;  biny=outbin; }
-
-         if (ncuts) {
-            if (!fPainter->IsInside(binx,biny)) continue;
-         }
-         // sum bin content and error if needed
-         cont  += GetBinContent(binx,biny);
-         if (computeErrors) {
-            Double_t exy = GetBinError(binx,biny);
-            err2  += exy*exy;
+   Int_t outfirst = 0;
+   Int_t outlast = outAxis->GetNbins() + 1;
+   if (outAxis->TestBit(TAxis::kAxisRange)) { outfirst = firstOutBin; outlast = lastOutBin; }
+   const Int_t noutcells = outlast >= outfirst ? outlast - outfirst + 1 : 0;
+   std::vector<Double_t> conts(noutcells);
+   std::vector<Double_t> errs2(noutcells);
+
+   // sum directly the arrays of the TH2D and TH2F if there are no cuts
+   const Int_t outStride = onX ? 1 : fXaxis.GetNbins() + 2;
+   const Int_t inStride = onX ? fXaxis.GetNbins() + 2 : 1;
+   auto outOffsets = TH1ArrayHelper::GetBinOffsets(outfirst, outlast, outAxis->GetNbins(), outStride);
+   auto inOffsets = TH1ArrayHelper::GetBinOffsets(firstbin, lastbin, inAxis->GetNbins(), inStride);
+   Double_t *sumErrs2 = computeErrors ? errs2.data() : nullptr;
+   if (ncuts || !TH1ArrayHelper::ProjectBins(*this, outOffsets, {0}, inOffsets, conts.data(), sumErrs2)) {
+      for (Int_t outbin = outfirst; outbin <= outlast; ++outbin) {
+         for (Int_t inbin = firstbin ; inbin <= lastbin ; ++inbin) {
+            Int_t binx, biny;
+            if (onX) { binx = outbin; biny=inbin; }
+            else     { binx = inbin;  biny=outbin; }
+
+            if (ncuts) {
+               if (!fPainter->IsInside(binx,biny)) continue;
+            }
+            // sum bin content and error if needed
+            conts[outbin - outfirst] += GetBinContent(binx,biny);
+            if (computeErrors) {
+               Double_t exy = GetBinError(binx,biny);
+               errs2[outbin - outfirst] += exy*exy;
+            }
          }
       }
+   }
+
+   for (Int_t outbin = outfirst; outbin <= outlast; ++outbin) {
+      cont = conts[outbin - outfirst];
+      err2 = errs2[outbin - outfirst];
       // find corresponding bin number in h1 for outbin
       Int_t binOut = h1->GetXaxis()->FindBin( outAxis->GetBinCenter(outbin) );
       h1->SetBinContent(binOut ,cont);
@@ -24,6 +24,9 @@
 #include "TError.h"
 #include "TMath.h"
 #include "TObjString.h"
+#include "TH1ArrayHelper.h"
+
+#include <algorithm>
 
 ClassImp(TH3);
 
@@ -383,6 +386,81 @@ Int_t TH3::Fill(Double_t x, Double_t y, Double_t z, Double_t w)
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Fill a 3-D histogram with an array of values and weights.
+///
+///  - ntimes:  number of entries in arrays x, y, z and w (array size must be ntimes*stride)
+///  - x:       array of x values to be histogrammed
+///  - y:       array of y values to be histogrammed
+///  - z:       array of z values to be histogrammed
+///  - w:       array of weights
+///  - stride:  step size through arrays x, y, z and w
+///
+///   - If the weight is not equal to 1, the storage of the sum of squares of
+///     weights is automatically triggered and the sum of the squares of weights is incremented
+///     by w[i]^2 in the bin corresponding to x[i],y[i],z[i].
+///   - If w is NULL each entry is assumed a weight=1
+///
+/// Unless an axis can be extended, the bins of kFillBatchSize entries are found at once
+/// (see TAxis::FindFixBins), which is much faster than calling Fill for each entry.
+
+void TH3::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double_t *z, const Double_t *w, Int_t stride)
+{
+   Int_t i;
+   if (fBuffer || fXaxis.CanExtend() || fYaxis.CanExtend() || fZaxis.CanExtend()) {
+      for (i = 0; i < ntimes; ++i) {
+         const Long64_t k = (Long64_t)i * stride;
+         Fill(x[k], y[k], z[k], w ? w[k] : 1.);
+      }
+      return;
+   }
+
+   fEntries += ntimes;
+   CheckFillNWeights(ntimes, w, stride);
+   const Bool_t statOverflows = GetStatOverflowsBehaviour();
+   const Int_t nx = fXaxis.GetNbins(), ny = fYaxis.GetNbins(), nz = fZaxis.GetNbins();
+   Double_t sumw = fTsumw, sumw2 = fTsumw2;
+   Double_t sumwx = fTsumwx, sumwx2 = fTsumwx2, sumwy = fTsumwy, sumwy2 = fTsumwy2, sumwxy = fTsumwxy;
+   Double_t sumwz = fTsumwz, sumwz2 = fTsumwz2, sumwxz = fTsumwxz, sumwyz = fTsumwyz;
+   Int_t binsx[kFillBatchSize], binsy[kFillBatchSize], binsz[kFillBatchSize];
+   for (Int_t first = 0; first < ntimes; first += kFillBatchSize) {
+      const Int_t n = std::min<Int_t>(kFillBatchSize, ntimes - first);
+      const Double_t *xb = x + (Long64_t)first * stride;
+      const Double_t *yb = y + (Long64_t)first * stride;
+      const Double_t *zb = z + (Long64_t)first * stride;
+      const Double_t *wb = w ? w + (Long64_t)first * stride : nullptr;
+      fXaxis.FindFixBins(n, xb, binsx, stride);
+      fYaxis.FindFixBins(n, yb, binsy, stride);
+      fZaxis.FindFixBins(n, zb, binsz, stride);
+      for (i = 0; i < n; ++i) {
+         const Bool_t inRange = statOverflows || (binsx[i] > 0 && binsx[i] <= nx && binsy[i] > 0 &&
+                                                  binsy[i] <= ny && binsz[i] > 0 && binsz[i] <= nz);
+         const Double_t ww = inRange ? (wb ? wb[i * stride] : 1.) : 0.;
+         const Double_t xx = inRange ? xb[i * stride] : 0.;
+         const Double_t yy = inRange ? yb[i * stride] : 0.;
+         const Double_t zz = inRange ? zb[i * stride] : 0.;
+         sumw   += ww;
+         sumw2  += ww*ww;
+         sumwx  += ww*xx;
+         sumwx2 += ww*xx*xx;
+         sumwy  += ww*yy;
+         sumwy2 += ww*yy*yy;
+         sumwxy += ww*xx*yy;
+         sumwz  += ww*zz;
+         sumwz2 += ww*zz*zz;
+         sumwxz += ww*xx*zz;
+         sumwyz += ww*yy*zz;
+      }
+      for (i = 0; i < n; ++i)
+         binsx[i] += (nx + 2) * (binsy[i] + (ny + 2) * binsz[i]);
+      DoFillBins(n, binsx, wb, stride);
+   }
+   fTsumw = sumw; fTsumw2 = sumw2;
+   fTsumwx = sumwx; fTsumwx2 = sumwx2; fTsumwy = sumwy; fTsumwy2 = sumwy2; fTsumwxy = sumwxy;
+   fTsumwz = sumwz; fTsumwz2 = sumwz2; fTsumwxz = sumwxz; fTsumwyz = sumwyz;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Increment cell defined by namex,namey,namez by a weight w
 ///
@@ -1930,32 +2008,54 @@ TH1D *TH3::DoProject1D(const char* name, const char * title, const TAxis* projX,
    if (useUF && !out2->TestBit(TAxis::kAxisRange) )  out2min -= 1;
    if (useOF && !out2->TestBit(TAxis::kAxisRange) )  out2max += 1;
 
-   for (ixbin=0;ixbin<=1+projX->GetNbins();ixbin++) {
-      if ( projX->TestBit(TAxis::kAxisRange) && ( ixbin < ixmin || ixbin > ixmax )) continue;
-
-      Double_t cont = 0;
-      Double_t err2 = 0;
+   Int_t ixfirst = 0;
+   Int_t ixlast = 1 + projX->GetNbins();
+   if (projX->TestBit(TAxis::kAxisRange)) { ixfirst = ixmin; ixlast = ixmax; }
+   const Int_t nxcells = ixlast >= ixfirst ? ixlast - ixfirst + 1 : 0;
+   std::vector<Double_t> conts(nxcells);
+   std::vector<Double_t> errs2(nxcells);
+
+   // sum directly the arrays of the TH3D and TH3F, with the bins to be integrated in the same order as below
+   const Int_t strides[3] = {1, fXaxis.GetNbins() + 2, (fXaxis.GetNbins() + 2) * (fYaxis.GetNbins() + 2)};
+   const Int_t projStride = strides[refX == &ixbin ? 0 : (refY == &ixbin ? 1 : 2)];
+   const Int_t out1Stride = strides[refX == &out1bin ? 0 : (refY == &out1bin ? 1 : 2)];
+   const Int_t out2Stride = strides[refX == &out2bin ? 0 : (refY == &out2bin ? 1 : 2)];
+   std::vector<Int_t> sumOffsets;
+   for (Int_t out1Offset : TH1ArrayHelper::GetBinOffsets(out1min, out1max, out1->GetNbins(), out1Stride)) {
+      for (Int_t out2Offset : TH1ArrayHelper::GetBinOffsets(out2min, out2max, out2->GetNbins(), out2Stride))
+         sumOffsets.push_back(out1Offset + out2Offset);
+   }
+   auto projOffsets = TH1ArrayHelper::GetBinOffsets(ixfirst, ixlast, projX->GetNbins(), projStride);
+   Double_t *sumErrs2 = computeErrors ? errs2.data() : nullptr;
+   if (!TH1ArrayHelper::ProjectBins(*this, projOffsets, {0}, sumOffsets, conts.data(), sumErrs2)) {
+      for (ixbin = ixfirst; ixbin <= ixlast; ixbin++) {
+         Double_t &cont = conts[ixbin - ixfirst];
+         Double_t &err2 = errs2[ixbin - ixfirst];
 
-      // loop on the bins to be integrated (outbin should be called inbin)
-      for (out1bin = out1min; out1bin <= out1max; out1bin++) {
-         for (out2bin = out2min; out2bin <= out2max; out2bin++) {
+         // loop on the bins to be integrated (outbin should be called inbin)
+         for (out1bin = out1min; out1bin <= out1max; out1bin++) {
+            for (out2bin = out2min; out2bin <= out2max; out2bin++) {
 
-            Int_t bin = GetBin(*refX, *refY, *refZ);
+               Int_t bin = GetBin(*refX, *refY, *refZ);
 
-            // sum the bin contents and errors if needed
-            cont += RetrieveBinContent(bin);
-            if (computeErrors) {
-               Double_t exyz = GetBinError(bin);
-               err2 += exyz*exyz;
+               // sum the bin contents and errors if needed
+               cont += RetrieveBinContent(bin);
+               if (computeErrors) {
+                  Double_t exyz = GetBinError(bin);
+                  err2 += exyz*exyz;
+               }
             }
          }
       }
+   }
+
+   for (ixbin = ixfirst; ixbin <= ixlast; ixbin++) {
+      Double_t cont = conts[ixbin - ixfirst];
       Int_t ix    = h1->FindBin( projX->GetBinCenter(ixbin) );
       h1->SetBinContent(ix ,cont);
-      if (computeErrors) h1->SetBinError(ix, TMath::Sqrt(err2) );
+      if (computeErrors) h1->SetBinError(ix, TMath::Sqrt(errs2[ixbin - ixfirst]) );
       // sum all content
       totcont += cont;
-
    }
 
    // since we use a combination of fill and SetBinError we need to reset and recalculate the statistics
@@ -2156,34 +2256,59 @@ TH2D *TH3::DoProject2D(const char* name, const char * title, const TAxis* projX,
    if (useUF && !out->TestBit(TAxis::kAxisRange) )  outmin -= 1;
    if (useOF && !out->TestBit(TAxis::kAxisRange) )  outmax += 1;
 
-   for (ixbin=0;ixbin<=1+projX->GetNbins();ixbin++) {
-      if ( projX->TestBit(TAxis::kAxisRange) && ( ixbin < ixmin || ixbin > ixmax )) continue;
-      Int_t ix = h2->GetYaxis()->FindBin( projX->GetBinCenter(ixbin) );
-
-      for (iybin=0;iybin<=1+projY->GetNbins();iybin++) {
-         if ( projY->TestBit(TAxis::kAxisRange) && ( iybin < iymin || iybin > iymax )) continue;
-         Int_t iy = h2->GetXaxis()->FindBin( projY->GetBinCenter(iybin) );
-
-         Double_t cont = 0;
-         Double_t err2 = 0;
-
-         // loop on the bins to be integrated (outbin should be called inbin)
-         for (outbin = outmin; outbin <= outmax; outbin++) {
-
-            Int_t bin = GetBin(*refX,*refY,*refZ);
+   Int_t ixfirst = 0;
+   Int_t ixlast = 1 + projX->GetNbins();
+   if (projX->TestBit(TAxis::kAxisRange)) { ixfirst = ixmin; ixlast = ixmax; }
+   Int_t iyfirst = 0;
+   Int_t iylast = 1 + projY->GetNbins();
+   if (projY->TestBit(TAxis::kAxisRange)) { iyfirst = iymin; iylast = iymax; }
+   const Int_t nxcells = ixlast >= ixfirst ? ixlast - ixfirst + 1 : 0;
+   const Int_t nycells = iylast >= iyfirst ? iylast - iyfirst + 1 : 0;
+   std::vector<Double_t> conts(nxcells * nycells);
+   std::vector<Double_t> errs2(nxcells * nycells);
+
+   // sum directly the arrays of the TH3D and TH3F, with the bins to be integrated in the same order as below
+   const Int_t strides[3] = {1, fXaxis.GetNbins() + 2, (fXaxis.GetNbins() + 2) * (fYaxis.GetNbins() + 2)};
+   const Int_t xStride = strides[refX == &ixbin ? 0 : (refY == &ixbin ? 1 : 2)];
+   const Int_t yStride = strides[refX == &iybin ? 0 : (refY == &iybin ? 1 : 2)];
+   const Int_t outStride = strides[refX == &outbin ? 0 : (refY == &outbin ? 1 : 2)];
+   auto xOffsets = TH1ArrayHelper::GetBinOffsets(ixfirst, ixlast, projX->GetNbins(), xStride);
+   auto yOffsets = TH1ArrayHelper::GetBinOffsets(iyfirst, iylast, projY->GetNbins(), yStride);
+   auto outOffsets = TH1ArrayHelper::GetBinOffsets(outmin, outmax, out->GetNbins(), outStride);
+   Double_t *sumErrs2 = computeErrors ? errs2.data() : nullptr;
+   if (!TH1ArrayHelper::ProjectBins(*this, xOffsets, yOffsets, outOffsets, conts.data(), sumErrs2)) {
+      for (ixbin = ixfirst; ixbin <= ixlast; ixbin++) {
+         for (iybin = iyfirst; iybin <= iylast; iybin++) {
+            Double_t &cont = conts[(ixbin - ixfirst) * nycells + iybin - iyfirst];
+            Double_t &err2 = errs2[(ixbin - ixfirst) * nycells + iybin - iyfirst];
+
+            // loop on the bins to be integrated (outbin should be called inbin)
+            for (outbin = outmin; outbin <= outmax; outbin++) {
+
+               Int_t bin = GetBin(*refX,*refY,*refZ);
+
+               // sum the bin contents and errors if needed
+               cont += RetrieveBinContent(bin);
+               if (computeErrors) {
+                  Double_t exyz = GetBinError(bin);
+                  err2 += exyz*exyz;
+               }
 
-            // sum the bin contents and errors if needed
-            cont += RetrieveBinContent(bin);
-            if (computeErrors) {
-               Double_t exyz = GetBinError(bin);
-               err2 += exyz*exyz;
             }
-
          }
+      }
+   }
+
+   for (ixbin = ixfirst; ixbin <= ixlast; ixbin++) {
+      Int_t ix = h2->GetYaxis()->FindBin( projX->GetBinCenter(ixbin) );
+
+      for (iybin = iyfirst; iybin <= iylast; iybin++) {
+         Int_t iy = h2->GetXaxis()->FindBin( projY->GetBinCenter(iybin) );
+         Double_t cont = conts[(ixbin - ixfirst) * nycells + iybin - iyfirst];
 
          // remember axis are inverted
          h2->SetBinContent(iy , ix, cont);
-         if (computeErrors) h2->SetBinError(iy, ix, TMath::Sqrt(err2) );
+         if (computeErrors) h2->SetBinError(iy, ix, TMath::Sqrt(errs2[(ixbin - ixfirst) * nycells + iybin - iyfirst]) );
          // sum all content
          totcont += cont;
 
@@ -2950,41 +3075,48 @@ TH3 *TH3::Rebin3D(Int_t nxgroup, Int_t nygroup, Int_t nzgroup, const char *newna
          hnew->SetBins(newxbins, xmin, xmax, newybins, ymin, ymax, newzbins, zmin, zmax);//changes also errors array
       }
 
-      Double_t binContent, binSumw2;
-      Int_t oldxbin = 1;
-      Int_t oldybin = 1;
-      Int_t oldzbin = 1;
-      Int_t bin;
-      for (xbin = 1; xbin <= newxbins; xbin++) {
-         oldybin=1;
-         oldzbin=1;
-         for (ybin = 1; ybin <= newybins; ybin++) {
-            oldzbin=1;
-            for (zbin = 1; zbin <= newzbins; zbin++) {
-               binContent = 0;
-               binSumw2   = 0;
-               for (i = 0; i < nxgroup; i++) {
-                  if (oldxbin+i > nxbins) break;
-                  for (j =0; j < nygroup; j++) {
-                     if (oldybin+j > nybins) break;
-                     for (k =0; k < nzgroup; k++) {
-                        if (oldzbin+k > nzbins) break;
-                        //get global bin (same conventions as in TH1::GetBin(xbin,ybin)
-                        bin = oldxbin + i + (oldybin + j)*(nxbins + 2) + (oldzbin + k)*(nxbins + 2)*(nybins + 2);
-                        binContent += oldBins[bin];
-                        if (oldSumw2) binSumw2 += oldSumw2[bin];
+      // merge the bins on many threads for large histograms, in ranges of new x bins;
+      // UpdateBinContent only writes the bin content, the statistics are set at the end
+      auto rebinRange = [&](Long64_t begin, Long64_t end) {
+         Int_t oldxbin = 1 + begin * nxgroup;
+         for (Int_t newxbin = begin + 1; newxbin <= end; newxbin++) {
+            Int_t oldybin = 1;
+            for (Int_t newybin = 1; newybin <= newybins; newybin++) {
+               Int_t oldzbin = 1;
+               for (Int_t newzbin = 1; newzbin <= newzbins; newzbin++) {
+                  Double_t binContent = 0;
+                  Double_t binSumw2   = 0;
+                  for (Int_t ii = 0; ii < nxgroup; ii++) {
+                     if (oldxbin+ii > nxbins) break;
+                     for (Int_t jj =0; jj < nygroup; jj++) {
+                        if (oldybin+jj > nybins) break;
+                        for (Int_t kk =0; kk < nzgroup; kk++) {
+                           if (oldzbin+kk > nzbins) break;
+                           //get global bin (same conventions as in TH1::GetBin(xbin,ybin)
+                           Int_t bin = oldxbin + ii + (oldybin + jj)*(nxbins + 2) + (oldzbin + kk)*(nxbins + 2)*(nybins + 2);
+                           binContent += oldBins[bin];
+                           if (oldSumw2) binSumw2 += oldSumw2[bin];
+                        }
                      }
                   }
+                  Int_t ibin = hnew->GetBin(newxbin,newybin,newzbin);  // new bin number
+                  hnew->UpdateBinContent(ibin, binContent);
+                  if (oldSumw2) hnew->fSumw2.fArray[ibin] = binSumw2;
+                  oldzbin += nzgroup;
                }
-               Int_t ibin = hnew->GetBin(xbin,ybin,zbin);  // new bin number
-               hnew->SetBinContent(ibin, binContent);
-               if (oldSumw2) hnew->fSumw2.fArray[ibin] = binSumw2;
-               oldzbin += nzgroup;
+               oldybin += nygroup;
             }
-            oldybin += nygroup;
+            oldxbin += nxgroup;
          }
-         oldxbin += nxgroup;
-      }
+      };
+      TH1ArrayHelper::ForEachRange(newxbins, Long64_t(nxgroup) * nybins * nzbins, rebinRange);
+
+      Double_t binContent, binSumw2;
+      // first old bins after the last new bins
+      Int_t oldxbin = 1 + newxbins * nxgroup;
+      Int_t oldybin = 1 + newybins * nygroup;
+      Int_t oldzbin = 1 + newzbins * nzgroup;
+      Int_t bin;
 
       // compute new underflow/overflows for the 8 vertices
       for (Int_t xover = 0; xover <= 1; xover++) {
@@ -31,6 +31,11 @@
 #include "Math/MinimizerOptions.h"
 #include "Math/WrappedMultiTF1.h"
 
+#include "TH1ArrayHelper.h"
+
+#include <algorithm>
+#include <vector>
+
 
 /** \class THnBase
     \ingroup Hist
@@ -440,6 +445,83 @@ Bool_t THnBase::IsInRange(Int_t *coord) const
    return kTRUE;
 }
 
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Offsets in the bin array of all the bins with coordinates first[d] to
+/// last[d] in each dimension d of dims, the last of dims varying fastest, as
+/// for the THn bin iterator. The coordinates of the bins are appended to
+/// coords, dims.size() per bin.
+
+std::vector<Long64_t> GetTHnBinOffsets(const std::vector<Int_t> &dims, const std::vector<Int_t> &first,
+                                       const std::vector<Int_t> &last, const TNDArray &arr,
+                                       std::vector<Int_t> *coords = nullptr)
+{
+   std::vector<Long64_t> offsets;
+   const Int_t n = dims.size();
+   std::vector<Int_t> coord(n);
+   for (Int_t d = 0; d < n; ++d) {
+      if (first[dims[d]] > last[dims[d]])
+         return offsets;
+      coord[d] = first[dims[d]];
+   }
+   while (true) {
+      Long64_t offset = 0;
+      for (Int_t d = 0; d < n; ++d)
+         offset += coord[d] * arr.GetCellSize(dims[d]);
+      offsets.push_back(offset);
+      if (coords)
+         coords->insert(coords->end(), coord.begin(), coord.end());
+      Int_t d = n - 1;
+      while (d >= 0 && coord[d] == last[dims[d]]) {
+         coord[d] = first[dims[d]];
+         --d;
+      }
+      if (d < 0)
+         break;
+      ++coord[d];
+   }
+   return offsets;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// For a THnT<T> hn, set cont[i] to the sum of the contents of the bins
+/// `projOffsets[i] + sumOffsets[k]`, added in the order of k, and err2[i] (if
+/// err2 is not nullptr) to the sum of their squared errors. The bins are read
+/// directly from the bin array, on many threads for large histograms.
+/// Returns kFALSE, without computing anything, if hn is not a THnT<T>.
+
+template <typename T>
+Bool_t ProjectTHnBins(const THnBase &hn, const std::vector<Long64_t> &projOffsets,
+                      const std::vector<Long64_t> &sumOffsets, Double_t *cont, Double_t *err2)
+{
+   const THnT<T> *thn = dynamic_cast<const THnT<T> *>(&hn);
+   if (!thn)
+      return kFALSE;
+   const TNDArrayT<T> &arr = static_cast<const TNDArrayT<T> &>(thn->GetArray());
+   const Bool_t haveErrors = thn->GetCalculateErrors();
+   auto projectRange = [&](Long64_t begin, Long64_t end) {
+      for (Long64_t i = begin; i < end; ++i) {
+         Double_t sum = 0.;
+         Double_t sum2 = 0.;
+         for (Long64_t offset : sumOffsets) {
+            const Long64_t bin = projOffsets[i] + offset;
+            const Double_t v = arr.At(bin);
+            sum += v;
+            if (err2)
+               sum2 += haveErrors ? thn->THn::GetBinError2(bin) : v;
+         }
+         cont[i] = sum;
+         if (err2)
+            err2[i] = sum2;
+      }
+   };
+   TH1ArrayHelper::ForEachRange(projOffsets.size(), sumOffsets.size(), projectRange);
+   return kTRUE;
+}
+
+} // unnamed namespace
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Project all bins into a ndim-dimensional THn / THnSparse (whatever
 /// *this is) or if (ndim < 4 and !wantNDim) a TH1/2/3 histogram,
@@ -520,61 +602,126 @@ TObject* THnBase::ProjectionAny(Int_t ndim, const Int_t* dim,
    Bool_t haveErrors = GetCalculateErrors();
    Bool_t wantErrors = haveErrors || (option && (strchr(option, 'E') || strchr(option, 'e')));
 
-   Int_t* bins  = new Int_t[ndim];
-   Long64_t myLinBin = 0;
+   // For a TH1/2/3 projection of a THn, sum the bins directly on the bin
+   // array (on many threads for large histograms) and fill the histogram
+   // once per target bin.
+   Bool_t haveSkippedBin = kFALSE;
+   Bool_t projected = kFALSE;
+   if (!wantNDim && InheritsFrom(THn::Class())) {
+      const Int_t ndimensions = GetNdimensions();
+      std::vector<Int_t> first(ndimensions);
+      std::vector<Int_t> last(ndimensions);
+      for (Int_t d = 0; d < ndimensions; ++d) {
+         TAxis *axis = GetAxis(d);
+         first[d] = 0;
+         last[d] = axis->GetNbins() + 1;
+         if (axis->TestBit(TAxis::kAxisRange)) {
+            haveSkippedBin = kTRUE;
+            first[d] = axis->GetFirst();
+            last[d] = axis->GetLast();
+            if (first[d] == 0 && last[d] == 0) {
+               // over- and underflow bins are de-selected, as in the THn bin iterator
+               first[d] = 1;
+               last[d] = axis->GetNbins();
+            }
+         }
+      }
+      std::vector<Int_t> projDims(dim, dim + ndim);
+      std::vector<Int_t> sumDims;
+      for (Int_t d = 0; d < ndimensions; ++d) {
+         if (std::find(projDims.begin(), projDims.end(), d) == projDims.end())
+            sumDims.push_back(d);
+      }
+      const TNDArray &arr = static_cast<const THn *>(this)->GetArray();
+      std::vector<Int_t> projCoords;
+      std::vector<Long64_t> projOffsets = GetTHnBinOffsets(projDims, first, last, arr, &projCoords);
+      std::vector<Long64_t> sumOffsets = GetTHnBinOffsets(sumDims, first, last, arr);
+      std::vector<Double_t> conts(projOffsets.size());
+      std::vector<Double_t> errs2(wantErrors ? projOffsets.size() : 0);
+      Double_t *sumErrs2 = wantErrors ? errs2.data() : nullptr;
+      projected = ProjectTHnBins<Double_t>(*this, projOffsets, sumOffsets, conts.data(), sumErrs2) ||
+                  ProjectTHnBins<Float_t>(*this, projOffsets, sumOffsets, conts.data(), sumErrs2);
+      if (projected) {
+         if (wantErrors && !hist->GetSumw2N())
+            hist->Sumw2();
+         Int_t bins[3] = {0, 0, 0};
+         for (size_t i = 0; i < projOffsets.size(); ++i) {
+            for (Int_t d = 0; d < ndim; ++d) {
+               bins[d] = projCoords[i * ndim + d];
+               if (!keepTargetAxis && GetAxis(dim[d])->TestBit(TAxis::kAxisRange)) {
+                  Int_t binOffset = GetAxis(dim[d])->GetFirst();
+                  if (binOffset > 0) --binOffset;
+                  bins[d] -= binOffset;
+               }
+            }
+            Int_t targetBin = bins[0];
+            if (ndim == 2) targetBin = hist->GetBin(bins[0], bins[1]);
+            else if (ndim == 3) targetBin = hist->GetBin(bins[0], bins[1], bins[2]);
+            if (wantErrors)
+               hist->GetSumw2()->fArray[targetBin] += errs2[i];
+            hist->AddBinContent(targetBin, conts[i]);
+         }
+      }
+   }
 
-   THnIter iter(this, kTRUE /*use axis range*/);
+   if (!projected) {
+      Int_t* bins  = new Int_t[ndim];
+      Long64_t myLinBin = 0;
 
-   while ((myLinBin = iter.Next()) >= 0) {
-      Double_t v = GetBinContent(myLinBin);
+      THnIter iter(this, kTRUE /*use axis range*/);
 
-      for (Int_t d = 0; d < ndim; ++d) {
-         bins[d] = iter.GetCoord(dim[d]);
-         if (!keepTargetAxis && GetAxis(dim[d])->TestBit(TAxis::kAxisRange)) {
-            Int_t binOffset = GetAxis(dim[d])->GetFirst();
-            // Don't subtract even more if underflow is alreday included:
-            if (binOffset > 0) --binOffset;
-            bins[d] -= binOffset;
-         }
-      }
+      while ((myLinBin = iter.Next()) >= 0) {
+         Double_t v = GetBinContent(myLinBin);
 
-      Long64_t targetLinBin = -1;
-      if (!wantNDim) {
-         if (ndim == 1) targetLinBin = bins[0];
-         else if (ndim == 2) targetLinBin = hist->GetBin(bins[0], bins[1]);
-         else if (ndim == 3) targetLinBin = hist->GetBin(bins[0], bins[1], bins[2]);
-      } else {
-         targetLinBin = hn->GetBin(bins, kTRUE /*allocate*/);
-      }
+         for (Int_t d = 0; d < ndim; ++d) {
+            bins[d] = iter.GetCoord(dim[d]);
+            if (!keepTargetAxis && GetAxis(dim[d])->TestBit(TAxis::kAxisRange)) {
+               Int_t binOffset = GetAxis(dim[d])->GetFirst();
+               // Don't subtract even more if underflow is alreday included:
+               if (binOffset > 0) --binOffset;
+               bins[d] -= binOffset;
+            }
+         }
 
-      if (wantErrors) {
-         Double_t err2 = 0.;
-         if (haveErrors) {
-            err2 = GetBinError2(myLinBin);
+         Long64_t targetLinBin = -1;
+         if (!wantNDim) {
+            if (ndim == 1) targetLinBin = bins[0];
+            else if (ndim == 2) targetLinBin = hist->GetBin(bins[0], bins[1]);
+            else if (ndim == 3) targetLinBin = hist->GetBin(bins[0], bins[1], bins[2]);
          } else {
-            err2 = v;
+            targetLinBin = hn->GetBin(bins, kTRUE /*allocate*/);
          }
-         if (wantNDim) {
-            hn->AddBinError2(targetLinBin, err2);
-         } else {
-            Double_t preverr = hist->GetBinError(targetLinBin);
-            hist->SetBinError(targetLinBin, TMath::Sqrt(preverr * preverr + err2));
+
+         if (wantErrors) {
+            Double_t err2 = 0.;
+            if (haveErrors) {
+               err2 = GetBinError2(myLinBin);
+            } else {
+               err2 = v;
+            }
+            if (wantNDim) {
+               hn->AddBinError2(targetLinBin, err2);
+            } else {
+               Double_t preverr = hist->GetBinError(targetLinBin);
+               hist->SetBinError(targetLinBin, TMath::Sqrt(preverr * preverr + err2));
+            }
          }
+
+         // only _after_ error calculation, or sqrt(v) is taken into account!
+         if (wantNDim)
+            hn->AddBinContent(targetLinBin, v);
+         else
+            hist->AddBinContent(targetLinBin, v);
       }
 
-      // only _after_ error calculation, or sqrt(v) is taken into account!
-      if (wantNDim)
-         hn->AddBinContent(targetLinBin, v);
-      else
-         hist->AddBinContent(targetLinBin, v);
+      delete [] bins;
+      haveSkippedBin = iter.HaveSkippedBin();
    }
 
-   delete [] bins;
-
    if (wantNDim) {
       hn->SetEntries(fEntries);
    } else {
-      if (!iter.HaveSkippedBin()) {
+      if (!haveSkippedBin) {
          hist->SetEntries(fEntries);
       } else {
          // re-compute the entries
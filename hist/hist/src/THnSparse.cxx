@@ -15,6 +15,13 @@
 #include "TClass.h"
 #include "TDataMember.h"
 #include "TDataType.h"
+#include "TROOT.h"
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#endif
+
+#include <algorithm>
+#include <vector>
 
 namespace {
 //______________________________________________________________________________
@@ -270,9 +277,9 @@ ULong64_t THnSparseCoordCompression::GetHashFromCoords(const Int_t* coord) const
 {
    // Bins are addressed in two different modes, depending
    // on whether the compact bin index fits into a Long64_t or not.
-   // If it does, we can use it as a "perfect hash" for the TExMap.
+   // If it does, we can use it as a "perfect hash" for the bin index.
    // If not we build a hash from the compact bin index, and use that
-   // as the TExMap's hash.
+   // as the bin index's hash.
 
    if (fCoordBufferSize <= 8) {
       // fits into a Long64_t
@@ -318,9 +325,9 @@ ULong64_t THnSparseCoordCompression::GetHashFromBuffer(const Char_t* buf) const
 {
    // Bins are addressed in two different modes, depending
    // on whether the compact bin index fits into a Long64_t or not.
-   // If it does, we can use it as a "perfect hash" for the TExMap.
+   // If it does, we can use it as a "perfect hash" for the bin index.
    // If not we build a hash from the compact bin index, and use that
-   // as the TExMap's hash.
+   // as the bin index's hash.
 
    if (fCoordBufferSize <= 8) {
       // fits into a Long64_t
@@ -489,6 +496,56 @@ void THnSparseArrayChunk::Sumw2()
 }
 
 
+/** \class THnSparseBinIndex
+THnSparseBinIndex is used internally by THnSparse to find the linear index
+of a filled bin from the hash of its compact coordinates.
+It is an open-addressing hash table with linear probing: hash and index of
+each bin are stored next to each other in one contiguous array, so a lookup
+usually touches a single cache line and allocates nothing. Bins with
+identical hashes (only possible for compact coordinates larger than 8
+bytes) are found by continuing the probe sequence.
+The table is kept at most two thirds full.
+*/
+
+////////////////////////////////////////////////////////////////////////////////
+/// Store bin index idx for hash; the table must have room for it.
+
+void THnSparseBinIndex::Insert(ULong64_t hash, Long64_t idx)
+{
+   size_t slot = GetFirstSlot(hash);
+   while (fEntries[slot].fIndex1)
+      slot = GetNextSlot(slot);
+   SetAt(slot, hash, idx);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Grow the table to hold nbins entries and re-insert the existing ones.
+
+void THnSparseBinIndex::Rehash(Long64_t nbins)
+{
+   Int_t log2 = 4;
+   while ((Long64_t(1) << log2) * 2 < 3 * nbins)
+      ++log2;
+   std::vector<Entry> old(size_t(1) << log2, Entry{0, 0});
+   old.swap(fEntries);
+   fShift = 64 - log2;
+   fSize = 0;
+   for (const Entry& e: old)
+      if (e.fIndex1)
+         Insert(e.fHash, e.fIndex1 - 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Remove all entries and release the memory.
+
+void THnSparseBinIndex::Clear()
+{
+   std::vector<Entry>().swap(fEntries);
+   fShift = 64;
+   fSize = 0;
+}
+
+
 /** \class THnSparse
     \ingroup Hist
 
@@ -528,6 +585,10 @@ histogram.
 Bins are allocated as needed; the status of the allocation can be observed
 by GetSparseFractionBins(), GetSparseFractionMem().
 
+Many entries are best filled at once with FillN(n, x, w), where x holds the
+n-dimensional coordinates of the n entries one after the other: the bins
+are then found in batches and their lookups overlap in memory.
+
 ## Fast Bin Content Access
 When iterating over a THnSparse one should only look at filled bins to save
 processing time. The number of filled bins is returned by
@@ -570,14 +631,14 @@ Translation from an n-dimensional bin coordinate to the linear index within
 the chunks is done by GetBin(). It creates a hash from the compacted bin
 coordinates (the hash of a bin coordinate is the compacted coordinate itself
 if it takes less than 8 bytes, the size of a Long64_t.
-This hash is used to lookup the linear index in the TExMap member fBins;
-the coordinates of the entry fBins points to is compared to the coordinates
-passed to GetBin(). If they do not match, these two coordinates have the same
-hash - which is extremely unlikely but (for the case where the compact bin
-coordinates are larger than 4 bytes) possible. In this case, fBinsContinued
-contains a chain of linear indexes with the same hash. Iterating through this
-chain and comparing each bin coordinates with the one passed to GetBin() will
-retrieve the matching bin.
+This hash is used to lookup the linear index in the open-addressing hash
+table fBins (see THnSparseBinIndex), which stores the hash of each filled
+bin next to its linear index. If the compacted coordinates are larger than
+8 bytes two bins can have the same hash - which is extremely unlikely but
+possible. In this case the coordinates of each bin with a matching hash are
+compared to the ones passed to GetBin(), until the matching bin is found.
+fBins is not persistent; it is rebuilt from the chunks when a THnSparse that
+was read from a file is accessed.
 */
 
 
@@ -658,28 +719,14 @@ void THnSparse::FillExMap()
    THnSparseArrayChunk* chunk = 0;
    THnSparseCoordCompression compactCoord(*GetCompactCoord());
    Long64_t idx = 0;
-   if (2 * GetNbins() > fBins.Capacity())
-      fBins.Expand(3 * GetNbins());
+   fBins.Reserve(GetNbins());
    while ((chunk = (THnSparseArrayChunk*) iChunk())) {
       const Int_t chunkSize = chunk->GetEntries();
       Char_t* buf = chunk->fCoordinates;
       const Int_t singleCoordSize = chunk->fSingleCoordinateSize;
       const Char_t* endbuf = buf + singleCoordSize * chunkSize;
-      for (; buf < endbuf; buf += singleCoordSize, ++idx) {
-         Long64_t hash = compactCoord.GetHashFromBuffer(buf);
-         Long64_t linidx = fBins.GetValue(hash);
-         if (linidx) {
-            Long64_t nextidx = linidx;
-            while (nextidx) {
-               // must be a collision, so go to fBinsContinued.
-               linidx = nextidx;
-               nextidx = fBinsContinued.GetValue(linidx);
-            }
-            fBinsContinued.Add(linidx, idx + 1);
-         } else {
-            fBins.Add(hash, idx + 1);
-         }
-      }
+      for (; buf < endbuf; buf += singleCoordSize, ++idx)
+         fBins.Insert(compactCoord.GetHashFromBuffer(buf), idx);
    }
 }
 
@@ -690,9 +737,7 @@ void THnSparse::Reserve(Long64_t nbins) {
    if (!fBins.GetSize() && fBinContent.GetSize()) {
       FillExMap();
    }
-   if (2 * nbins > fBins.Capacity()) {
-      fBins.Expand(3 * nbins);
-   }
+   fBins.Reserve(nbins);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -736,6 +781,62 @@ Long64_t THnSparse::GetBin(const Int_t* coord, Bool_t allocate /*= kTRUE*/)
    return GetBinIndexForCurrentBin(allocate);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Fill n entries at once. x holds the n-dimensional coordinates of the
+/// entries one after the other, i.e. x[i * GetNdimensions() + d] is the
+/// coordinate of entry i on axis d; w holds their weights, all entries have
+/// weight 1 if w is null. The result is identical to calling Fill() for each
+/// entry.
+/// The bins of a batch of entries are found for each axis at once, and the
+/// lookups of the batch in the bin index are started before the entries are
+/// filled, so the cache misses of the lookups in large histograms overlap.
+
+void THnSparse::FillN(Long64_t n, const Double_t *x, const Double_t *w /* = nullptr */)
+{
+   if (n <= 0)
+      return;
+   const Int_t ndim = fNdimensions;
+   for (Int_t d = 0; d < ndim; ++d) {
+      if (GetAxis(d)->CanExtend() || GetAxis(d)->IsAlphanumeric()) {
+         for (Long64_t i = 0; i < n; ++i)
+            Fill(x + i * ndim, w ? w[i] : 1.);
+         return;
+      }
+   }
+
+   const Int_t kBatchSize = 256;
+   std::vector<Int_t> bins(ndim * kBatchSize); // bins[d * kBatchSize + i]
+   std::vector<Int_t> coord(ndim);
+   THnSparseCompactBinCoord* cc = GetCompactCoord();
+   if (fBinContent.GetSize() && !fBins.GetSize())
+      FillExMap();
+
+   for (Long64_t start = 0; start < n; start += kBatchSize) {
+      const Int_t nbatch = (Int_t) std::min<Long64_t>(kBatchSize, n - start);
+      const Double_t *xbatch = x + start * ndim;
+      for (Int_t d = 0; d < ndim; ++d)
+         GetAxis(d)->FindFixBins(nbatch, xbatch + d, &bins[d * kBatchSize], ndim);
+
+      auto setCoord = [&](Int_t i) {
+         for (Int_t d = 0; d < ndim; ++d)
+            coord[d] = bins[d * kBatchSize + i];
+         cc->SetCoord(coord.data());
+      };
+      if (fBins.GetSize()) {
+         for (Int_t i = 0; i < nbatch; ++i) {
+            setCoord(i);
+            fBins.Prefetch(cc->GetHash());
+         }
+      }
+      for (Int_t i = 0; i < nbatch; ++i) {
+         const Double_t weight = w ? w[start + i] : 1.;
+         setCoord(i);
+         UpdateXStat(xbatch + i * ndim, weight);
+         FillBin(GetBinIndexForCurrentBin(kTRUE), weight);
+      }
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return the content of the filled bin number "idx".
 /// If coord is non-null, it will contain the bin's coordinates for each axis
@@ -792,17 +893,22 @@ Long64_t THnSparse::GetBinIndexForCurrentBin(Bool_t allocate)
    ULong64_t hash = cc->GetHash();
    if (fBinContent.GetSize() && !fBins.GetSize())
       FillExMap();
-   Long64_t linidx = (Long64_t) fBins.GetValue(hash);
-   while (linidx) {
+   if (allocate)
+      // grow before probing, such that the free slot found below stays valid
+      fBins.Reserve(fFilledBins + 1);
+   else if (!fBins.GetSize())
+      return -1;
+
+   size_t slot = fBins.GetFirstSlot(hash);
+   for (; fBins.GetEntry(slot).fIndex1; slot = fBins.GetNextSlot(slot)) {
+      const THnSparseBinIndex::Entry& entry = fBins.GetEntry(slot);
+      if (entry.fHash != hash)
+         continue;
       // fBins stores index + 1!
-      THnSparseArrayChunk* chunk = GetChunk((linidx - 1)/ fChunkSize);
-      if (chunk->Matches((linidx - 1) % fChunkSize, cc->GetBuffer()))
-         return linidx - 1; // we store idx+1, 0 is "TExMap: not found"
-
-      Long64_t nextlinidx = fBinsContinued.GetValue(linidx);
-      if (!nextlinidx) break;
-
-      linidx = nextlinidx;
+      const Long64_t linidx = entry.fIndex1 - 1;
+      THnSparseArrayChunk* chunk = GetChunk(linidx / fChunkSize);
+      if (chunk->Matches(linidx % fChunkSize, cc->GetBuffer()))
+         return linidx;
    }
    if (!allocate) return -1;
 
@@ -817,18 +923,9 @@ Long64_t THnSparse::GetBinIndexForCurrentBin(Bool_t allocate)
    }
    chunk->AddBin(newidx, cc->GetBuffer());
 
-   // store translation between hash and bin
+   // store translation between hash and bin in the free slot
    newidx += (fBinContent.GetEntriesFast() - 1) * fChunkSize;
-   if (!linidx) {
-      // fBins didn't find it
-      if (2 * GetNbins() > fBins.Capacity())
-         fBins.Expand(3 * GetNbins());
-      fBins.Add(hash, newidx + 1);
-   } else {
-      // fBins contains one, but it's the wrong one;
-      // add entry to fBinsContinued.
-      fBinsContinued.Add(linidx, newidx + 1);
-   }
+   fBins.SetAt(slot, hash, newidx);
    return newidx;
 }
 
@@ -880,7 +977,7 @@ Double_t THnSparse::GetSparseFractionMem() const {
 
    Double_t size = 0.;
    size += fBinContent.GetEntries() * (GetChunkSize() * sizePerChunkElement + sizeof(THnSparseArrayChunk));
-   size += + 3 * sizeof(Long64_t) * fBins.GetSize() /* TExMap */;
+   size += fBins.GetMemSize();
 
    Double_t nbinsTotal = 1.;
    for (Int_t d = 0; d < fNdimensions; ++d)
@@ -962,9 +1059,69 @@ void THnSparse::Sumw2()
 void THnSparse::Reset(Option_t *option /*= ""*/)
 {
    fFilledBins = 0;
-   fBins.Delete();
-   fBinsContinued.Clear();
+   fBins.Clear();
    fBinContent.Delete();
    ResetBase(option);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Merge this with a list of THnSparse's. All histograms provided in the list
+/// must have the same bin layout!
+/// If implicit multi-threading is enabled and the list is long enough, the
+/// list is split in groups that are added in parallel, the first group
+/// directly to this and each other group to an empty copy of this; the copies
+/// are then added to this. The bin contents are identical to the ones of a
+/// sequential merge up to rounding, but the filled bins can be in a different
+/// order. See THnBase::Merge().
+
+Long64_t THnSparse::Merge(TCollection* list)
+{
+#ifdef R__USE_IMT
+   const Int_t kMinHistsPerTask = 2;
+   if (list && ROOT::IsImplicitMTEnabled() && list->GetSize() >= 2 * kMinHistsPerTask) {
+      std::vector<const THnSparse*> hists;
+      Bool_t sameLayout = kTRUE;
+      TIter iter(list);
+      const TObject* addMeObj = 0;
+      while (sameLayout && (addMeObj = iter())) {
+         const THnSparse* addMe = dynamic_cast<const THnSparse*>(addMeObj);
+         sameLayout = addMe && addMe->GetNdimensions() == fNdimensions;
+         for (Int_t d = 0; sameLayout && d < fNdimensions; ++d)
+            sameLayout = addMe->GetAxis(d)->GetNbins() == GetAxis(d)->GetNbins();
+         if (sameLayout)
+            hists.push_back(addMe);
+      }
+      const Int_t ntasks = std::min<Int_t>(ROOT::GetThreadPoolSize(), hists.size() / kMinHistsPerTask);
+      if (sameLayout && ntasks > 1) {
+         // The copies are created up front: creating objects through their TClass
+         // is better not done concurrently.
+         std::vector<THnSparse*> partial(ntasks, this);
+         for (Int_t task = 1; task < ntasks; ++task)
+            partial[task] = (THnSparse*) CloneEmpty(GetName(), GetTitle(), GetListOfAxes(), kTRUE);
+
+         ROOT::TThreadExecutor pool;
+         pool.Foreach([&](Int_t task) {
+            const size_t begin = hists.size() * task / ntasks;
+            const size_t end = hists.size() * (task + 1) / ntasks;
+            Long64_t nbins = partial[task]->GetNbins();
+            for (size_t i = begin; i < end; ++i)
+               nbins += hists[i]->GetNbins();
+            partial[task]->Reserve(nbins);
+            for (size_t i = begin; i < end; ++i)
+               partial[task]->Add(hists[i]);
+         }, ROOT::TSeqI(ntasks));
+
+         Long64_t nbins = GetNbins();
+         for (Int_t task = 1; task < ntasks; ++task)
+            nbins += partial[task]->GetNbins();
+         Reserve(nbins);
+         for (Int_t task = 1; task < ntasks; ++task) {
+            Add(partial[task]);
+            delete partial[task];
+         }
+         return (Long64_t)GetEntries();
+      }
+   }
+#endif
+   return THnBase::Merge(list);
+}
@@ -22,6 +22,21 @@
  
  The algorithm is briefly described in (4). A binned version is also implemented to address the 
  performance issue due to its data size dependance.
+
+ For large data sets the evaluation algorithm can be chosen with SetEvaluation() (or the option
+ "Evaluation:Direct|Pruned|FFT"):
+  - kDirect (default) sums the kernel over all the data (or bins) at every evaluation point.
+  - kPruned sorts the data and sums only over the data whose kernel support contains the point.
+    The result is the same as kDirect up to rounding, for fixed and adaptive iterations.
+  - kFFT bins the data linearly on a fine grid, convolves them with the kernel using a FFT (when
+    the FFTW plugin is available) and interpolates linearly between the grid points. The grid is
+    chosen for a relative accuracy of about SetFFTTolerance() (1E-4 by default). It requires a
+    fixed bandwidth: with the adaptive iteration only the pilot estimate uses it, the final
+    evaluation uses kPruned.
+
+ kPruned and kFFT need a kernel with a known support, they are not used with user defined kernels.
+ GetValues() evaluates the estimate at many points at once, in parallel when the implicit
+ multi-threading is enabled (ROOT::EnableImplicitMT), except with user defined kernels.
  */
 
 
@@ -30,6 +45,7 @@
 #include <numeric>
 #include <limits>
 #include <cassert>
+#include <cstring>
 
 #include "Math/Error.h"
 #include "TMath.h"
@@ -40,20 +56,71 @@
 #include "TGraphErrors.h"
 #include "TF1.h"
 #include "TH1.h"
+#include "TROOT.h"
 #include "TVirtualPad.h"
+#include "TVirtualFFT.h"
+#include "TPluginManager.h"
 #include "TKDE.h"
 
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#endif
+
 
 ClassImp(TKDE);
 
+namespace {
+
+// Whether the FFTW plugins of TVirtualFFT are available, checked once and without
+// the error messages of TVirtualFFT::FFT when they are missing
+Bool_t HasFFTW()
+{
+   static const Bool_t hasFFTW = [] {
+      // an empty default means FFTW
+      const char *def = TVirtualFFT::GetDefaultFFT();
+      if (def && *def && strcmp(def, "fftw") != 0)
+         return kFALSE;
+      for (const char *name : {"fftwr2c", "fftwc2r"}) {
+         TPluginHandler *h = gROOT->GetPluginManager()->FindHandler("TVirtualFFT", name);
+         if (!h || h->CheckPlugin() != 0)
+            return kFALSE;
+      }
+      return kTRUE;
+   }();
+   return hasFFTW;
+}
+
+} // namespace
+
 class TKDE::TKernel {
    TKDE* fKDE;
    UInt_t fNWeights; // Number of kernel weights (bandwidth as vectorized for binning)
    std::vector<Double_t> fWeights; // Kernel weights (bandwidth)
+
+   EEvaluation fEvaluation; // Evaluation algorithm in use, depending on the kernel and the iteration
+   std::vector<Double_t> fSortedData; // Data (or bin centres) with non-zero count, in increasing order (kPruned)
+   std::vector<Double_t> fSortedScales; // Count over bandwidth of the sorted data (kPruned)
+   std::vector<Double_t> fSortedInvWeights; // Inverse of the bandwidth of the sorted data (kPruned)
+   std::vector<Double_t> fBlockMin; // Lower end of the kernel supports of each block of sorted data (kPruned)
+   std::vector<Double_t> fBlockMax; // Upper end of the kernel supports of each block of sorted data (kPruned)
+   Double_t fMaxReach; // Largest half width of the kernel supports (kPruned)
+   std::vector<Double_t> fGrid; // Kernel sum at the grid points (kFFT)
+   Double_t fGridMin; // Position of the first grid point (kFFT)
+   Double_t fGridStep; // Distance between the grid points (kFFT)
+
+   static const UInt_t kBlockSize = 64; // Number of sorted data per block (kPruned)
+
+   void SetSortedData(Double_t support);
+   void SetGridData(Double_t support);
+   template <Double_t (TKDE::*kernel)(Double_t) const>
+   Double_t SumKernels(Double_t x, UInt_t begin, UInt_t end) const;
+   Double_t Sum(Double_t x) const;
 public:
    TKernel(Double_t weight, TKDE* kde);
    void ComputeAdaptiveWeights();
+   void SetEvaluationData();
    Double_t operator()(Double_t x) const;
+   void Evaluate(UInt_t n, const Double_t* x, Double_t* values) const;
    Double_t GetWeight(Double_t x) const;
    Double_t GetFixedWeight() const;
    const std::vector<Double_t> & GetAdaptiveWeights() const;
@@ -77,11 +144,12 @@ TKDE::TKDE() :
    fLowerPDF(nullptr),
    fApproximateBias(nullptr),
    fGraph(nullptr),
+   fEvaluation(kDirect),
    fUseMirroring(false), fMirrorLeft(false), fMirrorRight(false), fAsymLeft(false), fAsymRight(false),
    fUseBins(false), fNewData(false), fUseMinMaxFromData(false),
    fNBins(0), fNEvents(0), fSumOfCounts(0), fUseBinsNEvents(0),
    fMean(0.),fSigma(0.), fSigmaRob(0.), fXMin(0.), fXMax(0.),
-   fRho(0.), fAdaptiveBandwidthFactor(0.), fWeightSize(0)
+   fRho(0.), fAdaptiveBandwidthFactor(0.), fFFTTolerance(1.E-4), fWeightSize(0)
 {
 }
 
@@ -121,11 +189,12 @@ void TKDE::Instantiate(KernelFunction_Ptr kernfunc, UInt_t events, const Double_
    fUseMinMaxFromData = (fXMin >= fXMax);
    fSumOfCounts = 0;
    fAdaptiveBandwidthFactor = 1.;
+   fFFTTolerance = 1.E-4;
    fRho = rho;
    fWeightSize = 0;
    fCanonicalBandwidths = std::vector<Double_t>(kTotalKernels, 0.0);
    fKernelSigmas2 = std::vector<Double_t>(kTotalKernels, -1.0);
-   fSettedOptions = std::vector<Bool_t>(4, kFALSE);
+   fSettedOptions = std::vector<Bool_t>(5, kFALSE);
    SetOptions(option, rho);
    CheckOptions(kTRUE);
    SetMirror();
@@ -140,7 +209,7 @@ void TKDE::SetOptions(const Option_t* option, Double_t rho) {
    TString opt = option;
    opt.ToLower();
    std::string options = opt.Data();
-   size_t numOpt = 4;
+   size_t numOpt = 5;
    std::vector<std::string> voption(numOpt, "");
    for (std::vector<std::string>::iterator it = voption.begin(); it != voption.end() && !options.empty(); ++it) {
       size_t pos = options.find_last_of(';');
@@ -269,6 +338,18 @@ void TKDE::GetOptions(std::string optionType, std::string option) {
          this->Warning("GetOptions", "Unknown binning option: setting to RelaxedBinning");
          fBinning = kRelaxedBinning;
       }
+   } else if (optionType.compare("evaluation") == 0) {
+      fSettedOptions[4] = kTRUE;
+      if (option.compare("direct") == 0) {
+         fEvaluation = kDirect;
+      } else if (option.compare("pruned") == 0) {
+         fEvaluation = kPruned;
+      } else if (option.compare("fft") == 0) {
+         fEvaluation = kFFT;
+      } else {
+         this->Warning("GetOptions", "Unknown evaluation option: setting to Direct");
+         fEvaluation = kDirect;
+      }
    }
 }
 
@@ -286,6 +367,9 @@ void TKDE::AssureOptions() {
    if (!fSettedOptions[3]) {
       fBinning = kRelaxedBinning;
    }
+   if (!fSettedOptions[4]) {
+      fEvaluation = kDirect;
+   }
 }
 
 void TKDE::CheckOptions(Bool_t isUserDefinedKernel) {
@@ -305,6 +389,14 @@ void TKDE::CheckOptions(Bool_t isUserDefinedKernel) {
       Warning("CheckOptions", "Illegal user binning type input - use default value !");
       fBinning = kRelaxedBinning;
    }
+   if (!(fEvaluation >= kDirect && fEvaluation <= kFFT)) {
+      Warning("CheckOptions", "Illegal user evaluation type input - use default value !");
+      fEvaluation = kDirect;
+   }
+   if (fFFTTolerance <= 0.0 || fFFTTolerance >= 1.0) {
+      Warning("CheckOptions", "FFT tolerance must be in ]0,1[ - use default value !");
+      fFFTTolerance = 1.E-4;
+   }
    if (fRho <= 0.0) {
       Warning("CheckOptions", "Tuning factor rho cannot be non-positive - use default value !");
       fRho = 1.0;
@@ -384,6 +476,23 @@ void TKDE::SetTuneFactor(Double_t rho) {
    SetKernel();
 }
 
+void TKDE::SetEvaluation(EEvaluation eval) {
+   // Sets User option for the algorithm evaluating the estimate, see the class description
+   fEvaluation = eval;
+   CheckOptions();
+   if (fEvaluation != kDirect && fKernelType == kUserDefined)
+      Warning("SetEvaluation", "The support of user defined kernels is unknown, the kernel is summed over all the data");
+   SetKernel();
+}
+
+void TKDE::SetFFTTolerance(Double_t tolerance) {
+   // Sets the approximate relative accuracy of the kFFT evaluation, which determines the grid spacing
+   // (about the bandwidth times sqrt(tolerance)).
+   fFFTTolerance = tolerance;
+   CheckOptions();
+   if (fEvaluation == kFFT) SetKernel();
+}
+
 void TKDE::SetRange(Double_t xMin, Double_t xMax) {
    // Sets minimum range value and maximum range value
    if (xMin >= xMax) {
@@ -570,6 +679,7 @@ void TKDE::SetKernel() {
    weight *= fRho * fCanonicalBandwidths[fKernelType] / fCanonicalBandwidths[kGaussian];
    if (fKernel) delete fKernel;
    fKernel = new TKernel(weight, this);
+   fKernel->SetEvaluationData();
    if (fIteration == kAdaptive) {
       fKernel->ComputeAdaptiveWeights();
    }
@@ -699,6 +809,21 @@ Double_t TKDE::operator()(Double_t x) const {
    return (*fKernel)(x);
 }
 
+void TKDE::GetValues(UInt_t n, const Double_t* x, Double_t* values) const {
+   // Evaluates the kernel density estimate at the n points x and stores the results in values.
+   // With implicit multi-threading enabled large sets of points are evaluated in parallel,
+   // unless the kernel is user defined.
+   if (!fKernel) {
+      (const_cast<TKDE*>(this))->ReInit();
+      // in case of failed re-initialization
+      if (!fKernel) {
+         std::fill(values, values + n, TMath::QuietNaN());
+         return;
+      }
+   }
+   fKernel->Evaluate(n, x, values);
+}
+
 Double_t TKDE::GetMean() const {
    // return the mean of the data
    if (fNewData) (const_cast<TKDE*>(this))->InitFromNewData();
@@ -721,9 +846,205 @@ TKDE::TKernel::TKernel(Double_t weight, TKDE* kde) :
 // Internal class constructor
 fKDE(kde),
 fNWeights(kde->fData.size()),
-fWeights(fNWeights, weight)
+fWeights(fNWeights, weight),
+fEvaluation(kDirect),
+fMaxReach(0.),
+fGridMin(0.),
+fGridStep(0.)
 {}
 
+void TKDE::TKernel::SetEvaluationData() {
+   // Prepares the data structures of the evaluation algorithm for the present bandwidths
+   fEvaluation = kDirect;
+   fSortedData.clear(); fSortedScales.clear(); fSortedInvWeights.clear();
+   fBlockMin.clear(); fBlockMax.clear();
+   fGrid.clear();
+   Double_t support = fKDE->GetKernelSupport();
+   if (fKDE->fEvaluation == kDirect || fNWeights == 0 || !fKDE->fKernelFunction ||
+       !(support < std::numeric_limits<Double_t>::infinity()))
+      return;
+   Bool_t fixedWeight = std::all_of(fWeights.begin(), fWeights.end(), [&](Double_t w) { return w == fWeights[0]; });
+   if (fKDE->fEvaluation == kFFT && fixedWeight) {
+      SetGridData(support);
+      fEvaluation = kFFT;
+   } else {
+      SetSortedData(support);
+      fEvaluation = kPruned;
+   }
+}
+
+void TKDE::TKernel::SetSortedData(Double_t support) {
+   // Sorts the data with their bandwidths and computes the range of the kernel supports of each block
+   // of kBlockSize sorted data, such that the sum at a point can skip the data that do not contribute
+   const std::vector<Double_t> &data = fKDE->fData;
+   Bool_t useBins = (fKDE->fBinCount.size() == fNWeights);
+   std::vector<UInt_t> order;
+   order.reserve(fNWeights);
+   for (UInt_t i = 0; i < fNWeights; ++i) {
+      if (!useBins || fKDE->fBinCount[i] != 0) order.push_back(i);
+   }
+   std::sort(order.begin(), order.end(), [&](UInt_t i, UInt_t j) { return data[i] < data[j]; });
+   UInt_t n = order.size();
+   fSortedData.resize(n);
+   fSortedScales.resize(n);
+   fSortedInvWeights.resize(n);
+   for (UInt_t k = 0; k < n; ++k) {
+      UInt_t i = order[k];
+      fSortedData[k] = data[i];
+      fSortedScales[k] = ((useBins) ? fKDE->fBinCount[i] : 1.0) / fWeights[i];
+      fSortedInvWeights[k] = 1. / fWeights[i];
+   }
+   // the kernels vanish at a distance support * bandwidth, keep a margin for the rounding
+   Double_t reach = support * (1. + 1.E-10);
+   UInt_t nBlocks = (n + kBlockSize - 1) / kBlockSize;
+   fBlockMin.assign(nBlocks, std::numeric_limits<Double_t>::max());
+   fBlockMax.assign(nBlocks, std::numeric_limits<Double_t>::lowest());
+   fMaxReach = 0;
+   for (UInt_t k = 0; k < n; ++k) {
+      Double_t halfWidth = reach / fSortedInvWeights[k];
+      UInt_t block = k / kBlockSize;
+      fBlockMin[block] = std::min(fBlockMin[block], fSortedData[k] - halfWidth);
+      fBlockMax[block] = std::max(fBlockMax[block], fSortedData[k] + halfWidth);
+      fMaxReach = std::max(fMaxReach, halfWidth);
+   }
+}
+
+void TKDE::TKernel::SetGridData(Double_t support) {
+   // Bins the data linearly on a regular grid covering the kernel supports and convolves them with the
+   // kernel sampled on the grid. The spacing is the bandwidth times sqrt(tolerance), since the errors of the
+   // linear binning and of the linear interpolation are of second order in the spacing over the bandwidth.
+   const UInt_t kMaxGridSize = 1 << 22;
+   const std::vector<Double_t> &data = fKDE->fData;
+   Bool_t useBins = (fKDE->fBinCount.size() == fNWeights);
+   Double_t weight = fWeights[0];
+   auto range = std::minmax_element(data.begin(), data.end());
+   fGridMin = *range.first - support * weight;
+   Double_t width = *range.second - *range.first + 2. * support * weight;
+   fGridStep = std::max(weight * std::sqrt(fKDE->fFFTTolerance), width / (kMaxGridSize - 2));
+   UInt_t nGrid = UInt_t(width / fGridStep) + 2;
+
+   std::vector<Double_t> counts(nGrid, 0.);
+   Bool_t positive = kTRUE;
+   for (UInt_t i = 0; i < fNWeights; ++i) {
+      Double_t count = (useBins) ? fKDE->fBinCount[i] : 1.0;
+      Double_t t = (data[i] - fGridMin) / fGridStep;
+      UInt_t k = std::min(UInt_t(t), nGrid - 2);
+      Double_t frac = t - k;
+      counts[k] += count * (1. - frac);
+      counts[k + 1] += count * frac;
+      positive &= (count >= 0);
+   }
+
+   // kernel values at the grid distances 0..nKernel, the kernel is symmetric
+   Int_t nKernel = std::min(Int_t(support * weight / fGridStep), Int_t(nGrid));
+   std::vector<Double_t> kernel(nKernel + 1);
+   for (Int_t m = 0; m <= nKernel; ++m)
+      kernel[m] = (*fKDE->fKernelFunction)(m * fGridStep / weight) / weight;
+
+   fGrid.assign(nGrid, 0.);
+   // zero padding avoids the wrap around of the cyclic convolution
+   Int_t nFFT = nGrid + 2 * nKernel;
+   TVirtualFFT *fftData = (nKernel > 32 && HasFFTW()) ? TVirtualFFT::FFT(1, &nFFT, "R2C K") : nullptr;
+   TVirtualFFT *fftKernel = (fftData) ? TVirtualFFT::FFT(1, &nFFT, "R2C K") : nullptr;
+   TVirtualFFT *fftInverse = (fftKernel) ? TVirtualFFT::FFT(1, &nFFT, "C2R K") : nullptr;
+   if (fftInverse) {
+      for (Int_t i = 0; i < nFFT; ++i) {
+         fftData->SetPoint(i, (i < Int_t(nGrid)) ? counts[i] : 0.);
+         Int_t m = (i <= nKernel) ? i : nFFT - i;
+         fftKernel->SetPoint(i, (m <= nKernel) ? kernel[m] : 0.);
+      }
+      fftData->Transform();
+      fftKernel->Transform();
+      Double_t re1, im1, re2, im2;
+      for (Int_t i = 0; i <= nFFT / 2; ++i) {
+         fftData->GetPointComplex(i, re1, im1);
+         fftKernel->GetPointComplex(i, re2, im2);
+         fftInverse->SetPoint(i, re1 * re2 - im1 * im2, re1 * im2 + re2 * im1);
+      }
+      fftInverse->Transform();
+      for (UInt_t k = 0; k < nGrid; ++k)
+         fGrid[k] = fftInverse->GetPointReal(k) / nFFT;
+   } else {
+      // FFT not available (or not worth): direct convolution, still independent of the number of events
+      for (UInt_t k = 0; k < nGrid; ++k) {
+         if (counts[k] == 0) continue;
+         UInt_t first = (k > UInt_t(nKernel)) ? k - nKernel : 0;
+         UInt_t last = std::min(nGrid - 1, k + nKernel);
+         for (UInt_t j = first; j <= last; ++j)
+            fGrid[j] += counts[k] * kernel[(j > k) ? j - k : k - j];
+      }
+   }
+   delete fftData;
+   delete fftKernel;
+   delete fftInverse;
+   // remove the rounding errors of the FFT where the estimate vanishes
+   if (positive) {
+      for (auto &value : fGrid)
+         value = std::max(value, 0.);
+   }
+}
+
+template <Double_t (TKDE::*kernel)(Double_t) const>
+Double_t TKDE::TKernel::SumKernels(Double_t x, UInt_t begin, UInt_t end) const {
+   // Sums the (inlined) kernel over the sorted data [begin, end)
+   Double_t result = 0;
+   for (UInt_t k = begin; k < end; ++k)
+      result += fSortedScales[k] * (fKDE->*kernel)((x - fSortedData[k]) * fSortedInvWeights[k]);
+   return result;
+}
+
+Double_t TKDE::TKernel::Sum(Double_t x) const {
+   // Returns the sum of the kernels at x (not normalized) for the kPruned and kFFT evaluations
+   if (fEvaluation == kFFT) {
+      Double_t t = (x - fGridMin) / fGridStep;
+      if (!(t >= 0 && t < fGrid.size() - 1)) return 0;
+      UInt_t k = UInt_t(t);
+      Double_t frac = t - k;
+      return (1. - frac) * fGrid[k] + frac * fGrid[k + 1];
+   }
+   // only the data within the largest kernel support can contribute
+   UInt_t begin = std::lower_bound(fSortedData.begin(), fSortedData.end(), x - fMaxReach) - fSortedData.begin();
+   UInt_t end = std::upper_bound(fSortedData.begin() + begin, fSortedData.end(), x + fMaxReach) - fSortedData.begin();
+   Double_t result = 0;
+   while (begin < end) {
+      UInt_t block = begin / kBlockSize;
+      UInt_t blockEnd = std::min(end, (block + 1) * kBlockSize);
+      if (x >= fBlockMin[block] && x <= fBlockMax[block]) {
+         switch (fKDE->fKernelType) {
+            case kGaussian: result += SumKernels<&TKDE::GaussianKernel>(x, begin, blockEnd); break;
+            case kEpanechnikov: result += SumKernels<&TKDE::EpanechnikovKernel>(x, begin, blockEnd); break;
+            case kBiweight: result += SumKernels<&TKDE::BiweightKernel>(x, begin, blockEnd); break;
+            case kCosineArch: result += SumKernels<&TKDE::CosineArchKernel>(x, begin, blockEnd); break;
+            default: break; // not used for user defined kernels
+         }
+      }
+      begin = blockEnd;
+   }
+   return result;
+}
+
+void TKDE::TKernel::Evaluate(UInt_t n, const Double_t* x, Double_t* values) const {
+   // Evaluates the estimate at n points, split in blocks evaluated in parallel with implicit multi-threading.
+   // User defined kernels are always evaluated serially, as they may not be thread safe.
+   const UInt_t kPointsPerTask = 1024;
+#ifdef R__USE_IMT
+   UInt_t nTasks = (n + kPointsPerTask - 1) / kPointsPerTask;
+   if (ROOT::IsImplicitMTEnabled() && nTasks > 1 && fKDE->fKernelType != kUserDefined) {
+      ROOT::TThreadExecutor pool;
+      pool.Foreach([&](UInt_t task) {
+         UInt_t end = std::min(n, (task + 1) * kPointsPerTask);
+         for (UInt_t i = task * kPointsPerTask; i < end; ++i)
+            values[i] = (*this)(x[i]);
+      }, ROOT::TSeqU(nTasks));
+      return;
+   }
+#else
+   (void)kPointsPerTask;
+#endif
+   for (UInt_t i = 0; i < n; ++i)
+      values[i] = (*this)(x[i]);
+}
+
 void TKDE::TKernel::ComputeAdaptiveWeights() {
    // Gets the adaptive weights (bandwidths) for TKernel internal computation
    std::vector<Double_t> weights = fWeights;
@@ -731,11 +1052,14 @@ void TKDE::TKernel::ComputeAdaptiveWeights() {
    unsigned int n = fKDE->fData.size();
    assert( n == weights.size() );
    bool useDataWeights = (fKDE->fBinCount.size() == n); 
+   // pilot estimate at the data, with the fixed bandwidth
+   std::vector<Double_t> pilot(n);
+   Evaluate(n, fKDE->fData.data(), pilot.data());
    Double_t f = 0.0;
    for (unsigned int i = 0; i < n; ++i) { 
 //   for (; weight != weights.end(); ++weight, ++data, ++dataW) {
       if (useDataWeights && fKDE->fBinCount[i] <= 0) continue;  // skip negative or null weights
-      f = (*fKDE->fKernel)(fKDE->fData[i]);
+      f = pilot[i];
       if (f <= 0)
          fKDE->Warning("ComputeAdativeWeights","function value is zero or negative for x = %f w = %f",
                        fKDE->fData[i],(useDataWeights) ? fKDE->fBinCount[i] : 1.);
@@ -747,6 +1071,7 @@ void TKDE::TKernel::ComputeAdaptiveWeights() {
    fKDE->fAdaptiveBandwidthFactor = fKDE->fUseMirroring ? kAPPROX_GEO_MEAN / fKDE->fSigmaRob : std::sqrt(std::exp(fKDE->fAdaptiveBandwidthFactor / fKDE->fData.size()));
    transform(weights.begin(), weights.end(), fWeights.begin(),
              std::bind(std::multiplies<Double_t>(), std::placeholders::_1, fKDE->fAdaptiveBandwidthFactor));
+   SetEvaluationData();
    //printf("adaptive bandwidth factor % f weight 0 %f , %f \n",fKDE->fAdaptiveBandwidthFactor, weights[0],fWeights[0] );
 }
 
@@ -937,6 +1262,18 @@ Double_t TKDE::TKernel::operator()(Double_t x) const {
    // case of bins or weighted data 
    Bool_t useBins = (fKDE->fBinCount.size() == n);
    Double_t nSum = (useBins) ? fKDE->fSumOfCounts : fKDE->fNEvents;
+   // the sorted data or the grid are valid as long as no data are added with Fill
+   if (fEvaluation != kDirect && n == fNWeights) {
+      result = Sum(x);
+      // the kernels are symmetric: the mirrored terms are the sums at the reflected points
+      if (fKDE->fAsymLeft) {
+         result -= Sum(2. * fKDE->fXMin - x);
+      }
+      if (fKDE->fAsymRight) {
+         result -= Sum(2. * fKDE->fXMax - x);
+      }
+      return result / nSum;
+   }
    // double dmin = 1.E10;
    // double xmin,bmin,wmin; 
    for (UInt_t i = 0; i < n; ++i) {
@@ -1046,6 +1383,21 @@ void TKDE::CheckKernelValidity() {
    }
 }
 
+Double_t TKDE::GetKernelSupport() const {
+   // Returns the half width of the kernel support, beyond which the kernel vanishes
+   // (infinity for the user defined kernels)
+   switch (fKernelType) {
+      case kGaussian :
+         return 9.; // see GaussianKernel
+      case kEpanechnikov :
+      case kBiweight :
+      case kCosineArch :
+         return 1.;
+      default :
+         return std::numeric_limits<Double_t>::infinity();
+   }
+}
+
 Double_t TKDE::ComputeKernelL2Norm() const {
    // Computes the kernel's L2 norm
    ROOT::Math::IntegratorOneDim ig(ROOT::Math::IntegrationOneDim::kGAUSS);
@@ -1,6 +1,10 @@
 #include "gtest/gtest.h"
 
 #include "THn.h"
+#include "THnSparse.h"
+#include "TList.h"
+#include "TRandom3.h"
+#include "TROOT.h"
 #include "TH1.h"
 #include "TH2.h"
 
@@ -111,3 +115,97 @@ TEST(THn, Projection) {
    }
 
 }
+
+namespace {
+// Expect that h2 has the same filled bins as h1, with the same contents.
+void ExpectSameBins(const THnSparse &h1, THnSparse &h2)
+{
+   ASSERT_EQ(h1.GetNbins(), h2.GetNbins());
+   std::vector<Int_t> coord(h1.GetNdimensions());
+   for (Long64_t i = 0; i < h1.GetNbins(); ++i) {
+      Double_t v = h1.GetBinContent(i, coord.data());
+      Long64_t bin = h2.GetBin(coord.data(), kFALSE);
+      ASSERT_GE(bin, 0);
+      EXPECT_DOUBLE_EQ(v, h2.GetBinContent(bin));
+      EXPECT_DOUBLE_EQ(h1.GetBinError2(i), h2.GetBinError2(bin));
+   }
+   EXPECT_DOUBLE_EQ(h1.GetEntries(), h2.GetEntries());
+}
+} // anonymous namespace
+
+// Filling THnSparse in batches, with compact coordinates smaller (3 axes)
+// and larger (12 axes) than 8 bytes.
+TEST(THnSparse, FillN) {
+   for (Int_t ndim : {3, 12}) {
+      std::vector<Int_t> bins(ndim, 1000);
+      std::vector<Double_t> xmin(ndim, -5.);
+      std::vector<Double_t> xmax(ndim, 5.);
+      THnSparseD h1("h1", "h1", ndim, bins.data(), xmin.data(), xmax.data(), 1000);
+      THnSparseD h2("h2", "h2", ndim, bins.data(), xmin.data(), xmax.data(), 1000);
+      h1.Sumw2();
+      h2.Sumw2();
+
+      const Long64_t n = 20000;
+      TRandom3 rnd(42);
+      std::vector<Double_t> x(n * ndim);
+      std::vector<Double_t> w(n);
+      for (Long64_t i = 0; i < n; ++i) {
+         // few distinct values such that bins are filled more than once
+         for (Int_t d = 0; d < ndim; ++d)
+            x[i * ndim + d] = d < 2 ? rnd.Gaus(0., 3.) : rnd.Integer(3) - 1.;
+         w[i] = rnd.Uniform(0.5, 2.);
+      }
+      for (Long64_t i = 0; i < n; ++i)
+         h1.Fill(&x[i * ndim], w[i]);
+      h2.FillN(n / 2, x.data(), w.data());
+      h2.FillN(n - n / 2, &x[(n / 2) * ndim], &w[n / 2]);
+
+      // Same sequence of entries, so the bins are allocated in the same order.
+      ASSERT_EQ(h1.GetNbins(), h2.GetNbins());
+      std::vector<Int_t> coord1(ndim), coord2(ndim);
+      for (Long64_t i = 0; i < h1.GetNbins(); ++i) {
+         EXPECT_EQ(h1.GetBinContent(i, coord1.data()), h2.GetBinContent(i, coord2.data()));
+         EXPECT_EQ(coord1, coord2);
+      }
+      ExpectSameBins(h1, h2);
+      EXPECT_EQ(h1.GetWeightSum(), h2.GetWeightSum());
+
+      std::vector<Int_t> empty(ndim, 1);
+      EXPECT_EQ(-1, h2.GetBin(empty.data(), kFALSE));
+      h2.Reset();
+      EXPECT_EQ(0, h2.GetNbins());
+      EXPECT_EQ(-1, h2.GetBin(coord1.data(), kFALSE));
+   }
+}
+
+// Merging many THnSparse gives the same bins as adding them one by one.
+TEST(THnSparse, Merge) {
+   const Int_t ndim = 4;
+   Int_t bins[ndim] = {100, 100, 50, 20};
+   Double_t xmin[ndim] = {0., 0., 0., 0.};
+   Double_t xmax[ndim] = {1., 1., 1., 1.};
+   THnSparseF expected("expected", "expected", ndim, bins, xmin, xmax);
+   THnSparseF merged("merged", "merged", ndim, bins, xmin, xmax);
+   TList list;
+   list.SetOwner();
+   TRandom3 rnd(7);
+   for (Int_t h = 0; h < 12; ++h) {
+      auto hist = new THnSparseF(TString::Format("h%d", h), "h", ndim, bins, xmin, xmax);
+      Double_t x[ndim];
+      for (Int_t i = 0; i < 1000; ++i) {
+         for (Int_t d = 0; d < ndim; ++d)
+            x[d] = rnd.Rndm();
+         hist->Fill(x);
+      }
+      expected.Add(hist);
+      list.Add(hist);
+   }
+#ifdef R__USE_IMT
+   ROOT::EnableImplicitMT(4);
+#endif
+   merged.Merge(&list);
+#ifdef R__USE_IMT
+   ROOT::DisableImplicitMT();
+#endif
+   ExpectSameBins(expected, merged);
+}
@@ -0,0 +1,174 @@
+#include "gtest/gtest.h"
+
+#include "TArrayD.h"
+#include "TArrayS.h"
+#include "TBufferFile.h"
+#include "TH3.h"
+#include "THn.h"
+#include "TRandom3.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <memory>
+
+namespace {
+
+// Sets the compact streaming for the duration of a test.
+class CompactStreaming {
+   Int_t fOldMinSize;
+
+public:
+   CompactStreaming(Int_t minsize) : fOldMinSize(TArray::GetCompactStreaming())
+   {
+      TArray::SetCompactStreaming(minsize);
+   }
+   ~CompactStreaming() { TArray::SetCompactStreaming(fOldMinSize); }
+};
+
+template <class T>
+std::unique_ptr<T> RoundTrip(const T &obj, Int_t &nbytes)
+{
+   TBufferFile wbuf(TBuffer::kWrite);
+   wbuf.WriteObject(&obj);
+   nbytes = wbuf.Length();
+   TBufferFile rbuf(TBuffer::kRead, wbuf.Length(), wbuf.Buffer(), kFALSE);
+   return std::unique_ptr<T>(static_cast<T *>(rbuf.ReadObject(T::Class())));
+}
+
+template <class T>
+std::unique_ptr<T> RoundTripArray(const T &arr, Int_t &nbytes)
+{
+   TBufferFile wbuf(TBuffer::kWrite);
+   TArray::WriteArray(wbuf, &arr);
+   nbytes = wbuf.Length();
+   TBufferFile rbuf(TBuffer::kRead, wbuf.Length(), wbuf.Buffer(), kFALSE);
+   return std::unique_ptr<T>(static_cast<T *>(TArray::ReadArray(rbuf, T::Class())));
+}
+
+} // anonymous namespace
+
+TEST(CompactStreaming, TArray)
+{
+   TArrayD arr(10000);
+   arr[0] = 1.;
+   arr[1] = -0.;
+   arr[2] = 3.;
+   arr[5] = std::numeric_limits<Double_t>::quiet_NaN();
+   for (Int_t i = 4000; i < 4100; i += 3)
+      arr[i] = i;
+   arr[9999] = -1.;
+
+   Int_t denseBytes = 0;
+   Int_t compactBytes = 0;
+   {
+      CompactStreaming compact(0);
+      RoundTripArray(arr, denseBytes);
+   }
+   CompactStreaming compact(1000);
+   auto read = RoundTripArray(arr, compactBytes);
+   ASSERT_TRUE(read);
+   EXPECT_LT(compactBytes, denseBytes / 10);
+   ASSERT_EQ(read->GetSize(), arr.GetSize());
+   EXPECT_EQ(0, memcmp(read->GetArray(), arr.GetArray(), arr.GetSize() * sizeof(Double_t)));
+   EXPECT_TRUE(std::signbit((*read)[1]));
+
+   // Reading into an array that already has the same size.
+   TBufferFile wbuf(TBuffer::kWrite);
+   arr.Streamer(wbuf);
+   TArrayD other(arr.GetSize());
+   other.Reset(7.);
+   TBufferFile rbuf(TBuffer::kRead, wbuf.Length(), wbuf.Buffer(), kFALSE);
+   other.Streamer(rbuf);
+   EXPECT_EQ(rbuf.Length(), wbuf.Length());
+   EXPECT_EQ(0, memcmp(other.GetArray(), arr.GetArray(), arr.GetSize() * sizeof(Double_t)));
+
+   // Short arrays and arrays without enough zeros are written in full.
+   TArrayS small(100);
+   small[10] = 1;
+   Int_t nbytes = 0;
+   Int_t expected = 0;
+   auto readSmall = RoundTripArray(small, nbytes);
+   {
+      CompactStreaming full(0);
+      RoundTripArray(small, expected);
+   }
+   EXPECT_EQ(nbytes, expected);
+   EXPECT_EQ((*readSmall)[10], 1);
+
+   TArrayD dense(2000);
+   for (Int_t i = 0; i < dense.GetSize(); ++i)
+      dense[i] = (i % 4 == 0) ? 0. : i;
+   auto readDense = RoundTripArray(dense, nbytes);
+   {
+      CompactStreaming full(0);
+      RoundTripArray(dense, expected);
+   }
+   EXPECT_EQ(nbytes, expected);
+   EXPECT_EQ(0, memcmp(readDense->GetArray(), dense.GetArray(), dense.GetSize() * sizeof(Double_t)));
+}
+
+TEST(CompactStreaming, TH3)
+{
+   TH3D h("h", "h", 50, 0., 1., 50, 0., 1., 50, 0., 1.);
+   h.SetDirectory(nullptr);
+   h.Sumw2();
+   TRandom3 rng(11);
+   for (Int_t i = 0; i < 500; ++i)
+      h.Fill(rng.Gaus(0.5, 0.05), rng.Gaus(0.5, 0.05), rng.Gaus(0.5, 0.05), rng.Uniform(0.5, 2.));
+
+   Int_t denseBytes = 0;
+   Int_t compactBytes = 0;
+   {
+      CompactStreaming compact(0);
+      RoundTrip(h, denseBytes);
+   }
+   CompactStreaming compact(1024);
+   auto read = RoundTrip(h, compactBytes);
+   ASSERT_TRUE(read);
+   EXPECT_LT(compactBytes, denseBytes / 4);
+   EXPECT_EQ(read->GetEntries(), h.GetEntries());
+   for (Int_t bin = 0; bin < h.GetNcells(); ++bin) {
+      EXPECT_EQ(read->GetBinContent(bin), h.GetBinContent(bin));
+      EXPECT_EQ(read->GetBinError(bin), h.GetBinError(bin));
+   }
+}
+
+TEST(CompactStreaming, THn)
+{
+   Int_t bins[4] = {20, 20, 20, 20};
+   Double_t xmin[4] = {0., 0., 0., 0.};
+   Double_t xmax[4] = {1., 1., 1., 1.};
+   THnD hn("hn", "hn", 4, bins, xmin, xmax);
+   hn.Sumw2();
+   TRandom3 rng(12);
+   Double_t x[4];
+   for (Int_t i = 0; i < 1000; ++i) {
+      for (auto &xi : x)
+         xi = rng.Gaus(0.5, 0.1);
+      hn.Fill(x, rng.Uniform(0.5, 2.));
+   }
+
+   Int_t denseBytes = 0;
+   Int_t compactBytes = 0;
+   {
+      CompactStreaming compact(0);
+      RoundTrip(hn, denseBytes);
+   }
+   CompactStreaming compact(1024);
+   auto read = RoundTrip(hn, compactBytes);
+   ASSERT_TRUE(read);
+   EXPECT_LT(compactBytes, denseBytes / 4);
+   ASSERT_EQ(read->GetNbins(), hn.GetNbins());
+   EXPECT_EQ(read->GetEntries(), hn.GetEntries());
+   for (Long64_t bin = 0; bin < hn.GetNbins(); ++bin) {
+      EXPECT_EQ(read->GetBinContent(bin), hn.GetBinContent(bin));
+      EXPECT_EQ(read->GetBinError2(bin), hn.GetBinError2(bin));
+   }
+
+   // An empty THn has no data allocated.
+   THnF empty("empty", "empty", 4, bins, xmin, xmax);
+   auto readEmpty = RoundTrip(empty, compactBytes);
+   ASSERT_TRUE(readEmpty);
+   EXPECT_EQ(readEmpty->GetBinContent(Long64_t(17)), 0.);
+}
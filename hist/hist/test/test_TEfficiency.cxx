@@ -5,6 +5,8 @@
 #include "Math/QuantFuncMathCore.h"
 
 #include <iostream>
+#include <memory>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -399,4 +401,61 @@ TEST(TFEfficiency, ConfIntervals)
 TEST(TFEfficiency, ConsistencyWithTGraph)
 {
    testConsistencyWithTGraph();
-}
\ No newline at end of file
+}
+
+TEST(TFEfficiency, BatchIntervals)
+{
+   // repeated pairs, an empty bin and non integer numbers of events
+   std::vector<double> total = {10, 20, 10, 0, 7.5, 100, 20, 10, 3};
+   std::vector<double> passed = {3, 20, 3, 0, 2.5, 0, 20, 7, 1};
+   const int n = total.size();
+   std::vector<double> lower(n), upper(n);
+
+   TEfficiency::ConfidenceIntervals(n, total.data(), passed.data(), 0.9, TEfficiency::kFCP, lower.data(), upper.data());
+   for (int i = 0; i < n; ++i) {
+      EXPECT_EQ(lower[i], TEfficiency::ClopperPearson(total[i], passed[i], 0.9, false));
+      EXPECT_EQ(upper[i], TEfficiency::ClopperPearson(total[i], passed[i], 0.9, true));
+   }
+   TEfficiency::ConfidenceIntervals(n, total.data(), passed.data(), 0.683, TEfficiency::kFWilson, lower.data(),
+                                    upper.data());
+   for (int i = 0; i < n; ++i) {
+      if (total[i] == 0)
+         continue;
+      EXPECT_EQ(lower[i], TEfficiency::Wilson(total[i], passed[i], 0.683, false));
+      EXPECT_EQ(upper[i], TEfficiency::Wilson(total[i], passed[i], 0.683, true));
+   }
+   TEfficiency::ConfidenceIntervals(n, total.data(), passed.data(), 0.95, TEfficiency::kBBayesian, lower.data(),
+                                    upper.data(), 2, 3, true);
+   for (int i = 0; i < n; ++i) {
+      EXPECT_EQ(lower[i], TEfficiency::Bayesian(total[i], passed[i], 0.95, 2, 3, false, true));
+      EXPECT_EQ(upper[i], TEfficiency::Bayesian(total[i], passed[i], 0.95, 2, 3, true, true));
+   }
+
+   // the graph of a TEfficiency uses the batch calculation
+   TH1D htotal("htotal", "htotal", 200, 0, 1);
+   TH1D hpassed("hpassed", "hpassed", 200, 0, 1);
+   htotal.SetDirectory(nullptr);
+   hpassed.SetDirectory(nullptr);
+   gRandom->SetSeed(112);
+   for (int b = 1; b <= 200; ++b) {
+      int nt = gRandom->Poisson(4);
+      htotal.SetBinContent(b, nt);
+      hpassed.SetBinContent(b, gRandom->Binomial(nt, 0.7));
+   }
+   TEfficiency eff(hpassed, htotal);
+   for (auto option : {TEfficiency::kFCP, TEfficiency::kFFC, TEfficiency::kBJeffrey}) {
+      eff.SetStatisticOption(option);
+      std::unique_ptr<TGraphAsymmErrors> graph(eff.CreateGraph());
+      int j = 0;
+      for (int b = 1; b <= 200; ++b) {
+         if (htotal.GetBinContent(b) == 0)
+            continue;
+         ASSERT_LT(j, graph->GetN());
+         EXPECT_EQ(graph->GetY()[j], eff.GetEfficiency(b));
+         EXPECT_EQ(graph->GetEYlow()[j], eff.GetEfficiencyErrorLow(b));
+         EXPECT_EQ(graph->GetEYhigh()[j], eff.GetEfficiencyErrorUp(b));
+         ++j;
+      }
+      EXPECT_EQ(j, graph->GetN());
+   }
+}
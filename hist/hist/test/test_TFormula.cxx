@@ -1,9 +1,84 @@
 #include "gtest/gtest.h"
 
 #include "TFormula.h"
+#include "TF1.h"
+#include "TF2.h"
+
+#include <vector>
 
 // Test that autoloading works (ROOT-9840)
 TEST(TFormula, Interp)
 {
   TFormula f("func", "TGeoBBox::DeclFileLine()");
 }
+
+// EvalParN gives the same values as EvalPar, point by point
+TEST(TFormula, EvalParN)
+{
+   TFormula f("evalParN", "[0]*exp(-0.5*((x-[1])/[2])^2) + [3]*y");
+   f.SetParameters(2., 0.5, 1.5, -0.25);
+   const int n = 1001;
+   std::vector<double> x(n), y(n), result(n);
+   for (int i = 0; i < n; ++i) {
+      x[i] = -5. + 0.01 * i;
+      y[i] = 0.003 * i;
+   }
+   const double *xy[2] = {x.data(), y.data()};
+
+   f.EvalParN(n, xy, result.data());
+   for (int i = 0; i < n; ++i) {
+      double point[2] = {x[i], y[i]};
+      EXPECT_DOUBLE_EQ(result[i], f.EvalPar(point));
+   }
+
+   // with other parameters than the ones of the formula
+   const double params[4] = {1., -1., 0.5, 2.};
+   f.EvalParN(n, xy, result.data(), params);
+   for (int i = 0; i < n; ++i) {
+      double point[2] = {x[i], y[i]};
+      EXPECT_DOUBLE_EQ(result[i], f.EvalPar(point, params));
+   }
+}
+
+TEST(TF1, EvalParN)
+{
+   const int n = 500;
+   std::vector<double> x(n), y(n), result(n);
+   for (int i = 0; i < n; ++i) {
+      x[i] = -3. + 0.013 * i;
+      y[i] = 1. - 0.002 * i;
+   }
+   const double *xx[2] = {x.data(), y.data()};
+
+   TF1 formula("evalParNFormula", "gaus(0) + pol1(3)", -3, 4);
+   formula.SetParameters(3., 0.2, 0.7, 0.1, -0.05);
+   TF1 lambda("evalParNLambda", [](double *v, double *p) { return p[0] * v[0] * v[0] + p[1]; }, -3, 4, 2);
+   lambda.SetParameters(0.5, -1.);
+   for (TF1 *f : {&formula, &lambda}) {
+      f->EvalParN(n, xx, result.data());
+      for (int i = 0; i < n; ++i)
+         EXPECT_DOUBLE_EQ(result[i], f->Eval(x[i])) << f->GetName() << " at x = " << x[i];
+   }
+
+   // normalized function
+   formula.SetNormalized(true);
+   formula.EvalParN(n, xx, result.data());
+   for (int i = 0; i < n; ++i)
+      EXPECT_DOUBLE_EQ(result[i], formula.Eval(x[i]));
+
+   TF2 f2("evalParNTF2", "[0]*x*y + [1]*sin(x)", -3, 4, -1, 1);
+   f2.SetParameters(1.5, -2.);
+   f2.EvalParN(n, xx, result.data());
+   for (int i = 0; i < n; ++i)
+      EXPECT_DOUBLE_EQ(result[i], f2.Eval(x[i], y[i]));
+}
+
+// The Gauss-Legendre integral evaluates the function on all the points at once
+TEST(TF1, IntegralFastEvalParN)
+{
+   TF1 f("integralFast", "[0]*x*x + [1]", 0, 3);
+   f.SetParameters(3., 1.);
+   EXPECT_NEAR(f.IntegralFast(20, nullptr, nullptr, 0, 3), 30., 1E-10);
+   double params[2] = {1., 0.};
+   EXPECT_NEAR(f.IntegralFast(20, nullptr, nullptr, 0, 3, params), 9., 1E-10);
+}
@@ -1,7 +1,21 @@
 #include "gtest/gtest.h"
 
 #include "TH1.h"
+#include "TH1ConcurrentFiller.h"
+#include "TH1Registry.h"
+#include "TH1D.h"
 #include "TH1F.h"
+#include "TH2F.h"
+#include "TH2D.h"
+#include "TH3D.h"
+#include "TList.h"
+#include "TRandom3.h"
+#include "TROOT.h"
+
+#include <cmath>
+#include <memory>
+#include <thread>
+#include <vector>
 
 // StatOverflows TH1
 TEST(TH1, StatOverflows)
@@ -30,3 +44,279 @@ TEST(TH1, StatOverflows)
    EXPECT_EQ(TH1::EStatOverflows::kConsider, h1.GetStatOverflows());
    EXPECT_EQ(TH1::EStatOverflows::kNeutral,  h2.GetStatOverflows());
 }
+
+// Merge of histograms with identical binning, summed array by array
+TEST(TH1, MergeSameAxes)
+{
+   TH1D h0("merge_h0", "h0", 20, 0, 10);
+   TH1D h1("merge_h1", "h1", 20, 0, 10);
+   TH1D h2("merge_h2", "h2", 20, 0, 10);
+   h2.Sumw2();
+   for (int i = 0; i < 100; ++i) {
+      h0.Fill(0.1 * i - 1);
+      h1.Fill(0.07 * i, 2.);
+      h2.Fill(0.05 * i + 3, 0.5);
+   }
+   TH1D expected(h0);
+   expected.Sumw2();
+   expected.Add(&h1);
+   expected.Add(&h2);
+
+   TList list;
+   list.Add(&h1);
+   list.Add(&h2);
+   EXPECT_EQ(h0.Merge(&list), 300);
+   for (int i = 0; i < h0.GetNcells(); ++i) {
+      EXPECT_DOUBLE_EQ(h0.GetBinContent(i), expected.GetBinContent(i));
+      EXPECT_DOUBLE_EQ(h0.GetBinError(i), expected.GetBinError(i));
+   }
+   EXPECT_DOUBLE_EQ(h0.GetMean(), expected.GetMean());
+   EXPECT_DOUBLE_EQ(h0.GetStdDev(), expected.GetStdDev());
+
+   TH2F h2d0("merge_h2d0", "h2d0", 5, 0, 5, 4, 0, 4);
+   TH2F h2d1("merge_h2d1", "h2d1", 5, 0, 5, 4, 0, 4);
+   h2d0.Fill(1, 1);
+   h2d1.Fill(1, 1, 3.);
+   h2d1.Fill(4, 2);
+   list.Clear();
+   list.Add(&h2d1);
+   h2d0.Merge(&list);
+   EXPECT_FLOAT_EQ(h2d0.GetBinContent(2, 2), 4.);
+   EXPECT_FLOAT_EQ(h2d0.GetBinContent(5, 3), 1.);
+   EXPECT_FLOAT_EQ(h2d0.GetBinError(2, 2), std::sqrt(10.f));
+}
+
+// Merge of histograms with identical labels
+TEST(TH1, MergeSameLabels)
+{
+   const char *labels[] = {"a", "b", "c"};
+   TH1F h0("mergelabels_h0", "h0", 3, 0, 3);
+   TH1F h1("mergelabels_h1", "h1", 3, 0, 3);
+   TH1F h2("mergelabels_h2", "h2", 3, 0, 3);
+   for (int i = 0; i < 3; ++i) {
+      h0.Fill(labels[i], 1);
+      h1.Fill(labels[i], i + 1);
+      h2.Fill(labels[i], 10 * (3 - i));
+   }
+   TList list;
+   list.Add(&h1);
+   list.Add(&h2);
+   h0.Merge(&list);
+   EXPECT_EQ(h0.GetXaxis()->GetNbins(), 3);
+   EXPECT_STREQ(h0.GetXaxis()->GetBinLabel(1), "a");
+   EXPECT_FLOAT_EQ(h0.GetBinContent(1), 1 + 1 + 30);
+   EXPECT_FLOAT_EQ(h0.GetBinContent(2), 1 + 2 + 20);
+   EXPECT_FLOAT_EQ(h0.GetBinContent(3), 1 + 3 + 10);
+
+   // different order of the labels: merged by label
+   TH1F h3("mergelabels_h3", "h3", 3, 0, 3);
+   h3.Fill("c", 100);
+   h3.Fill("a", 1000);
+   list.Clear();
+   list.Add(&h3);
+   h0.Merge(&list);
+   EXPECT_FLOAT_EQ(h0.GetBinContent(1), 1032);
+   EXPECT_FLOAT_EQ(h0.GetBinContent(3), 114);
+}
+
+namespace {
+
+void ExpectSameHistograms(const TH1 &h1, const TH1 &h2)
+{
+   ASSERT_EQ(h1.GetNcells(), h2.GetNcells());
+   EXPECT_EQ(h1.GetEntries(), h2.GetEntries());
+   for (int bin = 0; bin < h1.GetNcells(); ++bin) {
+      EXPECT_EQ(h1.GetBinContent(bin), h2.GetBinContent(bin)) << "bin " << bin;
+      EXPECT_EQ(h1.GetBinError(bin), h2.GetBinError(bin)) << "bin " << bin;
+   }
+   Double_t s1[TH1::kNstat], s2[TH1::kNstat];
+   h1.GetStats(s1);
+   h2.GetStats(s2);
+   for (int i = 0; i < TH1::kNstat; ++i)
+      EXPECT_EQ(s1[i], s2[i]) << "statistics " << i;
+}
+
+} // anonymous namespace
+
+// FillN finds the bins of whole batches at once: same result as Fill entry by entry
+TEST(TH1, FillNBatch)
+{
+   const int n = 3000;
+   const int stride = 2;
+   TRandom3 rnd(42);
+   std::vector<double> x(n * stride), y(n * stride), z(n * stride), w(n * stride);
+   for (int i = 0; i < n * stride; ++i) {
+      x[i] = rnd.Gaus(0, 3);
+      y[i] = rnd.Uniform(-12, 12);
+      z[i] = rnd.Exp(2);
+      w[i] = rnd.Uniform(0.5, 1.5);
+   }
+   y[0] = NAN;
+   x[2] = 10;  // upper edge
+   x[4] = -10; // lower edge
+   const double edges[] = {-10, -5, -2, -1, -0.5, 0, 0.25, 1, 3, 3.5, 10};
+
+   for (bool weighted : {false, true}) {
+      const double *pw = weighted ? w.data() : nullptr;
+
+      TH1D h1("fillnbatch_h1", "", 100, -10, 10);
+      TH1D h1ref("fillnbatch_h1ref", "", 100, -10, 10);
+      TH1D hv("fillnbatch_hv", "", 10, edges);
+      TH1D hvref("fillnbatch_hvref", "", 10, edges);
+      hv.SetStatOverflows(TH1::EStatOverflows::kConsider);
+      hvref.SetStatOverflows(TH1::EStatOverflows::kConsider);
+      h1.FillN(n, x.data(), pw, stride);
+      hv.FillN(n, x.data(), pw, stride);
+      for (int i = 0; i < n * stride; i += stride) {
+         h1ref.Fill(x[i], weighted ? w[i] : 1.);
+         hvref.Fill(x[i], weighted ? w[i] : 1.);
+      }
+      ExpectSameHistograms(h1, h1ref);
+      ExpectSameHistograms(hv, hvref);
+
+      TH2D h2("fillnbatch_h2", "", 20, -5, 5, 10, edges);
+      TH2D h2ref("fillnbatch_h2ref", "", 20, -5, 5, 10, edges);
+      h2.FillN(n, x.data(), y.data(), pw, stride);
+      for (int i = 0; i < n * stride; i += stride)
+         h2ref.Fill(x[i], y[i], weighted ? w[i] : 1.);
+      ExpectSameHistograms(h2, h2ref);
+
+      TH3D h3("fillnbatch_h3", "", 10, -5, 5, 12, -12, 12, 8, 0, 8);
+      TH3D h3ref("fillnbatch_h3ref", "", 10, -5, 5, 12, -12, 12, 8, 0, 8);
+      h3.FillN(n, x.data(), y.data(), z.data(), pw, stride);
+      for (int i = 0; i < n * stride; i += stride)
+         h3ref.Fill(x[i], y[i], z[i], weighted ? w[i] : 1.);
+      ExpectSameHistograms(h3, h3ref);
+   }
+}
+
+// Filling from several threads through TH1ConcurrentFiller gives the same histogram as a serial filling
+TEST(TH1, ConcurrentFiller)
+{
+   const int nthreads = 4;
+   const int n = 20000;
+   auto x = [](int t, int i) { return -6 + 0.0005 * ((i * 7919 + t * 104729) % 24000); };
+   auto y = [](int t, int i) { return -3 + 0.001 * ((i * 3571 + t * 15485863) % 6000); };
+   auto w = [](int t, int i) { return 0.5 * (1 + (i + t) % 4); };
+
+   using EMode = TH1ConcurrentFiller::EMode;
+   for (auto mode : {EMode::kSharded, EMode::kAtomic}) {
+      // With 2 slots for 4 threads, two threads fill the atomic contents.
+      for (unsigned nslots : {4u, 2u}) {
+         TH1D h1("concurrent_h1", "", 50, -5, 5);
+         TH1D h1ref("concurrent_h1ref", "", 50, -5, 5);
+         TH2D h2("concurrent_h2", "", 20, -5, 5, 20, -2, 2);
+         TH2D h2ref("concurrent_h2ref", "", 20, -5, 5, 20, -2, 2);
+         h1.Fill(1.);
+         h1ref.Fill(1.);
+         {
+            TH1ConcurrentFiller f1(h1, nslots, mode);
+            TH1ConcurrentFiller f2(h2, nslots, mode);
+            EXPECT_EQ(f1.GetMode(), mode);
+            std::vector<std::thread> threads;
+            for (int t = 0; t < nthreads; ++t) {
+               threads.emplace_back([&, t]() {
+                  for (int i = 0; i < n; ++i) {
+                     f1.Fill(x(t, i), w(t, i));
+                     f2.Fill(x(t, i), y(t, i));
+                  }
+               });
+            }
+            for (auto &thread : threads)
+               thread.join();
+         }
+         for (int t = 0; t < nthreads; ++t) {
+            for (int i = 0; i < n; ++i) {
+               h1ref.Fill(x(t, i), w(t, i));
+               h2ref.Fill(x(t, i), y(t, i));
+            }
+         }
+
+         for (auto hists : {std::make_pair<TH1 *, TH1 *>(&h1, &h1ref), std::make_pair<TH1 *, TH1 *>(&h2, &h2ref)}) {
+            EXPECT_EQ(hists.first->GetEntries(), hists.second->GetEntries());
+            EXPECT_EQ(hists.first->GetSumw2N(), hists.second->GetSumw2N());
+            for (int bin = 0; bin < hists.first->GetNcells(); ++bin) {
+               EXPECT_EQ(hists.first->GetBinContent(bin), hists.second->GetBinContent(bin)) << "bin " << bin;
+               EXPECT_EQ(hists.first->GetBinError(bin), hists.second->GetBinError(bin)) << "bin " << bin;
+            }
+            Double_t s1[TH1::kNstat], s2[TH1::kNstat];
+            hists.first->GetStats(s1);
+            hists.second->GetStats(s2);
+            for (int i = 0; i < TH1::kNstat; ++i)
+               EXPECT_NEAR(s1[i], s2[i], 1e-9 * (1 + std::abs(s2[i]))) << "statistics " << i;
+         }
+      }
+   }
+}
+
+// Histograms created concurrently in a TH1Registry are registered once and found by all the threads
+TEST(TH1, Registry)
+{
+   const int nthreads = 4;
+   const int nhists = 2000;
+   // The histograms are constructed concurrently.
+   ROOT::EnableThreadSafety();
+   TH1Registry registry;
+   std::vector<std::vector<TH1D *>> seen(nthreads, std::vector<TH1D *>(nhists));
+   std::vector<std::thread> threads;
+   for (int t = 0; t < nthreads; ++t) {
+      threads.emplace_back([&, t]() {
+         for (int i = 0; i < nhists; ++i) {
+            // threads go through the names in different orders
+            const int k = (i * (2 * t + 1)) % nhists;
+            TString name = TString::Format("registry_h%d", k);
+            TH1D *h = registry.GetOrCreate<TH1D>(name, "", 10, 0., 10.);
+            ASSERT_NE(h, nullptr);
+            EXPECT_EQ(registry.Get(name), h);
+            seen[t][k] = h;
+         }
+      });
+   }
+   for (auto &thread : threads)
+      thread.join();
+
+   EXPECT_EQ(registry.GetSize(), nhists);
+   for (int k = 0; k < nhists; ++k) {
+      TH1D *h = registry.Get<TH1D>(TString::Format("registry_h%d", k));
+      ASSERT_NE(h, nullptr);
+      EXPECT_EQ(h->GetDirectory(), nullptr);
+      for (int t = 0; t < nthreads; ++t)
+         EXPECT_EQ(seen[t][k], h);
+      h->Fill(k % 10, k);
+   }
+   EXPECT_EQ(registry.Get("registry_none"), nullptr);
+   EXPECT_EQ(registry.Get<TH2D>("registry_h1"), nullptr);
+   EXPECT_EQ((registry.GetOrCreate<TH2D>("registry_h1", "", 2, 0., 1., 2, 0., 1.)), nullptr);
+
+   TH1D *other = new TH1D("registry_h1", "", 5, 0., 1.);
+   EXPECT_FALSE(registry.Add(other));
+   delete other;
+   EXPECT_TRUE(registry.Add(new TH1D("registry_added", "", 5, 0., 1.)));
+   EXPECT_EQ(registry.GetSize(), nhists + 1);
+
+   std::unique_ptr<TList> snapshot(registry.Snapshot());
+   EXPECT_EQ(snapshot->GetSize(), nhists + 1);
+   for (TObject *obj : *snapshot) {
+      auto copy = static_cast<TH1 *>(obj);
+      TH1 *h = registry.Get(copy->GetName());
+      ASSERT_NE(h, nullptr);
+      EXPECT_NE(copy, h);
+      EXPECT_EQ(copy->GetDirectory(), nullptr);
+      EXPECT_EQ(copy->GetSumOfWeights(), h->GetSumOfWeights());
+   }
+}
+
+// Abscissas on duplicate edges go to the same bins as with FindFixBin (first of the equal edges)
+TEST(TH1, FindFixBinsDuplicateEdges)
+{
+   const double edges[] = {-2, -1, -1, 0, 0, 0, 1, 2, 2};
+   TAxis axis(8, edges);
+   std::vector<double> x;
+   for (double v = -3; v <= 3; v += 0.25)
+      x.push_back(v);
+   x.push_back(NAN);
+   std::vector<int> bins(x.size());
+   axis.FindFixBins(x.size(), x.data(), bins.data(), 1);
+   for (std::size_t i = 0; i < x.size(); ++i)
+      EXPECT_EQ(bins[i], axis.FindFixBin(x[i])) << "x = " << x[i];
+}
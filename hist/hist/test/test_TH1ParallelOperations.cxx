@@ -0,0 +1,221 @@
+#include "gtest/gtest.h"
+
+#include "TH2.h"
+#include "TH3.h"
+#include "THn.h"
+#include "TRandom3.h"
+#include "TROOT.h"
+
+#include <cmath>
+#include <memory>
+
+namespace {
+
+// Runs the operations on the bins of all histograms on many threads for the duration of a test.
+class ParallelOperations {
+   Int_t fOldThreshold;
+
+public:
+   ParallelOperations() : fOldThreshold(TH1::GetParallelThreshold())
+   {
+      TH1::SetParallelThreshold(1);
+#ifdef R__USE_IMT
+      ROOT::EnableImplicitMT(4);
+#endif
+   }
+   ~ParallelOperations()
+   {
+#ifdef R__USE_IMT
+      ROOT::DisableImplicitMT();
+#endif
+      TH1::SetParallelThreshold(fOldThreshold);
+   }
+};
+
+void FillRandom(TH3 &h, UInt_t seed, Bool_t weighted)
+{
+   TRandom3 rng(seed);
+   for (Int_t i = 0; i < 20000; ++i)
+      h.Fill(rng.Gaus(0.5, 0.3), rng.Gaus(0.5, 0.3), rng.Gaus(0.5, 0.3), weighted ? rng.Uniform(0.5, 2.) : 1.);
+}
+
+// Expect the same bin contents and errors; b is filled through the bin by bin code.
+void ExpectSameBins(const TH1 &a, const TH1 &b)
+{
+   ASSERT_EQ(a.GetNcells(), b.GetNcells());
+   for (Int_t bin = 0; bin < a.GetNcells(); ++bin) {
+      EXPECT_EQ(a.GetBinContent(bin), b.GetBinContent(bin)) << "bin " << bin;
+      EXPECT_NEAR(a.GetBinError(bin), b.GetBinError(bin), 1e-12 * (1. + b.GetBinError(bin))) << "bin " << bin;
+   }
+}
+
+} // anonymous namespace
+
+TEST(TH1ParallelOperations, Arithmetic)
+{
+   ParallelOperations parallel;
+   TH3D h1("h1", "h1", 30, 0., 1., 30, 0., 1., 30, 0., 1.);
+   TH3D h2("h2", "h2", 30, 0., 1., 30, 0., 1., 30, 0., 1.);
+   h1.SetDirectory(nullptr);
+   h2.SetDirectory(nullptr);
+   h1.Sumw2();
+   h2.Sumw2();
+   FillRandom(h1, 1, kTRUE);
+   FillRandom(h2, 2, kTRUE);
+
+   std::unique_ptr<TH3D> sum(static_cast<TH3D *>(h1.Clone("sum")));
+   sum->Add(&h2, 2.);
+   std::unique_ptr<TH3D> prod(static_cast<TH3D *>(h1.Clone("prod")));
+   prod->Multiply(&h2);
+   std::unique_ptr<TH3D> ratio(static_cast<TH3D *>(h1.Clone("ratio")));
+   ratio->Divide(&h2);
+   std::unique_ptr<TH3D> ratio2(static_cast<TH3D *>(h1.Clone("ratio2")));
+   ratio2->Divide(&h1, &h2, 1., 3.);
+
+   for (Int_t bin = 0; bin < h1.GetNcells(); ++bin) {
+      const Double_t c1 = h1.GetBinContent(bin);
+      const Double_t c2 = h2.GetBinContent(bin);
+      const Double_t e1sq = h1.GetBinError(bin) * h1.GetBinError(bin);
+      const Double_t e2sq = h2.GetBinError(bin) * h2.GetBinError(bin);
+      EXPECT_EQ(sum->GetBinContent(bin), c1 + 2. * c2);
+      EXPECT_NEAR(sum->GetBinError(bin), std::sqrt(e1sq + 4. * e2sq), 1e-12);
+      EXPECT_EQ(prod->GetBinContent(bin), c1 * c2);
+      EXPECT_NEAR(prod->GetBinError(bin), std::sqrt(e1sq * c2 * c2 + e2sq * c1 * c1), 1e-10);
+      if (c2 == 0.) {
+         EXPECT_EQ(ratio->GetBinContent(bin), 0.);
+         EXPECT_EQ(ratio2->GetBinContent(bin), 0.);
+         continue;
+      }
+      EXPECT_DOUBLE_EQ(ratio->GetBinContent(bin), c1 / c2);
+      EXPECT_NEAR(ratio->GetBinError(bin), std::sqrt(e1sq * c2 * c2 + e2sq * c1 * c1) / (c2 * c2), 1e-10);
+      EXPECT_DOUBLE_EQ(ratio2->GetBinContent(bin), c1 / (3. * c2));
+   }
+}
+
+TEST(TH1ParallelOperations, Projections)
+{
+   ParallelOperations parallel;
+   // Unit weights: the TH3I goes through the bin by bin code and gives the same results.
+   TH3D hd("hd", "hd", 20, 0., 1., 30, 0., 1., 25, 0., 1.);
+   TH3I hi("hi", "hi", 20, 0., 1., 30, 0., 1., 25, 0., 1.);
+   hd.SetDirectory(nullptr);
+   hi.SetDirectory(nullptr);
+   hd.Sumw2();
+   FillRandom(hd, 3, kFALSE);
+   FillRandom(hi, 3, kFALSE);
+
+   for (const char *option : {"x", "ye", "zx", "yxe", "zye"}) {
+      std::unique_ptr<TH1> pd(hd.Project3D(option));
+      std::unique_ptr<TH1> pi(hi.Project3D(option));
+      pd->SetDirectory(nullptr);
+      pi->SetDirectory(nullptr);
+      ExpectSameBins(*pd, *pi);
+   }
+
+   hd.GetZaxis()->SetRange(5, 15);
+   hi.GetZaxis()->SetRange(5, 15);
+   std::unique_ptr<TH1> pd(hd.Project3D("xy"));
+   std::unique_ptr<TH1> pi(hi.Project3D("xy"));
+   pd->SetDirectory(nullptr);
+   pi->SetDirectory(nullptr);
+   ExpectSameBins(*pd, *pi);
+
+   std::unique_ptr<TH2> hd2(static_cast<TH2 *>(hd.Project3D("yxe")));
+   std::unique_ptr<TH2> hi2(static_cast<TH2 *>(hi.Project3D("yxe")));
+   hd2->SetDirectory(nullptr);
+   hi2->SetDirectory(nullptr);
+   std::unique_ptr<TH1D> pxd(hd2->ProjectionX("pxd", 3, 10, "e"));
+   std::unique_ptr<TH1D> pxi(hi2->ProjectionX("pxi", 3, 10, "e"));
+   ExpectSameBins(*pxd, *pxi);
+   std::unique_ptr<TH1D> pyd(hd2->ProjectionY("pyd"));
+   std::unique_ptr<TH1D> pyi(hi2->ProjectionY("pyi"));
+   ExpectSameBins(*pyd, *pyi);
+}
+
+TEST(TH1ParallelOperations, Rebin)
+{
+   ParallelOperations parallel;
+   TH3D h("h", "h", 20, 0., 1., 30, 0., 1., 25, 0., 1.);
+   h.SetDirectory(nullptr);
+   h.Sumw2();
+   FillRandom(h, 4, kTRUE);
+
+   std::unique_ptr<TH3> rebinned(h.Rebin3D(2, 3, 5, "rebinned"));
+   rebinned->SetDirectory(nullptr);
+   EXPECT_DOUBLE_EQ(rebinned->GetEntries(), h.GetEntries());
+   for (Int_t x = 1; x <= 10; ++x) {
+      for (Int_t y = 1; y <= 10; ++y) {
+         for (Int_t z = 1; z <= 5; ++z) {
+            Double_t cont = 0.;
+            Double_t err2 = 0.;
+            for (Int_t i = 0; i < 2; ++i) {
+               for (Int_t j = 0; j < 3; ++j) {
+                  for (Int_t k = 0; k < 5; ++k) {
+                     const Int_t bin = h.GetBin(2 * x - 1 + i, 3 * y - 2 + j, 5 * z - 4 + k);
+                     cont += h.GetBinContent(bin);
+                     err2 += h.GetBinError(bin) * h.GetBinError(bin);
+                  }
+               }
+            }
+            EXPECT_NEAR(rebinned->GetBinContent(x, y, z), cont, 1e-10);
+            EXPECT_NEAR(rebinned->GetBinError(x, y, z), std::sqrt(err2), 1e-10);
+         }
+      }
+   }
+
+   std::unique_ptr<TH2> h2(static_cast<TH2 *>(h.Project3D("yx")));
+   h2->SetDirectory(nullptr);
+   std::unique_ptr<TH2> rebinned2(h2->Rebin2D(4, 5, "rebinned2"));
+   rebinned2->SetDirectory(nullptr);
+   for (Int_t x = 0; x <= 6; ++x) {
+      for (Int_t y = 0; y <= 7; ++y) {
+         const Int_t firstx = x == 0 ? 0 : 4 * x - 3;
+         const Int_t lastx = x == 6 ? 21 : (x == 0 ? 0 : 4 * x);
+         const Int_t firsty = y == 0 ? 0 : 5 * y - 4;
+         const Int_t lasty = y == 7 ? 31 : (y == 0 ? 0 : 5 * y);
+         Double_t cont = 0.;
+         for (Int_t i = firstx; i <= lastx; ++i) {
+            for (Int_t j = firsty; j <= lasty; ++j)
+               cont += h2->GetBinContent(i, j);
+         }
+         EXPECT_NEAR(rebinned2->GetBinContent(x, y), cont, 1e-10);
+      }
+   }
+}
+
+TEST(TH1ParallelOperations, THnProjection)
+{
+   ParallelOperations parallel;
+   Int_t bins[4] = {10, 12, 8, 9};
+   Double_t xmin[4] = {0., 0., 0., 0.};
+   Double_t xmax[4] = {1., 1., 1., 1.};
+   // Unit weights: the THnI goes through the bin by bin code and gives the same results.
+   THnD hd("hnd", "hnd", 4, bins, xmin, xmax);
+   THnI hi("hni", "hni", 4, bins, xmin, xmax);
+   hd.Sumw2();
+   TRandom3 rng(5);
+   Double_t x[4];
+   for (Int_t i = 0; i < 20000; ++i) {
+      for (auto &xi : x)
+         xi = rng.Gaus(0.5, 0.3);
+      hd.Fill(x);
+      hi.Fill(x);
+   }
+
+   std::unique_ptr<TH1D> pd(hd.Projection(2, "e"));
+   std::unique_ptr<TH1D> pi(hi.Projection(2, "e"));
+   ExpectSameBins(*pd, *pi);
+   EXPECT_DOUBLE_EQ(pd->GetEntries(), pi->GetEntries());
+
+   hd.GetAxis(1)->SetRange(3, 7);
+   hi.GetAxis(1)->SetRange(3, 7);
+   hd.GetAxis(3)->SetRange(2, 5);
+   hi.GetAxis(3)->SetRange(2, 5);
+   std::unique_ptr<TH2D> p2d(hd.Projection(3, 1, "e"));
+   std::unique_ptr<TH2D> p2i(hi.Projection(3, 1, "e"));
+   ExpectSameBins(*p2d, *p2i);
+   EXPECT_DOUBLE_EQ(p2d->GetEntries(), p2i->GetEntries());
+   std::unique_ptr<TH3D> p3d(hd.Projection(0, 1, 3, "o"));
+   std::unique_ptr<TH3D> p3i(hi.Projection(0, 1, 3, "o"));
+   ExpectSameBins(*p3d, *p3i);
+}
@@ -8,6 +8,13 @@
 #include "TVirtualPad.h"
 #include "TF1.h"
 #include "TH1.h"
+#include "TMath.h"
+#include "TROOT.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
 
 struct  TestKDE  {
 
@@ -209,3 +216,73 @@ TEST(TKDE, tkde_io_binned)
    }
 }
 
+
+/// Evaluation algorithms
+/// The pruned sum gives the direct sum up to rounding, the FFT evaluation agrees within its tolerance
+void CompareEvaluations(const TString &opt)
+{
+   std::vector<double> v(20000);
+   for (size_t i = 0; i < v.size(); ++i) v[i] = (i < 0.2 * v.size()) ? gRandom->Gaus(10, 1) : gRandom->Gaus(10, 4);
+   std::vector<double> x(200), direct(x.size()), values(x.size());
+   for (size_t i = 0; i < x.size(); ++i) x[i] = -5. + 0.15 * i;
+
+   TKDE kde(v.size(), v.data(), 0., 20., opt + ";Evaluation:Direct", 1);
+   kde.GetValues(x.size(), x.data(), direct.data());
+   double maxValue = *std::max_element(direct.begin(), direct.end());
+   for (size_t i = 0; i < x.size(); ++i)
+      EXPECT_DOUBLE_EQ(direct[i], kde(x[i]));
+
+   TKDE pruned(v.size(), v.data(), 0., 20., opt + ";Evaluation:Pruned", 1);
+   pruned.GetValues(x.size(), x.data(), values.data());
+   for (size_t i = 0; i < x.size(); ++i)
+      EXPECT_NEAR(values[i], direct[i], 1.E-12 * maxValue) << opt << " x = " << x[i];
+
+   TKDE fft(v.size(), v.data(), 0., 20., opt + ";Evaluation:FFT", 1);
+   fft.GetValues(x.size(), x.data(), values.data());
+   for (size_t i = 0; i < x.size(); ++i)
+      EXPECT_NEAR(values[i], direct[i], 1.E-3 * maxValue) << opt << " x = " << x[i];
+}
+
+TEST(TKDE, tkde_evaluation)
+{
+   CompareEvaluations("KernelType:Gaussian;Iteration:Fixed;Mirror:noMirror;Binning:Unbinned");
+   CompareEvaluations("KernelType:Gaussian;Iteration:Adaptive;Mirror:noMirror;Binning:Unbinned");
+   CompareEvaluations("KernelType:Epanechnikov;Iteration:Fixed;Mirror:MirrorAsymBoth;Binning:Unbinned");
+   CompareEvaluations("KernelType:Biweight;Iteration:Fixed;Mirror:MirrorLeft;Binning:ForcedBinning");
+}
+
+#ifdef R__USE_IMT
+/// Gaussian kernel counting the calls made from another thread than the one which created it.
+struct ThreadCheckingKernel {
+   std::thread::id fThread = std::this_thread::get_id();
+   mutable std::atomic<int> fCallsFromOtherThreads{0};
+   double operator()(double x) const
+   {
+      if (std::this_thread::get_id() != fThread)
+         ++fCallsFromOtherThreads;
+      return TMath::Gaus(x, 0., 1., true);
+   }
+};
+
+/// User defined kernels may not be thread safe: they are evaluated serially even with implicit MT.
+TEST(TKDE, tkde_user_kernel_serial)
+{
+   ROOT::EnableImplicitMT(4);
+   std::vector<double> v(1000);
+   TRandom r(3);
+   for (auto &xi : v)
+      xi = r.Gaus(10, 2);
+   ThreadCheckingKernel kernel;
+   TKDE kde("kde", kernel, v.size(), v.data(), 0., 20.,
+            "KernelType:UserDefined;Iteration:Fixed;Mirror:noMirror;Binning:Unbinned", 1);
+   std::vector<double> x(10000);
+   for (size_t i = 0; i < x.size(); ++i)
+      x[i] = 20. * i / x.size();
+   std::vector<double> values(x.size());
+   kde.GetValues(x.size(), x.data(), values.data());
+   ROOT::DisableImplicitMT();
+
+   EXPECT_EQ(kernel.fCallsFromOtherThreads, 0);
+   EXPECT_GT(values[x.size() / 2], 0.);
+}
+#endif
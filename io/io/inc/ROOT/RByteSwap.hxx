@@ -0,0 +1,63 @@
+// @(#)root/io:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2020, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_RByteSwap
+#define ROOT_RByteSwap
+
+#include "RtypesCore.h"
+
+#include <cstddef>
+
+namespace ROOT {
+namespace Internal {
+
+/**
+\namespace ROOT::Internal::ByteSwap
+\ingroup IO
+\brief Bulk byte-swapping kernels for arrays of fundamental types.
+
+ROOT files store numbers in big-endian order. These functions convert whole
+arrays between the in-memory and the on-disk representation. On x86-64 the
+swapping is done with SSSE3, AVX2 or AVX-512BW byte shuffles, selected at run
+time according to the instruction sets supported by the CPU; elsewhere a
+portable scalar loop is used.
+
+The CopyNN functions swap unconditionally, like memcpy with reversed bytes in
+each element (`n` is a number of elements, not of bytes). The Read and Write
+functions go from and to the on-disk (big-endian) representation, and only
+swap on little-endian hosts.
+*/
+namespace ByteSwap {
+
+enum class EKernel { kAuto, kScalar, kSSSE3, kAVX2, kAVX512 };
+
+void Copy16(void *to, const void *from, std::size_t n);
+void Copy32(void *to, const void *from, std::size_t n);
+void Copy64(void *to, const void *from, std::size_t n);
+
+// Double32_t without range nor number of bits: stored as Float_t.
+void ReadFloatAsDouble(Double_t *to, const char *buf, std::size_t n);
+void WriteDoubleAsFloat(char *buf, const Double_t *from, std::size_t n);
+
+// Float16_t and Double32_t with a range: stored as UInt_t scaled by factor.
+void ReadWithFactor(Float_t *to, const char *buf, std::size_t n, Double_t factor, Double_t xmin);
+void ReadWithFactor(Double_t *to, const char *buf, std::size_t n, Double_t factor, Double_t xmin);
+void WriteWithFactor(char *buf, const Float_t *from, std::size_t n, Double_t factor, Double_t xmin, Double_t xmax);
+void WriteWithFactor(char *buf, const Double_t *from, std::size_t n, Double_t factor, Double_t xmin, Double_t xmax);
+
+bool SetKernel(EKernel kernel);
+EKernel GetKernel();
+const char *GetKernelName(EKernel kernel);
+
+} // namespace ByteSwap
+} // namespace Internal
+} // namespace ROOT
+
+#endif
@@ -15,10 +15,12 @@
 #include "TFileMerger.h"
 #include "TMemFile.h"
 
+#include <condition_variable>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <queue>
+#include <thread>
 
 namespace ROOT {
 namespace Experimental {
@@ -93,6 +95,23 @@ public:
     */
    void SetMergeOptions(const TString& options);
 
+   /** Merge the queued buffers in a dedicated output thread, instead of in
+    *  the threads calling TBufferMergerFile::Write(). Writers then only queue
+    *  their data and return to filling, while the output thread merges in the
+    *  background; merging is thus pipelined with the production of the data
+    *  instead of stalling one of the writers. Since all TBufferMergerFiles use
+    *  the compression settings of the output file, combining this with
+    *  SetMergeOptions("fast") lets the output thread append the already
+    *  compressed baskets to the output trees without decompressing them.
+    *  Must be called before the first call to GetFile().
+    *  @param maxBuffered If not zero, writers block while more than this
+    *  number of bytes is waiting to be merged, to bound the memory usage.
+    */
+   void EnableBackgroundMerge(size_t maxBuffered = 0);
+
+   /** Returns whether buffers are merged by a dedicated output thread. */
+   bool IsBackgroundMerge() const { return fBackgroundMerge; }
+
    friend class TBufferMergerFile;
 
 private:
@@ -108,15 +127,23 @@ private:
    void Init(std::unique_ptr<TFile>);
 
    void Merge();
-   void Push(TBufferFile *buffer);
+   void MergeQueue(std::queue<TMemFile::BlockListPtr_t> &queue);
+   void MergeLoop();
+   void Push(TMemFile::BlockListPtr_t blocks, size_t size);
 
    size_t fAutoSave{0};                                          //< AutoSave only every fAutoSave bytes
    size_t fBuffered{0};                                          //< Number of bytes currently buffered
    TFileMerger fMerger{false, false};                            //< TFileMerger used to merge all buffers
    std::mutex fMergeMutex;                                       //< Mutex used to lock fMerger
    std::mutex fQueueMutex;                                       //< Mutex used to lock fQueue
-   std::queue<TBufferFile *> fQueue;                             //< Queue to which data is pushed and merged
+   std::queue<TMemFile::BlockListPtr_t> fQueue;                  //< Queue to which data is pushed and merged
    std::vector<std::weak_ptr<TBufferMergerFile>> fAttachedFiles; //< Attached files
+   bool fBackgroundMerge{false};                                 //< Whether buffers are merged by fMergeThread
+   bool fStopMerging{false};                                     //< Tells fMergeThread to merge what is left and exit
+   size_t fMaxBuffered{0};                                       //< Maximum number of bytes queued for background merging
+   std::condition_variable fDataAvailable;                       //< Wakes up fMergeThread
+   std::condition_variable fSpaceAvailable;                      //< Wakes up writers waiting for room in the queue
+   std::thread fMergeThread;                                     //< Output thread merging in the background
 };
 
 /**
@@ -153,7 +180,7 @@ public:
 
    using TMemFile::Write;
 
-   /** Write data into a TBufferFile and append it to TBufferMerger.
+   /** Hand the data over to TBufferMerger, without copying it.
     * @param name Name
     * @param opt  Options
     * @param bufsize Buffer size
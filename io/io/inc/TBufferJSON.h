@@ -16,6 +16,7 @@
 #include "TString.h"
 
 #include <deque>
+#include <iosfwd>
 #include <memory>
 #include <string>
 #include <vector>
@@ -58,7 +59,9 @@ public:
    Bool_t IsSkipClassInfo(const TClass *cl) const;
 
    TString StoreObject(const void *obj, const TClass *cl);
+   Long64_t StoreObject(const void *obj, const TClass *cl, std::ostream &out);
    void *RestoreObject(const char *str, TClass **cl);
+   void *RestoreObject(std::istream &in, TClass **cl);
 
    static TString ConvertToJSON(const TObject *obj, Int_t compact = 0, const char *member_name = nullptr);
    static TString
@@ -70,6 +73,7 @@ public:
 
    static TObject *ConvertFromJSON(const char *str);
    static void *ConvertFromJSONAny(const char *str, TClass **cl = nullptr);
+   static void *ConvertFromJSONAny(std::istream &in, TClass **cl = nullptr);
 
    template <class T>
    static TString ToJSON(const T *obj, Int_t compact = 0, const char *member_name = nullptr)
@@ -296,6 +300,10 @@ protected:
 
    void AppendOutput(const char *line0, const char *line1 = nullptr);
 
+   void JsonFlushOutput();
+
+   void *JsonReadDocument(void *docu, TClass **cl);
+
    void JsonPushValue();
 
    template <typename T>
@@ -316,6 +324,8 @@ protected:
 
    TString fOutBuffer;                 ///<!  main output buffer for json code
    TString *fOutput{nullptr};          ///<!  current output buffer for json code
+   std::ostream *fOutStream{nullptr};  ///<!  stream where main output buffer is flushed, when writing with streaming
+   Long64_t fOutStreamed{0};           ///<!  number of bytes already flushed to fOutStream
    TString fValue;                     ///<!  buffer for current value
    unsigned fJsonrCnt{0};              ///<!  counter for all objects, used for referencing
    std::deque<std::unique_ptr<TJSONStackObj>> fStack; ///<!  hierarchy of currently streamed element
@@ -26,9 +26,18 @@
 #include "TDatime.h"
 #include "TList.h"
 
+#include <string>
+#include <vector>
+
 class TKey;
 class TFile;
 
+namespace ROOT {
+namespace Internal {
+struct RKeysIndex;
+}
+}
+
 class TDirectoryFile : public TDirectory {
 
 protected:
@@ -44,10 +53,18 @@ protected:
    Long64_t    fSeekKeys{0};             ///< Location of Keys record on file
    TFile      *fFile{nullptr};           ///< Pointer to current file in memory
    TList      *fKeys{nullptr};           ///< Pointer to keys list in memory
+   mutable ROOT::Internal::RKeysIndex *fKeysIndex{nullptr}; ///<! Keys not yet in fKeys of a read-only directory (see ReadKeys)
 
    void        CleanTargets();
    void        InitDirectoryFile(TClass *cl = nullptr);
    void        BuildDirectoryFile(TFile* motherFile, TDirectory* motherDir);
+   TKey       *CreateIndexedKey(Int_t entry) const;
+   void        DeleteKeysIndex();
+   TKey       *FindKeyWithCycle(const char *name, Short_t cycle) const;
+   void        LoadAllKeys() const;
+   void        LoadIndexedKeys(const char *name) const;
+   void        ReadObjectsBulk(const std::vector<TKey *> &keys, std::vector<TObject *> &objects, UInt_t nthreads);
+   Bool_t      ReadKeysIndex(const char *buffer, Int_t len);
 
 private:
    TDirectoryFile(const TDirectoryFile &directory) = delete;  //Directories cannot be copied
@@ -86,14 +103,16 @@ public:
            void       *GetObjectChecked(const char *namecycle, const char* classname) override;
            void       *GetObjectChecked(const char *namecycle, const TClass* cl) override;
            void       *GetObjectUnchecked(const char *namecycle) override;
+   std::vector<TObject *> GetObjectsBulk(const std::vector<std::string> &namecycles, UInt_t nthreads = 0);
+   std::vector<TObject *> GetObjectsBulk(const char *pattern, UInt_t nthreads = 0);
            Int_t       GetBufferSize() const override;
    const TDatime      &GetCreationDate() const { return fDatimeC; }
            TFile      *GetFile() const override { return fFile; }
            TKey       *GetKey(const char *name, Short_t cycle=9999) const override;
-           TList      *GetListOfKeys() const override { return fKeys; }
+           TList      *GetListOfKeys() const override { if (fKeysIndex) LoadAllKeys(); return fKeys; }
    const TDatime      &GetModificationDate() const { return fDatimeM; }
            Int_t       GetNbytesKeys() const override { return fNbytesKeys; }
-           Int_t       GetNkeys() const override { return fKeys->GetSize(); }
+           Int_t       GetNkeys() const override;
            Long64_t    GetSeekDir() const override { return fSeekDir; }
            Long64_t    GetSeekParent() const override { return fSeekParent; }
            Long64_t    GetSeekKeys() const override { return fSeekKeys; }
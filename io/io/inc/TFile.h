@@ -51,6 +51,12 @@ class TProcessID;
 class TStopwatch;
 class TFilePrefetch;
 
+namespace ROOT {
+namespace Internal {
+class RFileAsyncWriter;
+}
+}
+
 class TFile : public TDirectoryFile {
   friend class TDirectoryFile;
   friend class TFilePrefetch;
@@ -100,6 +106,10 @@ protected:
    TMap            *fCacheReadMap{nullptr};   ///<!Pointer to the read cache (if any)
    TFileCacheWrite *fCacheWrite{nullptr};     ///<!Pointer to the write cache (if any)
    Long64_t         fArchiveOffset{0};        ///<!Offset at which file starts in archive
+   char            *fMapping{nullptr};        ///<!Read-only memory mapping of the whole file (if any)
+   Long64_t         fMappingSize{0};          ///<!Number of bytes in fMapping
+   Long64_t         fMappingPos{0};           ///<!Position of the file cursor in fMapping
+   ROOT::Internal::RFileAsyncWriter *fAsyncWriter{nullptr}; ///<!Background thread writing the buffers (if any)
    Bool_t           fIsArchive{kFALSE};       ///<!True if this is a pure archive file
    Bool_t           fNoAnchorInName{kFALSE};  ///<!True if we don't want to force the anchor to be appended to the file name
    Bool_t           fIsRootFile{kTRUE};       ///<!True is this is a ROOT file, raw file otherwise
@@ -131,12 +141,17 @@ protected:
    static std::atomic<Long64_t>  fgFileCounter;           ///<Counter for all opened files
    static std::atomic<Int_t>     fgReadCalls;             ///<Number of bytes read from all TFile objects
    static Int_t     fgReadaheadSize;         ///<Readahead buffer size
+   static Int_t     fgReadCoalesceGap;       ///<Largest hole between two blocks merged into a single vectored read
    static Bool_t    fgReadInfo;              ///<if true (default) ReadStreamerInfo is called when opening a file
 
    virtual EAsyncOpenStatus GetAsyncOpenStatus() { return fAsyncOpenStatus; }
    virtual void        Init(Bool_t create);
            Bool_t      FlushWriteCache();
            Int_t       ReadBufferViaCache(char *buf, Int_t len);
+           Bool_t      ReadBuffersVectored(char *buf, Long64_t *pos, Int_t *len, Int_t nbuf);
+           Bool_t      MapFile();
+           void        UnmapFile();
+           Bool_t      WaitAsyncWrites();
            Int_t       WriteBufferViaCache(const char *buf, Int_t len);
 
    ////////////////////////////////////////////////////////////////////////////////
@@ -186,7 +201,8 @@ public:
       kWriteError    = BIT(14),
       kBinaryFile    = BIT(15),
       kRedirected    = BIT(16),
-      kReproducible  = BIT(17)
+      kReproducible  = BIT(17),
+      kKeysIndex     = BIT(18)
    };
    enum ERelativeTo { kBeg = 0, kCur = 1, kEnd = 2 };
    enum { kStartBigFile  = 2000000000 };
@@ -207,10 +223,15 @@ public:
            void        Delete(const char *namecycle="") override;
            void        Draw(Option_t *option="") override;
    virtual void        DrawMap(const char *keys="*",Option_t *option=""); // *MENU*
+           Bool_t      EnableAsyncWrite(Long64_t maxQueued = 0);
+           void        DisableAsyncWrite();
            void        FillBuffer(char *&buffer) override;
    virtual void        Flush();
          TArchiveFile *GetArchive() const { return fArchive; }
            Long64_t    GetArchiveOffset() const { return fArchiveOffset; }
+           Long64_t    GetAsyncWriteQueued() const;
+           Int_t       GetAsyncWriteQueueDepth() const;
+           Double_t    GetAsyncWriteRate() const;
            Int_t       GetBestBuffer() const;
    virtual Int_t       GetBytesToPrefetch() const;
        TFileCacheRead *GetCacheRead(const TObject* tree = nullptr) const;
@@ -237,6 +258,7 @@ public:
            Int_t       GetVersion() const { return fVersion; }
            Int_t       GetRecordHeader(char *buf, Long64_t first, Int_t maxbytes,
                                        Int_t &nbytes, Int_t &objlen, Int_t &keylen);
+           char       *GetMappedBuffer(Long64_t pos, Int_t len);
    virtual Int_t       GetNbytesInfo() const {return fNbytesInfo;}
    virtual Int_t       GetNbytesFree() const {return fNbytesFree;}
    virtual TString     GetNewUrl() { return ""; }
@@ -249,6 +271,8 @@ public:
    virtual void        IncrementProcessIDs() { fNProcessIDs++; }
    virtual Bool_t      IsArchive() const { return fIsArchive; }
            Bool_t      IsBinary() const { return TestBit(kBinaryFile); }
+           Bool_t      IsMapped() const { return fMapping != nullptr; }
+           Bool_t      IsAsyncWrite() const { return fAsyncWriter != nullptr; }
            Bool_t      IsRaw() const { return !fIsRootFile; }
    virtual Bool_t      IsOpen() const;
            void        ls(Option_t *option="") const override;
@@ -310,11 +334,13 @@ public:
    static Long64_t     GetFileBytesWritten();
    static Int_t        GetFileReadCalls();
    static Int_t        GetReadaheadSize();
+   static Int_t        GetReadCoalesceGap();
 
    static void         SetFileBytesRead(Long64_t bytes = 0);
    static void         SetFileBytesWritten(Long64_t bytes = 0);
    static void         SetFileReadCalls(Int_t readcalls = 0);
    static void         SetReadaheadSize(Int_t bufsize = 256000);
+   static void         SetReadCoalesceGap(Int_t bytes = 65536);
    static void         SetReadStreamerInfo(Bool_t readinfo=kTRUE);
    static Bool_t       GetReadStreamerInfo();
 
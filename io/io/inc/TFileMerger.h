@@ -17,6 +17,7 @@
 #include "TString.h"
 #include "TStopwatch.h"
 #include <string>
+#include <unordered_map>
 
 class TFile;
 class TDirectory;
@@ -52,8 +53,13 @@ protected:
    TString        fObjectNames;               ///< List of object names to be either merged exclusively or skipped
    TList          fMergeList;                 ///< list of TObjString containing the name of the files need to be merged
    TList          fExcessFiles;               ///<! List of TObjString containing the name of the files not yet added to fFileList due to user or system limitiation on the max number of files opened.
+   UInt_t         fNThreads{1};               ///<! Number of threads used to open the input files and merge the objects
+   std::unordered_map<std::string, TObject *> fPreMerged; ///<! Objects merged over all of fFileList by ParallelPreMerge, by path
 
    Bool_t         OpenExcessFiles();
+   void           ParallelPreMerge(Int_t type);
+   TObject       *TakePreMerged(const TString &path, const char *name);
+   void           ClearPreMerged();
    virtual Bool_t AddFile(TFile *source, Bool_t own, Bool_t cpProgress);
    virtual Bool_t MergeRecursive(TDirectory *target, TList *sourcelist, Int_t type = kRegular | kAll);
 
@@ -84,6 +90,8 @@ public:
    TFile      *GetOutputFile() const { return fOutputFile; }
    Int_t       GetMaxOpenedFiles() const { return fMaxOpenedFiles; }
    void        SetMaxOpenedFiles(Int_t newmax);
+   UInt_t      GetNThreads() const { return fNThreads; }
+   void        SetNThreads(UInt_t nthreads);
    const char *GetMsgPrefix() const { return fMsgPrefix; }
    void        SetMsgPrefix(const char *prefix);
    const char *GetMergeOptions() { return fMergeOptions; }
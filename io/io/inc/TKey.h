@@ -69,6 +69,7 @@ protected:
    TKey(Long64_t pointer, Int_t nbytes, TDirectory* motherDir = 0);
    virtual ~TKey();
 
+           void        AttachToDirectory(TObject *obj);
    virtual void        Browse(TBrowser *b);
    virtual void        Delete(Option_t *option="");
    virtual void        DeleteBuffer();
@@ -98,6 +99,7 @@ protected:
    virtual Int_t       Read(TObject *obj);
    virtual TObject    *ReadObj();
    virtual TObject    *ReadObjWithBuffer(char *bufferRead);
+           TObject    *ReadObjFromRecord(const char *record);
    /// To read an object (non deriving from TObject) from the file.
    /// This is more user friendly version of TKey::ReadObjectAny.
    /// See TKey::ReadObjectAny for more details.
@@ -38,11 +38,13 @@ protected:
       ~TMemBlock();
 
       void CreateNext(Long64_t size);
+      void MoveFrom(TMemBlock &other);
 
       TMemBlock *fPrevious{nullptr};
       TMemBlock *fNext{nullptr};
       UChar_t   *fBuffer{nullptr};
       Long64_t   fSize{0};
+      Bool_t     fPooled{kFALSE};  ///< fBuffer was taken from the block pool and is returned to it
    };
    TMemBlock    fBlockList;               ///< Collection of memory blocks of size fgDefaultBlockSize
    ExternalDataPtr_t fExternalData;       ///< shared file data / content
@@ -59,6 +61,8 @@ protected:
 
    Long64_t MemRead(Int_t fd, void *buf, Long64_t len) const;
 
+   std::unique_ptr<TMemBlock> DetachBlocks();
+
    // Overload TFile interfaces.
    Int_t    SysOpen(const char *pathname, Int_t flags, UInt_t mode) override;
    Int_t    SysClose(Int_t fd) override;
@@ -87,6 +91,9 @@ protected:
    TMemFile &operator=(const TMemFile&) = delete; // Not implemented.
 
 public:
+   /// Memory blocks holding the content of a TMemFile, see DetachBlocks().
+   using BlockListPtr_t = std::unique_ptr<TMemBlock>;
+
    TMemFile(const char *name, Option_t *option = "", const char *ftitle = "",
             Int_t compress = ROOT::RCompressionSetting::EDefaults::kUseCompiledDefault, Long64_t defBlockSize = 0LL);
    TMemFile(const char *name, char *buffer, Long64_t size, Option_t *option = "", const char *ftitle = "",
@@ -94,6 +101,7 @@ public:
    TMemFile(const char *name, ExternalDataPtr_t data);
    TMemFile(const char *name, const ZeroCopyView_t &datarange);
    TMemFile(const char *name, std::unique_ptr<TBufferFile> buffer);
+   TMemFile(const char *name, BlockListPtr_t blocks);
    TMemFile(const TMemFile &orig);
    virtual ~TMemFile();
 
@@ -106,6 +114,12 @@ public:
 
            void        Print(Option_t *option="") const override;
 
+   static Long64_t  GetBlockPoolSize();
+   static void      SetBlockPoolSize(Long64_t maxbytes);
+   static Bool_t    GetBlockPoolHugePages();
+   static void      SetBlockPoolHugePages(Bool_t enable = kTRUE);
+   static ULong64_t GetBlockPoolAllocations();
+
    ClassDefOverride(TMemFile, 0) // A ROOT file that reads/writes on a chunk of memory
 };
 
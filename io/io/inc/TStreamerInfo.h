@@ -135,6 +135,8 @@ private:
    void AddWriteTextAction(TStreamerInfoActions::TActionSequence *writeSequence, Int_t index, TCompInfo *compinfo);
    void AddReadMemberWiseVecPtrAction(TStreamerInfoActions::TActionSequence *readSequence, Int_t index, TCompInfo *compinfo);
    void AddWriteMemberWiseVecPtrAction(TStreamerInfoActions::TActionSequence *writeSequence, Int_t index, TCompInfo *compinfo);
+   Int_t AddFusedReadAction(TStreamerInfoActions::TActionSequence *readSequence, Int_t index);
+   Int_t AddFusedWriteAction(TStreamerInfoActions::TActionSequence *writeSequence, Int_t index);
 
 public:
 
@@ -0,0 +1,363 @@
+// @(#)root/io:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2020, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "ROOT/RByteSwap.hxx"
+
+#include "Byteswap.h"
+#include "RConfig.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define R__HAS_X86_BSWAP_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace {
+
+using ROOT::Internal::ByteSwap::EKernel;
+
+// Byte shuffles reversing the bytes of each 2, 4 and 8 bytes element of a 16 bytes lane.
+alignas(16) const char kMask16[16] = {1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14};
+alignas(16) const char kMask32[16] = {3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12};
+alignas(16) const char kMask64[16] = {7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Portable kernels, also used for the tails of the vectorized ones.
+
+void ScalarCopy16(char *to, const char *from, std::size_t n)
+{
+   for (std::size_t i = 0; i < n; ++i) {
+      UShort_t v;
+      memcpy(&v, from + 2 * i, 2);
+      v = Rbswap_16(v);
+      memcpy(to + 2 * i, &v, 2);
+   }
+}
+
+void ScalarCopy32(char *to, const char *from, std::size_t n)
+{
+   for (std::size_t i = 0; i < n; ++i) {
+      UInt_t v;
+      memcpy(&v, from + 4 * i, 4);
+      v = Rbswap_32(v);
+      memcpy(to + 4 * i, &v, 4);
+   }
+}
+
+void ScalarCopy64(char *to, const char *from, std::size_t n)
+{
+   for (std::size_t i = 0; i < n; ++i) {
+      ULong64_t v;
+      memcpy(&v, from + 8 * i, 8);
+      v = Rbswap_64(v);
+      memcpy(to + 8 * i, &v, 8);
+   }
+}
+
+#ifdef R__HAS_X86_BSWAP_KERNELS
+
+////////////////////////////////////////////////////////////////////////////////
+/// Shuffle the bytes of nbytes from `from` to `to` with the given mask, as
+/// long as full vectors are available. Returns the number of bytes processed.
+
+__attribute__((target("ssse3"))) std::size_t ShuffleSSSE3(char *to, const char *from, std::size_t nbytes,
+                                                          const char *mask)
+{
+   const __m128i m = _mm_load_si128(reinterpret_cast<const __m128i *>(mask));
+   std::size_t i = 0;
+   for (; i + 16 <= nbytes; i += 16) {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(from + i));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(to + i), _mm_shuffle_epi8(v, m));
+   }
+   return i;
+}
+
+__attribute__((target("avx2"))) std::size_t ShuffleAVX2(char *to, const char *from, std::size_t nbytes,
+                                                        const char *mask)
+{
+   const __m256i m = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i *>(mask)));
+   std::size_t i = 0;
+   for (; i + 64 <= nbytes; i += 64) {
+      __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(from + i));
+      __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(from + i + 32));
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(to + i), _mm256_shuffle_epi8(v0, m));
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(to + i + 32), _mm256_shuffle_epi8(v1, m));
+   }
+   for (; i + 32 <= nbytes; i += 32) {
+      __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(from + i));
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(to + i), _mm256_shuffle_epi8(v, m));
+   }
+   return i;
+}
+
+__attribute__((target("avx512f,avx512bw"))) std::size_t ShuffleAVX512(char *to, const char *from,
+                                                                     std::size_t nbytes, const char *mask)
+{
+   const __m512i m = _mm512_broadcast_i32x4(_mm_load_si128(reinterpret_cast<const __m128i *>(mask)));
+   std::size_t i = 0;
+   for (; i + 64 <= nbytes; i += 64) {
+      __m512i v = _mm512_loadu_si512(from + i);
+      _mm512_storeu_si512(to + i, _mm512_shuffle_epi8(v, m));
+   }
+   return i;
+}
+
+#endif // R__HAS_X86_BSWAP_KERNELS
+
+using Shuffle_t = std::size_t (*)(char *, const char *, std::size_t, const char *);
+
+std::size_t NoShuffle(char *, const char *, std::size_t, const char *)
+{
+   return 0;
+}
+
+bool IsSupported(EKernel kernel)
+{
+   switch (kernel) {
+   case EKernel::kAuto:
+   case EKernel::kScalar: return true;
+#ifdef R__HAS_X86_BSWAP_KERNELS
+   case EKernel::kSSSE3: return __builtin_cpu_supports("ssse3");
+   case EKernel::kAVX2: return __builtin_cpu_supports("avx2");
+   case EKernel::kAVX512: return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+#endif
+   default: return false;
+   }
+}
+
+EKernel BestKernel()
+{
+   for (auto kernel : {EKernel::kAVX512, EKernel::kAVX2, EKernel::kSSSE3})
+      if (IsSupported(kernel))
+         return kernel;
+   return EKernel::kScalar;
+}
+
+Shuffle_t GetShuffle(EKernel kernel)
+{
+   switch (kernel) {
+#ifdef R__HAS_X86_BSWAP_KERNELS
+   case EKernel::kSSSE3: return ShuffleSSSE3;
+   case EKernel::kAVX2: return ShuffleAVX2;
+   case EKernel::kAVX512: return ShuffleAVX512;
+#endif
+   default: return NoShuffle;
+   }
+}
+
+std::atomic<EKernel> &CurrentKernel()
+{
+   static std::atomic<EKernel> gKernel{BestKernel()};
+   return gKernel;
+}
+
+std::atomic<Shuffle_t> &CurrentShuffle()
+{
+   static std::atomic<Shuffle_t> gShuffle{GetShuffle(CurrentKernel())};
+   return gShuffle;
+}
+
+/// Size of the chunks converted through a temporary buffer on the stack.
+constexpr std::size_t kChunk = 1024;
+
+/// Convert in place a chunk of unsigned integers from on-disk to host order.
+inline void ReadUInts(UInt_t *to, const char *buf, std::size_t n)
+{
+#ifdef R__BYTESWAP
+   ROOT::Internal::ByteSwap::Copy32(to, buf, n);
+#else
+   memcpy(to, buf, 4 * n);
+#endif
+}
+
+inline void WriteUInts(char *buf, const UInt_t *from, std::size_t n)
+{
+#ifdef R__BYTESWAP
+   ROOT::Internal::ByteSwap::Copy32(buf, from, n);
+#else
+   memcpy(buf, from, 4 * n);
+#endif
+}
+
+template <typename T>
+void ReadWithFactorImpl(T *to, const char *buf, std::size_t n, Double_t factor, Double_t xmin)
+{
+   UInt_t tmp[kChunk];
+   for (std::size_t first = 0; first < n; first += kChunk) {
+      const std::size_t len = std::min(kChunk, n - first);
+      ReadUInts(tmp, buf + 4 * first, len);
+      for (std::size_t i = 0; i < len; ++i)
+         to[first + i] = (T)(tmp[i] / factor + xmin);
+   }
+}
+
+template <typename T>
+void WriteWithFactorImpl(char *buf, const T *from, std::size_t n, Double_t factor, Double_t xmin, Double_t xmax)
+{
+   UInt_t tmp[kChunk];
+   for (std::size_t first = 0; first < n; first += kChunk) {
+      const std::size_t len = std::min(kChunk, n - first);
+      for (std::size_t i = 0; i < len; ++i) {
+         T x = from[first + i];
+         if (x < xmin) x = xmin;
+         if (x > xmax) x = xmax;
+         tmp[i] = UInt_t(0.5 + factor * (x - xmin));
+      }
+      WriteUInts(buf + 4 * first, tmp, len);
+   }
+}
+
+} // anonymous namespace
+
+namespace ROOT {
+namespace Internal {
+namespace ByteSwap {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy n 2-bytes elements from `from` to `to`, reversing their bytes.
+
+void Copy16(void *to, const void *from, std::size_t n)
+{
+   auto dst = static_cast<char *>(to);
+   auto src = static_cast<const char *>(from);
+   std::size_t done = CurrentShuffle().load(std::memory_order_relaxed)(dst, src, 2 * n, kMask16);
+   ScalarCopy16(dst + done, src + done, n - done / 2);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy n 4-bytes elements from `from` to `to`, reversing their bytes.
+
+void Copy32(void *to, const void *from, std::size_t n)
+{
+   auto dst = static_cast<char *>(to);
+   auto src = static_cast<const char *>(from);
+   std::size_t done = CurrentShuffle().load(std::memory_order_relaxed)(dst, src, 4 * n, kMask32);
+   ScalarCopy32(dst + done, src + done, n - done / 4);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy n 8-bytes elements from `from` to `to`, reversing their bytes.
+
+void Copy64(void *to, const void *from, std::size_t n)
+{
+   auto dst = static_cast<char *>(to);
+   auto src = static_cast<const char *>(from);
+   std::size_t done = CurrentShuffle().load(std::memory_order_relaxed)(dst, src, 8 * n, kMask64);
+   ScalarCopy64(dst + done, src + done, n - done / 8);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read n floats stored on disk and convert them to doubles.
+
+void ReadFloatAsDouble(Double_t *to, const char *buf, std::size_t n)
+{
+   Float_t tmp[kChunk];
+   for (std::size_t first = 0; first < n; first += kChunk) {
+      const std::size_t len = std::min(kChunk, n - first);
+#ifdef R__BYTESWAP
+      Copy32(tmp, buf + 4 * first, len);
+#else
+      memcpy(tmp, buf + 4 * first, 4 * len);
+#endif
+      for (std::size_t i = 0; i < len; ++i)
+         to[first + i] = tmp[i];
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Convert n doubles to floats and write them in the on-disk representation.
+
+void WriteDoubleAsFloat(char *buf, const Double_t *from, std::size_t n)
+{
+   Float_t tmp[kChunk];
+   for (std::size_t first = 0; first < n; first += kChunk) {
+      const std::size_t len = std::min(kChunk, n - first);
+      for (std::size_t i = 0; i < len; ++i)
+         tmp[i] = (Float_t)from[first + i];
+#ifdef R__BYTESWAP
+      Copy32(buf + 4 * first, tmp, len);
+#else
+      memcpy(buf + 4 * first, tmp, 4 * len);
+#endif
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read n integers stored on disk and convert them to aint/factor + xmin.
+
+void ReadWithFactor(Float_t *to, const char *buf, std::size_t n, Double_t factor, Double_t xmin)
+{
+   ReadWithFactorImpl(to, buf, n, factor, xmin);
+}
+
+void ReadWithFactor(Double_t *to, const char *buf, std::size_t n, Double_t factor, Double_t xmin)
+{
+   ReadWithFactorImpl(to, buf, n, factor, xmin);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Clamp n values to [xmin, xmax], convert them to UInt_t(0.5 + factor*(x - xmin))
+/// and write them in the on-disk representation.
+
+void WriteWithFactor(char *buf, const Float_t *from, std::size_t n, Double_t factor, Double_t xmin, Double_t xmax)
+{
+   WriteWithFactorImpl(buf, from, n, factor, xmin, xmax);
+}
+
+void WriteWithFactor(char *buf, const Double_t *from, std::size_t n, Double_t factor, Double_t xmin, Double_t xmax)
+{
+   WriteWithFactorImpl(buf, from, n, factor, xmin, xmax);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Select the kernels used by this process; kAuto selects the best one
+/// supported by the CPU. Returns false, leaving the selection unchanged, if
+/// the requested kernel is not supported.
+
+bool SetKernel(EKernel kernel)
+{
+   if (!IsSupported(kernel))
+      return false;
+   if (kernel == EKernel::kAuto)
+      kernel = BestKernel();
+   CurrentKernel() = kernel;
+   CurrentShuffle() = GetShuffle(kernel);
+   return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the kernel currently in use.
+
+EKernel GetKernel()
+{
+   return CurrentKernel();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return a printable name for the kernel.
+
+const char *GetKernelName(EKernel kernel)
+{
+   switch (kernel) {
+   case EKernel::kAuto: return "auto";
+   case EKernel::kScalar: return "scalar";
+   case EKernel::kSSSE3: return "SSSE3";
+   case EKernel::kAVX2: return "AVX2";
+   case EKernel::kAVX512: return "AVX-512";
+   }
+   return "unknown";
+}
+
+} // namespace ByteSwap
+} // namespace Internal
+} // namespace ROOT
@@ -0,0 +1,50 @@
+// @(#)root/io:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2021, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "RIOParallelFor.h"
+#include "RConfigure.h" // R__USE_IMT
+#include "TROOT.h"
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+/// Call func(i) for every i in [0, n), spreading the calls over up to nthreads
+/// threads (including the calling one). The indices are handed out one by one,
+/// so that slow calls do not hold back the other threads.
+/// If implicit multi-threading is enabled, the calls are run on its thread pool
+/// instead of on nthreads threads of our own, not to oversubscribe the cores.
+
+void ROOT::Internal::RIOParallelFor(UInt_t nthreads, std::size_t n, const std::function<void(std::size_t)> &func)
+{
+#ifdef R__USE_IMT
+   if (ROOT::IsImplicitMTEnabled() && nthreads > 1 && n > 1) {
+      ROOT::TThreadExecutor pool;
+      pool.Foreach([&func](unsigned int i) { func(i); }, ROOT::TSeqU(static_cast<unsigned int>(n)));
+      return;
+   }
+#endif
+   std::atomic<std::size_t> next{0};
+   auto worker = [&]() {
+      for (std::size_t i = next++; i < n; i = next++)
+         func(i);
+   };
+   std::vector<std::thread> threads;
+   for (std::size_t t = 1; t < std::min<std::size_t>(nthreads, n); ++t)
+      threads.emplace_back(worker);
+   worker();
+   for (auto &thread : threads)
+      thread.join();
+}
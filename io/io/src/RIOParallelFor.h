@@ -0,0 +1,30 @@
+// @(#)root/io:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2021, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_RIOParallelFor
+#define ROOT_RIOParallelFor
+
+#include "RtypesCore.h"
+
+#include <cstddef>
+#include <functional>
+
+namespace ROOT {
+namespace Internal {
+
+/// Call func(i) for every i in [0, n), spreading the calls over up to nthreads
+/// threads (including the calling one), or on the implicit MT thread pool when
+/// it is enabled. Used by TFileMerger and TDirectoryFile.
+void RIOParallelFor(UInt_t nthreads, std::size_t n, const std::function<void(std::size_t)> &func);
+
+} // namespace Internal
+} // namespace ROOT
+
+#endif
@@ -88,6 +88,24 @@ class Container {
 };
 ~~~
 
+For large objects JSON code can be written directly into output stream, without
+creating complete JSON string in memory. Output is flushed into stream while object is converted:
+~~~{.cpp}
+   std::ofstream out("hist.json");
+   TBufferJSON buf;
+   buf.SetCompact(TBufferJSON::kNoSpaces + TBufferJSON::kBase64);
+   buf.StoreObject(h1, TH1::Class(), out);
+~~~
+Same is done by TBufferJSON::ExportToFile() for plain JSON files.
+When reading, JSON code is parsed with SAX parser and long numeric arrays with many zeros
+(like histogram bin contents) are kept compressed in memory.
+Object can be also read directly from input stream:
+~~~{.cpp}
+   std::ifstream in("hist.json");
+   TClass *cl = nullptr;
+   void *obj = TBufferJSON::ConvertFromJSONAny(in, &cl);
+~~~
+
 */
 
 #include "TBufferJSON.h"
@@ -100,6 +118,9 @@ class Container {
 #include <memory>
 #include <cstdlib>
 #include <fstream>
+#include <iostream>
+#include <utility>
+#include <vector>
 
 #include <ROOT/RMakeUnique.hxx>
 
@@ -135,6 +156,12 @@ ClassImp(TBufferJSON);
 
 enum { json_TArray = 100, json_TCollection = -130, json_TString = 110, json_stdstring = 120 };
 
+// size of main output buffer which triggers flushing into output stream
+const Int_t kJsonFlushSize = 65536;
+
+// minimal size of numeric array which is stored compressed when parsing JSON
+const std::size_t kJsonSparseMinSize = 100;
+
 ///////////////////////////////////////////////////////////////
 // TArrayIndexProducer is used to correctly create
 /// JSON array separators for multi-dimensional JSON arrays
@@ -313,8 +340,15 @@ class TJSONStackObj : public TObject {
       nlohmann::json::iterator fIter;   //! iterator for std::map stored as JSON object
       const char *fTypeTag{nullptr};    //! type tag used for std::map stored as JSON object
       nlohmann::json fValue;            //! temporary value reading std::map as JSON
+      nlohmann::json fExpanded;         //! compressed "$arr" array expanded for reading element by element
       nlohmann::json *GetStlNode(nlohmann::json *prnt)
       {
+         if ((fMap <= 0) && prnt->is_object() && (prnt->count("$arr") == 1)) {
+            if (fExpanded.is_null())
+               fExpanded = ExpandArray(*prnt);
+            return &(fExpanded.at(fIndx++));
+         }
+
          if (fMap <= 0)
             return &(prnt->at(fIndx++));
 
@@ -339,6 +373,34 @@ class TJSONStackObj : public TObject {
          }
          return &fValue;
       }
+
+      // expand zero-suppressed "$arr" array, created by TJSONSaxBuilder
+      static nlohmann::json ExpandArray(const nlohmann::json &json)
+      {
+         nlohmann::json res = nlohmann::json::array();
+         int len = json.at("len").get<int>();
+         for (int n = 0; n < len; ++n)
+            res.push_back(0);
+         int p = 0, id = 0;
+         std::string idname;
+         while (p < len) {
+            if (json.count("p" + idname) == 1)
+               p = json.at("p" + idname).get<int>();
+            if (json.count("v" + idname) != 1)
+               break;
+            const nlohmann::json &v = json.at("v" + idname);
+            if (v.is_array()) {
+               for (unsigned sub = 0; (sub < v.size()) && (p < len); ++sub)
+                  res[p++] = v[sub];
+            } else {
+               unsigned ncopy = (json.count("n" + idname) == 1) ? json.at("n" + idname).get<unsigned>() : 1;
+               for (unsigned sub = 0; (sub < ncopy) && (p < len); ++sub)
+                  res[p++] = v;
+            }
+            idname = std::to_string(++id);
+         }
+         return res;
+      }
    };
 
 public:
@@ -472,6 +534,166 @@ public:
    }
 };
 
+///////////////////////////////////////////////////////////////
+/// TJSONSaxBuilder creates the JSON document from the events of the
+/// nlohmann::json SAX parser. Long numeric arrays, which are mostly zeros
+/// (like histogram bin contents), are stored in the zero-suppressed "$arr"
+/// form also produced by the writer, so that the document needs much less
+/// memory than the one created by nlohmann::json::parse.
+
+class TJSONSaxBuilder {
+   nlohmann::json &fRoot;                 ///< document being created
+   std::vector<nlohmann::json *> fStack;  ///< currently open objects and arrays
+   nlohmann::json *fMember{nullptr};      ///< member of the innermost object, created by the last key
+
+   template <typename Value>
+   nlohmann::json *AddValue(Value &&v)
+   {
+      if (fStack.empty()) {
+         fRoot = nlohmann::json(std::forward<Value>(v));
+         return &fRoot;
+      }
+      if (fStack.back()->is_array()) {
+         fStack.back()->push_back(nlohmann::json(std::forward<Value>(v)));
+         return &fStack.back()->back();
+      }
+      *fMember = nlohmann::json(std::forward<Value>(v));
+      return fMember;
+   }
+
+   static bool IsZero(const nlohmann::json &v) { return v.get<double>() == 0; }
+
+   // replace long numeric array with many zeros by its "$arr" form, see JsonReadFastArray
+   static void CompressArray(nlohmann::json &arr)
+   {
+      if (arr.size() < kJsonSparseMinSize)
+         return;
+      std::size_t nzeros = 0;
+      bool isfloat = false;
+      for (auto &v : arr) {
+         if (!v.is_number())
+            return;
+         if (IsZero(v))
+            nzeros++;
+         isfloat = isfloat || v.is_number_float();
+      }
+      if (2 * nzeros < arr.size())
+         return;
+
+      nlohmann::json res = nlohmann::json::object();
+      res["$arr"] = isfloat ? "Float64" : "Int64";
+      res["len"] = arr.size();
+      std::size_t p = 0, len = arr.size();
+      int id = 0;
+      while (p < len) {
+         if (IsZero(arr[p])) {
+            p++;
+            continue;
+         }
+         // segment ends before 10 or more zeros
+         std::size_t p0 = p, last = ++p;
+         for (; (p < len) && (p - last < 10); ++p)
+            if (!IsZero(arr[p]))
+               last = p + 1;
+         std::string idname = id > 0 ? std::to_string(id) : std::string();
+         id++;
+         res["p" + idname] = p0;
+         nlohmann::json &v = res["v" + idname];
+         v = nlohmann::json::array();
+         for (std::size_t k = p0; k < last; ++k)
+            v.push_back(std::move(arr[k]));
+         p = last;
+      }
+      arr = std::move(res);
+   }
+
+public:
+   TJSONSaxBuilder(nlohmann::json &root) : fRoot(root) {}
+
+   bool null()
+   {
+      AddValue(nullptr);
+      return true;
+   }
+
+   bool boolean(bool val)
+   {
+      AddValue(val);
+      return true;
+   }
+
+   bool number_integer(nlohmann::json::number_integer_t val)
+   {
+      AddValue(val);
+      return true;
+   }
+
+   bool number_unsigned(nlohmann::json::number_unsigned_t val)
+   {
+      AddValue(val);
+      return true;
+   }
+
+   bool number_float(nlohmann::json::number_float_t val, const std::string &)
+   {
+      AddValue(val);
+      return true;
+   }
+
+   bool string(std::string &val)
+   {
+      AddValue(std::move(val));
+      return true;
+   }
+
+   template <typename Binary>
+   bool binary(Binary &val)
+   {
+      AddValue(std::move(val));
+      return true;
+   }
+
+   bool start_object(std::size_t)
+   {
+      fStack.push_back(AddValue(nlohmann::json::object()));
+      return true;
+   }
+
+   bool key(std::string &val)
+   {
+      fMember = &(*fStack.back())[val];
+      return true;
+   }
+
+   bool end_object()
+   {
+      fStack.pop_back();
+      return true;
+   }
+
+   bool start_array(std::size_t)
+   {
+      fStack.push_back(AddValue(nlohmann::json::array()));
+      return true;
+   }
+
+   bool end_array()
+   {
+      nlohmann::json *arr = fStack.back();
+      fStack.pop_back();
+      // only members of objects - elements of multi-dimensional arrays are accessed directly
+      if (!fStack.empty() && fStack.back()->is_object() && (fStack.back()->count("$arr") == 0))
+         CompressArray(*arr);
+      return true;
+   }
+
+   template <class Exception>
+   bool parse_error(std::size_t, const std::string &, const Exception &ex)
+   {
+      throw ex;
+   }
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Creates buffer object to serialize data into json.
 
@@ -717,6 +939,47 @@ TString TBufferJSON::StoreObject(const void *obj, const TClass *cl)
    return fOutBuffer.Length() ? fOutBuffer : fValue;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Store provided object as JSON structure into output stream
+/// JSON code is written into the stream while object is converted, so that
+/// complete JSON string never kept in memory - this is preferable for large objects.
+/// Returns number of bytes written into the stream
+/// As StoreObject() method, can be called only once for TBufferJSON instance:
+///
+///   std::ofstream out("file.json");
+///   TBufferJSON buf;
+///   buf.SetCompact(TBufferJSON::kNoSpaces + TBufferJSON::kBase64);
+///   buf.StoreObject(obj, TClass::GetClass<UserClass>(), out);
+///
+
+Long64_t TBufferJSON::StoreObject(const void *obj, const TClass *cl, std::ostream &out)
+{
+   if (!IsWriting()) {
+      Error("StoreObject", "Can not store object into TBuffer for reading");
+      return 0;
+   }
+
+   fOutStream = &out;
+
+   InitMap();
+
+   PushStack(); // dummy stack entry to avoid extra checks in the beginning
+
+   JsonWriteObject(obj, cl);
+
+   PopStack();
+
+   // for STL containers and TArray complete JSON code is in the value
+   if ((fOutStreamed == 0) && (fOutBuffer.Length() == 0))
+      fOutBuffer.Swap(fValue);
+
+   JsonFlushOutput();
+
+   fOutStream = nullptr;
+
+   return fOutStreamed;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Converts selected data member into json
 /// Parameter ptr specifies address in memory, where data member is located
@@ -755,80 +1018,21 @@ Int_t TBufferJSON::ExportToFile(const char *filename, const TObject *obj, const
    if (!obj || !filename || (*filename == 0))
       return 0;
 
-   Int_t compact = strstr(filename, ".json.gz") ? 3 : 0;
-   if (option && (*option >= '0') && (*option <= '3'))
-      compact = TString(option).Atoi();
-
-   TString json = TBufferJSON::ConvertToJSON(obj, compact);
-
-   std::ofstream ofs(filename);
-
-   if (strstr(filename, ".json.gz")) {
-      const char *objbuf = json.Data();
-      Long_t objlen = json.Length();
-
-      unsigned long objcrc = R__crc32(0, NULL, 0);
-      objcrc = R__crc32(objcrc, (const unsigned char *)objbuf, objlen);
-
-      // 10 bytes (ZIP header), compressed data, 8 bytes (CRC and original length)
-      Int_t buflen = 10 + objlen + 8;
-      if (buflen < 512)
-         buflen = 512;
-
-      char *buffer = (char *)malloc(buflen);
-      if (!buffer)
-         return 0; // failure
-
-      char *bufcur = buffer;
-
-      *bufcur++ = 0x1f; // first byte of ZIP identifier
-      *bufcur++ = 0x8b; // second byte of ZIP identifier
-      *bufcur++ = 0x08; // compression method
-      *bufcur++ = 0x00; // FLAG - empty, no any file names
-      *bufcur++ = 0;    // empty timestamp
-      *bufcur++ = 0;    //
-      *bufcur++ = 0;    //
-      *bufcur++ = 0;    //
-      *bufcur++ = 0;    // XFL (eXtra FLags)
-      *bufcur++ = 3;    // OS   3 means Unix
-      // strcpy(bufcur, "item.json");
-      // bufcur += strlen("item.json")+1;
-
-      char dummy[8];
-      memcpy(dummy, bufcur - 6, 6);
-
-      // R__memcompress fills first 6 bytes with own header, therefore just overwrite them
-      unsigned long ziplen = R__memcompress(bufcur - 6, objlen + 6, (char *)objbuf, objlen);
-
-      memcpy(bufcur - 6, dummy, 6);
-
-      bufcur += (ziplen - 6); // jump over compressed data (6 byte is extra ROOT header)
-
-      *bufcur++ = objcrc & 0xff; // CRC32
-      *bufcur++ = (objcrc >> 8) & 0xff;
-      *bufcur++ = (objcrc >> 16) & 0xff;
-      *bufcur++ = (objcrc >> 24) & 0xff;
-
-      *bufcur++ = objlen & 0xff;         // original data length
-      *bufcur++ = (objlen >> 8) & 0xff;  // original data length
-      *bufcur++ = (objlen >> 16) & 0xff; // original data length
-      *bufcur++ = (objlen >> 24) & 0xff; // original data length
-
-      ofs.write(buffer, bufcur - buffer);
-
-      free(buffer);
-   } else {
-      ofs << json.Data();
-   }
-
-   ofs.close();
+   TClass *clActual = TObject::Class()->GetActualClass(obj);
+   void *ptr = (void *)obj;
+   if (!clActual)
+      clActual = TObject::Class();
+   else if (clActual != TObject::Class())
+      ptr = (void *)((Long_t)obj - clActual->GetBaseClassOffset(TObject::Class()));
 
-   return json.Length();
+   return ExportToFile(filename, ptr, clActual, option);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Convert object into JSON and store in text file
 /// Returns size of the produce file
+/// Plain JSON files are written while object is converted, without building
+/// complete JSON string in memory
 
 Int_t TBufferJSON::ExportToFile(const char *filename, const void *obj, const TClass *cl, const char *option)
 {
@@ -839,67 +1043,78 @@ Int_t TBufferJSON::ExportToFile(const char *filename, const void *obj, const TCl
    if (option && (*option >= '0') && (*option <= '3'))
       compact = TString(option).Atoi();
 
-   TString json = TBufferJSON::ConvertToJSON(obj, cl, compact);
-
    std::ofstream ofs(filename);
 
-   if (strstr(filename, ".json.gz")) {
-      const char *objbuf = json.Data();
-      Long_t objlen = json.Length();
+   if (!strstr(filename, ".json.gz")) {
+      TClass *clActual = cl->GetActualClass(obj);
+      const void *actualStart = obj;
+      if (clActual && (clActual != cl))
+         actualStart = (char *)obj - clActual->GetBaseClassOffset(cl);
+      else
+         clActual = const_cast<TClass *>(cl);
+
+      TBufferJSON buf;
+      buf.SetCompact(compact);
+      Long64_t len = buf.StoreObject(actualStart, clActual, ofs);
+      ofs.close();
+      return (Int_t)len;
+   }
 
-      unsigned long objcrc = R__crc32(0, NULL, 0);
-      objcrc = R__crc32(objcrc, (const unsigned char *)objbuf, objlen);
+   TString json = TBufferJSON::ConvertToJSON(obj, cl, compact);
 
-      // 10 bytes (ZIP header), compressed data, 8 bytes (CRC and original length)
-      Int_t buflen = 10 + objlen + 8;
-      if (buflen < 512)
-         buflen = 512;
+   const char *objbuf = json.Data();
+   Long_t objlen = json.Length();
 
-      char *buffer = (char *)malloc(buflen);
-      if (!buffer)
-         return 0; // failure
+   unsigned long objcrc = R__crc32(0, NULL, 0);
+   objcrc = R__crc32(objcrc, (const unsigned char *)objbuf, objlen);
 
-      char *bufcur = buffer;
+   // 10 bytes (ZIP header), compressed data, 8 bytes (CRC and original length)
+   Int_t buflen = 10 + objlen + 8;
+   if (buflen < 512)
+      buflen = 512;
 
-      *bufcur++ = 0x1f; // first byte of ZIP identifier
-      *bufcur++ = 0x8b; // second byte of ZIP identifier
-      *bufcur++ = 0x08; // compression method
-      *bufcur++ = 0x00; // FLAG - empty, no any file names
-      *bufcur++ = 0;    // empty timestamp
-      *bufcur++ = 0;    //
-      *bufcur++ = 0;    //
-      *bufcur++ = 0;    //
-      *bufcur++ = 0;    // XFL (eXtra FLags)
-      *bufcur++ = 3;    // OS   3 means Unix
-      // strcpy(bufcur, "item.json");
-      // bufcur += strlen("item.json")+1;
+   char *buffer = (char *)malloc(buflen);
+   if (!buffer)
+      return 0; // failure
 
-      char dummy[8];
-      memcpy(dummy, bufcur - 6, 6);
+   char *bufcur = buffer;
 
-      // R__memcompress fills first 6 bytes with own header, therefore just overwrite them
-      unsigned long ziplen = R__memcompress(bufcur - 6, objlen + 6, (char *)objbuf, objlen);
+   *bufcur++ = 0x1f; // first byte of ZIP identifier
+   *bufcur++ = 0x8b; // second byte of ZIP identifier
+   *bufcur++ = 0x08; // compression method
+   *bufcur++ = 0x00; // FLAG - empty, no any file names
+   *bufcur++ = 0;    // empty timestamp
+   *bufcur++ = 0;    //
+   *bufcur++ = 0;    //
+   *bufcur++ = 0;    //
+   *bufcur++ = 0;    // XFL (eXtra FLags)
+   *bufcur++ = 3;    // OS   3 means Unix
+   // strcpy(bufcur, "item.json");
+   // bufcur += strlen("item.json")+1;
 
-      memcpy(bufcur - 6, dummy, 6);
+   char dummy[8];
+   memcpy(dummy, bufcur - 6, 6);
 
-      bufcur += (ziplen - 6); // jump over compressed data (6 byte is extra ROOT header)
+   // R__memcompress fills first 6 bytes with own header, therefore just overwrite them
+   unsigned long ziplen = R__memcompress(bufcur - 6, objlen + 6, (char *)objbuf, objlen);
 
-      *bufcur++ = objcrc & 0xff; // CRC32
-      *bufcur++ = (objcrc >> 8) & 0xff;
-      *bufcur++ = (objcrc >> 16) & 0xff;
-      *bufcur++ = (objcrc >> 24) & 0xff;
+   memcpy(bufcur - 6, dummy, 6);
 
-      *bufcur++ = objlen & 0xff;         // original data length
-      *bufcur++ = (objlen >> 8) & 0xff;  // original data length
-      *bufcur++ = (objlen >> 16) & 0xff; // original data length
-      *bufcur++ = (objlen >> 24) & 0xff; // original data length
+   bufcur += (ziplen - 6); // jump over compressed data (6 byte is extra ROOT header)
 
-      ofs.write(buffer, bufcur - buffer);
+   *bufcur++ = objcrc & 0xff; // CRC32
+   *bufcur++ = (objcrc >> 8) & 0xff;
+   *bufcur++ = (objcrc >> 16) & 0xff;
+   *bufcur++ = (objcrc >> 24) & 0xff;
 
-      free(buffer);
-   } else {
-      ofs << json.Data();
-   }
+   *bufcur++ = objlen & 0xff;         // original data length
+   *bufcur++ = (objlen >> 8) & 0xff;  // original data length
+   *bufcur++ = (objlen >> 16) & 0xff; // original data length
+   *bufcur++ = (objlen >> 24) & 0xff; // original data length
+
+   ofs.write(buffer, bufcur - buffer);
+
+   free(buffer);
 
    ofs.close();
 
@@ -940,6 +1155,19 @@ void *TBufferJSON::ConvertFromJSONAny(const char *str, TClass **cl)
    return buf.RestoreObject(str, cl);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Read object from JSON code provided by input stream
+/// JSON code is parsed directly from the stream, without reading it first into a string
+/// In class pointer (if specified) read class is returned
+/// One must specify expected object class, if it is TArray or STL container
+
+void *TBufferJSON::ConvertFromJSONAny(std::istream &in, TClass **cl)
+{
+   TBufferJSON buf(TBuffer::kRead);
+
+   return buf.RestoreObject(in, cl);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Read object from JSON
 /// In class pointer (if specified) read class is returned
@@ -950,7 +1178,36 @@ void *TBufferJSON::RestoreObject(const char *json_str, TClass **cl)
    if (!IsReading())
       return nullptr;
 
-   nlohmann::json docu = nlohmann::json::parse(json_str);
+   nlohmann::json docu;
+   TJSONSaxBuilder builder(docu);
+   nlohmann::json::sax_parse(json_str, &builder);
+
+   return JsonReadDocument(&docu, cl);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read object from JSON code provided by input stream
+/// In class pointer (if specified) read class is returned
+/// One must specify expected object class, if it is TArray or STL container
+
+void *TBufferJSON::RestoreObject(std::istream &in, TClass **cl)
+{
+   if (!IsReading())
+      return nullptr;
+
+   nlohmann::json docu;
+   TJSONSaxBuilder builder(docu);
+   nlohmann::json::sax_parse(in, &builder);
+
+   return JsonReadDocument(&docu, cl);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read object from parsed JSON document
+
+void *TBufferJSON::JsonReadDocument(void *json_docu, TClass **cl)
+{
+   nlohmann::json &docu = *((nlohmann::json *)json_docu);
 
    if (docu.is_null() || (!docu.is_object() && !docu.is_array()))
       return nullptr;
@@ -964,7 +1221,7 @@ void *TBufferJSON::RestoreObject(const char *json_str, TClass **cl)
 
    InitMap();
 
-   PushStack(0, &docu);
+   PushStack(0, json_docu);
 
    void *obj = JsonReadObject(nullptr, objClass, cl);
 
@@ -1172,6 +1429,23 @@ void TBufferJSON::AppendOutput(const char *line0, const char *line1)
          fOutput->Append(line1);
       }
    }
+
+   if (fOutStream && (fOutput == &fOutBuffer) && (fOutBuffer.Length() >= kJsonFlushSize))
+      JsonFlushOutput();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write content of main output buffer into output stream
+/// Buffer is cleared keeping its capacity, therefore it is reused for the following JSON code
+
+void TBufferJSON::JsonFlushOutput()
+{
+   if (!fOutStream || (fOutBuffer.Length() == 0))
+      return;
+
+   fOutStream->write(fOutBuffer.Data(), fOutBuffer.Length());
+   fOutStreamed += fOutBuffer.Length();
+   fOutBuffer.Clear();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2777,7 +3051,7 @@ R__ALWAYS_INLINE void TBufferJSON::JsonReadFastArray(T *arr, Int_t arrsize, bool
          arr[cnt] = 0;
 
       if (json->count("b") == 1) {
-         auto base64 = json->at("b").get<std::string>();
+         auto &base64 = json->at("b").get_ref<const std::string &>();
 
          int offset = (json->count("o") == 1) ? json->at("o").get<int>() : 0;
 
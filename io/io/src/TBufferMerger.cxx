@@ -11,7 +11,6 @@
 
 #include "ROOT/TBufferMerger.hxx"
 
-#include "TBufferFile.h"
 #include "TError.h"
 #include "TROOT.h"
 #include "TVirtualMutex.h"
@@ -47,6 +46,15 @@ TBufferMerger::~TBufferMerger()
    for (const auto &f : fAttachedFiles)
       if (!f.expired()) Fatal("TBufferMerger", " TBufferMergerFiles must be destroyed before the server");
 
+   if (fMergeThread.joinable()) {
+      {
+         std::lock_guard<std::mutex> lock(fQueueMutex);
+         fStopMerging = true;
+      }
+      fDataAvailable.notify_one();
+      fMergeThread.join();
+   }
+
    if (!fQueue.empty())
       Merge();
 }
@@ -65,12 +73,24 @@ size_t TBufferMerger::GetQueueSize() const
    return fQueue.size();
 }
 
-void TBufferMerger::Push(TBufferFile *buffer)
+void TBufferMerger::Push(TMemFile::BlockListPtr_t blocks, size_t size)
 {
+   if (fBackgroundMerge) {
+      {
+         std::unique_lock<std::mutex> lock(fQueueMutex);
+         if (fMaxBuffered)
+            fSpaceAvailable.wait(lock, [this] { return fBuffered < fMaxBuffered || fQueue.empty(); });
+         fBuffered += size;
+         fQueue.push(std::move(blocks));
+      }
+      fDataAvailable.notify_one();
+      return;
+   }
+
    {
       std::lock_guard<std::mutex> lock(fQueueMutex);
-      fBuffered += buffer->BufferSize();
-      fQueue.push(buffer);
+      fBuffered += size;
+      fQueue.push(std::move(blocks));
    }
 
    if (fBuffered > fAutoSave)
@@ -98,25 +118,69 @@ void TBufferMerger::SetMergeOptions(const TString& options)
    fMerger.SetMergeOptions(options);
 }
 
+void TBufferMerger::EnableBackgroundMerge(size_t maxBuffered)
+{
+   std::lock_guard<std::mutex> lock(fQueueMutex);
+   fMaxBuffered = maxBuffered;
+   if (fBackgroundMerge)
+      return;
+   fBackgroundMerge = true;
+   fMergeThread = std::thread([this] { MergeLoop(); });
+}
+
 void TBufferMerger::Merge()
 {
    if (fMergeMutex.try_lock()) {
-      std::queue<TBufferFile *> queue;
+      std::queue<TMemFile::BlockListPtr_t> queue;
       {
          std::lock_guard<std::mutex> q(fQueueMutex);
          std::swap(queue, fQueue);
          fBuffered = 0;
       }
 
-      while (!queue.empty()) {
-         std::unique_ptr<TBufferFile> buffer{queue.front()};
-         fMerger.AddAdoptFile(new TMemFile(fMerger.GetOutputFileName(), std::move(buffer)));
-         queue.pop();
+      MergeQueue(queue);
+      fMergeMutex.unlock();
+   }
+}
+
+/// Merge the buffers of the queue into the output file. Must be called with fMergeMutex held.
+void TBufferMerger::MergeQueue(std::queue<TMemFile::BlockListPtr_t> &queue)
+{
+   while (!queue.empty()) {
+      fMerger.AddAdoptFile(new TMemFile(fMerger.GetOutputFileName(), std::move(queue.front())));
+      queue.pop();
+   }
+
+   fMerger.PartialMerge();
+   fMerger.Reset();
+}
+
+/// Body of the output thread: wait until enough data is queued (see SetAutoSave()),
+/// or until writers are blocked on a full queue, then merge everything queued so far
+/// while the writers keep going.
+void TBufferMerger::MergeLoop()
+{
+   std::unique_lock<std::mutex> lock(fQueueMutex);
+   while (true) {
+      fDataAvailable.wait(lock, [this] {
+         return fStopMerging ||
+                (!fQueue.empty() && (fBuffered > fAutoSave || (fMaxBuffered && fBuffered >= fMaxBuffered)));
+      });
+      if (fQueue.empty())
+         break; // fStopMerging was set and everything was merged.
+
+      std::queue<TMemFile::BlockListPtr_t> queue;
+      std::swap(queue, fQueue);
+      fBuffered = 0;
+      lock.unlock();
+      fSpaceAvailable.notify_all();
+
+      {
+         std::lock_guard<std::mutex> merge(fMergeMutex);
+         MergeQueue(queue);
       }
 
-      fMerger.PartialMerge();
-      fMerger.Reset();
-      fMergeMutex.unlock();
+      lock.lock();
    }
 }
 
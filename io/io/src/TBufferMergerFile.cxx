@@ -11,8 +11,6 @@
 
 #include "ROOT/TBufferMerger.hxx"
 
-#include "TBufferFile.h"
-
 namespace ROOT {
 namespace Experimental {
 
@@ -32,10 +30,10 @@ Int_t TBufferMergerFile::Write(const char *name, Int_t opt, Int_t bufsize)
    Int_t nbytes = TMemFile::Write(name, opt, bufsize);
 
    if (nbytes) {
-      TBufferFile *buffer = new TBufferFile(TBuffer::kWrite, GetSize());
-      CopyTo(*buffer);
-      buffer->SetReadMode();
-      fMerger.Push(buffer);
+      // The memory blocks are handed over to the merger, which reads them as
+      // a TMemFile; this file continues with fresh blocks from the pool.
+      Long64_t size = GetSize();
+      fMerger.Push(DetachBlocks(), size);
       ResetAfterMerge(0);
    }
    return nbytes;
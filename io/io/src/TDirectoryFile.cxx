@@ -48,10 +48,81 @@ End_Macro
 #include "TProcessUUID.h"
 #include "TVirtualMutex.h"
 #include "TEmulatedCollectionProxy.h"
+#include "ROOT/RMakeUnique.hxx"
+#include "ROOT/RStringView.hxx"
+#include "RIOParallelFor.h"
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 const UInt_t kIsBigFile = BIT(16);
 const Int_t  kMaxLen = 2048;
 
+namespace {
+
+/// Maximum number of bytes of the records read at once by TDirectoryFile::GetObjectsBulk.
+const Long64_t kBulkReadSize = 64 * 1024 * 1024;
+
+/// Base classes of the objects that TDirectoryFile::GetObjectsBulk may stream in
+/// parallel; the Streamer of other classes is not known to be thread safe.
+const char *const kBulkParallelClasses[] = {"TH1", "TGraph", "TObjString"};
+
+/// Marks the keys index appended to a keys record (see TDirectoryFile::WriteKeys).
+const UInt_t kKeysIndexMagic = 0x4B494458; // "KIDX"
+/// Size of the trailer of the keys index: number of entries and kKeysIndexMagic.
+const Int_t  kKeysIndexTrailer = sizeof(Int_t) + sizeof(UInt_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the name of a key serialized by TKey::FillBuffer, without
+/// deserializing the key.
+
+std::string_view R__GetSerializedKeyName(const char *keybuf, Short_t *cycle = nullptr)
+{
+   char *buffer = const_cast<char *>(keybuf) + sizeof(Int_t); // fNbytes
+   Version_t version;
+   frombuf(buffer, &version);
+   buffer += sizeof(Int_t) + sizeof(UInt_t) + sizeof(Short_t); // fObjlen, fDatime, fKeylen
+   Short_t keycycle;
+   frombuf(buffer, &keycycle);
+   if (cycle)
+      *cycle = keycycle;
+   buffer += (version > 1000) ? 2 * sizeof(Long64_t) : 2 * sizeof(Int_t); // fSeekKey, fSeekPdir
+   std::string_view name;
+   for (Int_t i = 0; i < 2; ++i) { // fClassName, fName
+      UChar_t nwh;
+      Int_t nchars;
+      frombuf(buffer, &nwh);
+      if (nwh == 255)
+         frombuf(buffer, &nchars);
+      else
+         nchars = nwh;
+      name = std::string_view(buffer, nchars);
+      buffer += nchars;
+   }
+   return name;
+}
+
+} // anonymous namespace
+
+namespace ROOT {
+namespace Internal {
+
+/// Keys record of a read-only directory written with an index of its keys.
+/// The TKey objects are only created, and added to the list of keys of the
+/// directory, when a key with the same name is looked up.
+struct RKeysIndex {
+   std::vector<char>  fRecord;  ///< Serialized keys, as read from the keys record
+   std::vector<Int_t> fOffsets; ///< Offset in fRecord of each key, sorted by name and decreasing cycle
+   std::vector<char>  fLoaded;  ///< Whether the key of each entry of fOffsets was created
+};
+
+} // namespace Internal
+} // namespace ROOT
+
 ClassImp(TDirectoryFile);
 
 
@@ -177,6 +248,7 @@ void TDirectoryFile::InitDirectoryFile(TClass *cl)
 
 TDirectoryFile::~TDirectoryFile()
 {
+   DeleteKeysIndex();
    if (fKeys) {
       fKeys->Delete("slow");
       SafeDelete(fKeys);
@@ -232,6 +304,8 @@ Int_t TDirectoryFile::AppendKey(TKey *key)
 
    fModified = kTRUE;
 
+   if (fKeysIndex) LoadAllKeys();
+
    key->SetMotherDir(this);
 
    // This is a fast hash lookup in case the key does not already exist
@@ -266,7 +340,7 @@ void TDirectoryFile::Browse(TBrowser *b)
       TObject *obj = nullptr;
       TIter nextin(fList);
       TKey *key = nullptr, *keyo = nullptr;
-      TIter next(fKeys);
+      TIter next(GetListOfKeys());
 
       cd();
 
@@ -426,6 +500,29 @@ TObject *TDirectoryFile::CloneObject(const TObject *obj, Bool_t autoadd /* = kTR
    return newobj;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Create the key of the given entry of the keys index.
+/// Returns nullptr if the key is invalid.
+
+TKey *TDirectoryFile::CreateIndexedKey(Int_t entry) const
+{
+   auto &index = *fKeysIndex;
+   char *buffer = index.fRecord.data() + index.fOffsets[entry];
+   index.fLoaded[entry] = 1;
+
+   TKey *key = new TKey(const_cast<TDirectoryFile *>(this));
+   key->ReadKeyBuffer(buffer);
+   Long64_t fsize = fFile->GetSize();
+   if (key->GetSeekKey() < 64 || key->GetSeekKey() > fsize ||
+       key->GetSeekPdir() < 64 || key->GetSeekPdir() > fsize) {
+      Error("ReadKeys", "reading illegal key %s", key->GetName());
+      key->SetMotherDir(nullptr); // Do not look for it in the list of keys.
+      delete key;
+      return nullptr;
+   }
+   return key;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Scan the memory lists of all files for an object with name
 
@@ -575,6 +672,7 @@ void TDirectoryFile::Close(Option_t *option)
    }
 
    // Delete keys from key list (but don't delete the list header)
+   DeleteKeysIndex();
    if (fKeys) {
       fKeys->Delete("slow");
    }
@@ -717,6 +815,15 @@ void TDirectoryFile::Delete(const char *namecycle)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Forget the keys not yet created from the keys index.
+
+void TDirectoryFile::DeleteKeysIndex()
+{
+   delete fKeysIndex;
+   fKeysIndex = nullptr;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Encode directory header into output buffer
 
@@ -812,6 +919,26 @@ TKey *TDirectoryFile::FindKeyAny(const char *keyname) const
    return nullptr;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the key with the given name and cycle; cycle 9999 selects the
+/// highest cycle.
+
+TKey *TDirectoryFile::FindKeyWithCycle(const char *name, Short_t cycle) const
+{
+   if (!fKeys) return nullptr;
+
+   LoadIndexedKeys(name);
+
+   TIter next( ((THashList *)fKeys)->GetListForObject(name) );
+   TKey *key, *found = nullptr;
+   while (( key = (TKey *)next() )) {
+      if (strcmp(name, key->GetName())) continue;
+      if (cycle == key->GetCycle()) return key;
+      if (cycle == 9999 && (!found || key->GetCycle() > found->GetCycle())) found = key;
+   }
+   return found;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Find object by name in the list of memory objects of the current
 /// directory or its sub-directories.
@@ -946,21 +1073,170 @@ TObject *TDirectoryFile::Get(const char *namecycle)
 
 //*-*---------------------Case of Key---------------------
 //                        ===========
-   TKey *key;
-   TIter nextkey(GetListOfKeys());
-   while ((key = (TKey *) nextkey())) {
-      if (strcmp(namobj,key->GetName()) == 0) {
-         if ((cycle == 9999) || (cycle == key->GetCycle())) {
-            TDirectory::TContext ctxt(this);
-            idcur = key->ReadObj();
-            break;
-         }
-      }
+   TKey *key = FindKeyWithCycle(namobj, cycle);
+   if (key) {
+      TDirectory::TContext ctxt(this);
+      idcur = key->ReadObj();
    }
 
    return idcur;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Read the objects with the given names in one go.
+///
+/// The records of all the keys are read with a single vectored read (see
+/// TFile::ReadBuffers), then they are decompressed and streamed in parallel
+/// with up to nthreads threads. This is much faster than calling Get() for
+/// each object when reading many small objects, like histograms.
+///
+/// \param[in] namecycles Names of the objects, with the format name;cycle as for Get().
+///            Only the keys of this directory are looked up, paths are not supported.
+/// \param[in] nthreads Number of threads decompressing and streaming the objects.
+///            If 0, the size of the implicit multi-threading pool is used, or a
+///            single thread if implicit multi-threading is disabled. The objects
+///            are only streamed in parallel if ROOT::EnableThreadSafety() was
+///            called, and only histograms (TH1), graphs (TGraph) and TObjString;
+///            the others are streamed one by one.
+///
+/// Returns the objects in the order of namecycles, with nullptr for the names
+/// which are not found or whose class does not inherit from TObject. As with
+/// Get(), objects already in memory are returned as they are, and the objects
+/// read are registered in this directory if their class requests it (e.g.
+/// histograms); otherwise they are owned by the caller.
+
+std::vector<TObject *> TDirectoryFile::GetObjectsBulk(const std::vector<std::string> &namecycles, UInt_t nthreads)
+{
+   std::vector<TObject *> objects(namecycles.size(), nullptr);
+   std::vector<TKey *> keys(namecycles.size(), nullptr);
+   // A key requested more than once is read once, the repeated requests
+   // (index, index of the first request) share its object.
+   std::unordered_map<TKey *, std::size_t> firstOfKey;
+   std::vector<std::pair<std::size_t, std::size_t>> repeated;
+
+   Short_t cycle;
+   char name[kMaxLen];
+   for (std::size_t i = 0; i < namecycles.size(); ++i) {
+      DecodeNameCycle(namecycles[i].c_str(), name, cycle, kMaxLen);
+      TObject *idcur = (cycle == 9999 && fList) ? fList->FindObject(name) : nullptr;
+      if (idcur && idcur != this) {
+         objects[i] = idcur;
+         continue;
+      }
+      TKey *key = FindKeyWithCycle(name, cycle);
+      auto first = key ? firstOfKey.emplace(key, i) : std::make_pair(firstOfKey.end(), true);
+      if (first.second)
+         keys[i] = key;
+      else
+         repeated.emplace_back(i, first.first->second);
+   }
+
+   ReadObjectsBulk(keys, objects, nthreads);
+   for (const auto &r : repeated)
+      objects[r.first] = objects[r.second];
+   return objects;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read in one go the objects of all the keys whose name matches the wildcard
+/// pattern (e.g. "h*"); only the highest cycle of each key is read.
+/// See GetObjectsBulk(const std::vector<std::string> &, UInt_t) for details.
+
+std::vector<TObject *> TDirectoryFile::GetObjectsBulk(const char *pattern, UInt_t nthreads)
+{
+   TRegexp re(pattern && *pattern ? pattern : "*", kTRUE);
+   std::vector<std::string> names;
+   std::unordered_set<std::string> seen;
+   TIter next(GetListOfKeys());
+   while (auto key = static_cast<TKey *>(next())) {
+      // The cycles of a key are stored in decreasing order.
+      TString keyname = key->GetName();
+      if (keyname.Index(re) == kNPOS || !seen.insert(keyname.Data()).second)
+         continue;
+      names.emplace_back(keyname.Data());
+   }
+   return GetObjectsBulk(names, nthreads);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read the objects of keys into the empty slots of objects, see GetObjectsBulk().
+/// The objects of keys that cannot be read in bulk (subdirectories, objects
+/// not deriving from TObject, keys of other storage formats) are read one by one.
+
+void TDirectoryFile::ReadObjectsBulk(const std::vector<TKey *> &keys, std::vector<TObject *> &objects, UInt_t nthreads)
+{
+   if (nthreads == 0)
+      nthreads = ROOT::IsImplicitMTEnabled() ? ROOT::GetThreadPoolSize() : 1;
+   // Without ROOT's thread safety (ROOT::EnableThreadSafety()), stream serially.
+   if (!gGlobalMutex)
+      nthreads = 1;
+
+   TDirectory::TContext ctxt(this);
+
+   std::vector<std::size_t> bulk;
+   std::vector<bool> parallel(keys.size(), false);
+   for (std::size_t i = 0; i < keys.size(); ++i) {
+      TKey *key = keys[i];
+      if (!key || objects[i])
+         continue;
+      TClass *cl = TClass::GetClass(key->GetClassName());
+      if (fFile && key->IsA() == TKey::Class() && cl && cl->IsTObject() && !cl->InheritsFrom(TDirectoryFile::Class())) {
+         bulk.push_back(i);
+         for (auto base : kBulkParallelClasses)
+            parallel[i] = parallel[i] || cl->InheritsFrom(base);
+      } else {
+         objects[i] = key->ReadObj();
+      }
+   }
+
+   for (std::size_t first = 0; first < bulk.size();) {
+      // Records of at most kBulkReadSize bytes (but at least one) are read at once.
+      std::vector<Long64_t> pos;
+      std::vector<Int_t> len;
+      std::vector<Long64_t> start;
+      Long64_t size = 0;
+      std::size_t last = first;
+      for (; last < bulk.size(); ++last) {
+         TKey *key = keys[bulk[last]];
+         if (last > first && size + key->GetNbytes() > kBulkReadSize)
+            break;
+         pos.push_back(key->GetSeekKey());
+         len.push_back(key->GetNbytes());
+         start.push_back(size);
+         size += key->GetNbytes();
+      }
+
+      std::unique_ptr<char[]> buffer(new char[size]);
+      if (fFile->ReadBuffers(buffer.get(), pos.data(), len.data(), (Int_t)pos.size())) {
+         // Let the keys report the error.
+         for (std::size_t k = first; k < last; ++k)
+            objects[bulk[k]] = keys[bulk[k]]->ReadObj();
+         first = last;
+         continue;
+      }
+
+      std::vector<std::size_t> inParallel;
+      for (std::size_t k = first; k < last; ++k) {
+         if (nthreads > 1 && parallel[bulk[k]])
+            inParallel.push_back(k);
+         else
+            objects[bulk[k]] = keys[bulk[k]]->ReadObjFromRecord(buffer.get() + start[k - first]);
+      }
+      ROOT::Internal::RIOParallelFor(nthreads, inParallel.size(), [&](std::size_t j) {
+         TDirectory::TContext taskCtxt(this);
+         const std::size_t k = inParallel[j];
+         objects[bulk[k]] = keys[bulk[k]]->ReadObjFromRecord(buffer.get() + start[k - first]);
+      });
+
+      // Registering the objects in the directory is not thread safe.
+      for (std::size_t k = first; k < last; ++k) {
+         if (objects[bulk[k]])
+            keys[bulk[k]]->AttachToDirectory(objects[bulk[k]]);
+      }
+      first = last;
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return pointer to object identified by namecycle.
 ///
@@ -1066,16 +1342,10 @@ void *TDirectoryFile::GetObjectChecked(const char *namecycle, const TClass* expe
 //*-*---------------------Case of Key---------------------
 //                        ===========
    void *idcur = nullptr;
-   TKey *key;
-   TIter nextkey(GetListOfKeys());
-   while ((key = (TKey *) nextkey())) {
-      if (strcmp(namobj,key->GetName()) == 0) {
-         if ((cycle == 9999) || (cycle == key->GetCycle())) {
-            TDirectory::TContext ctxt(this);
-            idcur = key->ReadObjectAny(expectedClass);
-            break;
-         }
-      }
+   TKey *key = FindKeyWithCycle(namobj, cycle);
+   if (key) {
+      TDirectory::TContext ctxt(this);
+      idcur = key->ReadObjectAny(expectedClass);
    }
 
    return idcur;
@@ -1103,8 +1373,10 @@ TKey *TDirectoryFile::GetKey(const char *name, Short_t cycle) const
 {
    if (!fKeys) return nullptr;
 
+   LoadIndexedKeys(name);
+
    // TIter::TIter() already checks for null pointers
-   TIter next( ((THashList *)(GetListOfKeys()))->GetListForObject(name) );
+   TIter next( ((THashList *)fKeys)->GetListForObject(name) );
 
    TKey *key;
    while (( key = (TKey *)next() )) {
@@ -1117,6 +1389,15 @@ TKey *TDirectoryFile::GetKey(const char *name, Short_t cycle) const
    return nullptr;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the number of keys of this directory, without creating the keys
+/// still described only by the keys index.
+
+Int_t TDirectoryFile::GetNkeys() const
+{
+   return fKeysIndex ? fKeysIndex->fOffsets.size() : fKeys->GetSize();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// List Directory contents
 ///
@@ -1166,7 +1447,7 @@ void TDirectoryFile::ls(Option_t *option) const
 
    if (diskobj && fKeys) {
       //*-* Loop on all the keys
-      TObjLink *lnk = fKeys->FirstLink();
+      TObjLink *lnk = GetListOfKeys()->FirstLink();
       while (lnk) {
          TKey *key = (TKey*)lnk->GetObject();
          TString s = key->GetName();
@@ -1186,6 +1467,69 @@ void TDirectoryFile::ls(Option_t *option) const
    TROOT::DecreaseDirLevel();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Create all the keys still described only by the keys index, in the
+/// order of the keys record, and drop the index.
+
+void TDirectoryFile::LoadAllKeys() const
+{
+   std::unique_ptr<ROOT::Internal::RKeysIndex> index(fKeysIndex);
+   const Int_t nentries = index->fOffsets.size();
+   std::vector<Int_t> order(nentries);
+   std::iota(order.begin(), order.end(), 0);
+   std::sort(order.begin(), order.end(), [&index](Int_t i, Int_t j) { return index->fOffsets[i] < index->fOffsets[j]; });
+
+   std::vector<TKey *> keys, created;
+   keys.reserve(nentries);
+   for (Int_t i : order) {
+      TKey *key = nullptr;
+      if (index->fLoaded[i]) {
+         Short_t cycle;
+         std::string_view name = R__GetSerializedKeyName(index->fRecord.data() + index->fOffsets[i], &cycle);
+         TIter next( ((THashList *)fKeys)->GetListForObject(std::string(name).c_str()) );
+         while (( key = (TKey *)next() )) {
+            if (name == key->GetName() && cycle == key->GetCycle())
+               break;
+         }
+         if (key) created.push_back(key);
+      } else {
+         key = CreateIndexedKey(i);
+      }
+      if (key) keys.push_back(key);
+   }
+   fKeysIndex = nullptr;
+
+   // Re-insert the keys created so far at their position in the record.
+   if ((Int_t)created.size() == fKeys->GetSize()) {
+      fKeys->Clear("nodelete");
+   } else {
+      for (TKey *key : created)
+         fKeys->Remove(key);
+   }
+   for (TKey *key : keys)
+      fKeys->Add(key);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create the keys named 'name' still described only by the keys index.
+
+void TDirectoryFile::LoadIndexedKeys(const char *name) const
+{
+   if (!fKeysIndex || !name) return;
+
+   auto &index = *fKeysIndex;
+   std::string_view sname(name);
+   auto keyName = [&index](Int_t offset) { return R__GetSerializedKeyName(index.fRecord.data() + offset); };
+   auto first = std::lower_bound(index.fOffsets.begin(), index.fOffsets.end(), sname,
+                                 [&keyName](Int_t offset, std::string_view n) { return keyName(offset) < n; });
+   for (auto it = first; it != index.fOffsets.end() && keyName(*it) == sname; ++it) {
+      Int_t entry = it - index.fOffsets.begin();
+      if (index.fLoaded[entry]) continue;
+      if (TKey *key = CreateIndexedKey(entry))
+         fKeys->Add(key);
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Interface to TFile::Open
 
@@ -1346,6 +1690,7 @@ Int_t TDirectoryFile::ReadKeys(Bool_t forceRead)
 
    char *buffer;
    if (forceRead) {
+      DeleteKeysIndex();
       fKeys->Delete();
       //In case directory was updated by another process, read new
       //position for the keys
@@ -1386,6 +1731,12 @@ Int_t TDirectoryFile::ReadKeys(Bool_t forceRead)
       buffer = headerkey->GetBuffer();
       headerkey->ReadKeyBuffer(buffer);
 
+      // The keys of read-only directories are created on demand.
+      if (!fFile->IsWritable() && !fKeysIndex && ReadKeysIndex(buffer, headerkey->GetObjlen())) {
+         delete headerkey;
+         return GetNkeys();
+      }
+
       TKey *key;
       frombuf(buffer, &nkeys);
       for (Int_t i = 0; i < nkeys; i++) {
@@ -1412,6 +1763,45 @@ Int_t TDirectoryFile::ReadKeys(Bool_t forceRead)
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Keep the keys record in memory instead of creating all its keys, if it
+/// contains a keys index (see WriteKeys). 'buffer' points to the number of
+/// keys and 'len' is the number of bytes of the record from there.
+/// Returns false if there is no valid index.
+
+Bool_t TDirectoryFile::ReadKeysIndex(const char *buffer, Int_t len)
+{
+   if (len < (Int_t)sizeof(Int_t) + kKeysIndexTrailer) return kFALSE;
+
+   char *trailer = const_cast<char *>(buffer) + len - kKeysIndexTrailer;
+   Int_t nentries;
+   UInt_t magic;
+   frombuf(trailer, &nentries);
+   frombuf(trailer, &magic);
+   if (magic != kKeysIndexMagic || nentries < 0 ||
+       (Long64_t)nentries * (Int_t)sizeof(Int_t) > len - (Int_t)sizeof(Int_t) - kKeysIndexTrailer)
+      return kFALSE;
+   Int_t nkeys;
+   char *start = const_cast<char *>(buffer);
+   frombuf(start, &nkeys);
+   if (nkeys != nentries)
+      return kFALSE;
+
+   const Int_t recordLen = len - nentries * sizeof(Int_t) - kKeysIndexTrailer;
+   char *entries = const_cast<char *>(buffer) + recordLen;
+   auto index = std::make_unique<ROOT::Internal::RKeysIndex>();
+   index->fOffsets.resize(nentries);
+   for (Int_t i = 0; i < nentries; ++i) {
+      frombuf(entries, &index->fOffsets[i]);
+      if (index->fOffsets[i] < (Int_t)sizeof(Int_t) || index->fOffsets[i] >= recordLen)
+         return kFALSE;
+   }
+   index->fRecord.assign(buffer, buffer + recordLen);
+   index->fLoaded.assign(nentries, 0);
+   fKeysIndex = index.release();
+   return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Read object with keyname from the current directory
 ///
@@ -1458,6 +1848,7 @@ void TDirectoryFile::ResetAfterMerge(TFileMergeInfo *info)
    fSeekParent = 0; // updated by Init
    fSeekKeys = 0;   // updated by Init
    // Does not change: fFile
+   DeleteKeysIndex();
    TKey *key = fKeys ? (TKey*)fKeys->FindObject(fName) : nullptr;
    TClass *cl = IsA();
    if (key) {
@@ -2114,6 +2505,12 @@ void TDirectoryFile::WriteDirHeader()
 /// Write Keys linked list on the file.
 ///
 ///  The linked list of keys (fKeys) is written as a single data record
+///
+/// If the bit TFile::kKeysIndex is set, the record ends with an index of the
+/// keys: the offsets of the serialized keys sorted by name and decreasing
+/// cycle, followed by their number and a magic number. Older versions of
+/// ROOT ignore it, while ReadKeys uses it to create the keys of read-only
+/// directories only when they are looked up.
 
 void TDirectoryFile::WriteKeys()
 {
@@ -2125,6 +2522,8 @@ void TDirectoryFile::WriteKeys()
       return;
    }
 
+   if (fKeysIndex) LoadAllKeys();
+
 //*-* Delete the old keys structure if it exists
    if (fSeekKeys != 0) {
       f->MakeFree(fSeekKeys, fSeekKeys + fNbytesKeys -1);
@@ -2138,17 +2537,35 @@ void TDirectoryFile::WriteKeys()
    while ((key = (TKey*)next())) {
       nbytes += key->Sizeof();
    }
+   const Bool_t withIndex = f->TestBit(TFile::kKeysIndex) && nkeys > 0;
+   const Int_t nbytesIndex = withIndex ? nkeys * sizeof(Int_t) + kKeysIndexTrailer : 0;
+   nbytes += nbytesIndex;
    TKey *headerkey  = new TKey(fName,fTitle,IsA(),nbytes,this);
    if (headerkey->GetSeekKey() == 0) {
       delete headerkey;
       return;
    }
    char *buffer = headerkey->GetBuffer();
+   char *start = buffer;
+   std::vector<std::pair<TKey *, Int_t>> offsets;
+   if (withIndex) offsets.reserve(nkeys);
    next.Reset();
    tobuf(buffer, nkeys);
    while ((key = (TKey*)next())) {
+      if (withIndex) offsets.emplace_back(key, buffer - start);
       key->FillBuffer(buffer);
    }
+   if (withIndex) {
+      std::stable_sort(offsets.begin(), offsets.end(), [](const std::pair<TKey *, Int_t> &a, const std::pair<TKey *, Int_t> &b) {
+         int cmp = std::string_view(a.first->GetName()).compare(b.first->GetName());
+         return cmp < 0 || (cmp == 0 && a.first->GetCycle() > b.first->GetCycle());
+      });
+      buffer = start + nbytes - nbytesIndex;
+      for (auto &entry : offsets)
+         tobuf(buffer, entry.second);
+      tobuf(buffer, nkeys);
+      tobuf(buffer, kKeysIndexMagic);
+   }
 
    fSeekKeys     = headerkey->GetSeekKey();
    fNbytesKeys   = headerkey->GetNbytes();
@@ -84,11 +84,24 @@ The structure of a directory is shown in TDirectoryFile::TDirectoryFile
 #include <sys/stat.h>
 #ifndef WIN32
 #   include <unistd.h>
+#   include <sys/mman.h>
 #else
 #   define ssize_t int
 #   include <io.h>
 #   include <sys/types.h>
 #endif
+#if defined(R__LINUX) || defined(R__FBSD)
+// for preadv
+#   define R__HAS_PREADV
+#   include <sys/uio.h>
+#   include <climits>
+#   ifndef IOV_MAX
+#      define IOV_MAX 1024
+#   endif
+#endif
+#ifdef R__HAS_URING
+#   include "ROOT/RIoUring.hxx"
+#endif
 
 #include "Bytes.h"
 #include "Compression.h"
@@ -129,9 +142,18 @@ The structure of a directory is shown in TDirectoryFile::TDirectoryFile
 #include "TObjString.h"
 #include "TStopwatch.h"
 #include "compiledata.h"
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <set>
+#include <thread>
+#include <vector>
 #include "TSchemaRule.h"
 #include "TSchemaRuleSet.h"
 #include "TThreadSlots.h"
@@ -146,6 +168,7 @@ std::atomic<Long64_t> TFile::fgBytesWrite{0};
 std::atomic<Long64_t> TFile::fgFileCounter{0};
 std::atomic<Int_t>    TFile::fgReadCalls{0};
 Int_t    TFile::fgReadaheadSize = 256000;
+Int_t    TFile::fgReadCoalesceGap = 65536;
 Bool_t   TFile::fgReadInfo = kTRUE;
 TList   *TFile::fgAsyncOpenRequests = nullptr;
 TString  TFile::fgCacheFileDir;
@@ -172,6 +195,181 @@ AddPseudoGlobals() {
 }
 } gAddPseudoGlobals;
 }
+
+namespace ROOT {
+namespace Internal {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Background thread writing the buffers of a TFile, see TFile::EnableAsyncWrite().
+/// The buffers are written in the order they are queued, each at the offset
+/// it was queued for; a sync request is executed once all the buffers queued
+/// before it are written. The total size of the queued buffers is bounded:
+/// Push() blocks until there is room for the new buffer.
+
+class RFileAsyncWriter {
+private:
+   struct RRequest {
+      std::unique_ptr<char[]> fBuffer; ///< Copy of the data, nullptr for a sync request
+      Long64_t fPos;                   ///< Offset in the file
+      Int_t fLen;                      ///< Number of bytes to write
+   };
+
+   Int_t fFD;                          ///< File descriptor
+   Long64_t fMaxQueued;                ///< Maximum number of bytes in fQueue
+   mutable std::mutex fMutex;          ///< Protects all the members below
+   std::condition_variable fWork;      ///< Signals new requests to the thread
+   std::condition_variable fDone;      ///< Signals completed requests
+   std::deque<RRequest> fQueue;        ///< Pending requests, the first one is being executed
+   Long64_t fQueued{0};                ///< Number of bytes in fQueue
+   Bool_t fStop{kFALSE};               ///< Terminate the thread once fQueue is empty
+   Int_t fErrno{0};                    ///< errno of the first failed request
+   Long64_t fWritten{0};               ///< Number of bytes written
+   Double_t fWriteTime{0};             ///< Time spent writing, in seconds
+   std::thread fThread;
+
+   static Int_t WriteAt(Int_t fd, const char *buf, Long64_t pos, Int_t len)
+   {
+#ifndef WIN32
+      while (len > 0) {
+         ssize_t siz = ::pwrite(fd, buf, len, pos);
+         if (siz < 0 && errno == EINTR)
+            continue;
+         if (siz <= 0)
+            return siz < 0 ? errno : EIO;
+         buf += siz;
+         pos += siz;
+         len -= siz;
+      }
+      return 0;
+#else
+      return ENOSYS;
+#endif
+   }
+
+   void Loop()
+   {
+      std::unique_lock<std::mutex> lock(fMutex);
+      while (true) {
+         fWork.wait(lock, [this] { return fStop || !fQueue.empty(); });
+         if (fQueue.empty())
+            break;
+
+         // The request stays in the queue while it is executed, so that Wait() also waits for it.
+         // References to deque elements are not invalidated by push_back().
+         RRequest &req = fQueue.front();
+         Bool_t failed = fErrno != 0;
+         lock.unlock();
+
+         Int_t err = 0;
+         auto start = std::chrono::steady_clock::now();
+         if (!failed) {
+            if (req.fBuffer)
+               err = WriteAt(fFD, req.fBuffer.get(), req.fPos, req.fLen);
+#ifndef WIN32
+            else if (::fsync(fFD) < 0)
+               err = errno;
+#endif
+         }
+         std::chrono::duration<Double_t> elapsed = std::chrono::steady_clock::now() - start;
+
+         lock.lock();
+         if (err && !fErrno)
+            fErrno = err;
+         if (!failed && !err) {
+            fWritten += req.fLen;
+            fWriteTime += elapsed.count();
+         }
+         fQueued -= req.fLen;
+         fQueue.pop_front();
+         fDone.notify_all();
+      }
+   }
+
+   Int_t Enqueue(RRequest &&req)
+   {
+      std::unique_lock<std::mutex> lock(fMutex);
+      fDone.wait(lock, [&] { return fErrno || fQueue.empty() || fQueued + req.fLen <= fMaxQueued; });
+      if (fErrno)
+         return fErrno;
+      fQueued += req.fLen;
+      fQueue.emplace_back(std::move(req));
+      fWork.notify_one();
+      return 0;
+   }
+
+public:
+   RFileAsyncWriter(Int_t fd, Long64_t maxQueued) : fFD(fd), fMaxQueued(maxQueued)
+   {
+      fThread = std::thread([this] { Loop(); });
+   }
+
+   /// Execute the pending requests and terminate the thread.
+   ~RFileAsyncWriter()
+   {
+      {
+         std::lock_guard<std::mutex> lock(fMutex);
+         fStop = kTRUE;
+      }
+      fWork.notify_one();
+      fThread.join();
+   }
+
+   /// Queue a copy of buf to be written at pos. Returns the errno of a failed previous request, or 0.
+   Int_t Push(const char *buf, Long64_t pos, Int_t len)
+   {
+      std::unique_ptr<char[]> copy(new char[len]);
+      memcpy(copy.get(), buf, len);
+      return Enqueue(RRequest{std::move(copy), pos, len});
+   }
+
+   /// Queue a sync of the file. Returns the errno of a failed previous request, or 0.
+   Int_t PushSync() { return Enqueue(RRequest{nullptr, 0, 0}); }
+
+   /// Wait until all the queued requests are executed. Returns the errno of a failed request, or 0.
+   Int_t Wait()
+   {
+      std::unique_lock<std::mutex> lock(fMutex);
+      fDone.wait(lock, [this] { return fQueue.empty(); });
+      return fErrno;
+   }
+
+   Long64_t GetQueued() const
+   {
+      std::lock_guard<std::mutex> lock(fMutex);
+      return fQueued;
+   }
+
+   Int_t GetQueueDepth() const
+   {
+      std::lock_guard<std::mutex> lock(fMutex);
+      return fQueue.size();
+   }
+
+   Double_t GetRate() const
+   {
+      std::lock_guard<std::mutex> lock(fMutex);
+      return fWriteTime > 0 ? fWritten / fWriteTime : 0.;
+   }
+};
+
+} // namespace Internal
+} // namespace ROOT
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Report a failure of the asynchronous writes; as for synchronous writes,
+/// the file is no longer writable afterwards.
+
+void ReportAsyncWriteError(TFile *file, const char *where, Int_t err)
+{
+   file->SetBit(TFile::kWriteError);
+   file->SetWritable(kFALSE);
+   file->Error(where, "error writing to file %s: %s", file->GetName(), strerror(err));
+}
+
+} // anonymous namespace
+
 ////////////////////////////////////////////////////////////////////////////////
 /// File default Constructor.
 
@@ -302,6 +500,32 @@ TFile::TFile() : TDirectoryFile(), fCompress(ROOT::RCompressionSetting::EAlgorit
 /// ~~~{.cpp}
 ///   TFile *f = TFile::Open("tmpname.root?reproducible=fixedname","RECREATE","File title");
 /// ~~~
+///
+/// A bit `TFile::kKeysIndex` can be enabled specifying the `"keysindex"` url
+/// option, or with `TFile.KeysIndex: yes` in the system.rootrc file, when
+/// writing the file. The list of keys of each directory is then followed on
+/// disk by an index of the keys sorted by name. When such a file is opened
+/// for reading, the TKey objects are only created when a key is looked up
+/// (e.g. by Get or GetKey) or when the list of keys is requested, which makes
+/// opening directories with many keys much faster. Older versions of ROOT
+/// ignore the index.
+///
+/// A local file opened for reading can be mapped into memory by specifying
+/// the `"mmap"` url option, or with `TFile.MMap: yes` in the system.rootrc file:
+/// ~~~{.cpp}
+///   TFile *f = TFile::Open("name.root?mmap","READ");
+/// ~~~
+/// The file is then read without system calls and the processes reading the
+/// same file share its pages in the page cache. Compressed records are
+/// decompressed straight from the mapping and uncompressed objects are
+/// streamed from it without copy. Files that cannot be mapped are read as usual.
+///
+/// A local file opened for writing can be written by a background thread by
+/// specifying the `"asyncwrite"` url option, or with `TFile.AsyncWrite: <MB>`
+/// in the system.rootrc file, see EnableAsyncWrite():
+/// ~~~{.cpp}
+///   TFile *f = TFile::Open("name.root?asyncwrite","RECREATE");
+/// ~~~
 
 TFile::TFile(const char *fname1, Option_t *option, const char *ftitle, Int_t compress)
            : TDirectoryFile(), fCompress(compress), fUrl(fname1,kTRUE)
@@ -334,6 +558,9 @@ TFile::TFile(const char *fname1, Option_t *option, const char *ftitle, Int_t com
    if (fUrl.HasOption("reproducible"))
       SetBit(kReproducible);
 
+   if (fUrl.HasOption("keysindex") || gEnv->GetValue("TFile.KeysIndex", 0))
+      SetBit(kKeysIndex);
+
    // We are opening synchronously
    fAsyncOpenStatus = kAOSNotAsync;
 
@@ -469,6 +696,8 @@ TFile::TFile(const char *fname1, Option_t *option, const char *ftitle, Int_t com
          goto zombie;
       }
       fWritable = kTRUE;
+      if (fUrl.HasOption("asyncwrite") || gEnv->GetValue("TFile.AsyncWrite", 0))
+         EnableAsyncWrite();
    } else {
 #ifndef WIN32
       fD = TFile::SysOpen(fname, O_RDONLY, 0644);
@@ -480,6 +709,8 @@ TFile::TFile(const char *fname1, Option_t *option, const char *ftitle, Int_t com
          goto zombie;
       }
       fWritable = kFALSE;
+      if (fUrl.HasOption("mmap") || gEnv->GetValue("TFile.MMap", 0))
+         MapFile();
    }
 
    // calling virtual methods from constructor not a good idea, but it is how code was developed
@@ -831,7 +1062,7 @@ void TFile::Init(Bool_t create)
             }
          } else if (fVersion != gROOT->GetVersionInt() && fVersion > 30000) {
             // Don't complain about missing streamer info for empty files.
-            if (fKeys->GetSize()) {
+            if (GetNkeys()) {
                Warning("Init","no StreamerInfo found in %s therefore preventing schema evolution when reading this file."
                               " The file was produced with version %d.%02d/%02d of ROOT.",
                               GetName(),  fVersion / 10000, (fVersion / 100) % (100), fVersion  % 100);
@@ -841,7 +1072,16 @@ void TFile::Init(Bool_t create)
    }
 
    // Count number of TProcessIDs in this file
-   {
+   if (fKeysIndex) {
+      // Look them up by name (see WriteProcessID) rather than creating all the keys.
+      char pidname[32];
+      snprintf(pidname, 32, "ProcessID%d", fNProcessIDs);
+      while (GetKey(pidname)) {
+         fNProcessIDs++;
+         snprintf(pidname, 32, "ProcessID%d", fNProcessIDs);
+      }
+      fProcessIDs = new TObjArray(fNProcessIDs+1);
+   } else {
       TIter next(fKeys);
       TKey *key;
       while ((key = (TKey*)next())) {
@@ -884,6 +1124,8 @@ void TFile::Close(Option_t *option)
 
    if (fIsArchive || !fIsRootFile) {
       FlushWriteCache();
+      DisableAsyncWrite();
+      UnmapFile();
       SysClose(fD);
       fD = -1;
 
@@ -939,6 +1181,8 @@ void TFile::Close(Option_t *option)
    }
 
    if (IsOpen()) {
+      DisableAsyncWrite();
+      UnmapFile();
       SysClose(fD);
       fD = -1;
    }
@@ -1060,6 +1304,12 @@ void TFile::Flush()
 {
    if (IsOpen() && fWritable) {
       FlushWriteCache();
+      if (fAsyncWriter) {
+         // The sync is done by the writer thread after the queued buffers.
+         if (Int_t err = fAsyncWriter->PushSync())
+            ReportAsyncWriteError(this, "Flush", err);
+         return;
+      }
       if (SysSync(fD) < 0) {
          // Write the system error only once for this file
          SetBit(kWriteError); SetWritable(kFALSE);
@@ -1730,6 +1980,8 @@ Bool_t TFile::ReadBuffer(char *buf, Int_t len)
 /// The value pos[i] is the seek position of block i of length len[i].
 /// Note that for nbuf=1, this call is equivalent to TFile::ReafBuffer.
 /// This function is overloaded by TNetFile, TWebFile, etc.
+/// For local files the blocks are read with vectored system calls, see
+/// TFile::ReadBuffersVectored, or copied from the mapping of memory mapped files.
 /// Returns kTRUE in case of failure.
 
 Bool_t TFile::ReadBuffers(char *buf, Long64_t *pos, Int_t *len, Int_t nbuf)
@@ -1744,6 +1996,31 @@ Bool_t TFile::ReadBuffers(char *buf, Long64_t *pos, Int_t *len, Int_t nbuf)
       return kFALSE;
    }
 
+   if (fMapping) {
+      // copy the blocks straight from the mapping of the file; the blocks
+      // written after the file was mapped are read with system calls
+      Long64_t k = 0;
+      for (Int_t j = 0; j < nbuf; j++) {
+         const char *mapped = GetMappedBuffer(pos[j], len[j]);
+         if (mapped) {
+            memcpy(&buf[k], mapped, len[j]);
+         } else if (SysSeek(fD, pos[j] + fArchiveOffset, SEEK_SET) < 0 || SysRead(fD, &buf[k], len[j]) != len[j]) {
+            Error("ReadBuffers", "error reading %d bytes at %lld of file %s", len[j], pos[j], GetName());
+            return kTRUE;
+         } else {
+            fBytesRead += len[j];
+            fgBytesRead += len[j];
+         }
+         k += len[j];
+      }
+      fReadCalls++;
+      fgReadCalls++;
+      return kFALSE;
+   }
+
+   if (ReadBuffersVectored(buf, pos, len, nbuf))
+      return kFALSE;
+
    Int_t k = 0;
    Bool_t result = kTRUE;
    TFileCacheRead *old = fCacheRead;
@@ -1794,6 +2071,269 @@ Bool_t TFile::ReadBuffers(char *buf, Long64_t *pos, Int_t *len, Int_t nbuf)
    return result;
 }
 
+#ifdef R__HAS_PREADV
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill the iovcnt buffers described by iov from the file descriptor fd,
+/// starting at the physical offset `offset`. Interrupted and partial reads are
+/// resumed; the entries of iov are consumed in the process.
+/// Returns the number of bytes read (less than requested only at the end of
+/// the file) or -1 in case of error.
+
+Long64_t R__PReadV(int fd, struct iovec *iov, int iovcnt, Long64_t offset)
+{
+   Long64_t total = 0;
+   while (iovcnt > 0) {
+      ssize_t siz = ::preadv(fd, iov, std::min(iovcnt, IOV_MAX), offset);
+      if (siz < 0) {
+         if (errno == EINTR)
+            continue;
+         return -1;
+      }
+      if (siz == 0)
+         break;
+      total += siz;
+      offset += siz;
+      while (iovcnt > 0 && (size_t)siz >= iov->iov_len) {
+         siz -= iov->iov_len;
+         ++iov;
+         --iovcnt;
+      }
+      if (siz > 0) {
+         iov->iov_base = static_cast<char *>(iov->iov_base) + siz;
+         iov->iov_len -= siz;
+      }
+   }
+   return total;
+}
+
+} // anonymous namespace
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read the nbuf blocks described in arrays pos and len with as few system
+/// calls as possible.
+///
+/// The blocks are sorted by position and neighbouring blocks separated by at
+/// most GetReadCoalesceGap() bytes are merged into a single run. Each run is
+/// read with one preadv() scattering directly into buf, the holes between the
+/// blocks being discarded into a scratch buffer. When io_uring is available,
+/// all the runs are submitted at once instead.
+///
+/// This is only done for plain local files (derived classes implement their own
+/// SysRead) that are not memory mapped and have no pending writes. In all other cases kFALSE is returned
+/// without reading anything and the caller falls back to the generic
+/// implementation; kTRUE is returned once the blocks have been read.
+/// A failed read leaves the generic implementation to retry and report the error.
+
+Bool_t TFile::ReadBuffersVectored(char *buf, Long64_t *pos, Int_t *len, Int_t nbuf)
+{
+#ifdef R__HAS_PREADV
+   if (fD < 0 || nbuf < 1 || fMapping || fAsyncWriter || IsA() != TFile::Class() || (fWritable && fCacheWrite))
+      return kFALSE;
+
+   // Where each block goes in buf, and the blocks in file order.
+   std::vector<Long64_t> dest(nbuf);
+   std::vector<Int_t> order(nbuf);
+   Long64_t requested = 0;
+   for (Int_t i = 0; i < nbuf; ++i) {
+      if (len[i] < 0 || pos[i] < 0)
+         return kFALSE;
+      dest[i] = requested;
+      requested += len[i];
+      order[i] = i;
+   }
+   std::stable_sort(order.begin(), order.end(), [pos](Int_t a, Int_t b) { return pos[a] < pos[b]; });
+
+   // Runs of blocks, [fFirst, fLast) in order, read by a single system call.
+   // Overlapping blocks start a new run since a byte can only land once.
+   struct RRun {
+      Long64_t fBegin;
+      Long64_t fEnd;
+      Int_t fFirst;
+      Int_t fLast;
+   };
+   std::vector<RRun> runs;
+   Long64_t maxGap = 0;
+   for (Int_t j = 0; j < nbuf; ++j) {
+      const Int_t i = order[j];
+      if (!runs.empty() && pos[i] >= runs.back().fEnd && pos[i] - runs.back().fEnd <= fgReadCoalesceGap) {
+         maxGap = std::max(maxGap, pos[i] - runs.back().fEnd);
+         runs.back().fEnd = pos[i] + len[i];
+         runs.back().fLast = j + 1;
+      } else {
+         runs.push_back({pos[i], pos[i] + len[i], j, j + 1});
+      }
+   }
+
+   Double_t start = 0;
+   if (gPerfStats) start = TTimeStamp();
+
+   Bool_t done = kFALSE;
+#ifdef R__HAS_URING
+   if (runs.size() > 1 && ROOT::Internal::RIoUring::IsAvailable()) {
+      // Runs of a single block land in place, the others are staged and scattered afterwards.
+      std::size_t nstaged = 0;
+      for (const auto &run : runs) {
+         if (run.fLast - run.fFirst > 1)
+            nstaged += run.fEnd - run.fBegin;
+      }
+      std::vector<char> staging(nstaged);
+      std::vector<ROOT::Internal::RIoUring::RReadEvent> events(runs.size());
+      std::size_t offset = 0;
+      for (std::size_t r = 0; r < runs.size(); ++r) {
+         const auto &run = runs[r];
+         if (run.fLast - run.fFirst == 1) {
+            events[r].fBuffer = buf + dest[order[run.fFirst]];
+         } else {
+            events[r].fBuffer = staging.data() + offset;
+            offset += run.fEnd - run.fBegin;
+         }
+         events[r].fOffset = run.fBegin + fArchiveOffset;
+         events[r].fSize = run.fEnd - run.fBegin;
+         events[r].fFileDes = fD;
+      }
+      try {
+         ROOT::Internal::RIoUring ring(std::min<std::size_t>(runs.size(), 1024));
+         ring.SubmitReadsAndWait(events.data(), events.size());
+         done = kTRUE;
+         for (std::size_t r = 0; r < runs.size() && done; ++r) {
+            if (events[r].fOutBytes != events[r].fSize)
+               done = kFALSE;
+         }
+      } catch (const std::runtime_error &) {
+         done = kFALSE;
+      }
+      if (done) {
+         for (std::size_t r = 0; r < runs.size(); ++r) {
+            const auto &run = runs[r];
+            if (run.fLast - run.fFirst == 1)
+               continue;
+            const char *from = static_cast<const char *>(events[r].fBuffer);
+            for (Int_t j = run.fFirst; j < run.fLast; ++j) {
+               const Int_t i = order[j];
+               memcpy(buf + dest[i], from + (pos[i] - run.fBegin), len[i]);
+            }
+         }
+      }
+   }
+#endif
+
+   if (!done) {
+      std::vector<char> scratch(maxGap);
+      std::vector<struct iovec> iov;
+      for (const auto &run : runs) {
+         iov.clear();
+         Long64_t end = run.fBegin;
+         for (Int_t j = run.fFirst; j < run.fLast; ++j) {
+            const Int_t i = order[j];
+            if (pos[i] > end)
+               iov.push_back({scratch.data(), (size_t)(pos[i] - end)});
+            iov.push_back({buf + dest[i], (size_t)len[i]});
+            end = pos[i] + len[i];
+         }
+         Long64_t siz = R__PReadV(fD, iov.data(), (int)iov.size(), run.fBegin + fArchiveOffset);
+         if (siz != run.fEnd - run.fBegin)
+            return kFALSE;
+      }
+      done = kTRUE;
+   }
+
+   Long64_t transferred = 0;
+   for (const auto &run : runs)
+      transferred += run.fEnd - run.fBegin;
+   fBytesRead += requested;
+   fgBytesRead += requested;
+   fBytesReadExtra += transferred - requested;
+   fReadCalls += (Int_t)runs.size();
+   fgReadCalls += (Int_t)runs.size();
+
+   if (gMonitoringWriter)
+      gMonitoringWriter->SendFileReadProgress(this);
+   if (gPerfStats)
+      gPerfStats->FileReadEvent(this, transferred, start);
+   return done;
+#else
+   (void)buf;
+   (void)pos;
+   (void)len;
+   (void)nbuf;
+   return kFALSE;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Map the whole file, opened for reading, into memory.
+///
+/// The mapping is read-only: its pages are shared with the page cache, and
+/// hence with the other processes reading the same file, and writing to them
+/// faults. Once mapped, SysRead() and SysSeek() work on the mapping and the
+/// records can be accessed in place with GetMappedBuffer(). The bytes written
+/// to the file after it was mapped are read with system calls.
+/// Returns kFALSE if the file could not be mapped, in which case it keeps
+/// being read with system calls.
+
+Bool_t TFile::MapFile()
+{
+#ifndef WIN32
+   if (fMapping || fD < 0 || fWritable)
+      return kFALSE;
+   struct stat st;
+   if (::fstat(fD, &st) != 0 || st.st_size <= 0)
+      return kFALSE;
+   const Long64_t size = st.st_size;
+   Long64_t cur = SysSeek(fD, 0, SEEK_CUR);
+   void *addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fD, 0);
+   if (addr == MAP_FAILED) {
+      SysError("MapFile", "cannot map file %s, reading it without mapping", GetName());
+      return kFALSE;
+   }
+   fMapping = static_cast<char *>(addr);
+   fMappingSize = size;
+   fMappingPos = cur < 0 ? 0 : cur;
+   return kTRUE;
+#else
+   return kFALSE;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Release the memory mapping of the file, if any.
+
+void TFile::UnmapFile()
+{
+#ifndef WIN32
+   if (!fMapping)
+      return;
+   ::munmap(fMapping, fMappingSize);
+   fMapping = nullptr;
+   fMappingSize = 0;
+   fMappingPos = 0;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return a pointer to the len bytes found at position pos of a memory mapped
+/// file, or nullptr if the file is not mapped or the bytes are beyond the end
+/// of the mapping, e.g. because they were written after the file was mapped;
+/// they must then be read with ReadBuffer().
+///
+/// The bytes are accounted as read from the file. The pointer is valid until
+/// the file is closed and the memory it points to must not be modified.
+
+char *TFile::GetMappedBuffer(Long64_t pos, Int_t len)
+{
+   if (!fMapping || pos < 0 || len < 0)
+      return nullptr;
+   const Long64_t start = pos + fArchiveOffset;
+   if (start + len > fMappingSize)
+      return nullptr;
+   fBytesRead += len;
+   fgBytesRead += len;
+   return fMapping + start;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Read buffer via cache.
 ///
@@ -2110,6 +2650,7 @@ Int_t TFile::ReOpen(Option_t *mode)
          fFree->Delete();
          SafeDelete(fFree);
 
+         DisableAsyncWrite();
          SysClose(fD);
          fD = -1;
 
@@ -2128,12 +2669,15 @@ Int_t TFile::ReOpen(Option_t *mode)
          return -1;
       }
       SetWritable(kFALSE);
+      if (fUrl.HasOption("mmap") || gEnv->GetValue("TFile.MMap", 0))
+         MapFile();
 
    } else {
       // switch to UPDATE mode
 
       // close readonly file
       if (IsOpen()) {
+         UnmapFile();
          SysClose(fD);
          fD = -1;
       }
@@ -2150,6 +2694,8 @@ Int_t TFile::ReOpen(Option_t *mode)
          return -1;
       }
       SetWritable(kTRUE);
+      if (fUrl.HasOption("asyncwrite") || gEnv->GetValue("TFile.AsyncWrite", 0))
+         EnableAsyncWrite();
 
       fFree = new TList;
       if (fSeekFree > fBEGIN)
@@ -2398,6 +2944,25 @@ Bool_t TFile::WriteBuffer(const char *buf, Int_t len)
          return kFALSE;
       }
 
+      if (fAsyncWriter) {
+         // The buffer is copied and written by the background thread at the
+         // current position, the file cursor is moved as by a write.
+         Long64_t pos = SysSeek(fD, 0, SEEK_CUR);
+         Int_t err = pos < 0 ? GetErrno() : fAsyncWriter->Push(buf, pos, len);
+         if (err) {
+            ReportAsyncWriteError(this, "WriteBuffer", err);
+            return kTRUE;
+         }
+         fOffset = SysSeek(fD, pos + len, SEEK_SET);
+         fBytesWrite  += len;
+         fgBytesWrite += len;
+
+         if (gMonitoringWriter)
+            gMonitoringWriter->SendFileWriteProgress(this);
+
+         return kFALSE;
+      }
+
       ssize_t siz;
       gSystem->IgnoreInterrupt();
       while ((siz = SysWrite(fD, buf, len)) < 0 && GetErrno() == EINTR)  // NOLINT: silence clang-tidy warnings
@@ -2449,6 +3014,99 @@ Int_t TFile::WriteBufferViaCache(const char *buf, Int_t len)
    return 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Write the buffers of the file in a background thread.
+///
+/// WriteBuffer() then only copies the buffer into a queue and returns; a
+/// dedicated thread writes the queued buffers in order. Flush() also queues
+/// the sync of the file instead of waiting for it. The producer is therefore
+/// not stalled by the storage latency, e.g. on TTree::AutoSave() or when
+/// baskets are written.
+///
+/// \param[in] maxQueued Maximum number of bytes queued; WriteBuffer() waits
+///            when the queue is full. If 0, the value in MB of the rootrc
+///            variable `TFile.AsyncWrite` is used, or 64 MB if it is not set.
+///
+/// The pending writes are completed before the file is read, before
+/// GetSize() and when the file is closed. A failed write is reported by the
+/// next WriteBuffer() or Flush() call, or when the file is closed.
+/// Asynchronous writing can also be requested with the "asyncwrite" option
+/// in the file URL, or for all files with `TFile.AsyncWrite`.
+///
+/// Only supported for local files opened for writing. Returns kTRUE if the
+/// background writing is active.
+
+Bool_t TFile::EnableAsyncWrite(Long64_t maxQueued)
+{
+#ifndef WIN32
+   if (fAsyncWriter)
+      return kTRUE;
+   if (fD < 0 || !fWritable || fIsArchive || IsA() != TFile::Class())
+      return kFALSE;
+
+   if (maxQueued <= 0) {
+      Long64_t mb = gEnv->GetValue("TFile.AsyncWrite", 0);
+      maxQueued = (mb > 0 ? mb : 64) * 1024 * 1024;
+   }
+   fAsyncWriter = new ROOT::Internal::RFileAsyncWriter(fD, maxQueued);
+   return kTRUE;
+#else
+   (void)maxQueued;
+   return kFALSE;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Complete the pending writes and stop the background writing.
+
+void TFile::DisableAsyncWrite()
+{
+   if (!fAsyncWriter)
+      return;
+   WaitAsyncWrites();
+   delete fAsyncWriter;
+   fAsyncWriter = nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Wait until the buffers queued for the background thread are written.
+/// Returns kTRUE in case of error.
+
+Bool_t TFile::WaitAsyncWrites()
+{
+   if (!fAsyncWriter)
+      return kFALSE;
+   Int_t err = fAsyncWriter->Wait();
+   if (err && !TestBit(kWriteError))
+      ReportAsyncWriteError(this, "WaitAsyncWrites", err);
+   return err != 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the number of bytes queued for the background writing thread.
+
+Long64_t TFile::GetAsyncWriteQueued() const
+{
+   return fAsyncWriter ? fAsyncWriter->GetQueued() : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the number of buffers queued for the background writing thread.
+
+Int_t TFile::GetAsyncWriteQueueDepth() const
+{
+   return fAsyncWriter ? fAsyncWriter->GetQueueDepth() : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the write throughput of the background writing thread, in bytes
+/// per second spent writing.
+
+Double_t TFile::GetAsyncWriteRate() const
+{
+   return fAsyncWriter ? fAsyncWriter->GetRate() : 0.;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Write FREE linked list on the file.
 /// The linked list of FREE segments (fFree) is written as a single data
@@ -4390,9 +5048,27 @@ Int_t TFile::SysClose(Int_t fd)
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Interface to system read. All arguments like in POSIX read().
+/// For memory mapped files the bytes are copied from the mapping, unless they
+/// were written after the file was mapped.
 
 Int_t TFile::SysRead(Int_t fd, void *buf, Int_t len)
 {
+   if (fAsyncWriter && fd == fD)
+      WaitAsyncWrites();
+   if (fMapping && fd == fD) {
+      if (fMappingPos + len <= fMappingSize) {
+         memcpy(buf, fMapping + fMappingPos, len);
+         fMappingPos += len;
+         return len;
+      }
+#ifndef WIN32
+      // The file grew since it was mapped.
+      ssize_t n = ::pread(fd, buf, len, fMappingPos);
+      if (n > 0)
+         fMappingPos += n;
+      return (Int_t)n;
+#endif
+   }
    return ::read(fd, buf, len);
 }
 
@@ -4409,9 +5085,25 @@ Int_t TFile::SysWrite(Int_t fd, const void *buf, Int_t len)
 /// All arguments like in POSIX lseek()
 /// except that the offset and return value are of a type which are
 /// able to handle 64 bit file systems.
+/// For memory mapped files only the cursor in the mapping is moved.
 
 Long64_t TFile::SysSeek(Int_t fd, Long64_t offset, Int_t whence)
 {
+   if (fMapping && fd == fD) {
+      Long64_t pos = offset;
+      if (whence == SEEK_CUR) {
+         pos += fMappingPos;
+      } else if (whence == SEEK_END) {
+         // The file may have grown since it was mapped.
+         struct stat st;
+         pos += ::fstat(fd, &st) == 0 ? (Long64_t)st.st_size : fMappingSize;
+      }
+      if (pos < 0) {
+         errno = EINVAL;
+         return -1;
+      }
+      return fMappingPos = pos;
+   }
 #if defined (R__SEEK64)
    return ::lseek64(fd, offset, whence);
 #elif defined(WIN32)
@@ -4431,6 +5123,7 @@ Long64_t TFile::SysSeek(Int_t fd, Long64_t offset, Int_t whence)
 Int_t TFile::SysStat(Int_t, Long_t *id, Long64_t *size, Long_t *flags,
                      Long_t *modtime)
 {
+   WaitAsyncWrites();
    return gSystem->GetPathInfo(fRealName, id, size, flags, modtime);
 }
 
@@ -4492,6 +5185,23 @@ Int_t TFile::GetReadaheadSize()
 //______________________________________________________________________________
 void TFile::SetReadaheadSize(Int_t bytes) { fgReadaheadSize = bytes; }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Static function returning the largest hole between two blocks requested
+/// via ReadBuffers() that is read rather than skipped, see SetReadCoalesceGap().
+
+Int_t TFile::GetReadCoalesceGap()
+{
+   return fgReadCoalesceGap;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Static function setting the largest hole between two blocks requested via
+/// ReadBuffers() from a local file for which both blocks are fetched by a single
+/// vectored read. The bytes of the hole are read and discarded; larger holes
+/// start a new read. A negative value disables the merging.
+
+void TFile::SetReadCoalesceGap(Int_t bytes) { fgReadCoalesceGap = bytes; }
+
 //______________________________________________________________________________
 void TFile::SetFileBytesRead(Long64_t bytes) { fgBytesRead = bytes; }
 
@@ -20,6 +20,14 @@ any of its remote file access plugins. It is therefore useful in
 a Grid environment where the files might be accessible only remotely.
 The merging interface allows files containing histograms and trees
 to be merged, like the standalone hadd program.
+
+With SetNThreads(n), the input files are opened concurrently and the
+objects that are merged in memory (histograms and, in general, objects
+with a Merge function and without a ResetAfterMerge function) are read
+and merged in parallel by up to n threads, each processing a contiguous
+range of input files. The partial results are then combined and written
+once to the output file; trees and other objects writing to the output
+are still merged sequentially.
 */
 
 #include "TFileMerger.h"
@@ -38,6 +46,8 @@ to be merged, like the standalone hadd program.
 #include "TROOT.h"
 #include "TMemFile.h"
 #include "TVirtualMutex.h"
+#include "TError.h"
+#include "RIOParallelFor.h"
 
 #ifdef WIN32
 // For _getmaxstdio
@@ -48,7 +58,11 @@ to be merged, like the standalone hadd program.
 #include <sys/resource.h>
 #endif
 
+#include <algorithm>
+#include <atomic>
 #include <cstring>
+#include <unordered_set>
+#include <vector>
 
 ClassImp(TFileMerger);
 
@@ -107,6 +121,7 @@ TFileMerger::~TFileMerger()
       R__LOCKGUARD(gROOTMutex);
       gROOT->GetListOfCleanups()->Remove(this);
    }
+   ClearPreMerged();
    SafeDelete(fOutputFile);
 }
 
@@ -115,6 +130,7 @@ TFileMerger::~TFileMerger()
 
 void TFileMerger::Reset()
 {
+   ClearPreMerged();
    fFileList.Clear();
    fMergeList.Clear();
    fExcessFiles.Clear();
@@ -133,7 +149,8 @@ Bool_t TFileMerger::AddFile(const char *url, Bool_t cpProgress)
    TFile *newfile = 0;
    TString localcopy;
 
-   if (fFileList.GetEntries() >= (fMaxOpenedFiles-1)) {
+   // In multi-threaded mode, the files are opened concurrently by OpenExcessFiles.
+   if (fFileList.GetEntries() >= (fMaxOpenedFiles-1) || fNThreads > 1) {
 
       TObjString *urlObj = new TObjString(url);
       fMergeList.Add(urlObj);
@@ -173,7 +190,7 @@ Bool_t TFileMerger::AddFile(const char *url, Bool_t cpProgress)
          Error("AddFile", "cannot open file %s", url);
       return kFALSE;
    } else {
-      if (fOutputFile && fOutputFile->GetCompressionLevel() != newfile->GetCompressionLevel()) fCompressionChange = kTRUE;
+      if (fOutputFile && fOutputFile->GetCompressionSettings() != newfile->GetCompressionSettings()) fCompressionChange = kTRUE;
 
       newfile->SetBit(kCanDelete);
       fFileList.Add(newfile);
@@ -422,8 +439,13 @@ Bool_t TFileMerger::MergeRecursive(TDirectory *target, TList *sourcelist, Int_t
    TFileMergeInfo info(target);
    info.fIOFeatures = fIOFeatures;
    info.fOptions = fMergeOptions;
-   if (fFastMethod && ((type&kKeepCompression) || !fCompressionChange) ) {
-      info.fOptions.Append(" fast");
+   if (fFastMethod) {
+      // When the compression changes, the baskets are recompressed (possibly in
+      // parallel) but still copied without being unstreamed.
+      if ((type&kKeepCompression) || !fCompressionChange)
+         info.fOptions.Append(" fast");
+      else
+         info.fOptions.Append(" fast recompress");
    }
 
    TFile      *current_file;
@@ -512,9 +534,19 @@ Bool_t TFileMerger::MergeRecursive(TDirectory *target, TList *sourcelist, Int_t
                   }
                }
             }
+            // Objects already merged over all the source files by ParallelPreMerge only need to be
+            // written out, or merged into the object found in the output for an incremental merge.
+            TObject *premerged = nullptr;
+            if (!alreadyseen && !fPreMerged.empty() && cl->IsTObject() && cl->GetMerge() && !cl->GetResetAfterMerge())
+               premerged = TakePreMerged(path, key->GetName());
+            Bool_t isPreMerged = premerged != nullptr;
+
             // read object from first source file
             TObject *obj;
-            if (type & kIncremental) {
+            if (premerged && current_file) {
+               obj = premerged;
+               premerged = nullptr;
+            } else if (type & kIncremental) {
                obj = current_sourcedir->GetList()->FindObject(key->GetName());
                if (!obj) {
                   obj = key->ReadObj();
@@ -589,7 +621,18 @@ Bool_t TFileMerger::MergeRecursive(TDirectory *target, TList *sourcelist, Int_t
 
                // Loop over all source files and merge same-name object
                TFile *nextsource = current_file ? (TFile*)sourcelist->After( current_file ) : (TFile*)sourcelist->First();
-               if (nextsource == 0) {
+               if (isPreMerged) {
+                  if (premerged) {
+                     inputs.Add(premerged);
+                     ROOT::MergeFunc_t func = cl->GetMerge();
+                     if (func(obj, &inputs, &info) < 0) {
+                        Error("MergeRecursive", "calling Merge() on '%s' with the corresponding merged input objects",
+                              key->GetName());
+                     }
+                     info.fIsFirst = kFALSE;
+                     inputs.Delete();
+                  }
+               } else if (nextsource == 0) {
                   // There is only one file in the list
                   ROOT::MergeFunc_t func = cl->GetMerge();
                   func(obj, &inputs, &info);
@@ -825,6 +868,10 @@ Bool_t TFileMerger::PartialMerge(Int_t in_type)
       }
    }
 
+   // In multi-threaded mode, AddFile only records the file names.
+   if (fFileList.GetEntries() == 0 && fExcessFiles.GetEntries() > 0 && !OpenExcessFiles())
+      return kFALSE;
+
    // Special treament for the single file case ...
    if ((fFileList.GetEntries() == 1) && !fExcessFiles.GetEntries() &&
       !(in_type & kIncremental) && !fCompressionChange && !fExplicitCompLevel) {
@@ -861,7 +908,10 @@ Bool_t TFileMerger::PartialMerge(Int_t in_type)
    Bool_t result = kTRUE;
    Int_t type = in_type;
    while (result && fFileList.GetEntries()>0) {
+      if (fNThreads > 1)
+         ParallelPreMerge(type);
       result = MergeRecursive(fOutputFile, &fFileList, type);
+      ClearPreMerged();
 
       // Remove local copies if there are any
       TIter next(&fFileList);
@@ -910,52 +960,251 @@ Bool_t TFileMerger::PartialMerge(Int_t in_type)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// Open up to fMaxOpenedFiles of the excess files.
+/// Open up to fMaxOpenedFiles of the excess files, concurrently if more than
+/// one thread was requested with SetNThreads.
 
 Bool_t TFileMerger::OpenExcessFiles()
 {
    if (fPrintLevel > 0) {
       Printf("%s Opening the next %d files", fMsgPrefix.Data(), TMath::Min(fExcessFiles.GetEntries(), fMaxOpenedFiles - 1));
    }
-   Int_t nfiles = 0;
+   std::vector<TObjString *> urls;
    TIter next(&fExcessFiles);
    TObjString *url = 0;
-   TString localcopy;
-   // We want gDirectory untouched by anything going on here
-   TDirectory::TContext ctxt;
-   while( nfiles < (fMaxOpenedFiles-1) && ( url = (TObjString*)next() ) ) {
-      TFile *newfile = 0;
+   while ((Int_t)urls.size() < (fMaxOpenedFiles - 1) && (url = (TObjString *)next()))
+      urls.push_back(url);
+
+   enum EOpenStatus { kNotTried, kCopyFailed, kOpened };
+   std::vector<Int_t> status(urls.size(), kNotTried);
+   std::vector<TString> localcopies(urls.size());
+   std::vector<TFile *> newfiles(urls.size(), nullptr);
+   std::atomic<bool> failed{false};
+   ROOT::Internal::RIOParallelFor(fNThreads, urls.size(), [&](std::size_t i) {
+      if (failed)
+         return;
+      // We want gDirectory untouched by anything going on here
+      TDirectory::TContext ctxt;
       if (fLocal) {
          TUUID uuid;
-         localcopy.Form("file:%s/ROOTMERGE-%s.root", gSystem->TempDirectory(), uuid.AsString());
-         if (!TFile::Cp(url->GetName(), localcopy, url->TestBit(kCpProgress))) {
-            Error("OpenExcessFiles", "cannot get a local copy of file %s", url->GetName());
-            return kFALSE;
+         localcopies[i].Form("file:%s/ROOTMERGE-%s.root", gSystem->TempDirectory(), uuid.AsString());
+         if (!TFile::Cp(urls[i]->GetName(), localcopies[i], urls[i]->TestBit(kCpProgress))) {
+            status[i] = kCopyFailed;
+            failed = true;
+            return;
          }
-         newfile = TFile::Open(localcopy, "READ");
+         newfiles[i] = TFile::Open(localcopies[i], "READ");
       } else {
-         newfile = TFile::Open(url->GetName(), "READ");
+         newfiles[i] = TFile::Open(urls[i]->GetName(), "READ");
       }
-
-      if (!newfile) {
+      // Zombie files should also be skipped
+      if (newfiles[i] && newfiles[i]->IsZombie()) {
+         delete newfiles[i];
+         newfiles[i] = nullptr;
+      }
+      status[i] = kOpened;
+      if (!newfiles[i])
+         failed = true;
+   });
+
+   for (std::size_t i = 0; i < urls.size(); ++i) {
+      if (status[i] == kCopyFailed) {
+         Error("OpenExcessFiles", "cannot get a local copy of file %s", urls[i]->GetName());
+      } else if (status[i] == kOpened && !newfiles[i]) {
          if (fLocal)
             Error("OpenExcessFiles", "cannot open local copy %s of URL %s",
-                  localcopy.Data(), url->GetName());
+                  localcopies[i].Data(), urls[i]->GetName());
          else
-            Error("OpenExcessFiles", "cannot open file %s", url->GetName());
-         return kFALSE;
+            Error("OpenExcessFiles", "cannot open file %s", urls[i]->GetName());
       } else {
-         if (fOutputFile && fOutputFile->GetCompressionLevel() != newfile->GetCompressionLevel()) fCompressionChange = kTRUE;
-
-         newfile->SetBit(kCanDelete);
-         fFileList.Add(newfile);
-         ++nfiles;
-         fExcessFiles.Remove(url);
+         continue;
+      }
+      for (std::size_t j = 0; j < urls.size(); ++j) {
+         delete newfiles[j];
+         // Remove the local copies made by the other threads
+         if (fLocal && !localcopies[j].IsNull())
+            gSystem->Unlink(TUrl(localcopies[j], kTRUE).GetFile());
       }
+      return kFALSE;
+   }
+
+   for (std::size_t i = 0; i < urls.size(); ++i) {
+      TFile *newfile = newfiles[i];
+      if (fOutputFile && fOutputFile->GetCompressionSettings() != newfile->GetCompressionSettings()) fCompressionChange = kTRUE;
+
+      newfile->SetBit(kCanDelete);
+      fFileList.Add(newfile);
+      delete fExcessFiles.Remove(urls[i]);
    }
    return kTRUE;
 }
 
+namespace {
+
+/// Objects of the same path merged by one of the ParallelPreMerge tasks.
+struct PreMergeSlot {
+   TObject *fObj = nullptr;         ///< Object the others are merged into
+   std::vector<TObject *> fPending; ///< Objects read but not yet merged into fObj
+};
+using PreMergeMap_t = std::unordered_map<std::string, PreMergeSlot>;
+
+/// Merge the pending objects of a slot into its first object and delete them.
+void MergePending(const std::string &name, PreMergeSlot &slot, TFileMergeInfo &info)
+{
+   if (slot.fPending.empty())
+      return;
+   TList inputs;
+   for (auto obj : slot.fPending)
+      inputs.Add(obj);
+   slot.fPending.clear();
+   ROOT::MergeFunc_t func = slot.fObj->IsA()->GetMerge();
+   if (func(slot.fObj, &inputs, &info) < 0)
+      ::Error("TFileMerger::ParallelPreMerge", "calling Merge() on '%s'", name.c_str());
+   info.fIsFirst = kFALSE;
+   inputs.Delete();
+}
+
+/// Read the objects of `dir` and of its subdirectories that can be merged in memory and merge
+/// them into `objects`. Objects inheriting from `oneGoClass` are merged in one go at the end.
+void PreMergeDirectory(TDirectory *dir, PreMergeMap_t &objects, TClass *oneGoClass, TFileMergeInfo &info)
+{
+   TString path(dir->GetPath());
+   path.Remove(0, std::strlen(dir->GetFile()->GetPath()));
+
+   std::unordered_set<std::string> seen;
+   TIter nextkey(dir->GetListOfKeys());
+   while (auto key = static_cast<TKey *>(nextkey())) {
+      // The cycles of a key are stored in decreasing order; only the highest one is merged.
+      if (!seen.insert(key->GetName()).second)
+         continue;
+      TClass *cl = TClass::GetClass(key->GetClassName());
+      if (!cl)
+         continue;
+      if (cl->InheritsFrom(TDirectory::Class())) {
+         if (TDirectory *subdir = dir->GetDirectory(key->GetName()))
+            PreMergeDirectory(subdir, objects, oneGoClass, info);
+         continue;
+      }
+      if (!cl->IsTObject() || !cl->GetMerge() || cl->GetResetAfterMerge())
+         continue;
+
+      TObject *obj = key->ReadObj();
+      if (!obj) {
+         ::Info("TFileMerger::ParallelPreMerge", "could not read object for key {%s, %s}; skipping file %s",
+                key->GetName(), key->GetTitle(), dir->GetFile()->GetName());
+         continue;
+      }
+      // The merged object outlives the input file.
+      if (ROOT::DirAutoAdd_t addfunc = obj->IsA()->GetDirectoryAutoAdd())
+         addfunc(obj, nullptr);
+      if (obj->InheritsFrom(TCollection::Class()))
+         ((TCollection *)obj)->SetOwner();
+      obj->ResetBit(kMustCleanup);
+
+      std::string name = std::string(path.Data()) + '/' + key->GetName();
+      auto &slot = objects[name];
+      if (!slot.fObj) {
+         slot.fObj = obj;
+      } else {
+         slot.fPending.push_back(obj);
+         if (!oneGoClass || !cl->InheritsFrom(oneGoClass))
+            MergePending(name, slot, info);
+      }
+   }
+}
+
+} // anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+/// Merge, with up to fNThreads threads, the objects of all the files of fFileList
+/// that are merged in memory, i.e. that have a Merge function and no
+/// ResetAfterMerge function (histograms, for instance).
+///
+/// Each thread reads and merges the objects of a contiguous range of input
+/// files; the partial results are then combined per object, again in parallel,
+/// in the order of the input files. MergeRecursive picks up the results from
+/// fPreMerged instead of reading the inputs again, and merges sequentially the
+/// objects writing to the output file, like trees.
+
+void TFileMerger::ParallelPreMerge(Int_t type)
+{
+   // The selection of listed objects is done while traversing the inputs in MergeRecursive.
+   if (type & (kOnlyListed | kSkipListed))
+      return;
+   if ((type & kResetable) && !(type & kNonResetable))
+      return;
+
+   std::vector<TDirectory *> files;
+   TIter next(&fFileList);
+   while (auto file = (TFile *)next())
+      files.push_back(file);
+   const std::size_t nchunks = std::min<std::size_t>(fNThreads, files.size());
+   if (nchunks < 2)
+      return;
+
+   TClass *oneGoClass = fHistoOneGo ? R__TH1_Class.GetClass() : nullptr;
+   std::vector<PreMergeMap_t> chunks(nchunks);
+   ROOT::Internal::RIOParallelFor(fNThreads, nchunks, [&](std::size_t c) {
+      TDirectory::TContext ctxt;
+      TFileMergeInfo info(nullptr);
+      info.fOptions = fMergeOptions;
+      for (std::size_t i = c * files.size() / nchunks; i < (c + 1) * files.size() / nchunks; ++i)
+         PreMergeDirectory(files[i], chunks[c], oneGoClass, info);
+      for (auto &entry : chunks[c])
+         MergePending(entry.first, entry.second, info);
+   });
+
+   PreMergeMap_t parts;
+   for (auto &chunk : chunks) {
+      for (auto &entry : chunk) {
+         auto &slot = parts[entry.first];
+         if (!slot.fObj)
+            slot.fObj = entry.second.fObj;
+         else
+            slot.fPending.push_back(entry.second.fObj);
+      }
+   }
+   chunks.clear();
+
+   std::vector<std::pair<const std::string, PreMergeSlot> *> entries;
+   entries.reserve(parts.size());
+   for (auto &entry : parts)
+      entries.push_back(&entry);
+   ROOT::Internal::RIOParallelFor(fNThreads, entries.size(), [&](std::size_t i) {
+      TDirectory::TContext ctxt;
+      TFileMergeInfo info(nullptr);
+      info.fOptions = fMergeOptions;
+      info.fIsFirst = kFALSE;
+      MergePending(entries[i]->first, entries[i]->second, info);
+   });
+
+   for (auto &entry : parts)
+      fPreMerged[entry.first] = entry.second.fObj;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Remove from fPreMerged and return the object merged by ParallelPreMerge for
+/// the key `name` in the directory `path` (relative to the file), if any.
+
+TObject *TFileMerger::TakePreMerged(const TString &path, const char *name)
+{
+   auto it = fPreMerged.find(std::string(path.Data()) + '/' + name);
+   if (it == fPreMerged.end())
+      return nullptr;
+   TObject *obj = it->second;
+   fPreMerged.erase(it);
+   return obj;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Delete the objects merged by ParallelPreMerge that were not used.
+
+void TFileMerger::ClearPreMerged()
+{
+   for (auto &entry : fPreMerged)
+      delete entry.second;
+   fPreMerged.clear();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Intercept the case where the output TFile is deleted!
 
@@ -986,6 +1235,21 @@ void TFileMerger::SetMaxOpenedFiles(Int_t newmax)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Set the number of threads used to open the input files and to merge the
+/// objects merged in memory, like histograms (see ParallelPreMerge).
+///
+/// With more than one thread, AddFile(const char*) only records the name of
+/// the file: the files are opened, concurrently, when merging and errors are
+/// reported then. Enables ROOT's thread safety.
+
+void TFileMerger::SetNThreads(UInt_t nthreads)
+{
+   fNThreads = nthreads > 0 ? nthreads : 1;
+   if (fNThreads > 1)
+      ROOT::EnableThreadSafety();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Set the prefix to be used when printing informational message.
 
@@ -759,7 +759,11 @@ TObject *TKey::ReadObj()
       return (TObject*)ReadObjectAny(0);
    }
 
-   TBufferFile bufferRef(TBuffer::kRead, fObjlen+fKeylen);
+   // For memory mapped files, uncompressed objects are streamed in place and
+   // compressed ones are decompressed straight from the mapping.
+   char *mapped = GetFile() ? GetFile()->GetMappedBuffer(fSeekKey, fNbytes) : nullptr;
+   const Bool_t inPlace = mapped && fObjlen <= fNbytes-fKeylen;
+   TBufferFile bufferRef(TBuffer::kRead, fObjlen+fKeylen, inPlace ? mapped : nullptr, kFALSE);
    if (!bufferRef.Buffer()) {
       Error("ReadObj", "Cannot allocate buffer: fObjlen = %d", fObjlen);
       return 0;
@@ -769,17 +773,20 @@ TObject *TKey::ReadObj()
    bufferRef.SetPidOffset(fPidOffset);
 
    std::unique_ptr<char []> compressedBuffer;
+   char *compressed = mapped;
    auto storeBuffer = fBuffer;
    if (fObjlen > fNbytes-fKeylen) {
-      compressedBuffer.reset(new char[fNbytes]);
-      fBuffer = compressedBuffer.get();
-      if( !ReadFile() )                    //Read object structure from file
-      {
-        fBuffer = 0;
-        return 0;
+      if (!compressed) {
+         compressedBuffer.reset(new char[fNbytes]);
+         compressed = fBuffer = compressedBuffer.get();
+         if( !ReadFile() )                    //Read object structure from file
+         {
+           fBuffer = 0;
+           return 0;
+         }
       }
-      memcpy(bufferRef.Buffer(),fBuffer,fKeylen);
-   } else {
+      memcpy(bufferRef.Buffer(),compressed,fKeylen);
+   } else if (!inPlace) {
       fBuffer = bufferRef.Buffer();
       if( !ReadFile() ) {                   //Read object structure from file
 
@@ -816,7 +823,7 @@ TObject *TKey::ReadObj()
 
    if (fObjlen > fNbytes-fKeylen) {
       char *objbuf = bufferRef.Buffer() + fKeylen;
-      UChar_t *bufcur = (UChar_t *)&compressedBuffer[fKeylen];
+      UChar_t *bufcur = (UChar_t *)&compressed[fKeylen];
       Int_t nin, nout = 0, nbuf;
       Int_t noutot = 0;
       while (1) {
@@ -894,54 +901,73 @@ TObject *TKey::ReadObjWithBuffer(char *bufferRead)
       return (TObject*)ReadObjectAny(0);
    }
 
+   TObject *tobj = ReadObjFromRecord(bufferRead);
+   if (tobj)
+      AttachToDirectory(tobj);
+   return tobj;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// To read a TObject* from the complete record of this key (key header
+/// followed by the object data, i.e. fNbytes bytes read at fSeekKey).
+///
+/// Unlike ReadObjWithBuffer, the object is neither registered in the mother
+/// directory nor styled, and no I/O is done: the function can be called
+/// concurrently for different keys (see TDirectoryFile::GetObjectsBulk).
+/// AttachToDirectory() completes what ReadObj would do.
+/// Returns nullptr if the class is unknown or does not inherit from TObject.
+
+TObject *TKey::ReadObjFromRecord(const char *record)
+{
+   TClass *cl = TClass::GetClass(fClassName.Data());
+   if (!cl) {
+      Error("ReadObjFromRecord", "Unknown class %s", fClassName.Data());
+      return nullptr;
+   }
+   if (!cl->IsTObject())
+      return nullptr;
+   if (GetFile() == nullptr)
+      return nullptr;
+
    TBufferFile bufferRef(TBuffer::kRead, fObjlen+fKeylen);
    if (!bufferRef.Buffer()) {
-      Error("ReadObjWithBuffer", "Cannot allocate buffer: fObjlen = %d", fObjlen);
-      return 0;
+      Error("ReadObjFromRecord", "Cannot allocate buffer: fObjlen = %d", fObjlen);
+      return nullptr;
    }
-   if (GetFile()==0) return 0;
    bufferRef.SetParent(GetFile());
    bufferRef.SetPidOffset(fPidOffset);
 
-   auto storeBuffer = fBuffer;
-   if (fObjlen > fNbytes-fKeylen) {
-      fBuffer = bufferRead;
-      memcpy(bufferRef.Buffer(),fBuffer,fKeylen);
-   } else {
-      fBuffer = bufferRef.Buffer();
-      ReadFile();                    //Read object structure from file
-   }
-   fBuffer = storeBuffer;
+   const Bool_t compressed = fObjlen > fNbytes-fKeylen;
+   memcpy(bufferRef.Buffer(), record, compressed ? fKeylen : fKeylen+fObjlen);
 
    // get version of key
    bufferRef.SetBufferOffset(sizeof(fNbytes));
    Version_t kvers = bufferRef.ReadVersion();
 
    bufferRef.SetBufferOffset(fKeylen);
-   TObject *tobj = 0;
    // Create an instance of this class
 
    char *pobj = (char*)cl->New();
    if (!pobj) {
-      Error("ReadObjWithBuffer", "Cannot create new object of class %s", fClassName.Data());
-      return 0;
+      Error("ReadObjFromRecord", "Cannot create new object of class %s", fClassName.Data());
+      return nullptr;
    }
    Int_t baseOffset = cl->GetBaseClassOffset(TObject::Class());
    if (baseOffset==-1) {
       // cl does not inherit from TObject.
       // Since this is not possible yet, the only reason we could reach this code
       // is because something is screw up in the ROOT code.
-      Fatal("ReadObjWithBuffer","Incorrect detection of the inheritance from TObject for class %s.\n",
+      Fatal("ReadObjFromRecord","Incorrect detection of the inheritance from TObject for class %s.\n",
             fClassName.Data());
    }
-   tobj = (TObject*)(pobj+baseOffset);
+   TObject *tobj = (TObject*)(pobj+baseOffset);
 
    if (kvers > 1)
       bufferRef.MapObject(pobj,cl);  //register obj in map to handle self reference
 
-   if (fObjlen > fNbytes-fKeylen) {
+   if (compressed) {
       char *objbuf = bufferRef.Buffer() + fKeylen;
-      UChar_t *bufcur = (UChar_t *)&bufferRead[fKeylen];
+      UChar_t *bufcur = (UChar_t *)&record[fKeylen];
       Int_t nin, nout = 0, nbuf;
       Int_t noutot = 0;
       while (1) {
@@ -966,6 +992,21 @@ TObject *TKey::ReadObjWithBuffer(char *bufferRead)
       tobj->Streamer(bufferRef);
    }
 
+   return tobj;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Finish the reading of an object returned by ReadObjFromRecord, as done by
+/// ReadObj: apply the current style if forced and register the object in the
+/// mother directory if its class requests it.
+
+void TKey::AttachToDirectory(TObject *tobj)
+{
+   TClass *cl = TClass::GetClass(fClassName.Data());
+   if (!tobj || !cl)
+      return;
+   char *pobj = (char*)tobj - cl->GetBaseClassOffset(TObject::Class());
+
    if (gROOT->GetForceStyle()) tobj->UseCurrentStyle();
 
    if (cl->InheritsFrom(TDirectoryFile::Class())) {
@@ -983,8 +1024,6 @@ TObject *TKey::ReadObjWithBuffer(char *bufferRead)
          addfunc(pobj, fMotherDir);
       }
    }
-
-   return tobj;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1014,7 +1053,11 @@ TObject *TKey::ReadObjWithBuffer(char *bufferRead)
 
 void *TKey::ReadObjectAny(const TClass* expectedClass)
 {
-   TBufferFile bufferRef(TBuffer::kRead, fObjlen+fKeylen);
+   // For memory mapped files, uncompressed objects are streamed in place and
+   // compressed ones are decompressed straight from the mapping.
+   char *mapped = GetFile() ? GetFile()->GetMappedBuffer(fSeekKey, fNbytes) : nullptr;
+   const Bool_t inPlace = mapped && fObjlen <= fNbytes-fKeylen;
+   TBufferFile bufferRef(TBuffer::kRead, fObjlen+fKeylen, inPlace ? mapped : nullptr, kFALSE);
    if (!bufferRef.Buffer()) {
       Error("ReadObj", "Cannot allocate buffer: fObjlen = %d", fObjlen);
       return 0;
@@ -1024,13 +1067,16 @@ void *TKey::ReadObjectAny(const TClass* expectedClass)
    bufferRef.SetPidOffset(fPidOffset);
 
    std::unique_ptr<char []> compressedBuffer;
+   char *compressed = mapped;
    auto storeBuffer = fBuffer;
    if (fObjlen > fNbytes-fKeylen) {
-      compressedBuffer.reset(new char[fNbytes]);
-      fBuffer = compressedBuffer.get();
-      ReadFile();                    //Read object structure from file
-      memcpy(bufferRef.Buffer(),fBuffer,fKeylen);
-   } else {
+      if (!compressed) {
+         compressedBuffer.reset(new char[fNbytes]);
+         compressed = fBuffer = compressedBuffer.get();
+         ReadFile();                    //Read object structure from file
+      }
+      memcpy(bufferRef.Buffer(),compressed,fKeylen);
+   } else if (!inPlace) {
       fBuffer = bufferRef.Buffer();
       ReadFile();                    //Read object structure from file
    }
@@ -1085,7 +1131,7 @@ void *TKey::ReadObjectAny(const TClass* expectedClass)
 
    if (fObjlen > fNbytes-fKeylen) {
       char *objbuf = bufferRef.Buffer() + fKeylen;
-      UChar_t *bufcur = (UChar_t *)&compressedBuffer[fKeylen];
+      UChar_t *bufcur = (UChar_t *)&compressed[fKeylen];
       Int_t nin, nout = 0, nbuf;
       Int_t noutot = 0;
       while (1) {
@@ -1150,7 +1196,11 @@ Int_t TKey::Read(TObject *obj)
 {
    if (!obj || (GetFile()==0)) return 0;
 
-   TBufferFile bufferRef(TBuffer::kRead, fObjlen+fKeylen);
+   // For memory mapped files, uncompressed objects are streamed in place and
+   // compressed ones are decompressed straight from the mapping.
+   char *mapped = GetFile() ? GetFile()->GetMappedBuffer(fSeekKey, fNbytes) : nullptr;
+   const Bool_t inPlace = mapped && fObjlen <= fNbytes-fKeylen;
+   TBufferFile bufferRef(TBuffer::kRead, fObjlen+fKeylen, inPlace ? mapped : nullptr, kFALSE);
    bufferRef.SetParent(GetFile());
    bufferRef.SetPidOffset(fPidOffset);
 
@@ -1158,13 +1208,16 @@ Int_t TKey::Read(TObject *obj)
       bufferRef.MapObject(obj);  //register obj in map to handle self reference
 
    std::unique_ptr<char []> compressedBuffer;
+   char *compressed = mapped;
    auto storeBuffer = fBuffer;
    if (fObjlen > fNbytes-fKeylen) {
-      compressedBuffer.reset(new char[fNbytes]);
-      fBuffer = compressedBuffer.get();
-      ReadFile();                    //Read object structure from file
-      memcpy(bufferRef.Buffer(),fBuffer,fKeylen);
-   } else {
+      if (!compressed) {
+         compressedBuffer.reset(new char[fNbytes]);
+         compressed = fBuffer = compressedBuffer.get();
+         ReadFile();                    //Read object structure from file
+      }
+      memcpy(bufferRef.Buffer(),compressed,fKeylen);
+   } else if (!inPlace) {
       fBuffer = bufferRef.Buffer();
       ReadFile();                    //Read object structure from file
    }
@@ -1173,7 +1226,7 @@ Int_t TKey::Read(TObject *obj)
    bufferRef.SetBufferOffset(fKeylen);
    if (fObjlen > fNbytes-fKeylen) {
       char *objbuf = bufferRef.Buffer() + fKeylen;
-      UChar_t *bufcur = (UChar_t *)&compressedBuffer[fKeylen];
+      UChar_t *bufcur = (UChar_t *)&compressed[fKeylen];
       Int_t nin, nout = 0, nbuf;
       Int_t noutot = 0;
       while (1) {
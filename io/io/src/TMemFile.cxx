@@ -15,6 +15,20 @@
 
 A TMemFile is like a normal TFile except that it reads and writes
 only from memory.
+
+The memory blocks of writable TMemFiles can be taken from a pool shared by
+all TMemFiles: blocks of deleted files are kept, up to GetBlockPoolSize()
+bytes, and reused by the next files, instead of being returned to the
+system and allocated again. The pool is disabled by default; its size can
+be set with SetBlockPoolSize() or with the rootrc variable
+`TMemFile.BlockPoolSize` (in MB). The kept blocks are freed at exit. On
+Linux the blocks can be backed by transparent huge pages, see
+SetBlockPoolHugePages() and `TMemFile.HugePages`.
+
+The blocks holding the content of a TMemFile can be handed over, without
+copying, to a new read-only TMemFile (see DetachBlocks() and the
+TMemFile(const char*, BlockListPtr_t) constructor); this is how
+TBufferMergerFile passes its data to the TBufferMerger.
 */
 
 #include "TBufferFile.h"
@@ -26,10 +40,21 @@ only from memory.
 #include "TArrayC.h"
 #include "TKey.h"
 #include "TClass.h"
+#include "TEnv.h"
 #include "TVirtualMutex.h"
 #include <errno.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <sys/stat.h>
+#ifdef R__LINUX
+#include <sys/mman.h>
+#endif
+
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <vector>
 
 // The following snippet is used for developer-level debugging
 #define TMemFile_TRACE
@@ -42,6 +67,123 @@ only from memory.
 
 ClassImp(TMemFile);
 
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Thread-safe pool of memory blocks, shared by all TMemFiles.
+/// Released blocks are kept, up to fMaxCached bytes in total, and handed out
+/// again for requests of the same size.
+
+class TMemBlockPool {
+private:
+   std::mutex fMutex;                                              ///< Protects fFree and fCached
+   std::unordered_map<Long64_t, std::vector<UChar_t *>> fFree;     ///< Released blocks, by size
+   Long64_t fCached{0};                                            ///< Total size of the released blocks
+   std::atomic<Long64_t> fMaxCached{0};                            ///< Maximum total size of the released blocks
+   std::atomic<Bool_t> fHugePages{kFALSE};                         ///< Back new blocks by transparent huge pages
+   std::atomic<ULong64_t> fAllocations{0};                         ///< Number of blocks allocated from the system
+
+   static constexpr Long64_t kHugePageSize = 2 * 1024 * 1024;
+
+   UChar_t *Allocate(Long64_t size)
+   {
+      void *ptr = nullptr;
+#if defined(R__LINUX) && defined(MADV_HUGEPAGE)
+      if (fHugePages && size >= kHugePageSize) {
+         if (posix_memalign(&ptr, kHugePageSize, size) != 0)
+            ptr = nullptr;
+         else
+            madvise(ptr, size, MADV_HUGEPAGE);
+      } else
+#endif
+         ptr = malloc(size);
+      if (!ptr)
+         throw std::bad_alloc();
+      ++fAllocations;
+      return static_cast<UChar_t *>(ptr);
+   }
+
+   /// Free released blocks until their total size is below maxCached. Must be called with fMutex held.
+   void Trim(Long64_t maxCached)
+   {
+      for (auto &entry : fFree) {
+         while (fCached > maxCached && !entry.second.empty()) {
+            free(entry.second.back());
+            entry.second.pop_back();
+            fCached -= entry.first;
+         }
+      }
+   }
+
+public:
+   TMemBlockPool()
+   {
+      if (gEnv) {
+         fMaxCached = gEnv->GetValue("TMemFile.BlockPoolSize", 0) * 1024LL * 1024LL;
+         fHugePages = gEnv->GetValue("TMemFile.HugePages", 0) != 0;
+      }
+   }
+
+   UChar_t *Acquire(Long64_t size)
+   {
+      {
+         std::lock_guard<std::mutex> lock(fMutex);
+         auto iter = fFree.find(size);
+         if (iter != fFree.end() && !iter->second.empty()) {
+            UChar_t *buffer = iter->second.back();
+            iter->second.pop_back();
+            fCached -= size;
+            return buffer;
+         }
+      }
+      return Allocate(size);
+   }
+
+   void Release(UChar_t *buffer, Long64_t size)
+   {
+      if (!buffer)
+         return;
+      {
+         std::lock_guard<std::mutex> lock(fMutex);
+         if (fCached + size <= fMaxCached) {
+            fFree[size].push_back(buffer);
+            fCached += size;
+            return;
+         }
+      }
+      free(buffer);
+   }
+
+   Long64_t GetMaxCached() const { return fMaxCached; }
+
+   void SetMaxCached(Long64_t maxbytes)
+   {
+      std::lock_guard<std::mutex> lock(fMutex);
+      fMaxCached = maxbytes > 0 ? maxbytes : 0;
+      Trim(fMaxCached);
+   }
+
+   Bool_t GetHugePages() const { return fHugePages; }
+   void SetHugePages(Bool_t enable) { fHugePages = enable; }
+   ULong64_t GetAllocations() const { return fAllocations; }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the block pool. It is intentionally never deleted, since TMemFiles
+/// may still release blocks during the tear down of the static objects, but
+/// its blocks are freed at exit and the blocks released later are not kept.
+
+TMemBlockPool &GetBlockPool()
+{
+   static TMemBlockPool *pool = new TMemBlockPool;
+   static struct TBlockPoolCleanup {
+      ~TBlockPoolCleanup() { pool->SetMaxCached(0); }
+   } cleanup;
+   return *pool;
+}
+
+} // anonymous namespace
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Constructor allocating the memory buffer.
 ///
@@ -54,8 +196,9 @@ TMemFile::TMemBlock::TMemBlock(Long64_t size, TMemBlock *previous) : fPrevious(p
 {
    // size will be -1 when copying an existing buffer into fBuffer.
    if (size != -1) {
-      fBuffer = new UChar_t[size];
+      fBuffer = GetBlockPool().Acquire(size);
       fSize = size;
+      fPooled = kTRUE;
    }
 }
 
@@ -72,7 +215,10 @@ TMemFile::TMemBlock::TMemBlock(UChar_t *data, Long64_t size) : fBuffer(data), fS
 TMemFile::TMemBlock::~TMemBlock()
 {
    delete fNext;
-   delete [] fBuffer;
+   if (fPooled)
+      GetBlockPool().Release(fBuffer, fSize);
+   else
+      delete [] fBuffer;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -83,6 +229,25 @@ void TMemFile::TMemBlock::CreateNext(Long64_t size)
    fNext = new TMemBlock(size,this);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Take over the buffer and the following blocks of 'other', which is left empty.
+/// The current content of this block must have been released before.
+
+void TMemFile::TMemBlock::MoveFrom(TMemBlock &other)
+{
+   R__ASSERT(fBuffer == nullptr && fNext == nullptr);
+   fBuffer = other.fBuffer;
+   fSize = other.fSize;
+   fPooled = other.fPooled;
+   fNext = other.fNext;
+   if (fNext)
+      fNext->fPrevious = this;
+   other.fBuffer = nullptr;
+   other.fSize = 0;
+   other.fPooled = kFALSE;
+   other.fNext = nullptr;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Parse option strings and set fOption.
 TMemFile::EMode TMemFile::ParseOption(Option_t *option)
@@ -152,6 +317,35 @@ TMemFile::TMemFile(const char *name, std::unique_ptr<TBufferFile> buffer)
    buffer.release();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Constructor to create a read-only TMemFile adopting the memory blocks
+/// detached from another TMemFile with DetachBlocks(). No data is copied. The
+/// size of the file is the data written, not the capacity of the blocks.
+
+TMemFile::TMemFile(const char *path, BlockListPtr_t blocks)
+   : TFile(path, "WEB", "read-only TMemFile", 0 /*compress*/), fIsOwnedByROOT(kTRUE), fBlockSeek(&(fBlockList))
+{
+   fD = 0;
+   fOption = "READ";
+   fWritable = kFALSE;
+
+   if (!blocks || !blocks->fBuffer) {
+      MakeZombie();
+      gDirectory = gROOT;
+      return;
+   }
+
+   fBlockList.MoveFrom(*blocks);
+   for (const TMemBlock *current = &fBlockList; current; current = current->fNext)
+      fSize += current->fSize;
+
+   Init(/* create */ false);
+
+   // The file ends with the data written, not with the unused end of the last block.
+   if (!IsZombie() && GetEND() < fSize)
+      fSize = GetEND();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// \brief Usual Constructor.
 /// The defBlockSize parameter defines the size of the blocks of memory allocated
@@ -284,6 +478,80 @@ void TMemFile::CopyTo(TBuffer &tobuf) const
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Detach the memory blocks holding the content of the file, without copying
+/// them, so that they can be adopted by a read-only TMemFile. The file is left
+/// with a single empty block and must be re-initialized, as done by
+/// ResetAfterMerge().
+/// Returns nullptr if the file does not own its data.
+
+TMemFile::BlockListPtr_t TMemFile::DetachBlocks()
+{
+   if (IsExternalData() || !fBlockList.fBuffer)
+      return nullptr;
+
+   BlockListPtr_t blocks(new TMemBlock());
+   blocks->MoveFrom(fBlockList);
+
+   fBlockList.fBuffer = GetBlockPool().Acquire(fDefaultBlockSize);
+   fBlockList.fSize = fDefaultBlockSize;
+   fBlockList.fPooled = kTRUE;
+   fSize = fDefaultBlockSize;
+   fSysOffset = 0;
+   fBlockSeek = &fBlockList;
+   fBlockOffset = 0;
+
+   return blocks;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the maximum total size, in bytes, of the released memory blocks kept
+/// for reuse by the TMemFiles.
+
+Long64_t TMemFile::GetBlockPoolSize()
+{
+   return GetBlockPool().GetMaxCached();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Set the maximum total size, in bytes, of the released memory blocks kept
+/// for reuse by the TMemFiles. A value of 0, the default, disables the reuse of
+/// the blocks. The default can be changed with the rootrc variable
+/// `TMemFile.BlockPoolSize` (in MB).
+
+void TMemFile::SetBlockPoolSize(Long64_t maxbytes)
+{
+   GetBlockPool().SetMaxCached(maxbytes);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return whether newly allocated memory blocks are backed by huge pages.
+
+Bool_t TMemFile::GetBlockPoolHugePages()
+{
+   return GetBlockPool().GetHugePages();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Request transparent huge pages for the memory blocks allocated from now on.
+/// Only blocks of at least 2 MB (the default block size) are affected, and only
+/// on Linux; elsewhere this setting is ignored.
+/// The default can be changed with the rootrc variable `TMemFile.HugePages`.
+
+void TMemFile::SetBlockPoolHugePages(Bool_t enable)
+{
+   GetBlockPool().SetHugePages(enable);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the number of memory blocks allocated from the system so far, i.e.
+/// not taken from the pool of released blocks.
+
+ULong64_t TMemFile::GetBlockPoolAllocations()
+{
+   return GetBlockPool().GetAllocations();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return the current size of the memory file
 
@@ -573,8 +841,9 @@ Long64_t TMemFile::SysSeek(Int_t, Long64_t offset, Int_t whence)
 Int_t TMemFile::SysOpen(const char * /* pathname */, Int_t /* flags */, UInt_t /* mode */)
 {
    if (!fBlockList.fBuffer) {
-      fBlockList.fBuffer = new UChar_t[fDefaultBlockSize];
+      fBlockList.fBuffer = GetBlockPool().Acquire(fDefaultBlockSize);
       fBlockList.fSize = fDefaultBlockSize;
+      fBlockList.fPooled = kTRUE;
       fSize = fDefaultBlockSize;
    }
    if (fBlockList.fBuffer) {
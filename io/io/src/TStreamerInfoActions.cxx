@@ -924,6 +924,133 @@ namespace TStreamerInfoActions
       return 0;
    }
 
+   class TConfFusedBasicTypes : public TConfiguration {
+      // Configuration of a run of consecutive data members of basic types (or
+      // fixed size arrays thereof) streamed by a single action.
+   public:
+      struct TItem {
+         Int_t  fOffset; // Offset relative to the configuration's fOffset
+         Int_t  fType;   // Basic type (TStreamerInfo::kInt, etc.)
+         UInt_t fLength; // Number of values
+      };
+      std::vector<TItem>        fItems;
+      std::vector<TCompInfo_t*> fCompInfos; // The elements of the run, for printing and the generic fallback
+      Int_t                     fNbytes;    // For a run of skipped elements, their size on file
+
+      TConfFusedBasicTypes(TVirtualStreamerInfo *info, UInt_t id, TCompInfo_t *compinfo, Int_t offset) : TConfiguration(info,id,compinfo,offset),fNbytes(0) {};
+
+      void AddItem(TCompInfo_t *compinfo, Int_t type)
+      {
+         fItems.push_back({compinfo->fOffset - fOffset, type, compinfo->fLength ? (UInt_t)compinfo->fLength : 1});
+         fCompInfos.push_back(compinfo);
+      }
+
+      void Print() const
+      {
+         TStreamerInfo *info = (TStreamerInfo*)fInfo;
+         printf("StreamerInfoAction, class:%s, fused run of %d members, offset=%d\n",
+                info->GetClass()->GetName(), (Int_t)fCompInfos.size(), fOffset);
+         for (auto compinfo : fCompInfos)
+            printf("   name=%s, fType=%d, length=%d\n", compinfo->fElem->GetName(), compinfo->fType, compinfo->fLength);
+      }
+
+      void PrintDebug(TBuffer &buf, void *addr) const
+      {
+         if (gDebug > 1) {
+            TStreamerInfo *info = (TStreamerInfo*)fInfo;
+            printf("StreamerInfoAction, class:%s, fused run of %d members starting with %s, bufpos=%d, arr=%p, offset=%d\n",
+                   info->GetClass()->GetName(), (Int_t)fCompInfos.size(), fCompInfo->fElem->GetName(),
+                   buf.Length(), addr, fOffset);
+         }
+      }
+
+      virtual TConfiguration *Copy() { return new TConfFusedBasicTypes(*this); }
+   };
+
+   template <typename T>
+   inline void ReadFusedItem(TBuffer &buf, char *x, UInt_t n)
+   {
+      if (n == 1) buf >> *(T*)x;
+      else buf.ReadFastArray((T*)x, n);
+   }
+
+   template <typename T>
+   inline void WriteFusedItem(TBuffer &buf, char *x, UInt_t n)
+   {
+      if (n == 1) buf << *(T*)x;
+      else buf.WriteFastArray((T*)x, n);
+   }
+
+   INLINE_TEMPLATE_ARGS Int_t ReadFusedBasicTypes(TBuffer &buf, void *addr, const TConfiguration *config)
+   {
+      // Read a run of consecutive data members of basic types, in a single action.
+
+      const TConfFusedBasicTypes *conf = (const TConfFusedBasicTypes*)config;
+      char *obj = ((char*)addr) + config->fOffset;
+      for (const auto &item : conf->fItems) {
+         char *x = obj + item.fOffset;
+         switch (item.fType) {
+            case TStreamerInfo::kBool:    ReadFusedItem<Bool_t>(buf, x, item.fLength);    break;
+            case TStreamerInfo::kChar:    ReadFusedItem<Char_t>(buf, x, item.fLength);    break;
+            case TStreamerInfo::kShort:   ReadFusedItem<Short_t>(buf, x, item.fLength);   break;
+            case TStreamerInfo::kInt:     ReadFusedItem<Int_t>(buf, x, item.fLength);     break;
+            case TStreamerInfo::kLong:    ReadFusedItem<Long_t>(buf, x, item.fLength);    break;
+            case TStreamerInfo::kLong64:  ReadFusedItem<Long64_t>(buf, x, item.fLength);  break;
+            case TStreamerInfo::kFloat:   ReadFusedItem<Float_t>(buf, x, item.fLength);   break;
+            case TStreamerInfo::kDouble:  ReadFusedItem<Double_t>(buf, x, item.fLength);  break;
+            case TStreamerInfo::kUChar:   ReadFusedItem<UChar_t>(buf, x, item.fLength);   break;
+            case TStreamerInfo::kUShort:  ReadFusedItem<UShort_t>(buf, x, item.fLength);  break;
+            case TStreamerInfo::kUInt:    ReadFusedItem<UInt_t>(buf, x, item.fLength);    break;
+            case TStreamerInfo::kULong:   ReadFusedItem<ULong_t>(buf, x, item.fLength);   break;
+            case TStreamerInfo::kULong64: ReadFusedItem<ULong64_t>(buf, x, item.fLength); break;
+         }
+      }
+      return 0;
+   }
+
+   INLINE_TEMPLATE_ARGS Int_t WriteFusedBasicTypes(TBuffer &buf, void *addr, const TConfiguration *config)
+   {
+      // Write a run of consecutive data members of basic types, in a single action.
+
+      const TConfFusedBasicTypes *conf = (const TConfFusedBasicTypes*)config;
+      char *obj = ((char*)addr) + config->fOffset;
+      for (const auto &item : conf->fItems) {
+         char *x = obj + item.fOffset;
+         switch (item.fType) {
+            case TStreamerInfo::kBool:    WriteFusedItem<Bool_t>(buf, x, item.fLength);    break;
+            case TStreamerInfo::kChar:    WriteFusedItem<Char_t>(buf, x, item.fLength);    break;
+            case TStreamerInfo::kShort:   WriteFusedItem<Short_t>(buf, x, item.fLength);   break;
+            case TStreamerInfo::kInt:     WriteFusedItem<Int_t>(buf, x, item.fLength);     break;
+            case TStreamerInfo::kLong:    WriteFusedItem<Long_t>(buf, x, item.fLength);    break;
+            case TStreamerInfo::kLong64:  WriteFusedItem<Long64_t>(buf, x, item.fLength);  break;
+            case TStreamerInfo::kFloat:   WriteFusedItem<Float_t>(buf, x, item.fLength);   break;
+            case TStreamerInfo::kDouble:  WriteFusedItem<Double_t>(buf, x, item.fLength);  break;
+            case TStreamerInfo::kUChar:   WriteFusedItem<UChar_t>(buf, x, item.fLength);   break;
+            case TStreamerInfo::kUShort:  WriteFusedItem<UShort_t>(buf, x, item.fLength);  break;
+            case TStreamerInfo::kUInt:    WriteFusedItem<UInt_t>(buf, x, item.fLength);    break;
+            case TStreamerInfo::kULong:   WriteFusedItem<ULong_t>(buf, x, item.fLength);   break;
+            case TStreamerInfo::kULong64: WriteFusedItem<ULong64_t>(buf, x, item.fLength); break;
+         }
+      }
+      return 0;
+   }
+
+   INLINE_TEMPLATE_ARGS Int_t SkipFusedBasicTypes(TBuffer &buf, void *addr, const TConfiguration *config)
+   {
+      // Skip a run of consecutive data members of basic types that are not
+      // in memory anymore. In a binary buffer their total size is known, so
+      // the whole run is skipped at once; otherwise we let the legacy code
+      // skip them one by one.
+
+      const TConfFusedBasicTypes *conf = (const TConfFusedBasicTypes*)config;
+      if (dynamic_cast<TBufferFile*>(&buf)) {
+         buf.SetBufferOffset(buf.Length() + conf->fNbytes);
+         return 0;
+      }
+      char *obj = (char*)addr;
+      return ((TStreamerInfo*)conf->fInfo)->ReadBuffer(buf, &obj, conf->fCompInfos.data(), /*first*/ 0, /*last*/ (Int_t)conf->fCompInfos.size(), /*narr*/ 1, /*eoffset*/ 0, 2);
+   }
+
    INLINE_TEMPLATE_ARGS Int_t ReadTString(TBuffer &buf, void *addr, const TConfiguration *config)
    {
       // Read in a TString object.
@@ -3184,12 +3311,24 @@ void TStreamerInfo::Compile()
       previous = element;
    }
 
-   for (i = 0; i < fNdata; ++i) {
-      if (!fCompOpt[i]->fElem || fCompOpt[i]->fElem->GetType()< 0) {
-         continue;
+   for (i = 0; i < fNdata; ) {
+      // Runs of consecutive basic type members are streamed by a single action.
+      Int_t nfused = TestBit(kCannotOptimize) ? 0 : AddFusedReadAction(fReadObjectWise, i);
+      if (!nfused) {
+         if (fCompOpt[i]->fElem && fCompOpt[i]->fElem->GetType() >= 0)
+            AddReadAction(fReadObjectWise, i, fCompOpt[i]);
+         nfused = 1;
       }
-      AddReadAction(fReadObjectWise, i, fCompOpt[i]);
-      AddWriteAction(fWriteObjectWise, i, fCompOpt[i]);
+      i += nfused;
+   }
+   for (i = 0; i < fNdata; ) {
+      Int_t nfused = TestBit(kCannotOptimize) ? 0 : AddFusedWriteAction(fWriteObjectWise, i);
+      if (!nfused) {
+         if (fCompOpt[i]->fElem && fCompOpt[i]->fElem->GetType() >= 0)
+            AddWriteAction(fWriteObjectWise, i, fCompOpt[i]);
+         nfused = 1;
+      }
+      i += nfused;
    }
    for (i = 0; i < fNfulldata; ++i) {
       if (!fCompFull[i]->fElem || fCompFull[i]->fElem->GetType()< 0) {
@@ -3468,6 +3607,106 @@ void TStreamerInfo::AddReadAction(TStreamerInfoActions::TActionSequence *readSeq
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the basic type of the element if it can be part of a fused run of
+/// actions (a data member of basic type or a fixed size array of them, streamed
+/// as is), -1 otherwise. If 'skipped' is true, look instead for elements of
+/// basic type that are on file but not in memory anymore.
+
+static Int_t GetFusableType(const TStreamerInfo::TCompInfo_t *compinfo, Bool_t skipped)
+{
+   const TStreamerElement *element = compinfo->fElem;
+   if (!element || element->GetType() < 0 || compinfo->fMethod
+       || element->TestBit(TStreamerElement::kCache) || element->TestBit(TStreamerElement::kWrite))
+      return -1;
+
+   Int_t type = compinfo->fType;
+   if (skipped) {
+      if (type < TStreamerInfo::kSkip || type >= TStreamerInfo::kSkipP)
+         return -1;
+      type -= TStreamerInfo::kSkip;
+   }
+   if (type >= TStreamerInfo::kOffsetL && type < TStreamerInfo::kOffsetP)
+      type -= TStreamerInfo::kOffsetL;
+   // The on file size of Long_t depends on the file version; let the legacy code skip them.
+   if (skipped && (type == TStreamerInfo::kLong || type == TStreamerInfo::kULong))
+      return -1;
+
+   switch (type) {
+      case TStreamerInfo::kBool:   case TStreamerInfo::kChar:   case TStreamerInfo::kShort:
+      case TStreamerInfo::kInt:    case TStreamerInfo::kLong:   case TStreamerInfo::kLong64:
+      case TStreamerInfo::kFloat:  case TStreamerInfo::kDouble: case TStreamerInfo::kUChar:
+      case TStreamerInfo::kUShort: case TStreamerInfo::kUInt:   case TStreamerInfo::kULong:
+      case TStreamerInfo::kULong64:
+         return type;
+      default:
+         return -1;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Size on file of a value of the given basic type.
+
+static Int_t GetOnFileSize(Int_t type)
+{
+   switch (type) {
+      case TStreamerInfo::kBool: case TStreamerInfo::kChar: case TStreamerInfo::kUChar: return 1;
+      case TStreamerInfo::kShort: case TStreamerInfo::kUShort: return 2;
+      case TStreamerInfo::kInt: case TStreamerInfo::kUInt: case TStreamerInfo::kFloat: return 4;
+      default: return 8;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// If the elements starting at 'index' in the optimized list form a run of at
+/// least two data members of basic types, streamed as is, or of skipped data
+/// members of basic types, add a single action reading the whole run.
+/// Returns the number of elements handled, 0 if no action was added.
+
+Int_t TStreamerInfo::AddFusedReadAction(TStreamerInfoActions::TActionSequence *readSequence, Int_t index)
+{
+   for (Bool_t skipped : {kFALSE, kTRUE}) {
+      Int_t last = index;
+      while (last < fNdata && GetFusableType(fCompOpt[last], skipped) >= 0)
+         ++last;
+      if (last - index < 2)
+         continue;
+
+      auto conf = new TConfFusedBasicTypes(this, index, fCompOpt[index], fCompOpt[index]->fOffset);
+      for (Int_t i = index; i < last; ++i) {
+         Int_t type = GetFusableType(fCompOpt[i], skipped);
+         conf->AddItem(fCompOpt[i], type);
+         conf->fNbytes += GetOnFileSize(type) * conf->fItems.back().fLength;
+      }
+      if (skipped)
+         readSequence->AddAction(SkipFusedBasicTypes, conf);
+      else
+         readSequence->AddAction(ReadFusedBasicTypes, conf);
+      return last - index;
+   }
+   return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// If the elements starting at 'index' in the optimized list form a run of at
+/// least two data members of basic types, add a single action writing the
+/// whole run. Returns the number of elements handled, 0 if no action was added.
+
+Int_t TStreamerInfo::AddFusedWriteAction(TStreamerInfoActions::TActionSequence *writeSequence, Int_t index)
+{
+   Int_t last = index;
+   while (last < fNdata && GetFusableType(fCompOpt[last], kFALSE) >= 0)
+      ++last;
+   if (last - index < 2)
+      return 0;
+
+   auto conf = new TConfFusedBasicTypes(this, index, fCompOpt[index], fCompOpt[index]->fOffset);
+   for (Int_t i = index; i < last; ++i)
+      conf->AddItem(fCompOpt[i], GetFusableType(fCompOpt[i], kFALSE));
+   writeSequence->AddAction(WriteFusedBasicTypes, conf);
+   return last - index;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Add a read text action for the given element.
 
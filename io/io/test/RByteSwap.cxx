@@ -0,0 +1,160 @@
+#include "ROOT/RByteSwap.hxx"
+#include "TBufferFile.h"
+#include "Byteswap.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+using ROOT::Internal::ByteSwap::EKernel;
+
+namespace {
+
+/// Restores the automatically selected kernel at the end of a test.
+struct KernelGuard {
+   ~KernelGuard() { ROOT::Internal::ByteSwap::SetKernel(EKernel::kAuto); }
+};
+
+std::vector<EKernel> SupportedKernels()
+{
+   std::vector<EKernel> kernels;
+   for (auto k : {EKernel::kScalar, EKernel::kSSSE3, EKernel::kAVX2, EKernel::kAVX512}) {
+      if (ROOT::Internal::ByteSwap::SetKernel(k))
+         kernels.push_back(k);
+   }
+   ROOT::Internal::ByteSwap::SetKernel(EKernel::kAuto);
+   return kernels;
+}
+
+} // anonymous namespace
+
+TEST(RByteSwap, Kernels)
+{
+   KernelGuard guard;
+   EXPECT_TRUE(ROOT::Internal::ByteSwap::SetKernel(EKernel::kScalar));
+   EXPECT_EQ(ROOT::Internal::ByteSwap::GetKernel(), EKernel::kScalar);
+   EXPECT_TRUE(ROOT::Internal::ByteSwap::SetKernel(EKernel::kAuto));
+   EXPECT_NE(ROOT::Internal::ByteSwap::GetKernel(), EKernel::kAuto);
+}
+
+TEST(RByteSwap, Copy)
+{
+   KernelGuard guard;
+   // Odd lengths and offsets exercise the unaligned accesses and the scalar tails.
+   for (auto kernel : SupportedKernels()) {
+      ASSERT_TRUE(ROOT::Internal::ByteSwap::SetKernel(kernel));
+      for (std::size_t n : {0, 1, 3, 7, 8, 15, 16, 31, 33, 127, 1001}) {
+         std::vector<UShort_t> s(n + 1), s2(n + 1);
+         std::vector<UInt_t> i(n + 1), i2(n + 1);
+         std::vector<ULong64_t> l(n + 1), l2(n + 1);
+         for (std::size_t k = 0; k <= n; ++k) {
+            s[k] = 0x0102 + 7 * k;
+            i[k] = 0x01020304 + 13 * k;
+            l[k] = 0x0102030405060708ULL + 17 * k;
+         }
+         ROOT::Internal::ByteSwap::Copy16(s2.data() + 1, s.data() + 1, n);
+         ROOT::Internal::ByteSwap::Copy32(i2.data() + 1, i.data() + 1, n);
+         ROOT::Internal::ByteSwap::Copy64(l2.data() + 1, l.data() + 1, n);
+         EXPECT_EQ(s2[0], 0u);
+         for (std::size_t k = 1; k <= n; ++k) {
+            ASSERT_EQ(s2[k], Rbswap_16(s[k])) << ROOT::Internal::ByteSwap::GetKernelName(kernel) << " n=" << n;
+            ASSERT_EQ(i2[k], Rbswap_32(i[k])) << ROOT::Internal::ByteSwap::GetKernelName(kernel) << " n=" << n;
+            ASSERT_EQ(l2[k], Rbswap_64(l[k])) << ROOT::Internal::ByteSwap::GetKernelName(kernel) << " n=" << n;
+         }
+      }
+   }
+}
+
+TEST(RByteSwap, FastArrayRoundTrip)
+{
+   KernelGuard guard;
+   const Int_t n = 2051;
+   std::vector<Short_t> s(n);
+   std::vector<Int_t> i(n);
+   std::vector<Long64_t> l(n);
+   std::vector<Float_t> f(n);
+   std::vector<Double_t> d(n);
+   for (Int_t k = 0; k < n; ++k) {
+      s[k] = k - 1000;
+      i[k] = 1000003 * k;
+      l[k] = -1000000007LL * k;
+      f[k] = 0.25f * k;
+      d[k] = 1e-3 * k;
+   }
+
+   for (auto kernel : SupportedKernels()) {
+      ASSERT_TRUE(ROOT::Internal::ByteSwap::SetKernel(kernel));
+      TBufferFile wbuf(TBuffer::kWrite);
+      wbuf.WriteFastArray(s.data(), n);
+      wbuf.WriteFastArray(i.data(), n);
+      wbuf.WriteFastArray(l.data(), n);
+      wbuf.WriteFastArray(f.data(), n);
+      wbuf.WriteFastArray(d.data(), n);
+
+      // The on-disk representation is big-endian.
+      auto onDisk = reinterpret_cast<const unsigned char *>(wbuf.Buffer() + sizeof(Short_t) * n + sizeof(Int_t));
+      UInt_t second = (UInt_t(onDisk[0]) << 24) | (UInt_t(onDisk[1]) << 16) | (UInt_t(onDisk[2]) << 8) | onDisk[3];
+      EXPECT_EQ((Int_t)second, i[1]);
+
+      TBufferFile rbuf(TBuffer::kRead, wbuf.Length(), wbuf.Buffer(), kFALSE);
+      std::vector<Short_t> s2(n);
+      std::vector<Int_t> i2(n);
+      std::vector<Long64_t> l2(n);
+      std::vector<Float_t> f2(n);
+      std::vector<Double_t> d2(n);
+      rbuf.ReadFastArray(s2.data(), n);
+      rbuf.ReadFastArray(i2.data(), n);
+      rbuf.ReadFastArray(l2.data(), n);
+      rbuf.ReadFastArray(f2.data(), n);
+      rbuf.ReadFastArray(d2.data(), n);
+      EXPECT_EQ(rbuf.Length(), wbuf.Length());
+      EXPECT_EQ(s, s2);
+      EXPECT_EQ(i, i2);
+      EXPECT_EQ(l, l2);
+      EXPECT_EQ(f, f2);
+      EXPECT_EQ(d, d2);
+   }
+}
+
+TEST(RByteSwap, Float16Double32RoundTrip)
+{
+   KernelGuard guard;
+   const Int_t n = 1500;
+   const Double_t xmin = -10., xmax = 10.;
+   const Double_t factor = (1u << 16) / (xmax - xmin);
+   std::vector<Float_t> f(n);
+   std::vector<Double_t> d(n);
+   for (Int_t k = 0; k < n; ++k) {
+      f[k] = -12.f + 0.016f * k; // includes values outside of the range
+      d[k] = -12. + 0.016 * k;
+   }
+
+   for (auto kernel : SupportedKernels()) {
+      ASSERT_TRUE(ROOT::Internal::ByteSwap::SetKernel(kernel));
+      TBufferFile wbuf(TBuffer::kWrite);
+      wbuf.WriteFastArrayDouble32(d.data(), n);
+      std::vector<char> packedF(sizeof(UInt_t) * n), packedD(sizeof(UInt_t) * n);
+      ROOT::Internal::ByteSwap::WriteWithFactor(packedF.data(), f.data(), n, factor, xmin, xmax);
+      ROOT::Internal::ByteSwap::WriteWithFactor(packedD.data(), d.data(), n, factor, xmin, xmax);
+
+      TBufferFile rbuf(TBuffer::kRead, wbuf.Length(), wbuf.Buffer(), kFALSE);
+      std::vector<Double_t> d2(n);
+      rbuf.ReadFastArrayDouble32(d2.data(), n);
+      for (Int_t k = 0; k < n; ++k)
+         ASSERT_EQ(d2[k], (Double_t)(Float_t)d[k]);
+
+      std::vector<Float_t> f2(n);
+      std::vector<Double_t> d3(n);
+      ROOT::Internal::ByteSwap::ReadWithFactor(f2.data(), packedF.data(), n, factor, xmin);
+      ROOT::Internal::ByteSwap::ReadWithFactor(d3.data(), packedD.data(), n, factor, xmin);
+      for (Int_t k = 0; k < n; ++k) {
+         Float_t xf = std::min(std::max(f[k], (Float_t)xmin), (Float_t)xmax);
+         ASSERT_EQ(f2[k], (Float_t)(UInt_t(0.5 + factor * (xf - xmin)) / factor + xmin));
+         Double_t x = std::min(std::max(d[k], xmin), xmax);
+         ASSERT_EQ(d3[k], UInt_t(0.5 + factor * (x - xmin)) / factor + xmin);
+         ASSERT_NEAR(d3[k], x, 1. / factor);
+      }
+   }
+}
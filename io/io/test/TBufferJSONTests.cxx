@@ -0,0 +1,91 @@
+#include "TBits.h"
+#include "TBufferJSON.h"
+#include "TClass.h"
+#include "TNamed.h"
+
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Object streamed into std::ostream produces the same JSON as the in-memory conversion.
+TEST(TBufferJSON, StreamOutput)
+{
+   std::vector<double> vect(100000);
+   for (std::size_t i = 0; i < vect.size(); ++i)
+      vect[i] = (i % 7 == 0) ? 0. : 0.5 * i;
+
+   auto cl = TClass::GetClass<std::vector<double>>();
+   ASSERT_NE(cl, nullptr);
+
+   for (Int_t compact : {0, TBufferJSON::kNoSpaces + TBufferJSON::kSameSuppression,
+                         TBufferJSON::kNoSpaces + TBufferJSON::kBase64}) {
+      TString json = TBufferJSON::ConvertToJSON(&vect, cl, compact);
+
+      std::ostringstream out;
+      TBufferJSON buf;
+      buf.SetCompact(compact);
+      Long64_t len = buf.StoreObject(&vect, cl, out);
+      EXPECT_EQ(len, json.Length());
+      EXPECT_EQ(out.str(), json.Data()) << "compact " << compact;
+
+      std::istringstream in(out.str());
+      TClass *readcl = cl;
+      auto res = static_cast<std::vector<double> *>(TBufferJSON::ConvertFromJSONAny(in, &readcl));
+      ASSERT_NE(res, nullptr);
+      EXPECT_EQ(*res, vect) << "compact " << compact;
+      delete res;
+   }
+}
+
+// Large TObject-based object is flushed in several portions and read back from the stream.
+TEST(TBufferJSON, StreamObject)
+{
+   std::string title(200000, 'x');
+   TNamed named("name", title.c_str());
+
+   TString json = TBufferJSON::ConvertToJSON(&named);
+
+   std::ostringstream out;
+   TBufferJSON buf;
+   EXPECT_EQ(buf.StoreObject(&named, TNamed::Class(), out), json.Length());
+   EXPECT_EQ(out.str(), json.Data());
+
+   std::istringstream in(out.str());
+   TClass *cl = nullptr;
+   void *obj = TBufferJSON::ConvertFromJSONAny(in, &cl);
+   ASSERT_NE(obj, nullptr);
+   ASSERT_EQ(cl, TNamed::Class());
+   auto res = static_cast<TNamed *>(obj);
+   EXPECT_STREQ(res->GetName(), "name");
+   EXPECT_EQ(title, res->GetTitle());
+   delete res;
+}
+
+// Long array member with many zeros is stored compressed when parsing and read back completely.
+TEST(TBufferJSON, ReadSparseArray)
+{
+   TBits bits(80000);
+   for (UInt_t n : {3u, 4u, 5u, 1000u, 1001u, 40000u, 79999u})
+      bits.SetBitNumber(n);
+
+   // plain JSON array with the 10000 bytes of the bits
+   TString json = TBufferJSON::ToJSON(&bits);
+   EXPECT_NE(json.Index("\"fAllBits\" : ["), kNPOS);
+
+   TBits *res = nullptr;
+   ASSERT_TRUE(TBufferJSON::FromJSON(res, json.Data()));
+   ASSERT_NE(res, nullptr);
+   EXPECT_EQ(res->GetNbits(), bits.GetNbits());
+   EXPECT_EQ(res->CountBits(), bits.CountBits());
+   EXPECT_TRUE(*res == bits);
+   delete res;
+
+   std::istringstream in(json.Data());
+   TClass *cl = TBits::Class();
+   std::unique_ptr<TBits> res2(static_cast<TBits *>(TBufferJSON::ConvertFromJSONAny(in, &cl)));
+   ASSERT_NE(res2, nullptr);
+   EXPECT_TRUE(*res2 == bits);
+}
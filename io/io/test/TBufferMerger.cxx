@@ -160,6 +160,65 @@ TEST(TBufferMerger, AutoSave)
    RemoveFile("tbuffermerger_autosave.root");
 }
 
+TEST(TBufferMerger, BackgroundMerge)
+{
+   int nevents = 16384;
+   int nthreads = 8;
+   int events_per_thread = nevents / nthreads;
+
+   ROOT::EnableThreadSafety();
+
+   {
+      TBufferMerger merger("tbuffermerger_background.root");
+      merger.SetMergeOptions("fast");
+      merger.EnableBackgroundMerge(1024 * 1024);
+      EXPECT_TRUE(merger.IsBackgroundMerge());
+
+      std::vector<std::thread> threads;
+      for (int i = 0; i < nthreads; ++i) {
+         threads.emplace_back([=, &merger]() {
+            auto myfile = merger.GetFile();
+            auto mytree = new TTree("mytree", "mytree");
+            mytree->SetAutoFlush(256);
+
+            int n = 0;
+            mytree->Branch("n", &n, "n/I");
+            for (int j = 0; j < events_per_thread; ++j) {
+               n = i * events_per_thread + j;
+               mytree->Fill();
+               // Write regularly, as a Snapshot does, while the output thread merges.
+               if (j % 512 == 511)
+                  myfile->Write();
+            }
+            mytree->ResetBranchAddresses();
+            myfile->Write();
+         });
+      }
+
+      for (auto &&t : threads)
+         t.join();
+   }
+
+   {
+      TFile f("tbuffermerger_background.root");
+      auto t = (TTree *)f.Get("mytree");
+      ASSERT_TRUE(t != nullptr);
+      EXPECT_EQ(nevents, t->GetEntries());
+
+      int n;
+      long long sum = 0;
+      t->SetBranchAddress("n", &n);
+      for (Long64_t i = 0; i < t->GetEntries(); ++i) {
+         t->GetEntry(i);
+         sum += n;
+      }
+      t->ResetBranchAddresses();
+      EXPECT_EQ((long long)nevents * (nevents - 1) / 2, sum);
+   }
+
+   RemoveFile("tbuffermerger_background.root");
+}
+
 TEST(TBufferMerger, CheckTreeFillResults)
 {
    int sum_s, sum_p;
@@ -266,3 +325,57 @@ TEST(TBufferMerger, SetMaxTreeSize)
 
    RemoveFile("tbuffermerger_setmaxtreesize.root");
 }
+
+// Blocks handed over to the merger are returned to the TMemFile block pool and reused.
+TEST(TBufferMerger, BlockPoolReuse)
+{
+   const int nwrites = 20;
+   const int nevents = 1000;
+
+   ROOT::EnableThreadSafety();
+
+   // The pool is disabled by default.
+   const Long64_t poolSize = TMemFile::GetBlockPoolSize();
+   TMemFile::SetBlockPoolSize(64 * 1024 * 1024);
+
+   ULong64_t allocations = 0;
+   {
+      TBufferMerger merger("tbuffermerger_blockpool.root");
+      auto myfile = merger.GetFile();
+      TTree *mytree = new TTree("mytree", "mytree");
+      int n = 0;
+      mytree->Branch("n", &n, "n/I");
+
+      for (int w = 0; w < nwrites; ++w) {
+         if (w == 2)
+            allocations = TMemFile::GetBlockPoolAllocations();
+         for (int i = 0; i < nevents; ++i) {
+            n = w * nevents + i;
+            mytree->Fill();
+         }
+         myfile->Write();
+      }
+      // Only a few blocks are in flight at any time, the others are taken from the pool.
+      EXPECT_LT(TMemFile::GetBlockPoolAllocations() - allocations, (ULong64_t)nwrites / 2);
+      mytree->ResetBranchAddresses();
+   }
+
+   {
+      TFile f{"tbuffermerger_blockpool.root"};
+      std::unique_ptr<TTree> t{f.Get<TTree>("mytree")};
+      ASSERT_NE(t, nullptr);
+      EXPECT_EQ(t->GetEntries(), nwrites * nevents);
+
+      long long sum = 0;
+      int n = 0;
+      t->SetBranchAddress("n", &n);
+      for (auto i = 0; i < t->GetEntries(); i++) {
+         t->GetEntry(i);
+         sum += n;
+      }
+      EXPECT_EQ(sum, (long long)nwrites * nevents * (nwrites * nevents - 1) / 2);
+   }
+
+   TMemFile::SetBlockPoolSize(poolSize);
+   RemoveFile("tbuffermerger_blockpool.root");
+}
@@ -2,9 +2,16 @@
 
 #include "TFileMerger.h"
 
+#include "TH1F.h"
 #include "TMemFile.h"
+#include "TROOT.h"
+#include "TSystem.h"
 #include "TTree.h"
 
+#include <memory>
+#include <string>
+#include <vector>
+
 static void CreateATuple(TMemFile &file, const char *name, double value)
 {
    auto mytree = new TTree(name, "A tree");
@@ -68,3 +75,147 @@ TEST(TFileMerger, CreateWithUnwritableTFilePointer)
    ROOT_EXPECT_ERROR(merger.OutputFile(std::move(output)), "TFileMerger::OutputFile",
                      "output file output.root is not writable");
 }
+
+TEST(TFileMerger, MultiThreaded)
+{
+   std::vector<std::unique_ptr<TMemFile>> inputs;
+   for (int i = 0; i < 7; ++i) {
+      auto file = std::make_unique<TMemFile>(TString::Format("mt_input_%d.root", i), "RECREATE");
+      CreateATuple(*file, "mt_tree", i);
+
+      TH1F h("h", "h", 10, 0, 10);
+      h.Fill(i);
+      file->WriteTObject(&h);
+      TH1F h2("h2", "h2", 10, 0, 10);
+      h2.Fill(1, i + 1.);
+      file->mkdir("dir")->WriteTObject(&h2);
+      if (i % 2) {
+         TH1F odd("odd", "odd", 10, 0, 10);
+         odd.Fill(0);
+         file->WriteTObject(&odd);
+      }
+      inputs.push_back(std::move(file));
+   }
+
+   TFileMerger merger;
+   merger.SetNThreads(3);
+   ASSERT_TRUE(merger.OutputFile(std::unique_ptr<TMemFile>(new TMemFile("mt_output.root", "CREATE"))));
+   for (auto &file : inputs)
+      merger.AddFile(file.get(), false);
+   ASSERT_TRUE(merger.PartialMerge());
+
+   auto &result = *static_cast<TMemFile *>(merger.GetOutputFile());
+   auto h = result.Get<TH1F>("h");
+   ASSERT_NE(h, nullptr);
+   EXPECT_EQ(h->GetEntries(), 7);
+   for (int i = 0; i < 7; ++i)
+      EXPECT_EQ(h->GetBinContent(i + 1), 1);
+   auto h2 = result.Get<TH1F>("dir/h2");
+   ASSERT_NE(h2, nullptr);
+   EXPECT_EQ(h2->GetBinContent(2), 28);
+   auto odd = result.Get<TH1F>("odd");
+   ASSERT_NE(odd, nullptr);
+   EXPECT_EQ(odd->GetEntries(), 3);
+   auto tree = result.Get<TTree>("mt_tree");
+   ASSERT_NE(tree, nullptr);
+   EXPECT_EQ(tree->GetEntries(), 7);
+}
+
+// With several threads, the files added by name are opened concurrently when merging.
+TEST(TFileMerger, MultiThreadedByName)
+{
+   std::vector<std::string> names;
+   for (int i = 0; i < 7; ++i) {
+      names.push_back(TString::Format("mt_byname_input_%d.root", i).Data());
+      TFile file(names.back().c_str(), "RECREATE");
+      TTree tree("mt_tree", "A tree");
+      double value = i;
+      tree.Branch("x", &value);
+      tree.Fill();
+      tree.Write();
+      TH1F h("h", "h", 10, 0, 10);
+      h.Fill(i);
+      file.WriteTObject(&h);
+   }
+
+   TFileMerger merger;
+   merger.SetNThreads(3);
+   // Open the inputs in several batches.
+   merger.SetMaxOpenedFiles(4);
+   ASSERT_TRUE(merger.OutputFile(std::unique_ptr<TMemFile>(new TMemFile("mt_byname_output.root", "CREATE"))));
+   for (auto &name : names)
+      ASSERT_TRUE(merger.AddFile(name.c_str(), false));
+   ASSERT_TRUE(merger.PartialMerge());
+
+   auto &result = *static_cast<TMemFile *>(merger.GetOutputFile());
+   auto h = result.Get<TH1F>("h");
+   ASSERT_NE(h, nullptr);
+   EXPECT_EQ(h->GetEntries(), 7);
+   for (int i = 0; i < 7; ++i)
+      EXPECT_EQ(h->GetBinContent(i + 1), 1);
+   auto tree = result.Get<TTree>("mt_tree");
+   ASSERT_NE(tree, nullptr);
+   EXPECT_EQ(tree->GetEntries(), 7);
+   double sum = 0.;
+   double x;
+   tree->SetBranchAddress("x", &x);
+   for (Long64_t i = 0; i < tree->GetEntries(); ++i) {
+      tree->GetEntry(i);
+      sum += x;
+   }
+   EXPECT_EQ(sum, 21.);
+   tree->ResetBranchAddresses();
+
+   for (auto &name : names)
+      gSystem->Unlink(name.c_str());
+}
+
+#ifdef R__USE_IMT
+// Merge trees into a file with other compression settings: the baskets are recompressed on many threads.
+TEST(TFileMerger, FastMergeRecompressMT)
+{
+   const Int_t nentries = 20000;
+   std::vector<std::unique_ptr<TMemFile>> inputs;
+   Int_t nbaskets = 0;
+   for (int i = 0; i < 3; ++i) {
+      auto file = std::make_unique<TMemFile>(TString::Format("recompress_input_%d.root", i), "RECREATE", "", 101);
+      auto tree = new TTree("t", "A tree");
+      tree->SetImplicitMT(false);
+      tree->SetDirectory(file.get());
+      Int_t idx;
+      tree->Branch("idx", &idx, "idx/I", 4000);
+      for (idx = i * nentries; idx < (i + 1) * nentries; ++idx)
+         tree->Fill();
+      file->Write();
+      tree->ResetBranchAddresses();
+      nbaskets += tree->GetBranch("idx")->GetWriteBasket();
+      inputs.push_back(std::move(file));
+   }
+
+   ROOT::EnableImplicitMT(4);
+   TFileMerger merger;
+   merger.SetNThreads(3);
+   ASSERT_TRUE(merger.OutputFile(std::unique_ptr<TMemFile>(new TMemFile("recompress_output.root", "CREATE", "", 209))));
+   for (auto &file : inputs)
+      merger.AddFile(file.get(), false);
+   ASSERT_TRUE(merger.PartialMerge());
+   ROOT::DisableImplicitMT();
+
+   auto &result = *static_cast<TMemFile *>(merger.GetOutputFile());
+   auto tree = result.Get<TTree>("t");
+   ASSERT_NE(tree, nullptr);
+   ASSERT_EQ(tree->GetEntries(), 3 * nentries);
+   TBranch *branch = tree->GetBranch("idx");
+   EXPECT_EQ(branch->GetCompressionSettings(), 209);
+   // The baskets were copied, not refilled.
+   EXPECT_EQ(branch->GetWriteBasket(), nbaskets);
+   EXPECT_LT(branch->GetZipBytes(), branch->GetTotBytes());
+   Int_t idx;
+   tree->SetBranchAddress("idx", &idx);
+   for (Long64_t i = 0; i < tree->GetEntries(); ++i) {
+      tree->GetEntry(i);
+      ASSERT_EQ(idx, i);
+   }
+   tree->ResetBranchAddresses();
+}
+#endif
@@ -1,7 +1,17 @@
 #include "TFile.h"
+#include "TKey.h"
+#include "TNamed.h"
+#include "TObjString.h"
+#include "TROOT.h"
+#include "TSystem.h"
+#include "TTree.h"
 
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <string>
+#include <vector>
+
 // Tests ROOT-9857
 TEST(TFile, ReadFromSameFile)
 {
@@ -21,4 +31,339 @@ TEST(TFile, ReadFromSameFile)
    auto o2 = f2.Get(objpath);
 
    EXPECT_TRUE(o1 != o2) << "Same objects read from two different files have the same pointer!";
-}
\ No newline at end of file
+}
+
+// Keys of files written with a keys index are created when looked up.
+TEST(TFile, KeysIndex)
+{
+   const auto filename = "KeysIndex.root";
+   const Int_t nkeys = 1000;
+   std::vector<std::string> expected;
+   {
+      TFile f((std::string(filename) + "?keysindex").c_str(), "RECREATE");
+      ASSERT_TRUE(f.TestBit(TFile::kKeysIndex));
+      // Write in an order different from the name order.
+      for (Int_t i = nkeys - 1; i >= 0; --i) {
+         TNamed obj(("obj" + std::to_string(i)).c_str(), "first");
+         f.WriteTObject(&obj);
+      }
+      TNamed obj("obj7", "second");
+      f.WriteTObject(&obj);
+      auto dir = f.mkdir("sub");
+      TNamed inner("inner", "in subdirectory");
+      dir->WriteTObject(&inner);
+      for (auto key : TRangeDynCast<TKey>(f.GetListOfKeys()))
+         expected.push_back(std::string(key->GetName()) + ";" + std::to_string(key->GetCycle()));
+   }
+   ASSERT_EQ(expected.size(), nkeys + 2u);
+
+   TFile f(filename);
+   ASSERT_FALSE(f.IsZombie());
+   EXPECT_EQ(f.GetNkeys(), nkeys + 2);
+
+   auto obj = f.Get<TNamed>("obj42");
+   ASSERT_NE(obj, nullptr);
+   EXPECT_STREQ(obj->GetTitle(), "first");
+   EXPECT_STREQ(f.Get<TNamed>("obj7")->GetTitle(), "second");
+   EXPECT_STREQ(f.Get<TNamed>("obj7;1")->GetTitle(), "first");
+   EXPECT_EQ(f.GetKey("obj7")->GetCycle(), 2);
+   EXPECT_EQ(f.Get("obj1000"), nullptr);
+   EXPECT_EQ(f.GetKey("obj"), nullptr);
+   auto inner = f.Get<TNamed>("sub/inner");
+   ASSERT_NE(inner, nullptr);
+   EXPECT_STREQ(inner->GetTitle(), "in subdirectory");
+
+   // The full list has the order of the keys record.
+   std::vector<std::string> names;
+   for (auto key : TRangeDynCast<TKey>(f.GetListOfKeys()))
+      names.push_back(std::string(key->GetName()) + ";" + std::to_string(key->GetCycle()));
+   EXPECT_EQ(names, expected);
+   EXPECT_EQ(f.GetNkeys(), nkeys + 2);
+
+   f.Close();
+   gSystem->Unlink(filename);
+}
+
+// Blocks requested through ReadBuffers end up in request order, whatever the coalescing.
+TEST(TFile, ReadBuffersCoalesced)
+{
+   const auto filename = "ReadBuffersCoalesced.root";
+   {
+      TFile f(filename, "RECREATE");
+      for (int i = 0; i < 50; ++i) {
+         TNamed obj(("obj" + std::to_string(i)).c_str(), std::string(100 * i, 'a' + i % 26).c_str());
+         obj.Write();
+      }
+   }
+
+   TFile f(filename);
+   ASSERT_FALSE(f.IsZombie());
+   std::vector<Long64_t> pos;
+   std::vector<Int_t> len;
+   for (auto key : TRangeDynCast<TKey>(f.GetListOfKeys())) {
+      pos.push_back(key->GetSeekKey());
+      len.push_back(key->GetNbytes());
+   }
+   // Unordered, with an overlapping and a repeated block.
+   std::reverse(pos.begin() + 10, pos.begin() + 30);
+   std::reverse(len.begin() + 10, len.begin() + 30);
+   pos.push_back(pos[3] + 10);
+   len.push_back(len[3] - 10);
+   pos.push_back(pos[7]);
+   len.push_back(len[7]);
+
+   std::vector<char> expected;
+   for (std::size_t i = 0; i < pos.size(); ++i) {
+      std::vector<char> block(len[i]);
+      ASSERT_FALSE(f.ReadBuffer(block.data(), pos[i], len[i]));
+      expected.insert(expected.end(), block.begin(), block.end());
+   }
+
+   const Int_t gap = TFile::GetReadCoalesceGap();
+   for (Int_t g : {-1, 0, 64, 1 << 20}) {
+      TFile::SetReadCoalesceGap(g);
+      std::vector<char> buf(expected.size());
+      ASSERT_FALSE(f.ReadBuffers(buf.data(), pos.data(), len.data(), (Int_t)pos.size())) << "gap " << g;
+      EXPECT_EQ(buf, expected) << "gap " << g;
+   }
+   TFile::SetReadCoalesceGap(gap);
+
+   gSystem->Unlink(filename);
+}
+
+TEST(TFile, MMap)
+{
+   const auto filename = "MMap.root";
+   for (Int_t compress : {0, 101}) {
+      {
+         TFile f(filename, "RECREATE", "", compress);
+         for (int i = 0; i < 20; ++i) {
+            TNamed obj(("obj" + std::to_string(i)).c_str(), std::string(1000 * i, 'a' + i % 26).c_str());
+            obj.Write();
+         }
+         TDirectory *dir = f.mkdir("dir");
+         dir->WriteObject(new TNamed("inner", "title"), "inner");
+      }
+
+      TFile f((std::string(filename) + "?mmap").c_str());
+      ASSERT_FALSE(f.IsZombie());
+      EXPECT_TRUE(f.IsMapped());
+      for (int i = 0; i < 20; ++i) {
+         auto obj = f.Get<TNamed>(("obj" + std::to_string(i)).c_str());
+         ASSERT_NE(obj, nullptr) << "compress " << compress;
+         EXPECT_EQ(std::string(obj->GetTitle()), std::string(1000 * i, 'a' + i % 26));
+         delete obj;
+      }
+      auto inner = f.Get<TNamed>("dir/inner");
+      ASSERT_NE(inner, nullptr);
+      EXPECT_STREQ(inner->GetTitle(), "title");
+      EXPECT_GT(f.GetBytesRead(), 0);
+
+      f.Close();
+      EXPECT_FALSE(f.IsMapped());
+   }
+
+   TFile plain(filename);
+   EXPECT_FALSE(plain.IsMapped());
+
+   gSystem->Unlink(filename);
+}
+
+// The records written after a file was mapped are read with system calls.
+TEST(TFile, MMapGrowingFile)
+{
+   const auto filename = "MMapGrowingFile.root";
+   {
+      TFile f(filename, "RECREATE");
+      TNamed obj("first", std::string(10000, 'a').c_str());
+      obj.Write();
+   }
+
+   TFile mapped((std::string(filename) + "?mmap").c_str());
+   ASSERT_FALSE(mapped.IsZombie());
+   EXPECT_TRUE(mapped.IsMapped());
+   {
+      TFile f(filename, "UPDATE");
+      TNamed obj("second", std::string(20000, 'b').c_str());
+      obj.Write();
+   }
+
+   mapped.ReadKeys();
+   auto second = mapped.Get<TNamed>("second");
+   ASSERT_NE(second, nullptr);
+   EXPECT_EQ(std::string(second->GetTitle()), std::string(20000, 'b'));
+   delete second;
+   auto first = mapped.Get<TNamed>("first");
+   ASSERT_NE(first, nullptr);
+   EXPECT_EQ(std::string(first->GetTitle()), std::string(10000, 'a'));
+   delete first;
+   mapped.Close();
+
+   gSystem->Unlink(filename);
+}
+
+// The compressed baskets of a memory mapped file are decompressed straight from the mapping.
+TEST(TFile, MMapTree)
+{
+   const auto filename = "MMapTree.root";
+   const Int_t nentries = 10000;
+   for (Int_t compress : {0, 101}) {
+      {
+         TFile f(filename, "RECREATE", "", compress);
+         TTree t("t", "t");
+         Int_t i;
+         Double_t x;
+         t.Branch("i", &i, "i/I", 4000);
+         t.Branch("x", &x, "x/D", 8000);
+         for (i = 0; i < nentries; ++i) {
+            x = 0.25 * (i % 1000);
+            t.Fill();
+         }
+         t.Write();
+      }
+
+      TFile f((std::string(filename) + "?mmap").c_str());
+      ASSERT_FALSE(f.IsZombie());
+      EXPECT_TRUE(f.IsMapped());
+      auto t = f.Get<TTree>("t");
+      ASSERT_NE(t, nullptr);
+      ASSERT_EQ(t->GetEntries(), nentries);
+      // Several baskets per branch
+      EXPECT_GT(t->GetBranch("i")->GetWriteBasket(), 1);
+      Int_t i = -1;
+      Double_t x = -1.;
+      t->SetBranchAddress("i", &i);
+      t->SetBranchAddress("x", &x);
+      for (Long64_t e = 0; e < nentries; ++e) {
+         ASSERT_GT(t->GetEntry(e), 0) << "compress " << compress;
+         ASSERT_EQ(i, e) << "compress " << compress;
+         ASSERT_EQ(x, 0.25 * (e % 1000)) << "compress " << compress;
+      }
+      t->ResetBranchAddresses();
+   }
+
+   gSystem->Unlink(filename);
+}
+
+TEST(TFile, AsyncWrite)
+{
+   const auto filename = "AsyncWrite.root";
+   {
+      TFile f((std::string(filename) + "?asyncwrite").c_str(), "RECREATE");
+      ASSERT_FALSE(f.IsZombie());
+      EXPECT_TRUE(f.IsAsyncWrite());
+      for (int i = 0; i < 50; ++i) {
+         TNamed obj(("obj" + std::to_string(i)).c_str(), std::string(10000 * i, 'a' + i % 26).c_str());
+         obj.Write();
+         if (i == 25) {
+            f.Flush();
+            // Reading back forces the pending writes to complete.
+            auto back = f.Get<TNamed>("obj10");
+            ASSERT_NE(back, nullptr);
+            EXPECT_EQ(std::string(back->GetTitle()), std::string(100000, 'a' + 10));
+            delete back;
+            EXPECT_EQ(f.GetAsyncWriteQueueDepth(), 0);
+            EXPECT_GE(f.GetSize(), f.GetEND());
+         }
+      }
+      EXPECT_GT(f.GetBytesWritten(), 0);
+      f.Close();
+      EXPECT_FALSE(f.IsAsyncWrite());
+   }
+
+   {
+      TFile f(filename, "UPDATE");
+      EXPECT_FALSE(f.IsAsyncWrite());
+      EXPECT_TRUE(f.EnableAsyncWrite(1024)); // smaller than most buffers, every write waits for the previous one
+      TNamed obj("updated", std::string(5000, 'u').c_str());
+      obj.Write();
+   }
+
+   TFile f(filename);
+   EXPECT_FALSE(f.EnableAsyncWrite());
+   for (int i = 0; i < 50; ++i) {
+      auto obj = f.Get<TNamed>(("obj" + std::to_string(i)).c_str());
+      ASSERT_NE(obj, nullptr);
+      EXPECT_EQ(std::string(obj->GetTitle()), std::string(10000 * i, 'a' + i % 26));
+      delete obj;
+   }
+   auto updated = f.Get<TNamed>("updated");
+   ASSERT_NE(updated, nullptr);
+   EXPECT_EQ(std::string(updated->GetTitle()), std::string(5000, 'u'));
+   delete updated;
+
+   gSystem->Unlink(filename);
+}
+
+TEST(TFile, GetObjectsBulk)
+{
+   // Without it, the objects are streamed serially.
+   ROOT::EnableThreadSafety();
+   const auto filename = "GetObjectsBulk.root";
+   auto title = [](int i) { return std::string(i % 2 ? 20 : 20000, 'a' + i % 26); };
+   for (int compress : {0, 101}) {
+      {
+         TFile f(filename, "RECREATE", "", compress);
+         for (int i = 0; i < 100; ++i) {
+            TNamed obj(("obj" + std::to_string(i)).c_str(), title(i).c_str());
+            obj.Write();
+            // TObjString is streamed in parallel, TNamed is not.
+            TObjString str(title(i).c_str());
+            str.Write(("str" + std::to_string(i)).c_str());
+         }
+         TNamed other("other", "cycle 1");
+         other.Write();
+         other.SetTitle("cycle 2");
+         other.Write();
+      }
+
+      TFile f(filename);
+      for (UInt_t nthreads : {1u, 4u}) {
+         std::vector<std::string> names;
+         for (int i = 99; i >= 0; i -= 3)
+            names.push_back("obj" + std::to_string(i));
+         const auto nobj = names.size();
+         for (int i = 0; i < 100; i += 7)
+            names.push_back("str" + std::to_string(i));
+         const auto nstr = names.size() - nobj;
+         names.push_back("missing");
+         names.push_back("other;1");
+         names.push_back("other");
+         // Requested twice, read once.
+         names.push_back("other;2");
+         auto objects = f.GetObjectsBulk(names, nthreads);
+         ASSERT_EQ(objects.size(), names.size());
+         for (std::size_t k = 0; k < nobj; ++k) {
+            ASSERT_NE(objects[k], nullptr);
+            EXPECT_EQ(names[k], objects[k]->GetName());
+            EXPECT_EQ(title(99 - 3 * k), objects[k]->GetTitle());
+         }
+         for (std::size_t k = 0; k < nstr; ++k) {
+            ASSERT_NE(objects[nobj + k], nullptr);
+            EXPECT_EQ(title(7 * k), objects[nobj + k]->GetName());
+         }
+         EXPECT_EQ(objects[names.size() - 4], nullptr);
+         ASSERT_NE(objects[names.size() - 3], nullptr);
+         EXPECT_STREQ(objects[names.size() - 3]->GetTitle(), "cycle 1");
+         ASSERT_NE(objects[names.size() - 2], nullptr);
+         EXPECT_STREQ(objects[names.size() - 2]->GetTitle(), "cycle 2");
+         EXPECT_EQ(objects[names.size() - 1], objects[names.size() - 2]);
+         objects.pop_back();
+         for (auto obj : objects)
+            delete obj;
+
+         objects = f.GetObjectsBulk("obj1*", nthreads);
+         ASSERT_EQ(objects.size(), 11u); // obj1, obj10 ... obj19
+         for (auto obj : objects) {
+            ASSERT_NE(obj, nullptr);
+            auto obj2 = f.Get<TNamed>(obj->GetName());
+            ASSERT_NE(obj2, nullptr);
+            EXPECT_STREQ(obj->GetTitle(), obj2->GetTitle());
+            delete obj2;
+            delete obj;
+         }
+      }
+   }
+
+   gSystem->Unlink(filename);
+}
@@ -0,0 +1,143 @@
+#include "TBufferFile.h"
+#include "TClass.h"
+#include "TInterpreter.h"
+#include "TStreamerInfo.h"
+#include "TStreamerInfoActions.h"
+#include "TString.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+template <typename T>
+T &Member(TClass *cl, void *obj, const char *name)
+{
+   return *reinterpret_cast<T *>(static_cast<char *>(obj) + cl->GetDataMemberOffset(name));
+}
+
+} // anonymous namespace
+
+// Consecutive members of basic types are streamed by a single action.
+TEST(TStreamerInfoActions, FusedBasicTypes)
+{
+   gInterpreter->Declare(R"CODE(
+      struct FusedActionsTest {
+         int a = 0;
+         float b = 0;
+         double c[3] = {0, 0, 0};
+         short d = 0;
+         TString s;
+         long long e = 0;
+         char f = 0;
+         bool g = false;
+      };
+   )CODE");
+   TClass *cl = TClass::GetClass("FusedActionsTest");
+   ASSERT_NE(cl, nullptr);
+
+   auto info = static_cast<TStreamerInfo *>(cl->GetStreamerInfo());
+   ASSERT_NE(info, nullptr);
+   if (TVirtualStreamerInfo::CanOptimize()) {
+      // {a, b, c, d}, s, {e, f, g}
+      EXPECT_EQ(info->GetReadObjectWiseActions()->fActions.size(), 3u);
+      EXPECT_EQ(info->GetWriteObjectWiseActions()->fActions.size(), 3u);
+   }
+
+   void *obj = cl->New();
+   Member<int>(cl, obj, "a") = 42;
+   Member<float>(cl, obj, "b") = 1.5f;
+   for (int i = 0; i < 3; ++i)
+      (&Member<double>(cl, obj, "c"))[i] = 0.25 * i - 7;
+   Member<short>(cl, obj, "d") = -3;
+   Member<TString>(cl, obj, "s") = "between the runs";
+   Member<long long>(cl, obj, "e") = -1234567890123LL;
+   Member<char>(cl, obj, "f") = 'x';
+   Member<bool>(cl, obj, "g") = true;
+
+   TBufferFile wbuf(TBuffer::kWrite);
+   wbuf.WriteClassBuffer(cl, obj);
+
+   void *copy = cl->New();
+   TBufferFile rbuf(TBuffer::kRead, wbuf.Length(), wbuf.Buffer(), kFALSE);
+   rbuf.ReadClassBuffer(cl, copy, nullptr);
+   EXPECT_EQ(rbuf.Length(), wbuf.Length());
+
+   EXPECT_EQ(Member<int>(cl, copy, "a"), 42);
+   EXPECT_EQ(Member<float>(cl, copy, "b"), 1.5f);
+   for (int i = 0; i < 3; ++i)
+      EXPECT_EQ((&Member<double>(cl, copy, "c"))[i], 0.25 * i - 7);
+   EXPECT_EQ(Member<short>(cl, copy, "d"), -3);
+   EXPECT_EQ(Member<TString>(cl, copy, "s"), "between the runs");
+   EXPECT_EQ(Member<long long>(cl, copy, "e"), -1234567890123LL);
+   EXPECT_EQ(Member<char>(cl, copy, "f"), 'x');
+   EXPECT_EQ(Member<bool>(cl, copy, "g"), true);
+
+   cl->Destructor(obj);
+   cl->Destructor(copy);
+}
+
+// Members of an older class layout which are not in memory anymore are skipped at once,
+// the members following them are read into their new places.
+TEST(TStreamerInfoActions, SkipFusedBasicTypes)
+{
+   gInterpreter->Declare(R"CODE(
+      struct SkipFusedOld {
+         int a = 0;
+         double x = 0;
+         float y = 0;
+         short z[2] = {0, 0};
+         TString s;
+         long long e = 0;
+         char f = 0;
+         int b = 0;
+      };
+      struct SkipFusedNew {
+         int b = 0;
+         char f = 0;
+         int a = 0;
+         TString s;
+         long long e = 0;
+      };
+   )CODE");
+   TClass *clOld = TClass::GetClass("SkipFusedOld");
+   TClass *clNew = TClass::GetClass("SkipFusedNew");
+   ASSERT_NE(clOld, nullptr);
+   ASSERT_NE(clNew, nullptr);
+   // SkipFusedNew is the current layout of the objects written as SkipFusedOld.
+   ASSERT_TRUE(TClass::AddRule(R"RULE(sourceClass="SkipFusedOld" targetClass="SkipFusedNew" version="[1-]")RULE"));
+
+   void *obj = clOld->New();
+   Member<int>(clOld, obj, "a") = 42;
+   Member<double>(clOld, obj, "x") = 3.5;
+   Member<float>(clOld, obj, "y") = -1.5f;
+   (&Member<short>(clOld, obj, "z"))[0] = 7;
+   (&Member<short>(clOld, obj, "z"))[1] = 8;
+   Member<TString>(clOld, obj, "s") = "after the skipped run";
+   Member<long long>(clOld, obj, "e") = -1234567890123LL;
+   Member<char>(clOld, obj, "f") = 'x';
+   Member<int>(clOld, obj, "b") = -17;
+
+   TBufferFile wbuf(TBuffer::kWrite);
+   wbuf.WriteClassBuffer(clOld, obj);
+
+   void *copy = clNew->New();
+   TBufferFile rbuf(TBuffer::kRead, wbuf.Length(), wbuf.Buffer(), kFALSE);
+   rbuf.ReadClassBuffer(clNew, copy, clOld);
+   EXPECT_EQ(rbuf.Length(), wbuf.Length());
+
+   EXPECT_EQ(Member<int>(clNew, copy, "a"), 42);
+   EXPECT_EQ(Member<TString>(clNew, copy, "s"), "after the skipped run");
+   EXPECT_EQ(Member<long long>(clNew, copy, "e"), -1234567890123LL);
+   EXPECT_EQ(Member<char>(clNew, copy, "f"), 'x');
+   EXPECT_EQ(Member<int>(clNew, copy, "b"), -17);
+
+   if (TVirtualStreamerInfo::CanOptimize()) {
+      // a, {x, y, z} skipped, s, {e, f, b}
+      auto info = static_cast<TStreamerInfo *>(clNew->GetConversionStreamerInfo(clOld, clOld->GetClassVersion()));
+      ASSERT_NE(info, nullptr);
+      EXPECT_EQ(info->GetReadObjectWiseActions()->fActions.size(), 4u);
+   }
+
+   clOld->Destructor(obj);
+   clNew->Destructor(copy);
+}
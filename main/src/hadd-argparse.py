@@ -6,7 +6,7 @@ def get_argparse():
 The target file is newly created and must not exist, or if -f (\"force\") is given, must not be one of the source files.\n
 """
 	EPILOGUE = """
-If Target and source files have different compression settings a slower method is used.
+If Target and source files have different compression settings the TTree baskets are recompressed, which is slower (use -threads to recompress in parallel).
 For options that takes a size as argument, a decimal number of bytes is expected.
 If the number ends with a ``k'', ``m'', ``g'', etc., the number is multiplied by 1000 (1K), 1000000 (1MB), 1000000000 (1G), etc.
 If this prefix is followed by i, the number is multiplied by the traditional 1024 (1KiB), 1048576 (1MiB), 1073741824 (1GiB), etc.
@@ -22,6 +22,7 @@ The prefix can be optionally followed by B whose casing is ignored, eg. 1k, 1K,
 	parser.add_argument("-j", help="Parallelize the execution in multiple processes")
 	parser.add_argument("-dbg", help="Parallelize the execution in multiple processes in debug mode (Does not delete partial files stored inside working directory)")
 	parser.add_argument("-d", help="Carry out the partial multiprocess execution in the specified directory")
+	parser.add_argument("-threads", help="Merge in a single process, opening the inputs, merging the histograms and recompressing the TTree baskets with multiple threads (by default as many as logical cores; the number can follow the option)")
 	parser.add_argument("-n", help="Open at most 'maxopenedfiles' at once (use 0 to request to use the system maximum)")
 	parser.add_argument("-cachesize", help="Resize the prefetching cache use to speed up I/O operations(use 0 to disable)")
 	parser.add_argument("-experimental-io-features", help="Used with an argument provided, enables the corresponding experimental feature for output trees")
@@ -30,6 +30,8 @@
   \param -dbg  Parallelise the execution in multiple processes in debug mode (Does not delete  partial  files  stored
               inside working directory)
   \param -d   Carry out the partial multiprocess execution in the specified directory
+  \param -threads Merge in a single process, opening the inputs, merging the histograms and recompressing the TTree baskets with
+              multiple threads (by default as many as logical cores; the number can follow the option)
   \param -n   Open at most `n` at once (use 0 to request to use the system maximum)
   \param -experimental-io-features `<feature>` Enables the corresponding experimental feature for output trees
   \return hadd returns a status code: 0 if OK, -1 otherwise
@@ -38,6 +40,8 @@
   level of the target file. By default the compression level is 1 (kDefaultZLIB), but
   if "-f0" is specified, the target file will not be compressed.
   if "-f6" is specified, the compression level 6 will be used.
+  When the compression settings of the target differ from the ones of the
+  sources, the baskets of the TTrees are recompressed without being unstreamed.
 
   For example assume 3 files f1, f2, f3 containing histograms hn and Trees Tn
    - f1 with h1 h2 h3 T1
@@ -101,6 +105,7 @@
 #include "ROOT/TIOFeatures.hxx"
 #include "TFile.h"
 #include "THashList.h"
+#include "TROOT.h"
 #include "TKey.h"
 #include "TClass.h"
 #include "TSystem.h"
@@ -140,12 +145,14 @@ int main( int argc, char **argv )
    Bool_t useFirstInputCompression = kFALSE;
    Bool_t multiproc = kFALSE;
    Bool_t debug = kFALSE;
+   Bool_t multithread = kFALSE;
    Int_t maxopenedfiles = 0;
    Int_t verbosity = 99;
    TString cacheSize;
    SysInfo_t s;
    gSystem->GetSysInfo(&s);
    auto nProcesses = s.fCpus;
+   auto nThreads = s.fCpus;
    auto workingDir = gSystem->TempDirectory();
    int outputPlace = 0;
    int ffirst = 2;
@@ -213,6 +220,21 @@ int main( int argc, char **argv )
          }
          multiproc = kTRUE;
          ++ffirst;
+      } else if (strcmp(argv[a], "-threads") == 0) {
+         // If the number of threads is not specified, use the default.
+         if (a + 1 != argc && isdigit(argv[a + 1][0])) {
+            Long_t request = strtol(argv[a + 1], 0, 10);
+            if (request < kMaxInt && request > 0) {
+               nThreads = (Int_t)request;
+               ++a;
+               ++ffirst;
+            } else {
+               std::cerr << "Error: could not parse the number of threads to use passed after -threads: "
+                         << argv[a + 1] << ". We will use the default value (number of logical cores).\n";
+            }
+         }
+         multithread = kTRUE;
+         ++ffirst;
       } else if ( strcmp(argv[a],"-cachesize=") == 0 ) {
          int size;
          static const size_t arglen = strlen("-cachesize=");
@@ -361,6 +383,12 @@ int main( int argc, char **argv )
       }
    }
 
+   if (multithread && multiproc) {
+      std::cerr << "Error: options -threads and -j cannot be combined. We will merge with " << nThreads
+                << " threads in a single process.\n";
+      multiproc = kFALSE;
+   }
+
    gSystem->Load("libTreePlayer");
 
    const char *targetname = 0;
@@ -380,6 +408,16 @@ int main( int argc, char **argv )
    if (maxopenedfiles > 0) {
       fileMerger.SetMaxOpenedFiles(maxopenedfiles);
    }
+   if (multithread) {
+      if (verbosity > 1)
+         std::cout << "hadd merging with " << nThreads << " threads\n";
+      fileMerger.SetNThreads(nThreads);
+#ifdef R__USE_IMT
+      // Used to recompress the TTree baskets in parallel; the TFileMerger then
+      // opens and merges the files on the same thread pool.
+      ROOT::EnableImplicitMT(nThreads);
+#endif
+   }
    if (newcomp == -1) {
       if (useFirstInputCompression || keepCompressionAsIs) {
          // grab from the first file.
@@ -455,7 +493,7 @@ int main( int argc, char **argv )
          if (!keepCompressionAsIs && merger.HasCompressionChange()) {
             // Don't warn if the user any request re-optimization.
             std::cout << "hadd Sources and Target have different compression levels" << std::endl;
-            std::cout << "hadd merging will be slower" << std::endl;
+            std::cout << "hadd the TTree baskets will be recompressed, merging will be slower" << std::endl;
          }
       }
       merger.SetNotrees(noTrees);
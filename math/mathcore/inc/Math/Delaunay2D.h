@@ -95,6 +95,9 @@ public:
    /// Return the Interpolated z value corresponding to the (x,y) point
    double  Interpolate(double x, double y);
 
+   /// Interpolate the z values of n (x,y) points, in parallel if implicit multi-threading is enabled
+   void    Interpolate(int n, const double *x, const double *y, double *z);
+
    /// Find all triangles 
    void      FindAllTriangles();
 
@@ -264,12 +267,20 @@ protected:
    /* To speed up localisation of points a grid is layed over normalized space
     *
     * A reference to triangle ABC is added to _all_ grid cells that include ABC's bounding box
+    *
+    * The number of cells grows with the number of points, to keep a few triangles per cell,
+    * but is reduced if the triangles would be added on average to more than fMaxCellsPerTriangle cells.
+    * The triangles of cell c are fCellTriangles[fCellStart[c]] to fCellTriangles[fCellStart[c+1]-1]
     */
 
-   static const int fNCells = 25; //! number of cells to divide the normalized space
+   static const int fMinNCells = 25;   //! minimum number of cells to divide the normalized space
+   static const int fMaxNCells = 4096; //! maximum number of cells to divide the normalized space
+   static const int fMaxCellsPerTriangle = 16; //! maximum average number of cells a triangle is added to
+   int fNCells;       //! number of cells to divide the normalized space
    double fXCellStep; //! inverse denominator to calculate X cell = fNCells / (fXNmax - fXNmin)
    double fYCellStep; //! inverse denominator to calculate X cell = fNCells / (fYNmax - fYNmin)
-   std::set<UInt_t> fCells[(fNCells+1)*(fNCells+1)]; //! grid cells with containing triangles
+   std::vector<UInt_t> fCellStart;     //! index of the first triangle of each grid cell in fCellTriangles
+   std::vector<UInt_t> fCellTriangles; //! triangles contained in the grid cells, cell after cell
 
    inline unsigned int Cell(UInt_t x, UInt_t y) const {
 	   return x*(fNCells+1) + y;
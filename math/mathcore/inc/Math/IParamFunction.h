@@ -21,6 +21,7 @@
 
 #include <cassert>
 #include <string>
+#include <vector>
 
 /**
    @defgroup ParamFunc Parameteric Function Evaluation Interfaces.
@@ -127,6 +128,22 @@ namespace ROOT {
             return DoEval(x);
          }
 
+         /**
+         Evaluate the function at n points for the given parameters p and store the values in f.
+         x[j] points to the n values of the coordinate j, i.e. point i is (x[0][i], ..., x[NDim()-1][i]).
+         The default implementation evaluates the points one by one; derived classes can re-implement it
+         to evaluate many points at once (e.g. with vectorized or compiled loops).
+         */
+         virtual void EvalParN(unsigned int n, const T *const *x, T *f, const double *p) const
+         {
+            std::vector<T> xi(this->NDim());
+            for (unsigned int i = 0; i < n; ++i) {
+               for (unsigned int j = 0; j < xi.size(); ++j)
+                  xi[j] = x[j][i];
+               f[i] = DoEvalPar(xi.data(), p);
+            }
+         }
+
       private:
          /**
             Implementation of the evaluation function using the x values and the parameters.
@@ -13,6 +13,11 @@
 
 #include "Math/Delaunay2D.h"
 #include "Rtypes.h"
+#include "TROOT.h"
+
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#endif
 
 //#include <thread>
 
@@ -23,6 +28,7 @@
 #endif
 
 #include <algorithm>
+#include <cmath>
 #include <stdlib.h>
 
 namespace ROOT {
@@ -95,6 +101,7 @@ void Delaunay2D::SetInputPoints(int n, const double * x, const double * y, const
 
 
 #ifndef HAS_CGAL
+   fNCells       = fMinNCells;
    fXCellStep    = 0.;
    fYCellStep    = 0.;
 #endif
@@ -124,6 +131,43 @@ double Delaunay2D::Interpolate(double x, double y)
    return zz;
 }
 
+//______________________________________________________________________________
+void Delaunay2D::Interpolate(int n, const double *x, const double *y, double *z)
+{
+   // Compute the z values of the n points (x[i],y[i]), as Interpolate(x[i],y[i]).
+   // The triangles are found once, then the points are located and interpolated
+   // in parallel chunks when implicit multi-threading is enabled.
+
+   if (n <= 0) return;
+
+   FindAllTriangles();
+
+   auto interpolateRange = [&](int begin, int end) {
+      for (int i = begin; i < end; ++i) {
+         double xx = Linear_transform(x[i], fOffsetX, fScaleFactorX);
+         double yy = Linear_transform(y[i], fOffsetY, fScaleFactorY);
+         double zz = DoInterpolateNormalized(xx, yy);
+         // see Interpolate(double, double)
+         if (zz == 0) zz = DoInterpolateNormalized(xx + 0.0001, yy);
+         z[i] = zz;
+      }
+   };
+
+   const int chunkSize = 1024;
+#if defined(R__USE_IMT) && !defined(HAS_CGAL)
+   if (ROOT::IsImplicitMTEnabled() && n > chunkSize) {
+      const unsigned int nChunks = (n + chunkSize - 1) / chunkSize;
+      ROOT::TThreadExecutor pool;
+      pool.Foreach([&](unsigned int chunk) {
+         const int begin = chunk * chunkSize;
+         interpolateRange(begin, std::min(n, begin + chunkSize));
+      }, ROOT::TSeqU(nChunks));
+      return;
+   }
+#endif
+   interpolateRange(0, n);
+}
+
 //______________________________________________________________________________
 void Delaunay2D::FindAllTriangles()
 {
@@ -247,6 +291,11 @@ void Delaunay2D::DoNormalizePoints() {
       fYN.push_back(Linear_transform(fY[n], fOffsetY, fScaleFactorY));
    }
 
+   //use about one cell per point, i.e. a few triangles per cell
+   fNCells = int(std::sqrt(double(fNpoints)));
+   if (fNCells < fMinNCells) fNCells = fMinNCells;
+   if (fNCells > fMaxNCells) fNCells = fMaxNCells;
+
    //also initialize fXCellStep and FYCellStep
    fXCellStep = fNCells / (fXNmax - fXNmin);
    fYCellStep = fNCells / (fYNmax - fYNmin);
@@ -324,6 +373,10 @@ void Delaunay2D::DoFindTriangles() {
    triangulate((char *) "zQN", &in, &out, nullptr);
 
    fTriangles.resize(out.numberoftriangles);
+
+   //sums of the bounding box areas and sides of the triangles, relative to the normalized space
+   double sumArea = 0, sumSides = 0;
+
    for(int t = 0; t < out.numberoftriangles; ++t){
       Triangle tri;
 
@@ -354,17 +407,62 @@ void Delaunay2D::DoFindTriangles() {
 
       auto bx = std::minmax({tri.x[0], tri.x[1], tri.x[2]});
       auto by = std::minmax({tri.y[0], tri.y[1], tri.y[2]});
+      const double w = (bx.second - bx.first) / (fXNmax - fXNmin);
+      const double h = (by.second - by.first) / (fYNmax - fYNmin);
+      sumArea += w * h;
+      sumSides += w + h;
+   }
+
+   //a triangle whose bounding box is w x h of the normalized space is added to
+   //about (w*n + 1)*(h*n + 1) cells of a n x n grid: with the long triangles of
+   //concave or clustered point sets, reduce n to keep the total below
+   //fMaxCellsPerTriangle per triangle
+   const double nTriangles = out.numberoftriangles;
+   const double maxExtra = (fMaxCellsPerTriangle - 1) * nTriangles;
+   if (sumArea * fNCells * fNCells + sumSides * fNCells > maxExtra) {
+      double n = (sumArea > 0) ? (std::sqrt(sumSides * sumSides + 4 * sumArea * maxExtra) - sumSides) / (2 * sumArea)
+                               : maxExtra / sumSides;
+      if (n < fNCells) fNCells = int(n);
+      if (fNCells < fMinNCells) fNCells = fMinNCells;
+      fXCellStep = fNCells / (fXNmax - fXNmin);
+      fYCellStep = fNCells / (fYNmax - fYNmin);
+   }
+
+   //number of triangles in each grid cell, then index of the first one in fCellTriangles
+   const unsigned int nCells = (fNCells+1)*(fNCells+1);
+   fCellStart.assign(nCells + 1, 0);
+   std::vector<unsigned int> cellRanges(4 * out.numberoftriangles);
+
+   for(int t = 0; t < out.numberoftriangles; ++t){
+      const Triangle &tri = fTriangles[t];
+      auto bx = std::minmax({tri.x[0], tri.x[1], tri.x[2]});
+      auto by = std::minmax({tri.y[0], tri.y[1], tri.y[2]});
+
+      unsigned int *range = &cellRanges[4 * t];
+      range[0] = CellX(bx.first);
+      range[1] = CellX(bx.second);
+      range[2] = CellY(by.first);
+      range[3] = CellY(by.second);
 
-      unsigned int cellXmin = CellX(bx.first);
-      unsigned int cellXmax = CellX(bx.second);
+      for(unsigned int i = range[0]; i <= range[1]; ++i) {
+         for(unsigned int j = range[2]; j <= range[3]; ++j) {
+            ++fCellStart[Cell(i,j) + 1];
+         }
+      }
+   }
 
-      unsigned int cellYmin = CellY(by.first);
-      unsigned int cellYmax = CellY(by.second);
+   for(unsigned int c = 0; c < nCells; ++c)
+      fCellStart[c + 1] += fCellStart[c];
 
-      for(unsigned int i = cellXmin; i <= cellXmax; ++i) {
-         for(unsigned int j = cellYmin; j <= cellYmax; ++j) {
+   //fill the cells in the order of the triangles
+   fCellTriangles.resize(fCellStart[nCells]);
+   std::vector<UInt_t> cellFill(fCellStart.begin(), fCellStart.end() - 1);
+   for(int t = 0; t < out.numberoftriangles; ++t){
+      const unsigned int *range = &cellRanges[4 * t];
+      for(unsigned int i = range[0]; i <= range[1]; ++i) {
+         for(unsigned int j = range[2]; j <= range[3]; ++j) {
             //printf("(%u,%u) = %u\n", i, j, Cell(i,j));
-            fCells[Cell(i,j)].insert(t);
+            fCellTriangles[cellFill[Cell(i,j)]++] = t;
          }
       }
    }
@@ -402,7 +500,9 @@ double Delaunay2D::DoInterpolateNormalized(double xx, double yy)
    if(cX < 0 || cX > fNCells || cY < 0 || cY > fNCells)
       return fZout; //TODO some more fancy interpolation here
 
-    for(unsigned int t : fCells[Cell(cX, cY)]){
+    const unsigned int cell = Cell(cX, cY);
+    for(unsigned int k = fCellStart[cell]; k < fCellStart[cell + 1]; ++k){
+       const unsigned int t = fCellTriangles[k];
        auto coords = bayCoords(t);
 
        if(inTriangle(coords)){
@@ -425,14 +525,14 @@ double Delaunay2D::DoInterpolateNormalized(double xx, double yy)
           //brute force found a triangle -> grid not
           printf("Found triangle %u for (%f,%f) -> (%u,%u)\n", t, xx,yy, cX, cY);
           printf("Triangles in grid cell: ");
-          for(unsigned int x : fCells[Cell(cX, cY)])
-             printf("%u ", x);
+          for(unsigned int k = fCellStart[Cell(cX, cY)]; k < fCellStart[Cell(cX, cY) + 1]; ++k)
+             printf("%u ", fCellTriangles[k]);
           printf("\n");
 
           printf("Triangle %u is in cells: ", t);
           for(unsigned int i = 0; i <= fNCells; ++i)
              for(unsigned int j = 0; j <= fNCells; ++j)
-                if(fCells[Cell(i,j)].count(t))
+                if(std::count(fCellTriangles.begin() + fCellStart[Cell(i,j)], fCellTriangles.begin() + fCellStart[Cell(i,j) + 1], t))
                    printf("(%u,%u) ", i, j);
           printf("\n");
           for(unsigned int i = 0; i < 3; ++i)
@@ -213,6 +213,28 @@ namespace ROOT {
             }
          }
 
+         // number of points for which the model function is evaluated at once, see EvalModelFunction
+         const unsigned int kEvalBatchSize = 256;
+
+         // evaluate the model function at the data points [begin, end), kEvalBatchSize points at a time
+         // with IParamMultiFunction::EvalParN, and call action(i, fval) for each point in order
+         template <class Action>
+         void EvalModelFunction(const IModelFunction &func, const FitData &data, const double *p,
+                                unsigned int begin, unsigned int end, Action &&action)
+         {
+            const unsigned int ndim = data.NDim();
+            std::vector<const double *> x(ndim);
+            double fval[kEvalBatchSize];
+            for (unsigned int ib = begin; ib < end; ib += kEvalBatchSize) {
+               const unsigned int nb = std::min(kEvalBatchSize, end - ib);
+               for (unsigned int j = 0; j < ndim; ++j)
+                  x[j] = data.GetCoordComponent(ib, j);
+               func.EvalParN(nb, x.data(), fval, p);
+               for (unsigned int i = 0; i < nb; ++i)
+                  action(ib + i, fval[i]);
+            }
+         }
+
 
 
       } // end namespace  FitUtil
@@ -275,17 +297,68 @@ namespace ROOT {
 
    (const_cast<IModelFunction &>(func)).SetParameters(p);
 
-   auto mapFunction = [&](const unsigned i){
+   // chi2 term of point i given the function value fval
+   auto chi2Term = [&](const unsigned i, double fval) {
 
       double chi2{};
-      double fval{};
 
-      const auto x1 = data.GetCoordComponent(i, 0);
       const auto y = data.Value(i);
       auto invError = data.InvError(i);
 
       //invError = (invError!= 0.0) ? 1.0/invError :1;
 
+      // expected errors
+      if (useExpErrors) {
+         double invWeight  = 1.0;
+         if (isWeighted) {
+            // we need first to check if a weight factor needs to be applied
+            // weight = sumw2/sumw = error**2/content
+            //invWeight = y * invError * invError;
+            // we use always the global weight and not the observed one in the bin
+            // for empty bins use global weight (if it is weighted data.SumError2() is not zero)
+            invWeight = data.SumOfContent()/ data.SumOfError2();
+            //if (invError > 0) invWeight = y * invError * invError;
+         }
+
+         //  if (invError == 0) invWeight = (data.SumOfError2() > 0) ? data.SumOfContent()/ data.SumOfError2() : 1.0;
+         // compute expected error  as f(x) / weight
+         double invError2 = (fval > 0) ? invWeight / fval : 0.0;
+         invError = std::sqrt(invError2);
+         //std::cout << "using Pearson chi2 " << x[0] << "  " << 1./invError2 << "  " << fval << std::endl;
+      }
+
+//#define DEBUG
+#ifdef DEBUG
+      std::cout << *data.GetCoordComponent(i, 0) << "  " << y << "  " << 1./invError << " params : ";
+      for (unsigned int ipar = 0; ipar < func.NPar(); ++ipar)
+         std::cout << p[ipar] << "\t";
+      std::cout << "\tfval = " << fval << " ref " << wrefVolume << std::endl;
+#endif
+//#undef DEBUG
+
+      if (invError > 0) {
+
+         double tmp = ( y -fval )* invError;
+         double resval = tmp * tmp;
+
+
+         // avoid inifinity or nan in chi2 values due to wrong function values
+         if ( resval < maxResValue )
+            chi2 += resval;
+         else {
+            //nRejected++;
+            chi2 += maxResValue;
+         }
+      }
+      return chi2;
+  };
+
+   auto mapFunction = [&](const unsigned i){
+
+      double fval{};
+
+      const auto x1 = data.GetCoordComponent(i, 0);
+
       const double * x = nullptr;
       std::vector<double> xc;
       double binVolume = 1.0;
@@ -330,50 +403,7 @@ namespace ROOT {
       // normalize result if requested according to bin volume
       if (useBinVolume) fval *= binVolume;
 
-      // expected errors
-      if (useExpErrors) {
-         double invWeight  = 1.0;
-         if (isWeighted) {
-            // we need first to check if a weight factor needs to be applied
-            // weight = sumw2/sumw = error**2/content
-            //invWeight = y * invError * invError;
-            // we use always the global weight and not the observed one in the bin
-            // for empty bins use global weight (if it is weighted data.SumError2() is not zero)
-            invWeight = data.SumOfContent()/ data.SumOfError2();
-            //if (invError > 0) invWeight = y * invError * invError;
-         }
-
-         //  if (invError == 0) invWeight = (data.SumOfError2() > 0) ? data.SumOfContent()/ data.SumOfError2() : 1.0;
-         // compute expected error  as f(x) / weight
-         double invError2 = (fval > 0) ? invWeight / fval : 0.0;
-         invError = std::sqrt(invError2);
-         //std::cout << "using Pearson chi2 " << x[0] << "  " << 1./invError2 << "  " << fval << std::endl;
-      }
-
-//#define DEBUG
-#ifdef DEBUG
-      std::cout << x[0] << "  " << y << "  " << 1./invError << " params : ";
-      for (unsigned int ipar = 0; ipar < func.NPar(); ++ipar)
-         std::cout << p[ipar] << "\t";
-      std::cout << "\tfval = " << fval << " bin volume " << binVolume << " ref " << wrefVolume << std::endl;
-#endif
-//#undef DEBUG
-
-      if (invError > 0) {
-
-         double tmp = ( y -fval )* invError;
-         double resval = tmp * tmp;
-
-
-         // avoid inifinity or nan in chi2 values due to wrong function values
-         if ( resval < maxResValue )
-            chi2 += resval;
-         else {
-            //nRejected++;
-            chi2 += maxResValue;
-         }
-      }
-      return chi2;
+      return chi2Term(i, fval);
   };
 
 #ifdef R__USE_IMT
@@ -391,16 +421,35 @@ namespace ROOT {
   }
 #endif
 
+  // without bin integral or volume the function values at the points are computed in batches
+  bool useBatches = !useBinIntegral && !useBinVolume;
+
   double res{};
   if(executionPolicy == ROOT::Fit::ExecutionPolicy::kSerial){
-    for (unsigned int i=0; i<n; ++i) {
-      res += mapFunction(i);
+    if (useBatches) {
+      EvalModelFunction(func, data, p, 0, n, [&](const unsigned i, double fval) { res += chi2Term(i, fval); });
+    } else {
+      for (unsigned int i=0; i<n; ++i) {
+        res += mapFunction(i);
+      }
     }
 #ifdef R__USE_IMT
   } else if(executionPolicy == ROOT::Fit::ExecutionPolicy::kMultithread) {
     ROOT::TThreadExecutor pool;
     auto chunks = nChunks !=0? nChunks: setAutomaticChunking(data.Size());
-    res = pool.MapReduce(mapFunction, ROOT::TSeq<unsigned>(0, n), redFunction, chunks);
+    if (useBatches) {
+      const unsigned nBatches = (n + kEvalBatchSize - 1) / kEvalBatchSize;
+      auto mapBatch = [&](const unsigned ib) {
+        double chi2{};
+        EvalModelFunction(func, data, p, ib * kEvalBatchSize, std::min(n, (ib + 1) * kEvalBatchSize),
+                          [&](const unsigned i, double fval) { chi2 += chi2Term(i, fval); });
+        return chi2;
+      };
+      if (nBatches > 0)
+        res = pool.MapReduce(mapBatch, ROOT::TSeq<unsigned>(0, nBatches), redFunction, std::min(chunks, nBatches));
+    } else {
+      res = pool.MapReduce(mapFunction, ROOT::TSeq<unsigned>(0, n), redFunction, chunks);
+    }
 #endif
 //   } else if(executionPolicy == ROOT::Fit::kMultitProcess){
     // ROOT::TProcessExecutor pool;
@@ -972,30 +1021,10 @@ double FitUtil::EvaluateLogL(const IModelFunctionTempl<double> &func, const UnBi
 
          // needed to compue effective global weight in case of extended likelihood
 
-         auto mapFunction = [&](const unsigned i) {
+         // log-likelihood term of point i given the function value fval
+         auto logLTerm = [&](const unsigned i, double fval) {
             double W = 0;
             double W2 = 0;
-            double fval = 0;
-
-            if (data.NDim() > 1) {
-               std::vector<double> x(data.NDim());
-               for (unsigned int j = 0; j < data.NDim(); ++j)
-                  x[j] = *data.GetCoordComponent(i, j);
-#ifdef USE_PARAMCACHE
-               fval = func(x.data());
-#else
-               fval = func(x.data(), p);
-#endif
-
-               // one -dim case
-            } else {
-               const auto x = data.GetCoordComponent(i, 0);
-#ifdef USE_PARAMCACHE
-               fval = func(x);
-#else
-               fval = func(x, p);
-#endif
-            }
 
             if (normalizeFunc)
                fval = fval * (1 / norm);
@@ -1043,24 +1072,34 @@ double FitUtil::EvaluateLogL(const IModelFunctionTempl<double> &func, const UnBi
   }
 #endif
 
+  // the function values at the points are computed in batches
   double logl{};
   double sumW{};
   double sumW2{};
   if(executionPolicy == ROOT::Fit::ExecutionPolicy::kSerial){
-    for (unsigned int i=0; i<n; ++i) {
-      auto resArray = mapFunction(i);
+    EvalModelFunction(func, data, p, 0, n, [&](const unsigned i, double fval) {
+      auto resArray = logLTerm(i, fval);
       logl+=resArray.logvalue;
       sumW+=resArray.weight;
       sumW2+=resArray.weight2;
-    }
+    });
 #ifdef R__USE_IMT
   } else if(executionPolicy == ROOT::Fit::ExecutionPolicy::kMultithread) {
     ROOT::TThreadExecutor pool;
     auto chunks = nChunks !=0? nChunks: setAutomaticChunking(data.Size());
-    auto resArray = pool.MapReduce(mapFunction, ROOT::TSeq<unsigned>(0, n), redFunction, chunks);
-    logl=resArray.logvalue;
-    sumW=resArray.weight;
-    sumW2=resArray.weight2;
+    const unsigned nBatches = (n + kEvalBatchSize - 1) / kEvalBatchSize;
+    auto mapBatch = [&](const unsigned ib) {
+      auto l0 = LikelihoodAux<double>(0.0, 0.0, 0.0);
+      EvalModelFunction(func, data, p, ib * kEvalBatchSize, std::min(n, (ib + 1) * kEvalBatchSize),
+                        [&](const unsigned i, double fval) { l0 = l0 + logLTerm(i, fval); });
+      return l0;
+    };
+    if (nBatches > 0) {
+      auto resArray = pool.MapReduce(mapBatch, ROOT::TSeq<unsigned>(0, nBatches), redFunction, std::min(chunks, nBatches));
+      logl=resArray.logvalue;
+      sumW=resArray.weight;
+      sumW2=resArray.weight2;
+    }
 #endif
 //   } else if(executionPolicy == ROOT::Fit::kMultitProcess){
     // ROOT::TProcessExecutor pool;
@@ -1436,9 +1475,59 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction &func, const BinData &d
    IntegralEvaluator<> igEval(func, p, useBinIntegral, igType);
 #endif
 
+   // negative log-likelihood term of bin i given the function value fval
+   auto poissonTerm = [&](const unsigned i, double fval) {
+      auto y = *data.ValuePtr(i);
+
+      // EvalLog protects against 0 values of fval but don't want to add in the -log sum
+      // negative values of fval
+      fval = std::max(fval, 0.0);
+
+      double nloglike = 0; // negative loglikelihood
+      if (useW2) {
+         // apply weight correction . Effective weight is error^2/ y
+         // and expected events in bins is fval/weight
+         // can apply correction only when y is not zero otherwise weight is undefined
+         // (in case of weighted likelihood I don't care about the constant term due to
+         // the saturated model)
+
+         // use for the empty bins the global weight
+         double weight = 1.0;
+         if (y != 0) {
+            double error = data.Error(i);
+            weight = (error * error) / y; // this is the bin effective weight
+            nloglike += weight * y * ( ROOT::Math::Util::EvalLog(y) - ROOT::Math::Util::EvalLog(fval) );
+         }
+         else {
+            // for empty bin use the average weight  computed from the total data weight
+            weight = data.SumOfError2()/ data.SumOfContent();
+         }
+         if (extended) {
+            nloglike += weight  *  ( fval - y);
+         }
+
+      } else {
+         // standard case no weights or iWeight=1
+         // this is needed for Poisson likelihood (which are extened and not for multinomial)
+         // the formula below  include constant term due to likelihood of saturated model (f(x) = y)
+         // (same formula as in Baker-Cousins paper, page 439 except a factor of 2
+         if (extended) nloglike = fval - y;
+
+         if (y >  0) {
+            nloglike += y * (ROOT::Math::Util::EvalLog(y) - ROOT::Math::Util::EvalLog(fval));
+         }
+      }
+#ifdef DEBUG
+      {
+         R__LOCKGUARD(gROOTMutex);
+         std::cout << " nll = " << nloglike << std::endl;
+      }
+#endif
+      return nloglike;
+   };
+
    auto mapFunction = [&](const unsigned i) {
       auto x1 = data.GetCoordComponent(i, 0);
-      auto y = *data.ValuePtr(i);
 
       const double *x = nullptr;
       std::vector<double> xc;
@@ -1483,8 +1572,6 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction &func, const BinData &d
       }
       if (useBinVolume) fval *= binVolume;
 
-
-
 #ifdef DEBUG
       int NSAMPLE = 100;
       if (i % NSAMPLE == 0) {
@@ -1496,56 +1583,11 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction &func, const BinData &d
             for (unsigned int j = 0; j < func.NDim(); ++j) std::cout << data.GetBinUpEdgeComponent(i, j) << " , ";
             std::cout << "] ";
          }
-         std::cout << "  y = " << y << " fval = " << fval << std::endl;
+         std::cout << "  y = " << *data.ValuePtr(i) << " fval = " << fval << std::endl;
       }
 #endif
 
-
-      // EvalLog protects against 0 values of fval but don't want to add in the -log sum
-      // negative values of fval
-      fval = std::max(fval, 0.0);
-
-      double nloglike = 0; // negative loglikelihood
-      if (useW2) {
-         // apply weight correction . Effective weight is error^2/ y
-         // and expected events in bins is fval/weight
-         // can apply correction only when y is not zero otherwise weight is undefined
-         // (in case of weighted likelihood I don't care about the constant term due to
-         // the saturated model)
-
-         // use for the empty bins the global weight
-         double weight = 1.0;
-         if (y != 0) {
-            double error = data.Error(i);
-            weight = (error * error) / y; // this is the bin effective weight
-            nloglike += weight * y * ( ROOT::Math::Util::EvalLog(y) - ROOT::Math::Util::EvalLog(fval) );
-         }
-         else {
-            // for empty bin use the average weight  computed from the total data weight
-            weight = data.SumOfError2()/ data.SumOfContent();
-         }
-         if (extended) {
-            nloglike += weight  *  ( fval - y);
-         }
-
-      } else {
-         // standard case no weights or iWeight=1
-         // this is needed for Poisson likelihood (which are extened and not for multinomial)
-         // the formula below  include constant term due to likelihood of saturated model (f(x) = y)
-         // (same formula as in Baker-Cousins paper, page 439 except a factor of 2
-         if (extended) nloglike = fval - y;
-
-         if (y >  0) {
-            nloglike += y * (ROOT::Math::Util::EvalLog(y) - ROOT::Math::Util::EvalLog(fval));
-         }
-      }
-#ifdef DEBUG
-      {
-         R__LOCKGUARD(gROOTMutex);
-         std::cout << " nll = " << nloglike << std::endl;
-      }
-#endif
-      return nloglike;
+      return poissonTerm(i, fval);
    };
 
 #ifdef R__USE_IMT
@@ -1563,16 +1605,35 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction &func, const BinData &d
    }
 #endif
 
+   // without bin integral or volume the function values at the bins are computed in batches
+   bool useBatches = !useBinIntegral && !useBinVolume;
+
    double res{};
    if (executionPolicy == ROOT::Fit::ExecutionPolicy::kSerial) {
-      for (unsigned int i = 0; i < n; ++i) {
-         res += mapFunction(i);
+      if (useBatches) {
+         EvalModelFunction(func, data, p, 0, n, [&](const unsigned i, double fval) { res += poissonTerm(i, fval); });
+      } else {
+         for (unsigned int i = 0; i < n; ++i) {
+            res += mapFunction(i);
+         }
       }
 #ifdef R__USE_IMT
    } else if (executionPolicy == ROOT::Fit::ExecutionPolicy::kMultithread) {
       ROOT::TThreadExecutor pool;
       auto chunks = nChunks != 0 ? nChunks : setAutomaticChunking(data.Size());
-      res = pool.MapReduce(mapFunction, ROOT::TSeq<unsigned>(0, n), redFunction, chunks);
+      if (useBatches) {
+         const unsigned nBatches = (n + kEvalBatchSize - 1) / kEvalBatchSize;
+         auto mapBatch = [&](const unsigned ib) {
+            double nloglike{};
+            EvalModelFunction(func, data, p, ib * kEvalBatchSize, std::min(n, (ib + 1) * kEvalBatchSize),
+                              [&](const unsigned i, double fval) { nloglike += poissonTerm(i, fval); });
+            return nloglike;
+         };
+         if (nBatches > 0)
+            res = pool.MapReduce(mapBatch, ROOT::TSeq<unsigned>(0, nBatches), redFunction, std::min(chunks, nBatches));
+      } else {
+         res = pool.MapReduce(mapFunction, ROOT::TSeq<unsigned>(0, n), redFunction, chunks);
+      }
 #endif
       //   } else if(executionPolicy == ROOT::Fit::kMultitProcess){
       // ROOT::TProcessExecutor pool;
@@ -17,7 +17,9 @@
 
 #include "TVirtualPad.h"
 
+#include <cmath>
 #include <iostream>
+#include <vector>
 
 void printDelaunay(const TGraphDelaunay2D & gd){
 
@@ -58,6 +60,23 @@ int delaunayTriangulation(bool old = false) {
            std::cout << eta << " " << res << "  " << res2 << std::endl;
 	}
 
+	// the batch interpolation must give the same values as the point by point one
+	const int N = 200;
+	std::vector<Double_t> xs(N*N), ys(N*N), zs(N*N);
+	for (int i = 0; i < N; i++) {
+           for (int j = 0; j < N; j++) {
+              xs[i*N + j] = graph->GetXmin() + (graph->GetXmax() - graph->GetXmin()) * (i + 0.5) / N;
+              ys[i*N + j] = graph->GetYmin() + (graph->GetYmax() - graph->GetYmin()) * (j + 0.5) / N;
+           }
+	}
+	graph->Interpolate(N*N, xs.data(), ys.data(), zs.data());
+	for (int k = 0; k < N*N; k++) {
+           if (zs[k] != delaunay.ComputeZ(xs[k], ys[k])) {
+              printf("ERROR - Batch interpolation at (%f,%f): %f instead of %f\n", xs[k], ys[k], zs[k], delaunay.ComputeZ(xs[k], ys[k]));
+              return 5;
+           }
+	}
+
 	if(delaunay.GetNdt() == EXP){
            if(VERBOSE) printDelaunay(delaunay);
 
@@ -72,6 +91,48 @@ int delaunayTriangulation(bool old = false) {
 
 }
 
+// Points on a thin ring and in a tight cluster give long triangles across the ring, which
+// cover many grid cells. A linear function must be interpolated exactly inside the ring.
+int delaunayRing() {
+
+   const int NRING = 20000, NCLUSTER = 5000;
+   auto func = [](double x, double y) { return 2 * x + 3 * y + 1; };
+
+   TGraph2D graph(NRING + NCLUSTER);
+   for (int i = 0; i < NRING; i++) {
+      double phi = 2 * M_PI * i / NRING;
+      double r = 1 - 0.01 * (i % 7) / 7;
+      graph.SetPoint(i, r * std::cos(phi), r * std::sin(phi), func(r * std::cos(phi), r * std::sin(phi)));
+   }
+   for (int i = 0; i < NCLUSTER; i++) {
+      double x = 0.5 + 1e-4 * (i % 71) / 71, y = 1e-4 * (i / 71) / 71;
+      graph.SetPoint(NRING + i, x, y, func(x, y));
+   }
+
+   const int N = 100;
+   std::vector<Double_t> xs, ys;
+   for (int i = 0; i < N; i++) {
+      for (int j = 0; j < N; j++) {
+         double x = -0.9 + 1.8 * (i + 0.5) / N, y = -0.9 + 1.8 * (j + 0.5) / N;
+         if (x * x + y * y < 0.8) {
+            xs.push_back(x);
+            ys.push_back(y);
+         }
+      }
+   }
+   std::vector<Double_t> zs(xs.size());
+   graph.Interpolate(xs.size(), xs.data(), ys.data(), zs.data());
+   for (std::size_t k = 0; k < xs.size(); k++) {
+      if (std::abs(zs[k] - func(xs[k], ys[k])) > 1e-6) {
+         printf("ERROR - Ring interpolation at (%f,%f): %f instead of %f\n", xs[k], ys[k], zs[k], func(xs[k], ys[k]));
+         return 6;
+      }
+   }
+
+   return 0;
+}
+
 int main() {
-   return delaunayTriangulation();
+   int res = delaunayTriangulation();
+   return res ? res : delaunayRing();
 }
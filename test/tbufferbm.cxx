@@ -0,0 +1,79 @@
+// @(#)root/test:$Id$
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "ROOT/RByteSwap.hxx"
+#include "TBufferFile.h"
+#include "TStopwatch.h"
+#include "snprintf.h"
+
+//
+// This program benchmarks TBufferFile::WriteFastArray and ReadFastArray,
+// i.e. the conversion of arrays of fundamental types to and from the
+// big-endian representation used in ROOT files, for every byte-swapping
+// kernel supported by the CPU (see ROOT::Internal::ByteSwap).
+//
+// Usage: tbufferbm [nelements] [ntimes]
+//
+
+using ROOT::Internal::ByteSwap::EKernel;
+
+template <typename T>
+void Benchmark(const char *type, Int_t n, Int_t ntimes)
+{
+   std::vector<T> in(n), out(n);
+   for (Int_t i = 0; i < n; ++i)
+      in[i] = T(i % 1000);
+
+   for (auto kernel : {EKernel::kScalar, EKernel::kSSSE3, EKernel::kAVX2, EKernel::kAVX512}) {
+      if (!ROOT::Internal::ByteSwap::SetKernel(kernel))
+         continue;
+      TBufferFile buf(TBuffer::kWrite, n * sizeof(T) + 64);
+      TStopwatch wtimer, rtimer;
+      wtimer.Stop();
+      rtimer.Stop();
+      for (Int_t t = 0; t < ntimes; ++t) {
+         buf.SetWriteMode();
+         buf.SetBufferOffset(0);
+         wtimer.Start(kFALSE);
+         buf.WriteFastArray(in.data(), n);
+         wtimer.Stop();
+         buf.SetReadMode();
+         buf.SetBufferOffset(0);
+         rtimer.Start(kFALSE);
+         buf.ReadFastArray(out.data(), n);
+         rtimer.Stop();
+      }
+      if (out != in) {
+         std::cerr << "tbufferbm: round trip failed for " << type << std::endl;
+         exit(1);
+      }
+      const Double_t mbytes = 1e-6 * sizeof(T) * n * ntimes;
+      char line[128];
+      snprintf(line, sizeof(line), "%-9s %-8s write %9.1f MB/s   read %9.1f MB/s", type,
+               ROOT::Internal::ByteSwap::GetKernelName(kernel), mbytes / (wtimer.RealTime() + 1e-9),
+               mbytes / (rtimer.RealTime() + 1e-9));
+      std::cout << line << std::endl;
+   }
+   ROOT::Internal::ByteSwap::SetKernel(EKernel::kAuto);
+}
+
+int main(int argc, char **argv)
+{
+   Int_t n = 100000;
+   Int_t ntimes = 1000;
+   if (argc > 1)
+      n = atoi(argv[1]);
+   if (argc > 2)
+      ntimes = atoi(argv[2]);
+
+   std::cout << "Elements: " << n << ", repetitions: " << ntimes << std::endl;
+   Benchmark<Short_t>("Short_t", n, ntimes);
+   Benchmark<Int_t>("Int_t", n, ntimes);
+   Benchmark<Float_t>("Float_t", n, ntimes);
+   Benchmark<Long64_t>("Long64_t", n, ntimes);
+   Benchmark<Double_t>("Double_t", n, ntimes);
+   return 0;
+}
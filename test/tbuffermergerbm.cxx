@@ -0,0 +1,91 @@
+// @(#)root/test:$Id$
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "ROOT/TBufferMerger.hxx"
+#include "TMemFile.h"
+#include "TROOT.h"
+#include "TStopwatch.h"
+#include "TTree.h"
+#include "snprintf.h"
+
+//
+// This program benchmarks a TBufferMerger-heavy job: several threads fill
+// trees and frequently hand their TMemFile content to the merger. It is run
+// with and without the reuse of the TMemFile memory blocks (see
+// TMemFile::SetBlockPoolSize), and reports the time and the number of memory
+// blocks allocated from the system.
+//
+// Usage: tbuffermergerbm [nthreads] [nwrites] [nevents]
+//
+
+using ROOT::Experimental::TBufferMerger;
+
+void Run(const char *label, Int_t nthreads, Int_t nwrites, Int_t nevents)
+{
+   const char *filename = "tbuffermergerbm.root";
+   ULong64_t allocations = TMemFile::GetBlockPoolAllocations();
+   TStopwatch timer;
+   {
+      TBufferMerger merger(filename);
+      std::vector<std::thread> threads;
+      for (Int_t t = 0; t < nthreads; ++t) {
+         threads.emplace_back([=, &merger]() {
+            auto file = merger.GetFile();
+            auto tree = new TTree("T", "T");
+            Double_t x = 0;
+            Int_t n = 0;
+            tree->Branch("x", &x, "x/D");
+            tree->Branch("n", &n, "n/I");
+            for (Int_t w = 0; w < nwrites; ++w) {
+               for (Int_t i = 0; i < nevents; ++i) {
+                  n = (t * nwrites + w) * nevents + i;
+                  x = 0.5 * n;
+                  tree->Fill();
+               }
+               file->Write();
+            }
+            tree->ResetBranchAddresses();
+         });
+      }
+      for (auto &&th : threads)
+         th.join();
+   }
+   timer.Stop();
+   remove(filename);
+
+   char line[128];
+   snprintf(line, sizeof(line), "%-14s time %8.3f s   block allocations %8llu", label, timer.RealTime(),
+            TMemFile::GetBlockPoolAllocations() - allocations);
+   std::cout << line << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+   Int_t nthreads = 4;
+   Int_t nwrites = 200;
+   Int_t nevents = 10000;
+   if (argc > 1)
+      nthreads = atoi(argv[1]);
+   if (argc > 2)
+      nwrites = atoi(argv[2]);
+   if (argc > 3)
+      nevents = atoi(argv[3]);
+
+   ROOT::EnableThreadSafety();
+
+   std::cout << "Threads: " << nthreads << ", writes per thread: " << nwrites << ", entries per write: " << nevents
+             << std::endl;
+
+   const Long64_t poolSize = TMemFile::GetBlockPoolSize();
+   TMemFile::SetBlockPoolSize(0);
+   Run("no block pool", nthreads, nwrites, nevents);
+   TMemFile::SetBlockPoolSize(128 * 1024 * 1024);
+   Run("block pool", nthreads, nwrites, nevents);
+   TMemFile::SetBlockPoolSize(poolSize);
+   return 0;
+}
@@ -0,0 +1,110 @@
+// @(#)root/test:$Id$
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "TH1D.h"
+#include "TH2D.h"
+#include "TH3D.h"
+#include "TRandom3.h"
+#include "TStopwatch.h"
+#include "snprintf.h"
+
+//
+// This program benchmarks the batch filling of histograms with FillN, which
+// finds the bins of many entries at once (see TAxis::FindFixBins), against
+// calling Fill for each entry, for fixed and variable bin sizes.
+//
+// Usage: thfillbm [nentries] [ntimes]
+//
+
+void Report(const char *what, Int_t n, Int_t ntimes, TStopwatch &fill, TStopwatch &filln)
+{
+   const Double_t mentries = 1e-6 * n * ntimes;
+   char line[128];
+   snprintf(line, sizeof(line), "%-22s Fill %8.1f M/s   FillN %8.1f M/s", what,
+            mentries / (fill.RealTime() + 1e-9), mentries / (filln.RealTime() + 1e-9));
+   std::cout << line << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+   Int_t n = 1000000;
+   Int_t ntimes = 10;
+   if (argc > 1)
+      n = atoi(argv[1]);
+   if (argc > 2)
+      ntimes = atoi(argv[2]);
+
+   TH1::AddDirectory(kFALSE);
+   TRandom3 rnd(1);
+   std::vector<Double_t> x(n), y(n), z(n), w(n);
+   for (Int_t i = 0; i < n; ++i) {
+      x[i] = rnd.Gaus(0, 2);
+      y[i] = rnd.Gaus(0, 2);
+      z[i] = rnd.Gaus(0, 2);
+      w[i] = rnd.Uniform(0.5, 1.5);
+   }
+   std::vector<Double_t> edges(201);
+   for (Int_t i = 0; i <= 200; ++i)
+      edges[i] = -10 + 20. * i * i / (200 * 200);
+
+   std::cout << "Entries: " << n << ", repetitions: " << ntimes << std::endl;
+
+   TH1D h1("h1", "fixed", 200, -10, 10), h1n("h1n", "fixed", 200, -10, 10);
+   TH1D hv("hv", "variable", 200, edges.data()), hvn("hvn", "variable", 200, edges.data());
+   TH2D h2("h2", "2D", 100, -10, 10, 100, -10, 10), h2n("h2n", "2D", 100, -10, 10, 100, -10, 10);
+   TH3D h3("h3", "3D", 50, -10, 10, 50, -10, 10, 50, -10, 10), h3n("h3n", "3D", 50, -10, 10, 50, -10, 10, 50, -10, 10);
+
+   TStopwatch fill[4], filln[4];
+   for (auto &timer : fill)
+      timer.Stop();
+   for (auto &timer : filln)
+      timer.Stop();
+   for (Int_t t = 0; t < ntimes; ++t) {
+      fill[0].Start(kFALSE);
+      for (Int_t i = 0; i < n; ++i)
+         h1.Fill(x[i], w[i]);
+      fill[0].Stop();
+      filln[0].Start(kFALSE);
+      h1n.FillN(n, x.data(), w.data());
+      filln[0].Stop();
+
+      fill[1].Start(kFALSE);
+      for (Int_t i = 0; i < n; ++i)
+         hv.Fill(x[i], w[i]);
+      fill[1].Stop();
+      filln[1].Start(kFALSE);
+      hvn.FillN(n, x.data(), w.data());
+      filln[1].Stop();
+
+      fill[2].Start(kFALSE);
+      for (Int_t i = 0; i < n; ++i)
+         h2.Fill(x[i], y[i], w[i]);
+      fill[2].Stop();
+      filln[2].Start(kFALSE);
+      h2n.FillN(n, x.data(), y.data(), w.data());
+      filln[2].Stop();
+
+      fill[3].Start(kFALSE);
+      for (Int_t i = 0; i < n; ++i)
+         h3.Fill(x[i], y[i], z[i], w[i]);
+      fill[3].Stop();
+      filln[3].Start(kFALSE);
+      h3n.FillN(n, x.data(), y.data(), z.data(), w.data());
+      filln[3].Stop();
+   }
+
+   if (h1.GetMean() != h1n.GetMean() || hv.GetBinContent(100) != hvn.GetBinContent(100) ||
+       h2.GetCorrelationFactor() != h2n.GetCorrelationFactor() || h3.GetMean(3) != h3n.GetMean(3)) {
+      std::cerr << "thfillbm: FillN and Fill give different histograms" << std::endl;
+      return 1;
+   }
+
+   Report("TH1D fixed bins", n, ntimes, fill[0], filln[0]);
+   Report("TH1D variable bins", n, ntimes, fill[1], filln[1]);
+   Report("TH2D", n, ntimes, fill[2], filln[2]);
+   Report("TH3D", n, ntimes, fill[3], filln[3]);
+   return 0;
+}
@@ -0,0 +1,111 @@
+// @(#)root/test:$Id$
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <streambuf>
+
+#include "TBufferJSON.h"
+#include "TH2.h"
+#include "TStopwatch.h"
+#include "snprintf.h"
+
+//
+// This program benchmarks conversion of a large histogram into JSON and back,
+// comparing the in-memory conversion (TBufferJSON::ConvertToJSON and
+// ConvertFromJSON) with writing directly into an output stream
+// (TBufferJSON::StoreObject) and reading directly from an input stream,
+// for several compact modes.
+//
+// Usage: tjsonbm [nbins] [ntimes]
+//
+
+namespace {
+
+/// Stream buffer which only counts written bytes, used as output sink
+class CountingBuf : public std::streambuf {
+   Long64_t fCount{0};
+
+protected:
+   int_type overflow(int_type c) override
+   {
+      if (c != traits_type::eof())
+         ++fCount;
+      return c;
+   }
+   std::streamsize xsputn(const char *, std::streamsize n) override
+   {
+      fCount += n;
+      return n;
+   }
+
+public:
+   Long64_t GetCount() const { return fCount; }
+};
+
+} // anonymous namespace
+
+int main(int argc, char **argv)
+{
+   Int_t nbins = 1000;
+   Int_t ntimes = 10;
+   if (argc > 1)
+      nbins = atoi(argv[1]);
+   if (argc > 2)
+      ntimes = atoi(argv[2]);
+
+   TH2D h2("h2", "JSON benchmark", nbins, 0, 1, nbins, 0, 1);
+   h2.SetDirectory(nullptr);
+   // fill only part of the bins, to profit from zero and same values suppression
+   for (Int_t n = 0; n < nbins * nbins / 4; ++n)
+      h2.Fill(0.1 + 0.3 * (n % 997) / 997., 0.2 + 0.5 * (n % 991) / 991.);
+
+   std::cout << "Bins: " << nbins << " x " << nbins << ", repetitions: " << ntimes << std::endl;
+
+   for (Int_t compact : {0, 3, 23, 33}) {
+      TStopwatch strtimer, streamtimer, readtimer, streadtimer;
+      strtimer.Stop();
+      streamtimer.Stop();
+      readtimer.Stop();
+      streadtimer.Stop();
+      Long64_t jsonlen = 0, streamedlen = 0;
+      TString json;
+      for (Int_t t = 0; t < ntimes; ++t) {
+         strtimer.Start(kFALSE);
+         json = TBufferJSON::ConvertToJSON(&h2, compact);
+         strtimer.Stop();
+         jsonlen = json.Length();
+
+         CountingBuf sink;
+         std::ostream out(&sink);
+         streamtimer.Start(kFALSE);
+         TBufferJSON buf;
+         buf.SetCompact(compact);
+         buf.StoreObject(&h2, TH2D::Class(), out);
+         streamtimer.Stop();
+         streamedlen = sink.GetCount();
+
+         readtimer.Start(kFALSE);
+         delete TBufferJSON::ConvertFromJSON(json.Data());
+         readtimer.Stop();
+
+         std::istringstream in(json.Data());
+         streadtimer.Start(kFALSE);
+         TClass *cl = nullptr;
+         delete static_cast<TH2D *>(TBufferJSON::ConvertFromJSONAny(in, &cl));
+         streadtimer.Stop();
+      }
+      if (jsonlen != streamedlen) {
+         std::cerr << "tjsonbm: streamed output size mismatch for compact " << compact << std::endl;
+         exit(1);
+      }
+      const Double_t mbytes = 1e-6 * jsonlen * ntimes;
+      char line[256];
+      snprintf(line, sizeof(line),
+               "compact %2d  size %10lld  string %8.1f MB/s  stream %8.1f MB/s  read %8.1f MB/s  stream read %8.1f MB/s",
+               compact, jsonlen, mbytes / (strtimer.RealTime() + 1e-9), mbytes / (streamtimer.RealTime() + 1e-9),
+               mbytes / (readtimer.RealTime() + 1e-9), mbytes / (streadtimer.RealTime() + 1e-9));
+      std::cout << line << std::endl;
+   }
+   return 0;
+}
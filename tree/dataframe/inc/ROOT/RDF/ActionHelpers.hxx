@@ -1509,6 +1509,12 @@ public:
       if(!out_file)
          throw std::runtime_error("Snapshot: could not create output file " + fFileName);
       fMerger = std::make_unique<ROOT::Experimental::TBufferMerger>(std::unique_ptr<TFile>(out_file));
+      // merge in a dedicated thread so that processing slots never stall on the output file; past 256MB of
+      // pending data, slots wait for the merger to catch up.
+      fMerger->EnableBackgroundMerge(256 * 1024 * 1024);
+      // all TBufferMergerFiles share the compression settings of the output file: their compressed baskets can be
+      // appended to the output trees as they are, without being read back and streamed again.
+      fMerger->SetMergeOptions("fast");
    }
 
    void Finalize()
@@ -877,6 +877,48 @@ TEST(RDFSnapshotMore, ManyTasksPerThread)
    ROOT::DisableImplicitMT();
 }
 
+// The baskets of the processing slots are fast merged into the output file: check entries, arrays and compression.
+TEST(RDFSnapshotMore, FastMergeMT)
+{
+   ROOT::EnableImplicitMT(4);
+   const auto outputFile = "snapshot_fastmerge_out.root";
+   const ULong64_t nEntries = 100000ull;
+   RSnapshotOptions opts;
+   opts.fCompressionAlgorithm = ROOT::kLZMA;
+   opts.fCompressionLevel = 5;
+   ROOT::RDataFrame d(nEntries);
+   d.Define("x", [](ULong64_t e) { return double(e); }, {"rdfentry_"})
+      .Define("n", [](ULong64_t e) { return int(e % 5); }, {"rdfentry_"})
+      .Define("v", [](ULong64_t e) { return RVec<float>(e % 5, float(e)); }, {"rdfentry_"})
+      .Snapshot<double, int, RVec<float>>("t", outputFile, {"x", "n", "v"}, opts);
+   ROOT::DisableImplicitMT();
+
+   {
+      TFile f(outputFile);
+      std::unique_ptr<TTree> t(f.Get<TTree>("t"));
+      ASSERT_NE(t, nullptr);
+      EXPECT_EQ(t->GetBranch("x")->GetCompressionSettings(), ROOT::CompressionSettings(ROOT::kLZMA, 5));
+   }
+
+   ROOT::RDataFrame check("t", outputFile);
+   auto xs = check.Take<double>("x");
+   auto ns = check.Take<int>("n");
+   auto vs = check.Take<RVec<float>>("v");
+   ASSERT_EQ(xs->size(), nEntries);
+   double sum = 0.;
+   for (std::size_t i = 0; i < nEntries; ++i) {
+      // the entries of the slots are interleaved, but each one must be intact
+      const auto e = ULong64_t((*xs)[i]);
+      EXPECT_EQ((*ns)[i], int(e % 5));
+      ASSERT_EQ((*vs)[i].size(), e % 5);
+      for (auto el : (*vs)[i])
+         EXPECT_EQ(el, float(e));
+      sum += (*xs)[i];
+   }
+   EXPECT_EQ(sum, double(nEntries) * (nEntries - 1) / 2);
+   gSystem->Unlink(outputFile);
+}
+
 void checkSnapshotArrayFileMT(RResultPtr<RInterface<RLoopManager>> &df, unsigned int kNEvents)
 {
    // fixedSizeArr and varSizeArr are RResultPtr<vector<vector<T>>>
@@ -94,16 +94,26 @@ protected:
 
    // Unzipping related members
    Int_t       fNseekMax;         ///<!  fNseek can change so we need to know its max size
-   Int_t       fUnzipGroupSize;   ///<!  Min accumulated size of a group of baskets ready to be unzipped by a IMT task
+   Int_t       fUnzipGroupSize;   ///<!  Obsolete: baskets are now scheduled one by one
    Long64_t    fUnzipBufferSize;  ///<!  Max Size for the ready unzipped blocks (default is 2*fBufferSize)
 
+   std::vector<Long64_t> fBasketEntry;       ///<! [fNseek] First entry of each basket registered in the cache
+   std::vector<Int_t>    fUnzipOrder;        ///<! Basket indices sorted by distance from the reader's entry
+   std::atomic<Int_t>    fUnzipNext;         ///<! Next position in fUnzipOrder to be claimed by an unzip task
+   std::atomic<Int_t>    fNActiveTasks;      ///<! Number of unzip tasks currently running
+   std::atomic<Long64_t> fUnzipMemory;       ///<! Bytes held by unzipped baskets not yet consumed
+   std::atomic<Long64_t> fUnzipMemoryPeak;   ///<! Maximum value reached by fUnzipMemory
+
    static Double_t fgRelBuffSize; ///< This is the percentage of the TTreeCacheUnzip that will be used
 
    // Members use to keep statistics
    Int_t       fNFound;           ///<! number of blocks that were found in the cache
    Int_t       fNMissed;          ///<! number of blocks that were not found in the cache and were unzipped
    Int_t       fNStalls;          ///<! number of hits which caused a stall
-   Int_t       fNUnzip;           ///<! number of blocks that were unzipped
+   std::atomic<Int_t> fNUnzip;    ///<! number of blocks that were unzipped
+   std::atomic<Int_t> fNCapped;   ///<! number of times an unzip task stopped because of the memory cap
+   Int_t       fNStolen;          ///<! number of blocks claimed and unzipped directly by the reading thread
+   Int_t       fNRestarted;       ///<! number of unzip tasks started again after stopping at the memory cap
 
 private:
    TTreeCacheUnzip(const TTreeCacheUnzip &);            //this class cannot be copied
@@ -114,6 +124,11 @@ private:
 
    // Private methods
    void  Init();
+   Int_t ClaimNextBasket();
+   void  SortBasketsByDistance(Long64_t entry);
+#ifdef R__USE_IMT
+   void  UnzipTask();
+#endif
 
 public:
    TTreeCacheUnzip();
@@ -139,6 +154,7 @@ public:
 #endif
    Int_t          GetRecordHeader(char *buf, Int_t maxbytes, Int_t &nbytes, Int_t &objlen, Int_t &keylen);
    virtual Int_t  GetUnzipBuffer(char **buf, Long64_t pos, Int_t len, Bool_t *free);
+   Long64_t       GetUnzipBufferSize() const { return fUnzipBufferSize; }
    Int_t          GetUnzipGroupSize() { return fUnzipGroupSize; }
    virtual void   ResetCache();
    virtual Int_t  SetBufferSize(Int_t buffersize);
@@ -152,6 +168,12 @@ public:
    Int_t  GetNUnzip() { return fNUnzip; }
    Int_t  GetNMissed(){ return fNMissed; }
    Int_t  GetNFound() { return fNFound; }
+   Int_t  GetNStalls() const { return fNStalls; }
+   Int_t  GetNStolen() const { return fNStolen; }
+   Int_t  GetNCapped() const { return fNCapped; }
+   Int_t  GetNRestarted() const { return fNRestarted; }
+   Long64_t GetUnzipMemory() const { return fUnzipMemory; }
+   Long64_t GetUnzipMemoryPeak() const { return fUnzipMemoryPeak; }
 
    void Print(Option_t* option = "") const;
 
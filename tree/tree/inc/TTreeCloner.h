@@ -31,6 +31,7 @@ class TTreeCloner {
 
    Bool_t     fIsValid;
    Bool_t     fNeedConversion;   ///< True if the fast merge is not possible but a slow merge might possible.
+   Bool_t     fRecompress;       ///< True if the baskets are recompressed with the settings of the output branches.
    UInt_t     fOptions;
    TTree     *fFromTree;
    TTree     *fToTree;
@@ -83,6 +84,7 @@ class TTreeCloner {
    void CreateCache();
    UInt_t FillCache(UInt_t from);
    void RestoreCache();
+   void WriteBasketsRecompressed();
 
 private:
    TTreeCloner(const TTreeCloner&) = delete;
@@ -27,6 +27,7 @@
 #include "RZip.h"
 
 #include <bitset>
+#include <vector>
 
 const UInt_t kDisplacementMask = 0xFF000000;  // In the streamer the two highest bytes of
                                               // the fEntryOffset are used to stored displacement.
@@ -158,6 +159,92 @@ Long64_t TBasket::CopyTo(TFile *to)
    return nBytes>0 ? nBytes : -1;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Recompress the content of a basket loaded with LoadBasketBuffers using the
+/// given compression settings (see ROOT::RCompressionSetting).
+///
+/// Only the buffers of this basket are used, so distinct baskets can be
+/// recompressed concurrently.  The key header is rewritten with the new number
+/// of bytes by the next call to CopyTo.
+/// Returns 0 in case of success and 1 if the basket could not be decompressed,
+/// in which case the buffers are left untouched.
+
+Int_t TBasket::Recompress(Int_t settings)
+{
+   if (!fBufferRef || fObjlen <= 0)
+      return 1;
+
+   const Int_t nin = fNbytes - fKeylen;
+   char *rawBuffer = fBufferRef->Buffer();
+
+   // Uncompress the object unless it was stored as is.
+   std::vector<char> uncompressed;
+   const char *objbuf = rawBuffer + fKeylen;
+   if (fObjlen > nin) {
+      uncompressed.resize(fObjlen);
+      UChar_t *src = (UChar_t *)rawBuffer + fKeylen;
+      UChar_t *tgt = (UChar_t *)uncompressed.data();
+      Int_t nintot = 0, noutot = 0;
+      while (noutot < fObjlen && nintot < nin) {
+         Int_t nzip, nbuf, nout = 0;
+         if (R__unzip_header(&nzip, src, &nbuf) != 0 || nintot + nzip > nin || noutot + nbuf > fObjlen)
+            break;
+         R__unzip(&nzip, src, &nbuf, tgt, &nout);
+         if (!nout)
+            break;
+         src += nzip;
+         tgt += nout;
+         nintot += nzip;
+         noutot += nout;
+      }
+      if (noutot != fObjlen) {
+         Error("Recompress", "Inconsistency found in basket (fNbytes=%d, fKeylen=%d, fObjlen=%d, noutot=%d)", fNbytes,
+               fKeylen, fObjlen, noutot);
+         return 1;
+      }
+      objbuf = uncompressed.data();
+   }
+
+   Int_t cxlevel = settings % 100;
+   auto cxAlgorithm = static_cast<ROOT::RCompressionSetting::EAlgorithm::EValues>(settings / 100);
+   std::vector<char> compressed;
+   Int_t noutot = 0;
+   if (cxlevel > 0) {
+      Int_t nbuffers = 1 + (fObjlen - 1) / kMAXZIPBUF;
+      compressed.resize(fObjlen + 9 * nbuffers + 28);
+      char *bufcur = compressed.data();
+      for (Int_t i = 0, nzip = 0; i < nbuffers; ++i, nzip += kMAXZIPBUF) {
+         Int_t bufmax = (i == nbuffers - 1) ? fObjlen - nzip : kMAXZIPBUF;
+         Int_t nout = 0;
+         R__zipMultipleAlgorithm(cxlevel, &bufmax, const_cast<char *>(objbuf) + nzip, &bufmax, bufcur, &nout,
+                                 cxAlgorithm);
+         // As in WriteBuffer, store the object uncompressed if it does not shrink.
+         if (nout == 0 || noutot + nout >= fObjlen) {
+            noutot = 0;
+            break;
+         }
+         bufcur += nout;
+         noutot += nout;
+      }
+   }
+
+   const char *payload = compressed.data();
+   if (noutot == 0) {
+      if (fObjlen == nin)
+         return 0; // Already stored uncompressed.
+      noutot = fObjlen;
+      payload = objbuf;
+   }
+
+   fBufferRef->SetWriteMode();
+   if (fBufferRef->BufferSize() < fKeylen + noutot)
+      fBufferRef->Expand(fKeylen + noutot);
+   memcpy(fBufferRef->Buffer() + fKeylen, payload, noutot);
+   fBufferRef->SetReadMode();
+   fNbytes = fKeylen + noutot;
+   return 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ///  Delete fEntryOffset array.
 
@@ -491,6 +578,24 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
       }
    }
 
+   // Compressed baskets of memory mapped files are decompressed straight from
+   // the mapping, without reading them into the compressed buffer first.
+   rawCompressedBuffer = nullptr;
+   if (fBranch->GetCompressionLevel() != 0 && file->IsMapped()) {
+      R__LOCKGUARD_IMT(gROOTMutex); // Lock for parallel TTree I/O
+      rawCompressedBuffer = file->GetMappedBuffer(pos, len);
+   }
+   if (rawCompressedBuffer) {
+      fBranch->GetTree()->IncrementTotalBuffers(-fBufferSize);
+      TBufferFile mappedRef(TBuffer::kRead, len, rawCompressedBuffer, kFALSE);
+      mappedRef.SetParent(file);
+      Streamer(mappedRef);
+      if (IsZombie()) {
+         return 1;
+      }
+      goto Unzip;
+   }
+
    // Determine which buffer to use, so that we can avoid a memcpy in case of
    // the basket was not compressed.
    TBuffer* readBufferRef;
@@ -577,6 +682,7 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
       }
    }
 
+Unzip:
    // Initialize buffer to hold the uncompressed data
    // Note that in previous versions we didn't allocate buffers until we verified
    // the zip headers; this is no longer beforehand as the buffer lifetime is scoped
@@ -3468,6 +3468,10 @@ namespace {
 ///
 /// See TTree::CloneTree for a detailed explanation of the semantics of these 3 options.
 ///
+/// If 'option' also contains 'Recompress', the baskets are decompressed and compressed
+/// again with the compression settings of the branches of this tree, still without being
+/// unstreamed; when the implicit multi-threading is enabled, this is done in parallel.
+///
 /// If the tree or any of the underlying tree of the chain has an index, that index and any
 /// index in the subsequent underlying TTree objects will be merged.
 ///
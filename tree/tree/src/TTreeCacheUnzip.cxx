@@ -29,8 +29,10 @@ A TTreeCache which exploits parallelized decompression of its own content.
 #include "TMutex.h"
 #include "ROOT/RMakeUnique.hxx"
 
+#include <algorithm>
+#include <numeric>
+
 #ifdef R__USE_IMT
-#include "ROOT/TThreadExecutor.hxx"
 #include "ROOT/TTaskGroup.hxx"
 #endif
 
@@ -113,6 +115,14 @@ void TTreeCacheUnzip::UnzipState::Reset(Int_t oldSize, Int_t newSize) {
    fUnzipStatus = aUnzipStatus;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Give back a basket claimed by a task which could not unzip it, so that
+/// the main thread can still claim it.
+
+void TTreeCacheUnzip::UnzipState::SetUntouched(Int_t index) {
+   fUnzipStatus[index].store((Byte_t)kUntouched);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Set cache as finished. 
 /// There are three scenarios that a basket is set as finished:
@@ -162,10 +172,17 @@ TTreeCacheUnzip::TTreeCacheUnzip() : TTreeCache(),
    fNseekMax(0),
    fUnzipGroupSize(0),
    fUnzipBufferSize(0),
+   fUnzipNext(0),
+   fNActiveTasks(0),
+   fUnzipMemory(0),
+   fUnzipMemoryPeak(0),
    fNFound(0),
    fNMissed(0),
    fNStalls(0),
-   fNUnzip(0)
+   fNUnzip(0),
+   fNCapped(0),
+   fNStolen(0),
+   fNRestarted(0)
 {
    // Default Constructor.
    Init();
@@ -181,10 +198,17 @@ TTreeCacheUnzip::TTreeCacheUnzip(TTree *tree, Int_t buffersize) : TTreeCache(tre
    fNseekMax(0),
    fUnzipGroupSize(0),
    fUnzipBufferSize(0),
+   fUnzipNext(0),
+   fNActiveTasks(0),
+   fUnzipMemory(0),
+   fUnzipMemoryPeak(0),
    fNFound(0),
    fNMissed(0),
    fNStalls(0),
-   fNUnzip(0)
+   fNUnzip(0),
+   fNCapped(0),
+   fNStolen(0),
+   fNRestarted(0)
 {
    Init();
 }
@@ -233,6 +257,12 @@ void TTreeCacheUnzip::Init()
 
 TTreeCacheUnzip::~TTreeCacheUnzip()
 {
+#ifdef R__USE_IMT
+   if (fUnzipTaskGroup) {
+      fUnzipTaskGroup->Cancel();
+      fUnzipTaskGroup.reset();
+   }
+#endif
    ResetCache();
    fUnzipState.Clear(fNseekMax);
 }
@@ -306,6 +336,7 @@ Bool_t TTreeCacheUnzip::FillBuffer()
 
    //clear cache buffer
    TFileCacheRead::Prefetch(0,0);
+   fBasketEntry.clear();
 
    //store baskets
    for (Int_t i = 0; i < fNbranches; i++) {
@@ -337,6 +368,9 @@ Bool_t TTreeCacheUnzip::FillBuffer()
          fNReadPref++;
 
          TFileCacheRead::Prefetch(pos, len);
+         // Remember where the basket starts so that the unzip tasks can
+         // serve the baskets closest to the reader first.
+         fBasketEntry.push_back(entries[j]);
       }
       if (gDebug > 0) printf("Entry: %lld, registering baskets branch %s, fEntryNext=%lld, fNseek=%d, fNtot=%d\n", entry, ((TBranch*)fBranches->UncheckedAt(i))->GetName(), fEntryNext, fNseek, fNtot);
    }
@@ -500,7 +534,17 @@ Int_t TTreeCacheUnzip::GetRecordHeader(char *buf, Int_t maxbytes, Int_t &nbytes,
 void TTreeCacheUnzip::ResetCache()
 {
    // Reset all the lists and wipe all the chunks
-   fCycle++;
+   {
+      // The unzip tasks may still be claiming baskets from the queue and
+      // accounting their memory. We cannot wait for them here: this is called
+      // by FillBuffer with fIOMutex held, which the tasks need to read their
+      // baskets. Take the lock they claim and account under instead.
+      R__LOCKGUARD(fIOMutex.get());
+      fCycle++;
+      fUnzipMemory = 0;
+      fUnzipOrder.clear();
+      fUnzipNext = 0;
+   }
    fUnzipState.Clear(fNseekMax);
 
    if(fNseekMax < fNseek){
@@ -573,7 +617,7 @@ Int_t TTreeCacheUnzip::UnzipCache(Int_t index)
    // I.e. mark it as done but set the pointer to 0
    // This block will be unzipped synchronously in the main thread
    // TODO: ROOT internally breaks zipped buffers into 16MB blocks, we can probably still unzip in parallel.
-   if (len > 4 * fUnzipBufferSize) {
+   if (fUnzipBufferSize > 0 && len > 4 * fUnzipBufferSize) {
            if (gDebug > 0)
                    Info("UnzipCache", "Block %d is too big, skipping.", index);
 
@@ -582,18 +626,49 @@ Int_t TTreeCacheUnzip::UnzipCache(Int_t index)
            return 0;
    }
 
+   // Reserve the memory of the unzipped basket before unzipping it, so that the
+   // baskets held by the cache never exceed fUnzipBufferSize. A basket bigger
+   // than the cap is only unzipped when nothing else is held. The accounting
+   // is done under fIOMutex, as ResetCache starts a new cycle under it.
+   {
+      R__LOCKGUARD(fIOMutex.get());
+      if (myCycle != fCycle) {
+         if (locbuff) delete [] locbuff;
+         return 1;
+      }
+      Long64_t mem = fUnzipMemory.load();
+      if (fUnzipBufferSize > 0 && mem > 0 && mem + len > fUnzipBufferSize) {
+         // Give the basket back: the reader will unzip it when it needs it.
+         fUnzipState.SetUntouched(index);
+         if (locbuff) delete [] locbuff;
+         return 2;
+      }
+      mem = (fUnzipMemory += len);
+      Long64_t peak = fUnzipMemoryPeak.load();
+      while (mem > peak && !fUnzipMemoryPeak.compare_exchange_weak(peak, mem)) {}
+   }
+   auto release = [&](Long64_t bytes) {
+      R__LOCKGUARD(fIOMutex.get());
+      if (myCycle == fCycle)
+         fUnzipMemory -= bytes;
+   };
+
    // Unzip it into a new blk
    char *ptr = 0;
    Int_t loclen = UnzipBuffer(&ptr, locbuff);
    if ((loclen > 0) && (loclen == objlen + keylen)) {
       if ((myCycle != fCycle) || !fIsTransferred) {
+         release(len);
          fUnzipState.SetFinished(index); // Set it as not done, main thread will take charge
          if (locbuff) delete [] locbuff;
          return 1;
       }
       fUnzipState.SetUnzipped(index, ptr, loclen); // Set it as done
       fNUnzip++;
+      if (loclen != len)
+         release(len - loclen);
    } else {
+      release(len);
       fUnzipState.SetFinished(index); // Set it as not done, main thread will take charge
    }
 
@@ -601,52 +676,104 @@ Int_t TTreeCacheUnzip::UnzipCache(Int_t index)
    return 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Order the baskets registered in the cache by the distance between their
+/// first entry and the given entry, so that the baskets the reader will ask
+/// for first are unzipped first. Baskets which already contain the entry have
+/// distance 0. Ties are resolved by file position to keep the reads forward.
+/// If the basket entries are not known (the cache was filled by another
+/// code path), the registration order is kept.
+
+void TTreeCacheUnzip::SortBasketsByDistance(Long64_t entry)
+{
+   fUnzipOrder.resize(fNseek);
+   std::iota(fUnzipOrder.begin(), fUnzipOrder.end(), 0);
+   if ((Int_t)fBasketEntry.size() == fNseek) {
+      auto distance = [&](Int_t i) { return std::max(fBasketEntry[i] - entry, Long64_t(0)); };
+      std::stable_sort(fUnzipOrder.begin(), fUnzipOrder.end(), [&](Int_t a, Int_t b) {
+         Long64_t da = distance(a);
+         Long64_t db = distance(b);
+         if (da != db)
+            return da < db;
+         return fSeek[a] < fSeek[b];
+      });
+   }
+   fUnzipNext = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Claim the next untouched basket in priority order.
+/// Returns the basket index, now in progress and owned by the caller, or -1
+/// if all the baskets have been claimed already.
+
+Int_t TTreeCacheUnzip::ClaimNextBasket()
+{
+   // ResetCache may clear the queue from the reading thread.
+   R__LOCKGUARD(fIOMutex.get());
+   const Int_t n = fUnzipOrder.size();
+   while (true) {
+      Int_t next = fUnzipNext.fetch_add(1);
+      if (next >= n)
+         return -1;
+      Int_t idx = fUnzipOrder[next];
+      if (idx < fNseek && fUnzipState.TryUnzipping(idx))
+         return idx;
+   }
+}
+
 #ifdef R__USE_IMT
 ////////////////////////////////////////////////////////////////////////////////
-/// We create a TTaskGroup and asynchronously maps each group of baskets(> 100 kB in total)
-/// to a task. In TTaskGroup, we use TThreadExecutor to do the actually work of unzipping 
-/// a group of basket. The purpose of creating TTaskGroup is to avoid competing with main thread.
+/// Body of an unzip task: unzip baskets one at a time, nearest to the reader
+/// first, until there is nothing left, the cache is invalidated, or the
+/// next basket does not fit in fUnzipBufferSize next to the unzipped but not
+/// yet consumed ones. In the latter case the task stops and new ones are
+/// started by GetUnzipBuffer as soon as the reader has released memory.
 
-Int_t TTreeCacheUnzip::CreateTasks()
+void TTreeCacheUnzip::UnzipTask()
 {
-   auto mapFunction = [&]() {
-      auto unzipFunction = [&](const std::vector<Int_t> &indices) {
-         // If cache is invalidated and we should return immediately.
-         if (!fIsTransferred) return nullptr;
-
-         for (auto ii : indices) {
-            if(fUnzipState.TryUnzipping(ii)) {
-               Int_t res = UnzipCache(ii);
-               if(res)
-                  if (gDebug > 0)
-                     Info("UnzipCache", "Unzipping failed or cache is in learning state");
-            }
-         }
-         return nullptr;
-      };
-
-      Int_t accusz = 0;
-      std::vector<std::vector<Int_t>> basketIndices;
-      std::vector<Int_t> indices;
-      if (fUnzipGroupSize <= 0) fUnzipGroupSize = 102400;
-      for (Int_t i = 0; i < fNseek; i++) {
-         while (accusz < fUnzipGroupSize) {
-            accusz += fSeekLen[i];
-            indices.push_back(i);
-            i++;
-            if (i >= fNseek) break;
-         }
-         if (i < fNseek) i--;
-         basketIndices.push_back(indices);
-         indices.clear();
-         accusz = 0;
+   const Int_t myCycle = fCycle;
+   while (fIsTransferred && myCycle == fCycle) {
+      if (fUnzipBufferSize > 0 && fUnzipMemory.load() >= fUnzipBufferSize) {
+         fNCapped++;
+         break;
       }
-      ROOT::TThreadExecutor pool;
-      pool.Foreach(unzipFunction, basketIndices);
-   };
+      Int_t idx = ClaimNextBasket();
+      if (idx < 0)
+         break;
+      Int_t res = UnzipCache(idx);
+      if (res == 2) {
+         fNCapped++;
+         break;
+      }
+      if (res && gDebug > 0)
+         Info("UnzipCache", "Unzipping failed or cache is in learning state");
+   }
+   fNActiveTasks--;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// We create a TTaskGroup and start as many unzip tasks as there are threads
+/// in the IMT pool. The tasks share a single queue of baskets sorted by their
+/// distance from the entry currently read, and each task claims the baskets
+/// one by one: the fastest tasks naturally take over the work of the slower
+/// ones, and the reader can claim any basket it needs right away
+/// (see GetUnzipBuffer).
 
+Int_t TTreeCacheUnzip::CreateTasks()
+{
+   TTree *tree = fNbranches > 0 ? ((TBranch*)fBranches->UncheckedAt(0))->GetTree() : nullptr;
+   Long64_t entry = tree ? tree->GetReadEntry() : fEntryCurrent;
+   if (entry < fEntryCurrent) entry = fEntryCurrent;
+
+   // Destroying the previous group waits for its tasks to finish.
    fUnzipTaskGroup.reset(new ROOT::Experimental::TTaskGroup());
-   fUnzipTaskGroup->Run(mapFunction);
+   fNActiveTasks = 0;
+   SortBasketsByDistance(entry);
+   const Int_t nTasks = std::max(1, std::min((Int_t)ROOT::GetThreadPoolSize(), fNseek));
+   for (Int_t i = 0; i < nTasks; ++i) {
+      fNActiveTasks++;
+      fUnzipTaskGroup->Run([this]() { UnzipTask(); });
+   }
 
    return 0;
 }
@@ -677,6 +804,7 @@ Int_t TTreeCacheUnzip::GetUnzipBuffer(char **buf, Long64_t pos, Int_t len, Bool_
    // better to be done in the main thread.
 
    Int_t myCycle = fCycle;
+   Bool_t claimed = kFALSE;
 
    if (fParallel && !fIsLearning) {
 
@@ -694,75 +822,72 @@ Int_t TTreeCacheUnzip::GetUnzipBuffer(char **buf, Long64_t pos, Int_t len, Bool_
          // The buffer is, at minimum, in the file cache. We must know its index in the requests list
          // In order to get its info
          Int_t seekidx = fSeekIndex[loc];
+         Bool_t wasUnzipped = fUnzipState.IsUnzipped(seekidx);
 
-         do {
+         // If no task picked up the basket yet, the reader claims it and
+         // unzips it directly into the destination buffer below, instead of
+         // waiting for its turn in the task queue.
+         if (fUnzipState.TryUnzipping(seekidx)) {
+            fUnzipState.SetMissed(seekidx);
+            fNStolen++;
+            claimed = kTRUE;
+            seekidx = -1;
+         }
 
-            // If the block is ready we get it immediately.
-            // And also we don't have to alloc the blks. This is supposed to be
-            // the main thread of the app.
-            if (fUnzipState.IsUnzipped(seekidx)) {
-               if(!(*buf)) {
-                  *buf = fUnzipState.fUnzipChunks[seekidx].get();
-                  fUnzipState.fUnzipChunks[seekidx].release();
-                  *free = kTRUE;
+         while (seekidx >= 0 && fUnzipState.IsProgress(seekidx)) {
+            // The requested basket is being unzipped by a background task:
+            // meanwhile we help with the next basket in the queue, if it fits.
+            if (fEmpty && (fUnzipBufferSize <= 0 || fUnzipMemory.load() < fUnzipBufferSize)) {
+               Int_t reqi = ClaimNextBasket();
+               if (reqi < 0) {
+                  fEmpty = kFALSE;
                } else {
-                  memcpy(*buf, fUnzipState.fUnzipChunks[seekidx].get(), fUnzipState.fUnzipLen[seekidx]);
-                  fUnzipState.fUnzipChunks[seekidx].reset();
-                  *free = kFALSE;
+                  UnzipCache(reqi);
                }
-
-               fNFound++;
-               return fUnzipState.fUnzipLen[seekidx];
             }
 
-            // If the requested basket is being unzipped by a background task, we try to steal a blk to unzip.
-            Int_t reqi = -1;
-            
-            if (fUnzipState.IsProgress(seekidx)) {
-               if (fEmpty) {
-                  for (Int_t ii = 0; ii < fNseek; ++ii) {
-                     Int_t idx = (seekidx + 1 + ii) % fNseek;
-                     if (fUnzipState.IsUntouched(idx)) {
-                        if(fUnzipState.TryUnzipping(idx)) {
-                           reqi = idx;
-                           break;
-                        }
-                     }
-                  }
-                  if (reqi < 0) {
-                     fEmpty = kFALSE;
-                  } else {
-                     UnzipCache(reqi);
-                  }
-               }
- 
-               if ( myCycle != fCycle ) {
-                  if (gDebug > 0)
-                     Info("GetUnzipBuffer", "Sudden paging Break!!! fNseek: %d, fIsLearning:%d",
-                          fNseek, fIsLearning);
-
-                  seekidx = -1;
-                  break;
-               }
-            }
+            if ( myCycle != fCycle ) {
+               if (gDebug > 0)
+                  Info("GetUnzipBuffer", "Sudden paging Break!!! fNseek: %d, fIsLearning:%d",
+                       fNseek, fIsLearning);
 
-         } while (fUnzipState.IsProgress(seekidx));
+               seekidx = -1;
+               break;
+            }
+         }
 
-         // Here the block is not pending. It could be done or aborted or not yet being processed.
+         // Here the block is not pending. It could be done or aborted or claimed by us.
          if ( (seekidx >= 0) && (fUnzipState.IsUnzipped(seekidx)) ) {
+            Int_t unzipLen = fUnzipState.fUnzipLen[seekidx];
             if(!(*buf)) {
-              *buf = fUnzipState.fUnzipChunks[seekidx].get();
+               *buf = fUnzipState.fUnzipChunks[seekidx].get();
                fUnzipState.fUnzipChunks[seekidx].release();
                *free = kTRUE;
             } else {
-               memcpy(*buf, fUnzipState.fUnzipChunks[seekidx].get(), fUnzipState.fUnzipLen[seekidx]);
+               memcpy(*buf, fUnzipState.fUnzipChunks[seekidx].get(), unzipLen);
                fUnzipState.fUnzipChunks[seekidx].reset();
                *free = kFALSE;
             }
+            fUnzipMemory -= unzipLen;
 
-            fNStalls++;
-            return fUnzipState.fUnzipLen[seekidx];
-         } else {
+            if (wasUnzipped)
+               fNFound++;
+            else
+               fNStalls++;
+#ifdef R__USE_IMT
+            // Restart the tasks which stopped because of the memory cap, as many as CreateTasks started.
+            if (fUnzipTaskGroup && fUnzipNext.load() < (Int_t)fUnzipOrder.size() &&
+                (fUnzipBufferSize <= 0 || fUnzipMemory.load() < fUnzipBufferSize)) {
+               const Int_t nTasks = std::max(1, std::min((Int_t)ROOT::GetThreadPoolSize(), fNseek));
+               while (fNActiveTasks.load() < nTasks) {
+                  fNActiveTasks++;
+                  fNRestarted++;
+                  fUnzipTaskGroup->Run([this]() { UnzipTask(); });
+               }
+            }
+#endif
+            return unzipLen;
+         } else if (seekidx >= 0) {
             // This is a complete miss. We want to avoid the background tasks
             // to try unzipping this block in the future.
             fUnzipState.SetMissed(seekidx);
@@ -814,7 +939,8 @@ Int_t TTreeCacheUnzip::GetUnzipBuffer(char **buf, Long64_t pos, Int_t len, Bool_
       *free = kTRUE;
    }
 
-   if (!fIsLearning) {
+   // The baskets claimed by the reader are counted in fNStolen.
+   if (!fIsLearning && !claimed) {
       fNMissed++;
    }
    
@@ -831,7 +957,10 @@ void TTreeCacheUnzip::SetUnzipRelBufferSize(Float_t relbufferSize)
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Sets the size for the unzipping cache... by default it should be
-/// two times the size of the prefetching cache
+/// two times the size of the prefetching cache.
+/// This is also the cap on the memory held by baskets unzipped in advance
+/// and not yet consumed: the unzip tasks pause when it is reached and are
+/// resumed once the reader has caught up. A value <= 0 removes the cap.
 
 void TTreeCacheUnzip::SetUnzipBufferSize(Long64_t bufferSize)
 {
@@ -945,10 +1074,14 @@ void  TTreeCacheUnzip::Print(Option_t* option) const {
 
    printf("******TreeCacheUnzip statistics for file: %s ******\n",fFile->GetName());
    printf("Max allowed mem for pending buffers: %lld\n", fUnzipBufferSize);
-   printf("Number of blocks unzipped by threads: %d\n", fNUnzip);
+   printf("Peak mem used by pending buffers: %lld\n", fUnzipMemoryPeak.load());
+   printf("Number of blocks unzipped by threads: %d\n", fNUnzip.load());
    printf("Number of hits: %d\n", fNFound);
    printf("Number of stalls: %d\n", fNStalls);
    printf("Number of misses: %d\n", fNMissed);
+   printf("Number of blocks claimed by the reader: %d\n", fNStolen);
+   printf("Number of task stops due to mem cap: %d\n", fNCapped.load());
+   printf("Number of tasks restarted after mem cap: %d\n", fNRestarted);
 
    TTreeCache::Print(option);
 }
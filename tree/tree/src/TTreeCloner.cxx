@@ -37,6 +37,14 @@ Class implementing or helping  the various TTree cloning method
 #include "snprintf.h"
 
 #include <algorithm>
+#include <memory>
+#include <vector>
+
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#include "ROOT/TSeq.hxx"
+#include "TROOT.h"
+#endif
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -100,11 +108,18 @@ Bool_t TTreeCloner::CompareEntry::operator()(UInt_t i1, UInt_t i2)
 /// This means that on the file the baskets will be in the order
 /// in which they will be needed when reading the whole tree
 /// sequentially.
+///
+/// If 'method' contains 'Recompress', the baskets are decompressed and
+/// compressed again with the compression settings of the output
+/// branches instead of being copied as is.  The basket boundaries are
+/// preserved, so the other properties of the fast cloning are kept.
+/// See WriteBasketsRecompressed.
 
 TTreeCloner::TTreeCloner(TTree *from, TTree *to, Option_t *method, UInt_t options) :
    fWarningMsg(),
    fIsValid(kTRUE),
    fNeedConversion(kFALSE),
+   fRecompress(kFALSE),
    fOptions(options),
    fFromTree(from),
    fToTree(to),
@@ -136,6 +151,7 @@ TTreeCloner::TTreeCloner(TTree *from, TTree *to, Option_t *method, UInt_t option
       //::Info("TTreeCloner::TTreeCloner","use: kSortBasketsByOffset");
       fCloneMethod = TTreeCloner::kSortBasketsByOffset;
    }
+   fRecompress = opt.Contains("recompress");
    if (fToTree) fToStartEntries = fToTree->GetEntries();
 
    if (fFromTree == nullptr) {
@@ -686,6 +702,11 @@ UInt_t TTreeCloner::FillCache(UInt_t from)
 
 void TTreeCloner::WriteBaskets()
 {
+   if (fRecompress) {
+      WriteBasketsRecompressed();
+      return;
+   }
+
    TBasket *basket = new TBasket();
    for(UInt_t j = 0, notCached = 0; j<fMaxBaskets; ++j) {
       TBranch *from = (TBranch*)fFromBranches.UncheckedAt( fBasketBranchNum[ fBasketIndex[j] ] );
@@ -722,3 +743,119 @@ void TTreeCloner::WriteBaskets()
    }
    delete basket;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the compression settings effectively used for the baskets of the
+/// branch, resolving the settings inherited from the file.
+
+static Int_t R__GetEffectiveCompression(TBranch *branch, TFile *file)
+{
+   Int_t settings = branch->GetCompressionSettings();
+   if (settings < 0 && file)
+      settings = file->GetCompressionSettings();
+   // All the algorithms are equivalent when not compressing.
+   return settings % 100 == 0 ? 0 : settings;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Transfer the baskets from the 'from' tree to the 'to' tree, recompressing
+/// them with the compression settings of the output branches.
+///
+/// The baskets are handled in batches of at most 64MB of uncompressed data.
+/// The compressed buffers of a batch are read sequentially (using the file
+/// cache), decompressed and compressed again concurrently when the implicit
+/// multi-threading is enabled, and finally written sequentially in the order
+/// selected by the cloning method.  Baskets whose input and output compression
+/// settings already agree are copied as is.
+
+void TTreeCloner::WriteBasketsRecompressed()
+{
+   constexpr Long64_t kMaxBatchBytes = 64 * 1024 * 1024;
+
+   struct BasketToCopy {
+      TBasket *fBasket;
+      TBranch *fTo;
+      Long64_t fStartEntry;
+      Int_t    fSettings; ///< Output compression settings, or -1 to copy the basket as is.
+      Int_t    fStatus;
+   };
+   std::vector<std::unique_ptr<TBasket>> baskets;
+   std::vector<BasketToCopy> batch;
+
+   auto recompress = [&batch](UInt_t i) {
+      BasketToCopy &b = batch[i];
+      if (b.fSettings >= 0)
+         b.fStatus = b.fBasket->Recompress(b.fSettings);
+   };
+
+   UInt_t j = 0, notCached = 0;
+   while (j < fMaxBaskets) {
+      // Read the compressed buffers of the next batch.
+      batch.clear();
+      Long64_t batchBytes = 0;
+      for (; j < fMaxBaskets && batchBytes < kMaxBatchBytes; ++j) {
+         TBranch *from = (TBranch*)fFromBranches.UncheckedAt( fBasketBranchNum[ fBasketIndex[j] ] );
+         TBranch *to   = (TBranch*)fToBranches.UncheckedAt( fBasketBranchNum[ fBasketIndex[j] ] );
+         Int_t index = fBasketNum[ fBasketIndex[j] ];
+         Long64_t pos = from->GetBasketSeek(index);
+         if (pos == 0)
+            break;
+
+         TFile *tofile = to->GetFile(0);
+         TFile *fromfile = from->GetFile(0);
+         if (fFileCache && j >= notCached) {
+            notCached = FillCache(notCached);
+         }
+         if (batch.size() == baskets.size())
+            baskets.emplace_back(new TBasket());
+         TBasket *basket = baskets[batch.size()].get();
+         if (from->GetBasketBytes()[index] == 0) {
+            from->GetBasketBytes()[index] = basket->ReadBasketBytes(pos, fromfile);
+         }
+         Int_t len = from->GetBasketBytes()[index];
+         basket->LoadBasketBuffers(pos,len,fromfile,fFromTree);
+
+         Int_t settings = R__GetEffectiveCompression(to, tofile);
+         if (settings == R__GetEffectiveCompression(from, fromfile))
+            settings = -1;
+         batch.push_back({basket, to, fToStartEntries + from->GetBasketEntry()[index], settings, 0});
+         batchBytes += basket->GetObjlen();
+      }
+
+#ifdef R__USE_IMT
+      if (ROOT::IsImplicitMTEnabled() && batch.size() > 1) {
+         ROOT::TThreadExecutor pool;
+         pool.Foreach(recompress, ROOT::TSeqU(batch.size()));
+      } else
+#endif
+      {
+         for (UInt_t i = 0; i < batch.size(); ++i)
+            recompress(i);
+      }
+
+      for (auto &b : batch) {
+         if (b.fStatus != 0) {
+            Warning("TTreeCloner::WriteBaskets", "Could not recompress a basket of the branch %s, copying it as is.",
+                    b.fTo->GetName());
+         }
+         b.fBasket->IncrementPidOffset(fPidOffset);
+         b.fBasket->CopyTo(b.fTo->GetFile(0));
+         b.fTo->AddBasket(*b.fBasket, kTRUE, b.fStartEntry);
+      }
+
+      // Baskets still in memory are written by the output branch itself.
+      if (j < fMaxBaskets && batch.empty()) {
+         TBranch *from = (TBranch*)fFromBranches.UncheckedAt( fBasketBranchNum[ fBasketIndex[j] ] );
+         TBranch *to   = (TBranch*)fToBranches.UncheckedAt( fBasketBranchNum[ fBasketIndex[j] ] );
+         Int_t index = fBasketNum[ fBasketIndex[j] ];
+         TBasket *frombasket = from->GetBasket( index );
+         if (frombasket && frombasket->GetNevBuf()>0) {
+            TBasket *tobasket = (TBasket*)frombasket->Clone();
+            tobasket->SetBranch(to);
+            to->AddBasket(*tobasket, kFALSE, fToStartEntries+from->GetBasketEntry()[index]);
+            to->FlushOneBasket(to->GetWriteBasket());
+         }
+         ++j;
+      }
+   }
+}
@@ -1,7 +1,9 @@
 #include "TFile.h"
 #include "TROOT.h"
+#include "TString.h"
 #include "TSystem.h"
 #include "TTree.h"
+#include "TTreeCacheUnzip.h"
 
 #include "gtest/gtest.h"
 
@@ -28,4 +30,100 @@ TEST(TTreeImplicitMT, flushBaskets)
    gSystem->Unlink(ofileName);
 }
 
+TEST(TTreeImplicitMT, parallelUnzip)
+{
+   ROOT::EnableImplicitMT();
+   const auto ofileName = "parallelUnzipMT.root";
+   const Long64_t nEntries = 20000;
+   {
+      TFile f(ofileName, "RECREATE");
+      TTree t("t", "t");
+      t.SetAutoFlush(5000);
+      int i = 0;
+      double d = 0.;
+      t.Branch("i", &i, 1000);
+      t.Branch("d", &d, 1000);
+      for (i = 0; i < nEntries; ++i) {
+         d = 0.5 * i;
+         t.Fill();
+      }
+      t.Write();
+   }
+
+   const auto oldMode = TTreeCacheUnzip::GetParallelUnzip();
+   TTreeCacheUnzip::SetParallelUnzip(TTreeCacheUnzip::kEnable);
+   {
+      TFile f(ofileName);
+      auto t = f.Get<TTree>("t");
+      t->SetCacheSize(10000000);
+      int i = -1;
+      double d = -1.;
+      t->SetBranchAddress("i", &i);
+      t->SetBranchAddress("d", &d);
+      for (Long64_t e = 0; e < nEntries; ++e) {
+         t->GetEntry(e);
+         ASSERT_EQ(i, e);
+         ASSERT_DOUBLE_EQ(d, 0.5 * e);
+      }
+      auto cache = dynamic_cast<TTreeCacheUnzip *>(f.GetCacheRead(t));
+      ASSERT_NE(cache, nullptr);
+      EXPECT_GT(cache->GetNUnzip() + cache->GetNStolen(), 0);
+   }
+   TTreeCacheUnzip::SetParallelUnzip(oldMode);
+   gSystem->Unlink(ofileName);
+}
+
+TEST(TTreeImplicitMT, parallelUnzipMemoryCap)
+{
+   ROOT::EnableImplicitMT(4);
+   const auto ofileName = "parallelUnzipMemoryCapMT.root";
+   const Long64_t nEntries = 50000;
+   const Int_t nBranches = 8;
+   {
+      TFile f(ofileName, "RECREATE");
+      TTree t("t", "t");
+      // One basket of about 40 KB per branch and cluster.
+      t.SetAutoFlush(5000);
+      double d[nBranches];
+      for (Int_t b = 0; b < nBranches; ++b)
+         t.Branch(TString::Format("d%d", b), &d[b], 128000);
+      for (Long64_t e = 0; e < nEntries; ++e) {
+         for (Int_t b = 0; b < nBranches; ++b)
+            d[b] = e + 0.1 * b;
+         t.Fill();
+      }
+      t.Write();
+   }
+
+   const auto oldMode = TTreeCacheUnzip::GetParallelUnzip();
+   TTreeCacheUnzip::SetParallelUnzip(TTreeCacheUnzip::kEnable);
+   {
+      TFile f(ofileName);
+      auto t = f.Get<TTree>("t");
+      t->SetCacheSize(10000000);
+      auto cache = dynamic_cast<TTreeCacheUnzip *>(f.GetCacheRead(t));
+      ASSERT_NE(cache, nullptr);
+      // Room for two unzipped baskets out of the eight of each cluster.
+      const Long64_t cap = 100000;
+      cache->SetUnzipBufferSize(cap);
+      double d[nBranches];
+      for (Int_t b = 0; b < nBranches; ++b)
+         t->SetBranchAddress(TString::Format("d%d", b), &d[b]);
+      for (Long64_t e = 0; e < nEntries; ++e) {
+         t->GetEntry(e);
+         for (Int_t b = 0; b < nBranches; ++b)
+            ASSERT_DOUBLE_EQ(d[b], e + 0.1 * b);
+      }
+      EXPECT_EQ(cache->GetUnzipBufferSize(), cap);
+      EXPECT_GT(cache->GetNCapped(), 0);
+      EXPECT_GT(cache->GetUnzipMemoryPeak(), 0);
+      EXPECT_LE(cache->GetUnzipMemoryPeak(), cap);
+      // After hitting the cap, more than one task was started again.
+      EXPECT_GT(cache->GetNRestarted(), 1);
+      EXPECT_GT(cache->GetNUnzip(), 0);
+   }
+   TTreeCacheUnzip::SetParallelUnzip(oldMode);
+   gSystem->Unlink(ofileName);
+}
+
 #endif // R__USE_IMT
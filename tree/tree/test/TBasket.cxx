@@ -403,3 +403,54 @@ TEST(TBasket, TestSettingIOBits)
    readEntryOffset = reinterpret_cast<Bool_t *>(reinterpret_cast<char *>(basket2) + offset);
    EXPECT_EQ(*readEntryOffset, kTRUE);
 }
+
+// Fast clone a TTree into a file with different compression settings.
+TEST(TBasket, FastCloneRecompress)
+{
+   const Int_t nentries = 20000;
+   TMemFile in("tbasket_recompress_in.root", "CREATE", "", 101);
+   TTree tin("t", "Tree to recompress");
+   Int_t idx;
+   Double_t x;
+   tin.Branch("idx", &idx, "idx/I", 4000);
+   tin.Branch("x", &x, "x/D", 8000);
+   for (idx = 0; idx < nentries; ++idx) {
+      x = 0.5 * (idx % 100);
+      tin.Fill();
+   }
+   tin.Write();
+
+   for (Int_t settings : {0, 109}) {
+      TMemFile out("tbasket_recompress_out.root", "RECREATE", "", settings);
+      TTree *tout = tin.CloneTree(0);
+      ASSERT_NE(tout, nullptr);
+      EXPECT_GT(tout->CopyEntries(&tin, -1, "fast recompress"), 0);
+      EXPECT_EQ(tout->GetEntries(), nentries);
+
+      for (const char *name : {"idx", "x"}) {
+         TBranch *bin = tin.GetBranch(name);
+         TBranch *bout = tout->GetBranch(name);
+         // The basket boundaries are preserved.
+         ASSERT_EQ(bout->GetWriteBasket(), bin->GetWriteBasket());
+         for (Int_t b = 0; b < bin->GetWriteBasket(); ++b)
+            EXPECT_EQ(bout->GetBasketEntry()[b], bin->GetBasketEntry()[b]);
+         if (settings == 0)
+            EXPECT_EQ(bout->GetZipBytes(), bout->GetTotBytes());
+         else
+            EXPECT_LT(bout->GetZipBytes(), bout->GetTotBytes());
+      }
+
+      Int_t idx2;
+      Double_t x2;
+      tout->SetBranchAddress("idx", &idx2);
+      tout->SetBranchAddress("x", &x2);
+      for (Long64_t i = 0; i < nentries; ++i) {
+         tout->GetEntry(i);
+         ASSERT_EQ(idx2, i);
+         ASSERT_EQ(x2, 0.5 * (i % 100));
+      }
+      tout->ResetBranchAddresses();
+      delete tout;
+   }
+   tin.ResetBranchAddresses();
+}
@@ -26,6 +26,7 @@
 #pragma link C++ class TTreePerfStats+;
 #pragma link C++ class TTreeReader+;
 #pragma link C++ class ROOT::Experimental::TTreeReaderFast+;
+#pragma link C++ class ROOT::Experimental::TTreeColumnExporter;
 #pragma link C++ class TTreeTableInterface;
 #pragma link C++ class TSimpleAnalysis+;
 #ifndef _MSC_VER
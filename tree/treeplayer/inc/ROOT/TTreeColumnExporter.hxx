@@ -0,0 +1,120 @@
+// @(#)root/treeplayer:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2020, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TTreeColumnExporter
+#define ROOT_TTreeColumnExporter
+
+#include "RtypesCore.h"
+#include "ROOT/RStringView.hxx"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+class TTree;
+
+namespace ROOT {
+namespace Experimental {
+
+/** \class ROOT::Experimental::TTreeColumnExporter
+    \ingroup treeplayer
+    \brief Read branches of a TTree into contiguous, columnar memory buffers.
+
+The selected branches are read with the bulk I/O API (TBranch::GetBulkRead()):
+the content of each basket is byte-swapped straight from the I/O buffer into
+its final position in the output column, without any intermediate per-entry
+container. If implicit multi-threading is enabled, groups of clusters are read
+in parallel, each task with its own TFile and TTree.
+
+Columns are stored in 64-byte aligned buffers, the layout expected by numpy
+and Apache Arrow:
+  - scalar branches (`x/F`): one value per entry;
+  - fixed-size arrays (`x[3]/F`): GetInnerSize() values per entry, row-major;
+  - variable-size arrays (`x[n]/F`): a flat buffer of values plus an array of
+    GetNEntries()+1 offsets (Long64_t), as in an Arrow LargeList.
+
+The buffers are owned by the exporter and stay valid until the next call to
+Export() or the destruction of the exporter.
+
+Only branches with a single leaf of fundamental type supporting the bulk API
+can be exported; the tree must have been written with cluster-aligned baskets
+(the default when auto-flush is active).
+
+~~~{.cpp}
+ROOT::Experimental::TTreeColumnExporter exporter("events", "data.root");
+exporter.Export({"px", "nhits", "hits_x"});
+auto &px = exporter.GetColumn("px");
+auto data = static_cast<const float *>(px.GetData());
+~~~
+*/
+class TTreeColumnExporter {
+public:
+   class TColumn {
+      friend class TTreeColumnExporter;
+
+      /// A heap buffer aligned to 64 bytes.
+      class TAlignedBuffer {
+         std::unique_ptr<char[]> fStorage;
+         char *fData = nullptr;
+
+      public:
+         void Allocate(Long64_t nbytes);
+         char *Get() const { return fData; }
+      };
+
+      std::string fName;        ///< Name of the branch
+      std::string fTypeName;    ///< Type of the leaf, e.g. "Float_t"
+      Int_t fElementSize = 0;   ///< Size in bytes of a value
+      Int_t fInnerSize = 1;     ///< Number of values per entry for fixed-size arrays
+      bool fIsJagged = false;   ///< Whether the branch is a variable-size array
+      Long64_t fNEntries = 0;   ///< Number of entries read
+      Long64_t fNValues = 0;    ///< Number of values in the data buffer
+      TAlignedBuffer fData;     ///< The values
+      TAlignedBuffer fOffsets;  ///< fNEntries+1 offsets into fData, for variable-size arrays only
+
+   public:
+      const std::string &GetName() const { return fName; }
+      const std::string &GetTypeName() const { return fTypeName; }
+      Int_t GetElementSize() const { return fElementSize; }
+      Int_t GetInnerSize() const { return fInnerSize; }
+      bool IsJagged() const { return fIsJagged; }
+      Long64_t GetNEntries() const { return fNEntries; }
+      Long64_t GetNValues() const { return fNValues; }
+      const void *GetData() const { return fData.Get(); }
+      const Long64_t *GetOffsets() const { return reinterpret_cast<const Long64_t *>(fOffsets.Get()); }
+   };
+
+private:
+   /// An entry range [first, second) starting on a basket boundary of every exported branch.
+   using Range_t = std::pair<Long64_t, Long64_t>;
+
+   std::string fTreeName;
+   std::string fFileName;
+   std::vector<TColumn> fColumns;
+
+   std::vector<Range_t> MakeRanges(TTree &tree) const;
+   void ReadRanges(TTree &tree, const std::vector<Range_t> &ranges, bool countsOnly);
+   template <typename F>
+   void ForEachRangeGroup(const std::vector<Range_t> &ranges, F &&func);
+
+public:
+   TTreeColumnExporter(std::string_view treeName, std::string_view fileName);
+
+   void Export(const std::vector<std::string> &branchNames);
+
+   const std::vector<TColumn> &GetColumns() const { return fColumns; }
+   const TColumn &GetColumn(std::string_view name) const;
+};
+
+} // namespace Experimental
+} // namespace ROOT
+
+#endif
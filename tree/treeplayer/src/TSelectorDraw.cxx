@@ -1362,7 +1362,7 @@ void TSelectorDraw::TakeAction()
    //__________________________2-D histogram_______________________
    else if (fAction ==  2) {
       TH2 *h2 = (TH2*)fObject;
-      for (i = 0; i < fNfill; i++) h2->Fill(fVal[1][i], fVal[0][i], fW[i]);
+      h2->FillN(fNfill, fVal[1], fVal[0], fW);
    }
    //__________________________Profile histogram_______________________
    else if (fAction ==  4)((TProfile*)fObject)->FillN(fNfill, fVal[1], fVal[0], fW);
@@ -1411,14 +1411,14 @@ void TSelectorDraw::TakeAction()
          else                                                                pm->Draw(fOption.Data());
       }
       if (!h2->TestBit(kCanDelete)) {
-         for (i = 0; i < fNfill; i++) h2->Fill(fVal[1][i], fVal[0][i], fW[i]);
+         h2->FillN(fNfill, fVal[1], fVal[0], fW);
       }
    }
    //__________________________3D scatter plot_______________________
    else if (fAction ==  3) {
       TH3 *h3 = (TH3*)fObject;
       if (!h3->TestBit(kCanDelete)) {
-         for (i = 0; i < fNfill; i++) h3->Fill(fVal[2][i], fVal[1][i], fVal[0][i], fW[i]);
+         h3->FillN(fNfill, fVal[2], fVal[1], fVal[0], fW);
       }
    } else if (fAction == 13) {
       TPolyMarker3D *pm3d = new TPolyMarker3D(fNfill);
@@ -1431,7 +1431,7 @@ void TSelectorDraw::TakeAction()
       pm3d->Draw();
       TH3 *h3 = (TH3*)fObject;
       if (!h3->TestBit(kCanDelete)) {
-         for (i = 0; i < fNfill; i++) h3->Fill(fVal[2][i], fVal[1][i], fVal[0][i], fW[i]);
+         h3->FillN(fNfill, fVal[2], fVal[1], fVal[0], fW);
       }
    }
    //__________________________3D scatter plot (3rd variable = col)__
@@ -1580,7 +1580,7 @@ void TSelectorDraw::TakeEstimate()
          }
          THLimitsFinder::GetLimitsFinder()->FindGoodLimits(h2, fVmin[1], fVmax[1], fVmin[0], fVmax[0]);
       }
-      for (i = 0; i < fNfill; i++) h2->Fill(fVal[1][i], fVal[0][i], fW[i]);
+      h2->FillN(fNfill, fVal[1], fVal[0], fW);
    //__________________________Profile histogram_______________________
    } else if (fAction ==  4) {
       TProfile *hp = (TProfile*)fObject;
@@ -1668,7 +1668,7 @@ void TSelectorDraw::TakeEstimate()
          }
       }
       if (h2 && !h2->TestBit(kCanDelete)) {
-         for (i = 0; i < fNfill; i++) h2->Fill(fVal[1][i], fVal[0][i], fW[i]);
+         h2->FillN(fNfill, fVal[1], fVal[0], fW);
       }
    //__________________________3D scatter plot with option col_______________________
    } else if (fAction == 33) {
@@ -1724,7 +1724,7 @@ void TSelectorDraw::TakeEstimate()
          THLimitsFinder::GetLimitsFinder()->FindGoodLimits(h3, fVmin[2], fVmax[2], fVmin[1], fVmax[1], fVmin[0], fVmax[0]);
       }
       if (fAction == 3) {
-         for (i = 0; i < fNfill; i++) h3->Fill(fVal[2][i], fVal[1][i], fVal[0][i], fW[i]);
+         h3->FillN(fNfill, fVal[2], fVal[1], fVal[0], fW);
          return;
       }
       if (!strstr(fOption.Data(), "same") && !strstr(fOption.Data(), "goff")) {
@@ -1758,7 +1758,7 @@ void TSelectorDraw::TakeEstimate()
       }
       if (!fDraw && !strstr(fOption.Data(), "goff")) pm3d->Draw();
       if (!h3->TestBit(kCanDelete)) {
-         for (i = 0; i < fNfill; i++) h3->Fill(fVal[2][i], fVal[1][i], fVal[0][i], fW[i]);
+         h3->FillN(fNfill, fVal[2], fVal[1], fVal[0], fW);
       }
 
    //__________________________2D Profile Histogram__________________
@@ -0,0 +1,333 @@
+// @(#)root/treeplayer:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2020, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "ROOT/TTreeColumnExporter.hxx"
+
+#include "RConfig.h"
+#include "ROOT/RByteSwap.hxx"
+#include "TBranch.h"
+#include "TBufferFile.h"
+#include "TFile.h"
+#include "TLeaf.h"
+#include "TROOT.h"
+#include "TTree.h"
+
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy n values of the given size from the big-endian on-disk representation
+/// in src to the native representation in dst.
+
+void CopyToHost(char *dst, const char *src, Long64_t n, Int_t size)
+{
+#ifdef R__BYTESWAP
+   switch (size) {
+   case 1: memcpy(dst, src, n); break;
+   case 2: ROOT::Internal::ByteSwap::Copy16(dst, src, n); break;
+   case 4: ROOT::Internal::ByteSwap::Copy32(dst, src, n); break;
+   case 8: ROOT::Internal::ByteSwap::Copy64(dst, src, n); break;
+   }
+#else
+   memcpy(dst, src, n * size);
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read an unsigned big-endian integer of the given size.
+
+Long64_t ReadCount(const char *src, Int_t size)
+{
+   switch (size) {
+   case 1: return *reinterpret_cast<const UChar_t *>(src);
+   case 2: { UShort_t v; CopyToHost(reinterpret_cast<char *>(&v), src, 1, 2); return v; }
+   case 4: { UInt_t v; CopyToHost(reinterpret_cast<char *>(&v), src, 1, 4); return v; }
+   default: { ULong64_t v; CopyToHost(reinterpret_cast<char *>(&v), src, 1, 8); return v; }
+   }
+}
+
+bool IsSupportedType(const std::string &typeName)
+{
+   static const char *supported[] = {"Char_t", "UChar_t", "Short_t", "UShort_t", "Int_t",    "UInt_t",
+                                     "Long_t", "ULong_t", "Long64_t", "ULong64_t", "Float_t", "Double_t"};
+   return std::find(std::begin(supported), std::end(supported), typeName) != std::end(supported);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Whether entry is the first entry of one of the baskets of the branch.
+
+bool IsBasketStart(TBranch &branch, Long64_t entry)
+{
+   const Long64_t *basketEntry = branch.GetBasketEntry();
+   const Int_t nBaskets = branch.GetWriteBasket();
+   if (entry == 0)
+      return true;
+   if (!basketEntry || nBaskets <= 0)
+      return false;
+   return std::binary_search(basketEntry, basketEntry + nBaskets, entry);
+}
+
+TBranch *GetBranchOrThrow(TTree &tree, const std::string &name)
+{
+   auto branch = tree.GetBranch(name.c_str());
+   if (!branch)
+      throw std::runtime_error("TTreeColumnExporter: branch " + name + " not found in tree " + tree.GetName());
+   return branch;
+}
+
+} // anonymous namespace
+
+namespace ROOT {
+namespace Experimental {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Allocate nbytes, aligned to 64 bytes. The previous content is released.
+
+void TTreeColumnExporter::TColumn::TAlignedBuffer::Allocate(Long64_t nbytes)
+{
+   constexpr std::size_t kAlign = 64;
+   fStorage.reset(new char[nbytes + kAlign]);
+   void *ptr = fStorage.get();
+   std::size_t space = nbytes + kAlign;
+   fData = static_cast<char *>(std::align(kAlign, nbytes, ptr, space));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create an exporter for the tree treeName stored in the file fileName.
+
+TTreeColumnExporter::TTreeColumnExporter(std::string_view treeName, std::string_view fileName)
+   : fTreeName(treeName), fFileName(fileName)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the exported column read from the branch name.
+/// Throws std::runtime_error if the branch was not exported.
+
+const TTreeColumnExporter::TColumn &TTreeColumnExporter::GetColumn(std::string_view name) const
+{
+   for (const auto &column : fColumns)
+      if (column.fName == name)
+         return column;
+   throw std::runtime_error("TTreeColumnExporter: column " + std::string(name) + " was not exported");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Split the tree in ranges of clusters which can be read independently:
+/// each range starts on a basket boundary of all the exported branches and
+/// of their count branches.
+
+std::vector<TTreeColumnExporter::Range_t> TTreeColumnExporter::MakeRanges(TTree &tree) const
+{
+   std::vector<TBranch *> branches;
+   for (const auto &column : fColumns) {
+      auto branch = GetBranchOrThrow(tree, column.fName);
+      branches.emplace_back(branch);
+      if (column.fIsJagged)
+         branches.emplace_back(static_cast<TLeaf *>(branch->GetListOfLeaves()->UncheckedAt(0))->GetLeafCount()->GetBranch());
+   }
+
+   const Long64_t nEntries = tree.GetEntries();
+   std::vector<Range_t> ranges;
+   auto clusterIt = tree.GetClusterIterator(0);
+   Long64_t start = 0;
+   Long64_t clusterStart;
+   while ((clusterStart = clusterIt()) < nEntries) {
+      if (clusterStart == start)
+         continue;
+      bool aligned = std::all_of(branches.begin(), branches.end(),
+                                 [clusterStart](TBranch *b) { return IsBasketStart(*b, clusterStart); });
+      if (aligned) {
+         ranges.emplace_back(start, clusterStart);
+         start = clusterStart;
+      }
+   }
+   if (start < nEntries)
+      ranges.emplace_back(start, nEntries);
+   return ranges;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Split the ranges in contiguous groups and call func(tree, firstRange, lastRange)
+/// for each group, in parallel if implicit multi-threading is enabled. Each
+/// group is processed with its own TFile and TTree.
+
+template <typename F>
+void TTreeColumnExporter::ForEachRangeGroup(const std::vector<Range_t> &ranges, F &&func)
+{
+   auto processGroup = [&](std::size_t first, std::size_t last) {
+      std::unique_ptr<TFile> file(TFile::Open(fFileName.c_str()));
+      if (!file || file->IsZombie())
+         throw std::runtime_error("TTreeColumnExporter: cannot open file " + fFileName);
+      auto tree = file->Get<TTree>(fTreeName.c_str());
+      if (!tree)
+         throw std::runtime_error("TTreeColumnExporter: cannot find tree " + fTreeName + " in file " + fFileName);
+      func(*tree, first, last);
+   };
+
+#ifdef R__USE_IMT
+   if (ROOT::IsImplicitMTEnabled() && ranges.size() > 1) {
+      const std::size_t nGroups = std::min<std::size_t>(ranges.size(), 2 * ROOT::GetThreadPoolSize());
+      std::vector<std::size_t> groups(nGroups);
+      for (std::size_t i = 0; i < nGroups; ++i)
+         groups[i] = i;
+      ROOT::TThreadExecutor pool;
+      pool.Foreach(
+         [&](std::size_t group) {
+            processGroup(group * ranges.size() / nGroups, (group + 1) * ranges.size() / nGroups);
+         },
+         groups);
+      return;
+   }
+#endif
+   processGroup(0, ranges.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read the given branches into columnar buffers, replacing the columns of a
+/// previous call. Throws std::runtime_error if the file or the tree cannot be
+/// opened, or if a branch does not exist or cannot be read in bulk.
+
+void TTreeColumnExporter::Export(const std::vector<std::string> &branchNames)
+{
+   fColumns.clear();
+
+   std::unique_ptr<TFile> file(TFile::Open(fFileName.c_str()));
+   if (!file || file->IsZombie())
+      throw std::runtime_error("TTreeColumnExporter: cannot open file " + fFileName);
+   auto tree = file->Get<TTree>(fTreeName.c_str());
+   if (!tree)
+      throw std::runtime_error("TTreeColumnExporter: cannot find tree " + fTreeName + " in file " + fFileName);
+   const Long64_t nEntries = tree->GetEntries();
+
+   fColumns.resize(branchNames.size());
+   bool hasJagged = false;
+   for (std::size_t i = 0; i < branchNames.size(); ++i) {
+      auto &column = fColumns[i];
+      auto branch = GetBranchOrThrow(*tree, branchNames[i]);
+      if (!branch->GetBulkRead().SupportsBulkRead())
+         throw std::runtime_error("TTreeColumnExporter: branch " + branchNames[i] + " does not support bulk reading");
+      auto leaf = static_cast<TLeaf *>(branch->GetListOfLeaves()->UncheckedAt(0));
+      column.fName = branchNames[i];
+      column.fTypeName = leaf->GetTypeName();
+      if (!IsSupportedType(column.fTypeName) || leaf->IsRange())
+         throw std::runtime_error("TTreeColumnExporter: branch " + branchNames[i] + " has unsupported type " +
+                                  column.fTypeName);
+      column.fElementSize = leaf->GetLenType();
+      column.fInnerSize = leaf->GetLenStatic();
+      column.fIsJagged = leaf->GetLeafCount() != nullptr;
+      column.fNEntries = nEntries;
+      if (column.fIsJagged) {
+         column.fOffsets.Allocate((nEntries + 1) * sizeof(Long64_t));
+         hasJagged = true;
+      } else {
+         column.fNValues = nEntries * column.fInnerSize;
+         column.fData.Allocate(column.fNValues * column.fElementSize);
+      }
+   }
+
+   const auto ranges = MakeRanges(*tree);
+   file.reset();
+
+   // First pass, only for variable-size arrays: read the counts into the
+   // offset arrays, relative to the start of each range.
+   std::vector<std::vector<Long64_t>> rangeBase(fColumns.size());
+   if (hasJagged) {
+      ForEachRangeGroup(ranges, [&](TTree &t, std::size_t first, std::size_t last) {
+         TBufferFile buf(TBuffer::kWrite, 32 * 1024);
+         for (auto &column : fColumns) {
+            if (!column.fIsJagged)
+               continue;
+            auto leaf = static_cast<TLeaf *>(GetBranchOrThrow(t, column.fName)->GetListOfLeaves()->UncheckedAt(0));
+            auto countBranch = leaf->GetLeafCount()->GetBranch();
+            const Int_t countSize = leaf->GetLeafCount()->GetLenType();
+            const Int_t factor = column.fInnerSize;
+            auto offsets = reinterpret_cast<Long64_t *>(column.fOffsets.Get());
+            for (std::size_t r = first; r < last; ++r) {
+               Long64_t total = 0;
+               for (Long64_t entry = ranges[r].first; entry < ranges[r].second;) {
+                  Int_t n = countBranch->GetBulkRead().GetEntriesSerialized(entry, buf);
+                  if (n <= 0)
+                     throw std::runtime_error("TTreeColumnExporter: bulk read failed for branch " +
+                                              std::string(countBranch->GetName()));
+                  n = std::min<Long64_t>(n, ranges[r].second - entry);
+                  const char *src = buf.GetCurrent();
+                  for (Int_t k = 0; k < n; ++k, src += countSize) {
+                     total += factor * ReadCount(src, countSize);
+                     offsets[entry + k + 1] = total;
+                  }
+                  entry += n;
+               }
+            }
+         }
+      });
+
+      for (std::size_t i = 0; i < fColumns.size(); ++i) {
+         auto &column = fColumns[i];
+         if (!column.fIsJagged)
+            continue;
+         auto offsets = reinterpret_cast<Long64_t *>(column.fOffsets.Get());
+         offsets[0] = 0;
+         Long64_t base = 0;
+         rangeBase[i].resize(ranges.size());
+         for (std::size_t r = 0; r < ranges.size(); ++r) {
+            rangeBase[i][r] = base;
+            base += offsets[ranges[r].second];
+         }
+         column.fNValues = base;
+         column.fData.Allocate(std::max<Long64_t>(base, 1) * column.fElementSize);
+      }
+   }
+
+   // Second pass: byte-swap the values of each basket straight into the columns.
+   ForEachRangeGroup(ranges, [&](TTree &t, std::size_t first, std::size_t last) {
+      TBufferFile buf(TBuffer::kWrite, 32 * 1024);
+      for (std::size_t i = 0; i < fColumns.size(); ++i) {
+         auto &column = fColumns[i];
+         auto branch = GetBranchOrThrow(t, column.fName);
+         auto offsets = reinterpret_cast<Long64_t *>(column.fOffsets.Get());
+         for (std::size_t r = first; r < last; ++r) {
+            const Long64_t begin = ranges[r].first;
+            const Long64_t end = ranges[r].second;
+            if (column.fIsJagged) {
+               for (Long64_t entry = begin; entry < end; ++entry)
+                  offsets[entry + 1] += rangeBase[i][r];
+            }
+            for (Long64_t entry = begin; entry < end;) {
+               Int_t n = branch->GetBulkRead().GetEntriesSerialized(entry, buf);
+               if (n <= 0)
+                  throw std::runtime_error("TTreeColumnExporter: bulk read failed for branch " + column.fName);
+               n = std::min<Long64_t>(n, end - entry);
+               Long64_t firstValue, nValues;
+               if (column.fIsJagged) {
+                  firstValue = entry == begin ? rangeBase[i][r] : offsets[entry];
+                  nValues = offsets[entry + n] - firstValue;
+               } else {
+                  firstValue = entry * column.fInnerSize;
+                  nValues = Long64_t(n) * column.fInnerSize;
+               }
+               CopyToHost(column.fData.Get() + firstValue * column.fElementSize, buf.GetCurrent(), nValues,
+                          column.fElementSize);
+               entry += n;
+            }
+         }
+      }
+   });
+}
+
+} // namespace Experimental
+} // namespace ROOT
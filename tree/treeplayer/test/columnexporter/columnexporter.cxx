@@ -0,0 +1,137 @@
+#include "ROOT/TTreeColumnExporter.hxx"
+#include "TFile.h"
+#include "TROOT.h"
+#include "TTree.h"
+#include "TSystem.h"
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+class TTreeColumnExporterTest : public ::testing::Test {
+protected:
+   const char *fFileName = "TTreeColumnExporter.root";
+   static constexpr Long64_t fNEntries = 10000;
+
+   void SetUp() override
+   {
+      TFile f(fFileName, "RECREATE");
+      TTree t("t", "t");
+      t.SetAutoFlush(1000);
+      Int_t i = 0;
+      Float_t x = 0.f;
+      Double_t v[3] = {0., 0., 0.};
+      Int_t n = 0;
+      Short_t s[10];
+      t.Branch("i", &i, "i/I");
+      t.Branch("x", &x, "x/F");
+      t.Branch("v", v, "v[3]/D");
+      t.Branch("n", &n, "n/I");
+      t.Branch("s", s, "s[n]/S");
+      for (i = 0; i < fNEntries; ++i) {
+         x = 0.5f * i;
+         for (int k = 0; k < 3; ++k)
+            v[k] = i + 0.1 * k;
+         n = i % 10;
+         for (int k = 0; k < n; ++k)
+            s[k] = k - i % 7;
+         t.Fill();
+      }
+      t.Write();
+   }
+
+   void TearDown() override { gSystem->Unlink(fFileName); }
+};
+
+constexpr Long64_t TTreeColumnExporterTest::fNEntries;
+
+TEST_F(TTreeColumnExporterTest, Scalars)
+{
+   ROOT::Experimental::TTreeColumnExporter exporter("t", fFileName);
+   exporter.Export({"i", "x"});
+
+   const auto &i = exporter.GetColumn("i");
+   EXPECT_EQ(i.GetTypeName(), "Int_t");
+   EXPECT_FALSE(i.IsJagged());
+   ASSERT_EQ(i.GetNValues(), fNEntries);
+   EXPECT_EQ(reinterpret_cast<std::uintptr_t>(i.GetData()) % 64, 0u);
+   auto iData = static_cast<const Int_t *>(i.GetData());
+   auto xData = static_cast<const Float_t *>(exporter.GetColumn("x").GetData());
+   for (Long64_t e = 0; e < fNEntries; ++e) {
+      ASSERT_EQ(iData[e], e);
+      ASSERT_FLOAT_EQ(xData[e], 0.5f * e);
+   }
+}
+
+TEST_F(TTreeColumnExporterTest, FixedSizeArray)
+{
+   ROOT::Experimental::TTreeColumnExporter exporter("t", fFileName);
+   exporter.Export({"v"});
+
+   const auto &v = exporter.GetColumn("v");
+   EXPECT_EQ(v.GetInnerSize(), 3);
+   ASSERT_EQ(v.GetNValues(), 3 * fNEntries);
+   auto data = static_cast<const Double_t *>(v.GetData());
+   for (Long64_t e = 0; e < fNEntries; ++e)
+      for (int k = 0; k < 3; ++k)
+         ASSERT_DOUBLE_EQ(data[3 * e + k], e + 0.1 * k);
+}
+
+TEST_F(TTreeColumnExporterTest, JaggedArray)
+{
+   ROOT::Experimental::TTreeColumnExporter exporter("t", fFileName);
+   exporter.Export({"s"});
+
+   const auto &s = exporter.GetColumn("s");
+   ASSERT_TRUE(s.IsJagged());
+   auto offsets = s.GetOffsets();
+   auto data = static_cast<const Short_t *>(s.GetData());
+   EXPECT_EQ(offsets[0], 0);
+   for (Long64_t e = 0; e < fNEntries; ++e) {
+      ASSERT_EQ(offsets[e + 1] - offsets[e], e % 10);
+      for (Long64_t k = 0; k < e % 10; ++k)
+         ASSERT_EQ(data[offsets[e] + k], k - e % 7);
+   }
+   EXPECT_EQ(s.GetNValues(), offsets[fNEntries]);
+}
+
+TEST_F(TTreeColumnExporterTest, Errors)
+{
+   ROOT::Experimental::TTreeColumnExporter exporter("t", fFileName);
+   EXPECT_THROW(exporter.Export({"doesnotexist"}), std::runtime_error);
+   exporter.Export({"i"});
+   EXPECT_THROW(exporter.GetColumn("x"), std::runtime_error);
+}
+
+#ifdef R__USE_IMT
+// With implicit MT, the ranges of entries are read in parallel: same columns as the serial export.
+TEST_F(TTreeColumnExporterTest, ImplicitMT)
+{
+   const std::vector<std::string> names{"i", "x", "v", "n", "s"};
+   ROOT::Experimental::TTreeColumnExporter serial("t", fFileName);
+   serial.Export(names);
+
+   ROOT::EnableImplicitMT(4);
+   ROOT::Experimental::TTreeColumnExporter parallel("t", fFileName);
+   parallel.Export(names);
+   ROOT::DisableImplicitMT();
+
+   for (const auto &name : names) {
+      const auto &expected = serial.GetColumn(name);
+      const auto &column = parallel.GetColumn(name);
+      EXPECT_EQ(column.GetTypeName(), expected.GetTypeName()) << name;
+      ASSERT_EQ(column.GetNEntries(), fNEntries) << name;
+      ASSERT_EQ(column.GetNValues(), expected.GetNValues()) << name;
+      EXPECT_EQ(0, std::memcmp(column.GetData(), expected.GetData(), expected.GetNValues() * expected.GetElementSize()))
+         << name;
+      ASSERT_EQ(column.IsJagged(), expected.IsJagged()) << name;
+      if (expected.IsJagged()) {
+         EXPECT_EQ(0, std::memcmp(column.GetOffsets(), expected.GetOffsets(), (fNEntries + 1) * sizeof(Long64_t)))
+            << name;
+      }
+   }
+}
+#endif